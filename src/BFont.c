@@ -218,34 +218,31 @@ int put_char(struct font *font, int x, int y, unsigned char c)
 /**
  * Write a string on a surface using specified font, taking letter-spacing
  * into account.
+ * The string's layout is pre-computed and cached (see text_layout.c), so that
+ * the visible characters are emitted as a single batch.
  */
 void put_string(struct font *font, int x, int y, const char *text)
 {
-	char *ptr = (char *)text;
+	struct text_layout *layout = get_text_run_layout(font, text, FALSE);
+	SDL_Rect clip_rect;
+	int i;
 
-	set_current_font(font);
+	SDL_GetClipRect(Screen, &clip_rect);
 
 #ifdef HAVE_LIBGL
 	if (use_open_gl) {
-		SDL_Rect clip_rect;
-		SDL_GetClipRect(Screen, &clip_rect);
 		set_gl_clip_rect(&clip_rect);
 	}
 #endif
 
 	start_image_batch();
 
-	int letter_spacing = get_letter_spacing(get_current_font());
-
-	while (*ptr != '\0') {
-		// handle_switch_font_char() can change the current font, so we need
-		// to call get_current_font() at each step
-		if (handle_switch_font_char(&ptr)) {
-			letter_spacing = get_letter_spacing(get_current_font());
-			continue;
+	for (i = 0; i < layout->nb_glyphs; i++) {
+		struct text_layout_glyph *glyph = &layout->glyphs[i];
+		int glyph_x = x + glyph->x;
+		if ((glyph_x >= clip_rect.x) && (glyph_x < clip_rect.x + clip_rect.w)) {
+			display_image_on_screen(glyph->img, glyph_x, y, IMAGE_NO_TRANSFO);
 		}
-		x += put_char(get_current_font(), x, y, *ptr) + letter_spacing;
-		ptr++;
 	}
 
 	end_image_batch(__FUNCTION__);
@@ -255,6 +252,9 @@ void put_string(struct font *font, int x, int y, const char *text)
 		unset_gl_clip_rect();
 	}
 #endif
+
+	// Font switch codes change the current font
+	set_current_font(layout->steps[layout->nb_steps].font);
 }
 
 /**
@@ -263,41 +263,36 @@ void put_string(struct font *font, int x, int y, const char *text)
  */
 int text_width(struct font *font, const char *text)
 {
-	char *ptr = (char *)text;
-	int width = 0;
-	int letter_spacing = get_letter_spacing(font);
-
-	while (*ptr != '\0') {
-		if (handle_switch_font_char(&ptr)) {
-			letter_spacing = get_letter_spacing(font);
-			continue;
-		}
-		width += font_char_width(font, *ptr) + letter_spacing;
-		ptr++;
-	}
-	return width;
+	struct text_layout *layout = get_text_run_layout(font, text, TRUE);
+	struct text_layout_step *end = &layout->steps[layout->nb_steps];
+
+	// Font switch codes change the current font
+	if (end->font)
+		set_current_font(end->font);
+
+	return end->x;
 }
 
 /**
- *
- *
+ * Return the number of characters of a string needed to reach a given width,
+ * or -1 if the whole string is narrower.
  */
 int limit_text_width(struct font *font, const char *text, int limit)
 {
-	char *ptr = (char *)text;
-	int width = 0;
-	int letter_spacing = get_letter_spacing(font);
-
-	while (*ptr != '\0') {
-		if (handle_switch_font_char(&ptr)) {
-			letter_spacing = get_letter_spacing(font);
-			continue;
+	struct text_layout *layout = get_text_run_layout(font, text, TRUE);
+	int i;
+
+	for (i = 0; i < layout->nb_steps; i++) {
+		struct text_layout_step *next = &layout->steps[i + 1];
+		if (!layout->steps[i].is_font_switch && next->x >= limit) {
+			if (next->font)
+				set_current_font(next->font);
+			return next->offset;
 		}
-		width += font_char_width(font, *ptr) + letter_spacing;
-		ptr++;
-		if (width >= limit)
-			return (ptr - text);
 	}
+
+	if (layout->steps[layout->nb_steps].font)
+		set_current_font(layout->steps[layout->nb_steps].font);
 	return -1;
 }
 
@@ -54,8 +54,8 @@
  */
 static void find_dropable_position_near_chest(float *item_x, float *item_y, int obst_index, level *obst_level)
 {
-	float obst_x = obst_level->obstacle_list[obst_index].pos.x;
-	float obst_y = obst_level->obstacle_list[obst_index].pos.y;
+	float obst_x = ACCESS_OBSTACLE(obst_level, obst_index).pos.x;
+	float obst_y = ACCESS_OBSTACLE(obst_level, obst_index).pos.y;
 	pointf offset_vector;
 	int tries;
 
@@ -64,7 +64,7 @@ static void find_dropable_position_near_chest(float *item_x, float *item_y, int
 	*item_y = Me.pos.y;
 
 	// Step 1: randomly choose one of 16 main 22.5° directions around the chest
-	float obs_diag = get_obstacle_spec(obst_level->obstacle_list[obst_index].type)->diaglength;
+	float obs_diag = get_obstacle_spec(ACCESS_OBSTACLE(obst_level, obst_index).type)->diaglength;
 	offset_vector.x = obs_diag + 0.5;
 	offset_vector.y = 0.0;
 	RotateVectorByAngle(&offset_vector, (float)MyRandom(16) * 22.5);
@@ -130,7 +130,7 @@ static void throw_out_all_chest_content(int obst_index)
 	int drop_count = 0;
 	level *lvl = CURLEVEL();
 
-	struct dynarray *item_list = get_obstacle_extension(CURLEVEL(), &(lvl->obstacle_list[obst_index]), OBSTACLE_EXTENSION_CHEST_ITEMS);
+	struct dynarray *item_list = get_obstacle_extension(CURLEVEL(), &(ACCESS_OBSTACLE(lvl, obst_index)), OBSTACLE_EXTENSION_CHEST_ITEMS);
 
 	play_open_chest_sound();
 
@@ -152,7 +152,7 @@ static void throw_out_all_chest_content(int obst_index)
 		dynarray_free(item_list);
 
 		// Remove the chest items obstacle extension
-		del_obstacle_extension(lvl, &(lvl->obstacle_list[obst_index]), OBSTACLE_EXTENSION_CHEST_ITEMS);
+		del_obstacle_extension(lvl, &(ACCESS_OBSTACLE(lvl, obst_index)), OBSTACLE_EXTENSION_CHEST_ITEMS);
 	}
 	
 	// If the chest was empty, maybe generate a random item to be dropped
@@ -170,8 +170,8 @@ static int mouse_cursor_is_on_that_obstacle(level *lvl, int obst_index)
 {
 	// mouse_cursor_is_on_that_iso_image() needs a position defined relatively to
 	// current level
-	gps obs_pos = { lvl->obstacle_list[obst_index].pos.x,
-		lvl->obstacle_list[obst_index].pos.y,
+	gps obs_pos = { ACCESS_OBSTACLE(lvl, obst_index).pos.x,
+		ACCESS_OBSTACLE(lvl, obst_index).pos.y,
 		lvl->levelnum
 	};
 	gps obs_vpos;
@@ -179,7 +179,7 @@ static int mouse_cursor_is_on_that_obstacle(level *lvl, int obst_index)
 	if (obs_vpos.z == -1)
 		return FALSE;
 
-	struct image *img = get_obstacle_image(lvl->obstacle_list[obst_index].type, lvl->obstacle_list[obst_index].frame_index);
+	struct image *img = get_obstacle_image(ACCESS_OBSTACLE(lvl, obst_index).type, ACCESS_OBSTACLE(lvl, obst_index).frame_index);
 	if (mouse_cursor_is_on_that_image(obs_vpos.x, obs_vpos.y, img))
 		return TRUE;
 
@@ -239,10 +239,10 @@ int clickable_obstacle_below_mouse_cursor(level **obst_lvl, int clickable_only)
 		int j;
 		for (j = 0; j < lvl->map[y][x].glued_obstacles.size; j++) {
 			obst_index = ((int *)(lvl->map[y][x].glued_obstacles.arr))[j];
-			obst_normal = lvl->obstacle_list[obst_index].pos.x + lvl->obstacle_list[obst_index].pos.y;
+			obst_normal = ACCESS_OBSTACLE(lvl, obst_index).pos.x + ACCESS_OBSTACLE(lvl, obst_index).pos.y;
 
 			if (obst_normal > max_normal &&
-				(!clickable_only || (get_obstacle_spec(lvl->obstacle_list[obst_index].type)->flags & IS_CLICKABLE)) &&
+				(!clickable_only || (get_obstacle_spec(ACCESS_OBSTACLE(lvl, obst_index).type)->flags & IS_CLICKABLE)) &&
 				mouse_cursor_is_on_that_obstacle(lvl, obst_index)) {
 
 				max_normal = obst_normal;
@@ -263,9 +263,9 @@ int clickable_obstacle_below_mouse_cursor(level **obst_lvl, int clickable_only)
  */
 static int reach_obstacle_from_any_direction(level *obst_lvl, int obst_index) {
 	gps obst_vpos;
-	obstacle_spec *obstacle_spec = get_obstacle_spec(obst_lvl->obstacle_list[obst_index].type);
+	obstacle_spec *obstacle_spec = get_obstacle_spec(ACCESS_OBSTACLE(obst_lvl, obst_index).type);
 
-	update_virtual_position(&obst_vpos, &(obst_lvl->obstacle_list[obst_index].pos), Me.pos.z);
+	update_virtual_position(&obst_vpos, &(ACCESS_OBSTACLE(obst_lvl, obst_index).pos), Me.pos.z);
 	if (calc_distance(Me.pos.x, Me.pos.y, obst_vpos.x, obst_vpos.y)
 		<= (obstacle_spec->block_area_parm_1 * sqrt(2)) / 2.0 + 0.5) {
 		// Maybe a combo_action has made us come here and open the chest.  Then of
@@ -306,9 +306,9 @@ static int reach_obstacle_from_any_direction(level *obst_lvl, int obst_index) {
 			// This position has to be defined relatively to the barrel's level, so that we
 			// can retrieve the barrel later (at the end the combo action)
 			//
-			Me.mouse_move_target.x = step_vector.x + obst_lvl->obstacle_list[obst_index].pos.x;
-			Me.mouse_move_target.y = step_vector.y + obst_lvl->obstacle_list[obst_index].pos.y;
-			Me.mouse_move_target.z = obst_lvl->obstacle_list[obst_index].pos.z;
+			Me.mouse_move_target.x = step_vector.x + ACCESS_OBSTACLE(obst_lvl, obst_index).pos.x;
+			Me.mouse_move_target.y = step_vector.y + ACCESS_OBSTACLE(obst_lvl, obst_index).pos.y;
+			Me.mouse_move_target.z = ACCESS_OBSTACLE(obst_lvl, obst_index).pos.z;
 
 			// We set up the combo_action, so that the barrel can be smashed later...
 			//
@@ -360,10 +360,10 @@ static int reach_obstacle_from_any_direction(level *obst_lvl, int obst_index) {
 			// can retrieve the barrel later (at the end the combo action)
 			//
 			Me.mouse_move_target.x =
-				obst_lvl->obstacle_list[obst_index].pos.x + step_vector.x * (half_size.x + 0.05);
+				ACCESS_OBSTACLE(obst_lvl, obst_index).pos.x + step_vector.x * (half_size.x + 0.05);
 			Me.mouse_move_target.y =
-				obst_lvl->obstacle_list[obst_index].pos.y + step_vector.y * (half_size.y + 0.05);
-			Me.mouse_move_target.z = obst_lvl->obstacle_list[obst_index].pos.z;
+				ACCESS_OBSTACLE(obst_lvl, obst_index).pos.y + step_vector.y * (half_size.y + 0.05);
+			Me.mouse_move_target.z = ACCESS_OBSTACLE(obst_lvl, obst_index).pos.z;
 
 			// We set up the combo_action, so that the barrel can be smashed later, on the
 			// second call (made by move_tux_towards_intermediate_point)...
@@ -389,7 +389,7 @@ static int reach_obstacle_from_any_direction(level *obst_lvl, int obst_index) {
  */
 static int reach_obstacle_from_specific_direction(level *obst_lvl, int obst_index, int direction) {
 	gps obst_vpos;
-	update_virtual_position(&obst_vpos, &(obst_lvl->obstacle_list[obst_index].pos), Me.pos.z);
+	update_virtual_position(&obst_vpos, &(ACCESS_OBSTACLE(obst_lvl, obst_index).pos), Me.pos.z);
 	if (fabsf(Me.pos.x - obst_vpos.x) + fabsf(Me.pos.y - obst_vpos.y) < 1.1) {
     	// Maybe a combo_action has made us come here and open the chest.  Then of
     	// course we can remove the combo action setting now...
@@ -406,13 +406,13 @@ static int reach_obstacle_from_specific_direction(level *obst_lvl, int obst_inde
 	//
 	DebugPrintf(2, "\nreach_obstacle_from_specific_direction:  setting up combined mouse move target!");
 		
-	Me.mouse_move_target.x = obst_lvl->obstacle_list[obst_index].pos.x;
-	Me.mouse_move_target.y = obst_lvl->obstacle_list[obst_index].pos.y;
+	Me.mouse_move_target.x = ACCESS_OBSTACLE(obst_lvl, obst_index).pos.x;
+	Me.mouse_move_target.y = ACCESS_OBSTACLE(obst_lvl, obst_index).pos.y;
 	Me.mouse_move_target.z = obst_lvl->levelnum;
 	enemy_set_reference(&Me.current_enemy_target_n, &Me.current_enemy_target_addr, NULL);
 	Me.mouse_move_target_combo_action_type = COMBO_ACTION_OBSTACLE;
 	Me.mouse_move_target_combo_action_parameter = obst_index;
-	int obst_type = obst_lvl->obstacle_list[obst_index].type;
+	int obst_type = ACCESS_OBSTACLE(obst_lvl, obst_index).type;
 
 	obstacle_spec *spec = get_obstacle_spec(obst_type);
 	switch (direction) {
@@ -570,7 +570,7 @@ static void __obstacle_action(level *lvl, int index, enum interactive_obstacle_t
 	if (index == -1)
 		return;
 
-	o = &lvl->obstacle_list[index];
+	o = &ACCESS_OBSTACLE(lvl, index);
 
 	// Compute the position of the obtacle
 	update_virtual_position(&vpos, &o->pos, Me.pos.z);
@@ -690,7 +690,7 @@ int check_for_items_to_pickup(level *item_lvl, int item_index)
 	if (item_lvl == NULL || item_index == -1)
 		return FALSE;
 
-	update_virtual_position(&item_vpos, &item_lvl->ItemList[item_index].pos, Me.pos.z);
+	update_virtual_position(&item_vpos, &ACCESS_FLOOR_ITEM(item_lvl, item_index).pos, Me.pos.z);
 
 	if ((calc_distance(Me.pos.x, Me.pos.y, item_vpos.x, item_vpos.y) < ITEM_TAKE_DIST)
 		&& DirectLineColldet(Me.pos.x, Me.pos.y, item_vpos.x, item_vpos.y, Me.pos.z, NULL))
@@ -699,8 +699,8 @@ int check_for_items_to_pickup(level *item_lvl, int item_index)
 	}
 
 	// Set up the combo_action
-	Me.mouse_move_target.x = item_lvl->ItemList[item_index].pos.x;
-	Me.mouse_move_target.y = item_lvl->ItemList[item_index].pos.y;
+	Me.mouse_move_target.x = ACCESS_FLOOR_ITEM(item_lvl, item_index).pos.x;
+	Me.mouse_move_target.y = ACCESS_FLOOR_ITEM(item_lvl, item_index).pos.y;
 	Me.mouse_move_target.z = item_lvl->levelnum;
 
 	enemy_set_reference(&Me.current_enemy_target_n, &Me.current_enemy_target_addr, NULL);
@@ -291,13 +291,13 @@ static void generate_animated_obstacle_list(struct visible_level *vis_lvl)
 	INIT_LIST_HEAD(&vis_lvl->animated_obstacles_list);
 
 	/* Now browse obstacles and fill our list of animated obstacles. */
-	for (obstacle_index = 0; obstacle_index < MAX_OBSTACLES_ON_MAP; obstacle_index++) {
-		if (Lev->obstacle_list[obstacle_index].type == -1)
+	for (obstacle_index = 0; obstacle_index < Lev->obstacle_list.size; obstacle_index++) {
+		if (ACCESS_OBSTACLE(Lev, obstacle_index).type == -1)
 			continue;
-		animation_fptr animation_fn = get_obstacle_spec(Lev->obstacle_list[obstacle_index].type)->animation_fn;
+		animation_fptr animation_fn = get_obstacle_spec(ACCESS_OBSTACLE(Lev, obstacle_index).type)->animation_fn;
 		if (animation_fn != NULL) {
 			struct animated_scenery_piece *a = MyMalloc(sizeof(struct animated_scenery_piece));
-			a->scenery_piece = (void *)&Lev->obstacle_list[obstacle_index];
+			a->scenery_piece = (void *)&ACCESS_OBSTACLE(Lev, obstacle_index);
 			a->animation_fn = animation_fn;
 			list_add(&a->node, &vis_lvl->animated_obstacles_list);
 			continue;
@@ -0,0 +1,519 @@
+/*
+ *
+ *   Copyright (c) 2026 FreedroidRPG development team
+ *
+ *
+ *  This file is part of Freedroid
+ *
+ *  Freedroid is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Freedroid is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Freedroid; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ *  MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file asset_pack.c
+ * \brief Images and texture atlases read from the asset pack.
+ *
+ * When the graphics data dir contains an asset pack (built with
+ * 'make asset-pack'), the file is mapped in memory, and the images it
+ * contains are created from their already decoded pixels, instead of
+ * being loaded from their PNG and offset files. Images which are not in
+ * the pack are still loaded from their own files.
+ *
+ * The pack records the files each image and atlas was built from. Before
+ * an entry is used, these files are checked (with their modification time
+ * and size, or their content if the modification time differs), and the
+ * entry is ignored if one of them changed since the pack was built.
+ */
+
+#define _asset_pack_c 1
+
+#include "system.h"
+
+#include "defs.h"
+#include "struct.h"
+#include "global.h"
+#include "proto.h"
+
+#include "asset_pack.h"
+
+#define ASSET_PACK_FILE "assets.pack"
+
+// States of the sources of the pack
+enum {
+	SOURCE_UNCHECKED = 0,
+	SOURCE_CURRENT,
+	SOURCE_MODIFIED
+};
+
+static struct {
+	unsigned char *data;
+	size_t size;
+	int mapped;
+
+	struct asset_pack_header *header;
+	struct asset_pack_image *images;
+	struct asset_pack_atlas *atlases;
+	struct asset_pack_atlas_page *pages;
+	struct asset_pack_atlas_element *elements;
+	struct asset_pack_source *sources;
+	const char *strings;
+
+	// SOURCE_* state of each source, checked on first use
+	unsigned char *source_states;
+
+	// Open addressing hash tables of the image and atlas names.
+	// They store index + 1, 0 being an empty slot.
+	uint32_t *image_slots;
+	uint32_t nb_image_slots;
+	uint32_t *atlas_slots;
+	uint32_t nb_atlas_slots;
+} pack;
+
+static uint32_t name_hash(const char *name)
+{
+	uint32_t hash = 2166136261u;
+	const unsigned char *ptr;
+
+	for (ptr = (const unsigned char *)name; *ptr; ptr++)
+		hash = (hash ^ *ptr) * 16777619u;
+
+	return hash;
+}
+
+/**
+ * Remove the './' and duplicated '/' from a path, so that it can be
+ * compared to the names stored in the pack.
+ */
+static int normalize_name(char *dst, const char *src)
+{
+	char *out = dst;
+
+	while (*src) {
+		if (src[0] == '/' && out > dst && out[-1] == '/') {
+			src++;
+			continue;
+		}
+		if (src[0] == '.' && src[1] == '/' && (out == dst || out[-1] == '/')) {
+			src += 2;
+			continue;
+		}
+		if (out - dst >= PATH_MAX - 1)
+			return FALSE;
+		*out++ = *src++;
+	}
+	*out = '\0';
+
+	return TRUE;
+}
+
+static const char *pack_string(uint32_t offset)
+{
+	if (offset >= pack.header->strings_size)
+		return "";
+
+	return pack.strings + offset;
+}
+
+/**
+ * Build the hash table of the names of a table of the pack. The name is
+ * the first field of each member of the table.
+ */
+static uint32_t *build_name_index(const void *table, size_t stride, uint32_t nb, uint32_t *nb_slots)
+{
+	uint32_t i;
+
+	*nb_slots = 16;
+	while (*nb_slots < 2 * nb)
+		*nb_slots *= 2;
+
+	uint32_t *slots = MyMalloc(*nb_slots * sizeof(uint32_t));
+
+	for (i = 0; i < nb; i++) {
+		const char *name = pack_string(*(const uint32_t *)((const char *)table + i * stride));
+		uint32_t slot = name_hash(name) & (*nb_slots - 1);
+		while (slots[slot])
+			slot = (slot + 1) & (*nb_slots - 1);
+		slots[slot] = i + 1;
+	}
+
+	return slots;
+}
+
+static int find_name(const uint32_t *slots, uint32_t nb_slots, const void *table, size_t stride, const char *path)
+{
+	char name[PATH_MAX];
+
+	if (!slots || !normalize_name(name, path))
+		return -1;
+
+	uint32_t slot = name_hash(name) & (nb_slots - 1);
+	while (slots[slot]) {
+		uint32_t idx = slots[slot] - 1;
+		if (!strcmp(pack_string(*(const uint32_t *)((const char *)table + idx * stride)), name))
+			return idx;
+		slot = (slot + 1) & (nb_slots - 1);
+	}
+
+	return -1;
+}
+
+static int table_is_valid(uint64_t offset, uint32_t nb, size_t member_size)
+{
+	return offset <= pack.size && (pack.size - offset) / member_size >= nb;
+}
+
+static int pack_is_valid(void)
+{
+	struct asset_pack_header *h = pack.header;
+	uint32_t i;
+
+	if (pack.size < sizeof(struct asset_pack_header) ||
+	    memcmp(h->magic, ASSET_PACK_MAGIC, sizeof(h->magic)) ||
+	    h->version != ASSET_PACK_VERSION ||
+	    h->byte_order != ASSET_PACK_BYTE_ORDER)
+		return FALSE;
+
+	if (!table_is_valid(h->images_offset, h->nb_images, sizeof(struct asset_pack_image)) ||
+	    !table_is_valid(h->atlases_offset, h->nb_atlases, sizeof(struct asset_pack_atlas)) ||
+	    !table_is_valid(h->atlas_pages_offset, h->nb_atlas_pages, sizeof(struct asset_pack_atlas_page)) ||
+	    !table_is_valid(h->atlas_elements_offset, h->nb_atlas_elements, sizeof(struct asset_pack_atlas_element)) ||
+	    !table_is_valid(h->sources_offset, h->nb_sources, sizeof(struct asset_pack_source)) ||
+	    !table_is_valid(h->strings_offset, h->strings_size, 1) ||
+	    !h->strings_size || pack.data[h->strings_offset + h->strings_size - 1] != '\0')
+		return FALSE;
+
+	pack.images = (struct asset_pack_image *)(pack.data + h->images_offset);
+	pack.atlases = (struct asset_pack_atlas *)(pack.data + h->atlases_offset);
+	pack.pages = (struct asset_pack_atlas_page *)(pack.data + h->atlas_pages_offset);
+	pack.elements = (struct asset_pack_atlas_element *)(pack.data + h->atlas_elements_offset);
+	pack.sources = (struct asset_pack_source *)(pack.data + h->sources_offset);
+	pack.strings = (const char *)(pack.data + h->strings_offset);
+
+	for (i = 0; i < h->nb_images; i++) {
+		struct asset_pack_image *img = &pack.images[i];
+		if (img->w > 16384 || img->h > 16384 || !table_is_valid(img->pixels, img->w * img->h, 4) ||
+		    img->source >= h->nb_sources || img->offset_source >= h->nb_sources)
+			return FALSE;
+	}
+
+	for (i = 0; i < h->nb_atlases; i++) {
+		struct asset_pack_atlas *atlas = &pack.atlases[i];
+		if (atlas->first_page > h->nb_atlas_pages || atlas->nb_pages > h->nb_atlas_pages - atlas->first_page ||
+		    atlas->source >= h->nb_sources)
+			return FALSE;
+	}
+
+	for (i = 0; i < h->nb_atlas_pages; i++) {
+		struct asset_pack_atlas_page *page = &pack.pages[i];
+		if (page->image >= h->nb_images || page->first_element > h->nb_atlas_elements ||
+		    page->nb_elements > h->nb_atlas_elements - page->first_element)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * Open the asset pack of the graphics data dir, if there is one.
+ *
+ * \return TRUE if the asset pack is open
+ */
+int open_asset_pack(void)
+{
+	char fpath[PATH_MAX];
+
+	if (pack.data)
+		return TRUE;
+
+	if (!find_file(fpath, GRAPHICS_DIR, ASSET_PACK_FILE, NULL, SILENT))
+		return FALSE;
+
+	FILE *f = fopen(fpath, "rb");
+	if (!f) {
+		error_message(__FUNCTION__, "Unable to open asset pack %s: %s.", NO_REPORT, fpath, strerror(errno));
+		return FALSE;
+	}
+
+	pack.size = FS_filelength(f);
+
+#if defined HAVE_MMAP && defined HAVE_SYS_MMAN_H
+	// Pages are copied on write, as SDL can modify the pixels of a surface
+	void *data = mmap(NULL, pack.size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fileno(f), 0);
+	if (data != MAP_FAILED) {
+		pack.data = data;
+		pack.mapped = TRUE;
+	}
+#endif
+
+	if (!pack.data) {
+		pack.data = malloc(pack.size);
+		if (!pack.data || fread(pack.data, pack.size, 1, f) != 1) {
+			error_message(__FUNCTION__, "Unable to read asset pack %s.", NO_REPORT, fpath);
+			fclose(f);
+			free(pack.data);
+			pack.data = NULL;
+			return FALSE;
+		}
+	}
+	fclose(f);
+
+	pack.header = (struct asset_pack_header *)pack.data;
+	if (!pack_is_valid() ||
+	    pack.header->rmask != rmask || pack.header->gmask != gmask ||
+	    pack.header->bmask != bmask || pack.header->amask != amask) {
+		error_message(__FUNCTION__, "The asset pack %s is invalid or was built for another version of the game, it is ignored.\n"
+		              "Run 'make asset-pack' to rebuild it.", NO_REPORT, fpath);
+		close_asset_pack();
+		return FALSE;
+	}
+
+	pack.image_slots = build_name_index(pack.images, sizeof(struct asset_pack_image), pack.header->nb_images, &pack.nb_image_slots);
+	pack.atlas_slots = build_name_index(pack.atlases, sizeof(struct asset_pack_atlas), pack.header->nb_atlases, &pack.nb_atlas_slots);
+	pack.source_states = MyMalloc(pack.header->nb_sources + 1);
+
+	return TRUE;
+}
+
+/**
+ * Close the asset pack. Images are then loaded from their own files.
+ */
+void close_asset_pack(void)
+{
+	if (!pack.data)
+		return;
+
+#if defined HAVE_MMAP && defined HAVE_SYS_MMAN_H
+	if (pack.mapped)
+		munmap(pack.data, pack.size);
+	else
+#endif
+		free(pack.data);
+
+	free(pack.image_slots);
+	free(pack.atlas_slots);
+	free(pack.source_states);
+	memset(&pack, 0, sizeof(pack));
+}
+
+/**
+ * FNV-1a hash of the content of a file, as computed by make_pack.
+ */
+static uint64_t hash_file(FILE *f)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	unsigned char buf[65536];
+	size_t len, i;
+
+	while ((len = fread(buf, 1, sizeof(buf), f)) > 0) {
+		for (i = 0; i < len; i++)
+			hash = (hash ^ buf[i]) * 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+/**
+ * Compare a source of the pack with the current file of the graphics data dir.
+ * The content is only hashed when the size matches but the modification time
+ * does not, as it happens when the data is copied. 'make install' records
+ * the modification times of the installed files in the installed pack
+ * (see 'make_pack --update-sources'), so that they are not hashed.
+ */
+static int source_matches_file(struct asset_pack_source *src)
+{
+	char fpath[PATH_MAX];
+	struct stat st;
+	int found = find_file(fpath, GRAPHICS_DIR, pack_string(src->name), NULL, SILENT);
+
+	if (!found || stat(fpath, &st))
+		return (src->flags & ASSET_PACK_SOURCE_MISSING) != 0;
+
+	if ((src->flags & ASSET_PACK_SOURCE_MISSING) || (uint64_t)st.st_size != src->size)
+		return FALSE;
+
+	if ((int64_t)st.st_mtime == src->mtime)
+		return TRUE;
+
+	FILE *f = fopen(fpath, "rb");
+	if (!f)
+		return FALSE;
+
+	uint64_t hash = hash_file(f);
+	int read_error = ferror(f);
+	fclose(f);
+
+	return !read_error && hash == src->hash;
+}
+
+/**
+ * Check if a source of the pack is unchanged since the pack was built.
+ * Each source is only checked once.
+ */
+static int source_is_current(uint32_t idx)
+{
+	if (!pack.source_states[idx]) {
+		pack.source_states[idx] = source_matches_file(&pack.sources[idx]) ? SOURCE_CURRENT : SOURCE_MODIFIED;
+		if (pack.source_states[idx] == SOURCE_MODIFIED) {
+			error_once_message(ONCE_PER_RUN, __FUNCTION__, "The asset pack is out of date, the modified images are loaded from their own files.\n"
+			                   "Run 'make asset-pack' to rebuild it.", NO_REPORT);
+		}
+	}
+
+	return pack.source_states[idx] == SOURCE_CURRENT;
+}
+
+/**
+ * Find an image in the asset pack, ignoring it if its files were modified.
+ *
+ * \return The index of the image, or -1
+ */
+static int find_current_image(const char *filename)
+{
+	int idx = find_name(pack.image_slots, pack.nb_image_slots, pack.images, sizeof(struct asset_pack_image), filename);
+	if (idx < 0)
+		return -1;
+
+	if (!source_is_current(pack.images[idx].source) || !source_is_current(pack.images[idx].offset_source))
+		return -1;
+
+	return idx;
+}
+
+/**
+ * Check if an image of the graphics data dir is in the asset pack.
+ */
+int asset_pack_has_image(const char *filename)
+{
+	return find_current_image(filename) >= 0;
+}
+
+/**
+ * Load an image of the graphics data dir from the asset pack.
+ *
+ * \param img        Image to fill in
+ * \param filename   Name of the image, relatively to the graphics data dir
+ * \param mod_flags  Modifications to apply
+ * \return TRUE if the image was created from the asset pack
+ */
+int load_image_from_asset_pack(struct image *img, const char *filename, int mod_flags)
+{
+	int idx = find_current_image(filename);
+	if (idx < 0)
+		return FALSE;
+
+	if (image_loaded(img)) {
+		error_message(__FUNCTION__, "The image has already been loaded: %s.", PLEASE_INFORM, filename);
+		return TRUE;
+	}
+
+	struct asset_pack_image *pimg = &pack.images[idx];
+
+	// Same as load_surface_bitmap(), without the decoding
+	SDL_Surface *surf = SDL_CreateRGBSurfaceFrom(pack.data + pimg->pixels, pimg->w, pimg->h, 32, pimg->w * 4,
+	                                             rmask, gmask, bmask, amask);
+	if (!surf) {
+		error_message(__FUNCTION__, "Could not create image %s from the asset pack: %s.", PLEASE_INFORM, filename, SDL_GetError());
+		return FALSE;
+	}
+	SDL_SetAlpha(surf, 0, SDL_ALPHA_OPAQUE);
+	img->surface = SDL_DisplayFormatAlpha(surf);
+	SDL_FreeSurface(surf);
+
+	// Let the caller load the image from its own file
+	if (!img->surface)
+		return FALSE;
+
+	img->texture_type = NO_TEXTURE;
+	img->w = img->surface->w;
+	img->h = img->surface->h;
+	img->offset_x = 0;
+	img->offset_y = 0;
+
+	if (mod_flags & USE_OFFSET) {
+		if (pimg->flags & ASSET_PACK_HAS_OFFSET) {
+			img->offset_x = pimg->offset_x;
+			img->offset_y = pimg->offset_y;
+		} else {
+			error_message(__FUNCTION__, "The asset pack has no offset for the isometric image %s, 0 will be used instead.",
+			              NO_REPORT, filename);
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * Find a texture atlas in the asset pack.
+ *
+ * \param atlas_name  Name of the atlas description file, relatively to the graphics data dir
+ * \param first_page  Filled with the index of the first page of the atlas
+ * \param nb_pages    Filled with the number of pages of the atlas
+ * \return TRUE if the atlas is in the asset pack, and is up to date
+ */
+int get_packed_atlas(const char *atlas_name, int *first_page, int *nb_pages)
+{
+	int page;
+	int idx = find_name(pack.atlas_slots, pack.nb_atlas_slots, pack.atlases, sizeof(struct asset_pack_atlas), atlas_name);
+	if (idx < 0)
+		return FALSE;
+
+	// The whole atlas is loaded from its files if its description or one
+	// of its pages was modified
+	if (!source_is_current(pack.atlases[idx].source))
+		return FALSE;
+
+	for (page = pack.atlases[idx].first_page; page < pack.atlases[idx].first_page + pack.atlases[idx].nb_pages; page++) {
+		struct asset_pack_image *pimg = &pack.images[pack.pages[page].image];
+		if (!source_is_current(pimg->source) || !source_is_current(pimg->offset_source))
+			return FALSE;
+	}
+
+	*first_page = pack.atlases[idx].first_page;
+	*nb_pages = pack.atlases[idx].nb_pages;
+	return TRUE;
+}
+
+/**
+ * Get a page of a texture atlas of the asset pack.
+ *
+ * \return The name of the page image, to be used with load_image()
+ */
+const char *get_packed_atlas_page(int page, int *first_element, int *nb_elements)
+{
+	*first_element = pack.pages[page].first_element;
+	*nb_elements = pack.pages[page].nb_elements;
+	return pack_string(pack.images[pack.pages[page].image].name);
+}
+
+/**
+ * Get an element of a texture atlas of the asset pack.
+ *
+ * \return The key of the element
+ */
+const char *get_packed_atlas_element(int element, SDL_Rect *rect, int *offset_x, int *offset_y)
+{
+	struct asset_pack_atlas_element *elt = &pack.elements[element];
+
+	rect->x = elt->x;
+	rect->y = elt->y;
+	rect->w = elt->w;
+	rect->h = elt->h;
+	*offset_x = elt->offset_x;
+	*offset_y = elt->offset_y;
+	return pack_string(elt->key);
+}
+
+#undef _asset_pack_c
@@ -0,0 +1,123 @@
+/*
+ *
+ *   Copyright (c) 2026 FreedroidRPG development team
+ *
+ *
+ *  This file is part of Freedroid
+ *
+ *  Freedroid is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Freedroid is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Freedroid; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ *  MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file asset_pack.h
+ * \brief Layout of the asset pack file.
+ *
+ * The asset pack is written by tools/atlas/make_pack, and read by the game
+ * in asset_pack.c. It contains the already decoded pixels of the images of
+ * the graphics data dir, along with their offsets and the content of the
+ * texture atlas descriptions.
+ *
+ * The file starts with a header, followed by the pixel blocks, the tables
+ * and the string table. All the integers are in the byte order of the
+ * computer which wrote the file, and all the offsets are from the start of
+ * the file. Names are stored relatively to the graphics data dir, without
+ * './' or '//' parts.
+ *
+ * The files an entry was built from (its sources) are listed with their
+ * modification time, size and FNV-1a hash, so that the game can ignore the
+ * entries whose files were modified since the pack was built.
+ */
+
+#ifndef _asset_pack_h
+#define _asset_pack_h
+
+#include <stdint.h>
+
+#define ASSET_PACK_MAGIC "FDPACK\n"
+#define ASSET_PACK_VERSION 2
+#define ASSET_PACK_BYTE_ORDER 0x01020304
+
+// Pixel blocks are aligned on this size
+#define ASSET_PACK_ALIGN 16
+
+// The image has an offset, read from its .offset file
+#define ASSET_PACK_HAS_OFFSET 1
+
+// The source file did not exist when the pack was built
+#define ASSET_PACK_SOURCE_MISSING 1
+
+struct asset_pack_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+
+	// Masks of the 32 bits pixels
+	uint32_t rmask, gmask, bmask, amask;
+
+	uint32_t nb_images;
+	uint32_t nb_atlases;
+	uint32_t nb_atlas_pages;
+	uint32_t nb_atlas_elements;
+	uint32_t nb_sources;
+
+	uint64_t images_offset;
+	uint64_t atlases_offset;
+	uint64_t atlas_pages_offset;
+	uint64_t atlas_elements_offset;
+	uint64_t sources_offset;
+	uint64_t strings_offset;
+	uint64_t strings_size;
+};
+
+struct asset_pack_image {
+	uint32_t name;          // Offset in the string table
+	uint32_t flags;
+	uint32_t w, h;
+	int32_t offset_x, offset_y;
+	uint32_t source;        // Index of the source of the PNG file
+	uint32_t offset_source; // Index of the source of the .offset file
+	uint64_t pixels;        // w * h 32 bits pixels, without padding
+};
+
+struct asset_pack_atlas {
+	uint32_t name;          // Offset in the string table
+	uint32_t first_page;
+	uint32_t nb_pages;
+	uint32_t source;        // Index of the source of the description file
+};
+
+struct asset_pack_atlas_page {
+	uint32_t image;         // Index of the page image
+	uint32_t first_element;
+	uint32_t nb_elements;
+};
+
+struct asset_pack_atlas_element {
+	uint32_t key;           // Offset in the string table
+	int32_t x, y, w, h;
+	int32_t offset_x, offset_y;
+};
+
+struct asset_pack_source {
+	uint32_t name;          // Offset in the string table
+	uint32_t flags;
+	int64_t mtime;
+	uint64_t size;
+	uint64_t hash;          // FNV-1a hash of the content
+};
+
+#endif
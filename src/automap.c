@@ -33,6 +33,11 @@
 #include "global.h"
 #include "proto.h"
 #include "map.h"
+#include "rtprof.h"
+
+#ifdef HAVE_LIBGL
+extern int gl_max_texture_size;	//defined in open_gl.c
+#endif
 
 int AUTOMAP_TEXTURE_WIDTH = 2048;
 int AUTOMAP_TEXTURE_HEIGHT = 1024;
@@ -46,15 +51,226 @@ int AUTOMAP_TEXTURE_HEIGHT = 1024;
 
 static struct image compass;
 
+/**
+ * Cached picture of the walls and events known on a level.
+ * Only the squares whose automap flags changed are redrawn in it.
+ */
+struct automap_image {
+	SDL_Surface *surface;
+	struct image img;
+	int dirty_x0, dirty_y0;	// Range of squares to redraw, empty if dirty_x0 > dirty_x1
+	int dirty_x1, dirty_y1;
+};
+
+static struct automap_image automap_images[MAX_LEVELS];
+
+/**
+ * Window of tiles scanned by the last call to CollectAutomapData().
+ * When Tux moves, only the tiles entering this window are scanned.
+ */
+static struct {
+	int z;
+	int start_x;
+	int start_y;
+	int end_x;
+	int end_y;
+} automap_window = { .z = -1 };
+
+static void free_automap_image(int z)
+{
+	struct automap_image *ai = &automap_images[z];
+
+	if (!ai->surface)
+		return;
+
+	if (ai->img.surface == ai->surface)
+		ai->img.surface = NULL;
+	delete_image(&ai->img);
+	SDL_FreeSurface(ai->surface);
+	ai->surface = NULL;
+}
+
 /**
  * This function clears out the Automap data.
  */
 void ClearAutomapData(void)
 {
-	memset(Me.Automap, 0, MAX_LEVELS * 100 * 100);
+	int i;
+
+	for (i = 0; i < MAX_LEVELS; i++) {
+		free_automap_image(i);
+		free(Me.Automap[i].planes);
+		Me.Automap[i].planes = NULL;
+		Me.Automap[i].xlen = 0;
+		Me.Automap[i].ylen = 0;
+	}
+
+	automap_window.z = -1;
 
 };				// void ClearAutomapData ( void )
 
+static inline int automap_plane_test(const uint32_t *plane, int idx)
+{
+	return (plane[idx >> 5] >> (idx & 31)) & 1;
+}
+
+/**
+ * Return the bitplane storing a single automap flag.
+ */
+static uint32_t *automap_plane(automap_data_t *am, int bit)
+{
+	int plane = 0;
+
+	while (bit > 1) {
+		bit >>= 1;
+		plane++;
+	}
+
+	return am->planes + plane * AUTOMAP_PLANE_WORDS(am->xlen, am->ylen);
+}
+
+/**
+ * Return the automap flags (EW_WALL_BIT, ...) stored for a square,
+ * given its index in the bitplanes.
+ */
+static int automap_flags(automap_data_t *am, int idx)
+{
+	int words = AUTOMAP_PLANE_WORDS(am->xlen, am->ylen);
+	int plane, flags = 0;
+
+	for (plane = 0; plane < AUTOMAP_NB_PLANES; plane++) {
+		if (automap_plane_test(am->planes + plane * words, idx))
+			flags |= (1 << plane);
+	}
+
+	return flags;
+}
+
+/**
+ * Set (if 'set' is TRUE) or clear the given automap flags of a square.
+ */
+static void automap_change_flags(automap_data_t *am, int idx, int flags, int set)
+{
+	int words = AUTOMAP_PLANE_WORDS(am->xlen, am->ylen);
+	uint32_t mask = 1u << (idx & 31);
+	int plane;
+	int changed = 0;
+
+	for (plane = 0; plane < AUTOMAP_NB_PLANES; plane++) {
+		if (!(flags & (1 << plane)))
+			continue;
+
+		uint32_t *word = &am->planes[plane * words + (idx >> 5)];
+		uint32_t old = *word;
+
+		if (set)
+			*word |= mask;
+		else
+			*word &= ~mask;
+
+		if (*word != old)
+			changed |= (1 << plane);
+	}
+
+	// Mark the square to be redrawn in the cached automap picture,
+	// if its look changed
+	struct automap_image *ai = &automap_images[am - Me.Automap];
+	if (ai->surface && (changed & (EW_WALL_BIT | NS_WALL_BIT | VISIBLE_EVENT_BIT))) {
+		int x = idx % am->xlen;
+		int y = idx / am->xlen;
+
+		if (ai->dirty_x0 > ai->dirty_x1) {
+			ai->dirty_x0 = ai->dirty_x1 = x;
+			ai->dirty_y0 = ai->dirty_y1 = y;
+		} else {
+			ai->dirty_x0 = min(ai->dirty_x0, x);
+			ai->dirty_x1 = max(ai->dirty_x1, x);
+			ai->dirty_y0 = min(ai->dirty_y0, y);
+			ai->dirty_y1 = max(ai->dirty_y1, y);
+		}
+	}
+}
+
+/**
+ * Get the automap data of a level, sized to the current size of the level.
+ *
+ * The bitplanes are allocated on demand, if 'create' is TRUE. Otherwise NULL
+ * is returned for a level without any automap data.
+ * When the size of the level changed since the data was recorded (level
+ * editor, old savegame), the known data is cropped or extended to the new size.
+ */
+static automap_data_t *get_automap(int z, int create)
+{
+	if (z < 0 || z >= MAX_LEVELS || !level_exists(z))
+		return NULL;
+
+	level *automap_level = curShip.AllLevels[z];
+	automap_data_t *am = &Me.Automap[z];
+
+	if (!am->planes && !create)
+		return NULL;
+
+	if (am->planes && am->xlen == automap_level->xlen && am->ylen == automap_level->ylen)
+		return am;
+
+	int xlen = automap_level->xlen;
+	int ylen = automap_level->ylen;
+	int words = AUTOMAP_PLANE_WORDS(xlen, ylen);
+	uint32_t *planes = MyMalloc(AUTOMAP_NB_PLANES * words * sizeof(uint32_t));
+
+	if (am->planes) {
+		int old_words = AUTOMAP_PLANE_WORDS(am->xlen, am->ylen);
+		int x, y, plane;
+
+		for (plane = 0; plane < AUTOMAP_NB_PLANES; plane++) {
+			for (y = 0; y < min(ylen, am->ylen); y++) {
+				for (x = 0; x < min(xlen, am->xlen); x++) {
+					int idx = x + y * xlen;
+					if (automap_plane_test(am->planes + plane * old_words, x + y * am->xlen))
+						planes[plane * words + (idx >> 5)] |= 1u << (idx & 31);
+				}
+			}
+		}
+		free(am->planes);
+	}
+
+	// The cached picture and the scanned window are no longer relevant
+	free_automap_image(z);
+	if (automap_window.z == z)
+		automap_window.z = -1;
+
+	am->planes = planes;
+	am->xlen = xlen;
+	am->ylen = ylen;
+
+	return am;
+}
+
+/**
+ * Count the squares of a level that were seen by Tux.
+ */
+int automap_count_seen_squares(int z)
+{
+	automap_data_t *am = get_automap(z, FALSE);
+	int i, count = 0;
+
+	if (!am)
+		return 0;
+
+	int words = AUTOMAP_PLANE_WORDS(am->xlen, am->ylen);
+	uint32_t *plane = automap_plane(am, SQUARE_SEEN_AT_ALL_BIT);
+
+	for (i = 0; i < words; i++) {
+		uint32_t w = plane[i];
+		while (w) {
+			w &= w - 1;
+			count++;
+		}
+	}
+
+	return count;
+}
+
 /**
  * This function does a special rounding that is used by the automap
  * to compute the start and end position of an obstacle on the map.
@@ -86,63 +302,146 @@ static void round_automap_pos(float a, float b, int *ra, int *rb)
  * then it tags each square touching it to redraw the automap.
  *
  */
-static void update_automap_square(int z, int x, int y)
+static void update_automap_square(automap_data_t *am, int x, int y)
 {
 	int a, b;
-	level *automap_level = curShip.AllLevels[z];
 
-	Me.Automap[z][y][x] &= ~UPDATE_SQUARE_BIT;
-	Me.Automap[z][y][x] &= ~EW_WALL_BIT;
-	Me.Automap[z][y][x] &= ~NS_WALL_BIT;
+	automap_change_flags(am, x + y * am->xlen, UPDATE_SQUARE_BIT | EW_WALL_BIT | NS_WALL_BIT, FALSE);
 
 	for (a = x - 1 ; a <=  x + 1; a++) {
-		if ((a < 0) || (a >= automap_level->xlen))
+		if ((a < 0) || (a >= am->xlen))
 			continue;
 			
 		for (b = y - 1; b <=  y + 1; b++) {
-			if ((b < 0) || (b >= automap_level->ylen))
+			if ((b < 0) || (b >= am->ylen))
 				continue;
 
-			Me.Automap[z][b][a] &= ~SQUARE_SEEN_AT_ALL_BIT;
+			automap_change_flags(am, a + b * am->xlen, SQUARE_SEEN_AT_ALL_BIT, FALSE);
 		}
 	}	
 }
 
+/**
+ * Record the walls and the visible events of a square on the automap.
+ * Returns TRUE if the square had to be updated first, in which case
+ * some of its neighbors were forgotten.
+ */
+static int collect_automap_square(automap_data_t *am, level *automap_level, int x, int y, int tstamp)
+{
+	int i;
+	int updated = FALSE;
+	obstacle *our_obstacle;
+	int flags = automap_flags(am, x + y * am->xlen);
+
+	if (flags & UPDATE_SQUARE_BIT) {
+		update_automap_square(am, x, y);
+		flags = automap_flags(am, x + y * am->xlen);
+		updated = TRUE;
+	}
+
+	if (flags & SQUARE_SEEN_AT_ALL_BIT)
+		return updated;
+
+	for (i = 0; i < automap_level->map[y][x].glued_obstacles.size; i++) {
+		int idx = ((int *)(automap_level->map[y][x].glued_obstacles.arr))[i];
+
+		our_obstacle = &(ACCESS_OBSTACLE(automap_level, idx));
+
+		if (our_obstacle->timestamp == tstamp)
+			continue;
+
+		our_obstacle->timestamp = tstamp;
+
+		if ((our_obstacle->type >= ISO_H_DOOR_000_OPEN) && (our_obstacle->type <= ISO_V_DOOR_100_OPEN))
+			continue;
+		if ((our_obstacle->type >= ISO_DH_DOOR_000_OPEN) && (our_obstacle->type <= ISO_DV_DOOR_100_OPEN))
+			continue;
+		if ((our_obstacle->type >= ISO_OUTER_DOOR_V_00) && (our_obstacle->type <= ISO_OUTER_DOOR_H_100))
+			continue;
+
+		int obstacle_start_x;
+		int obstacle_end_x;
+		int obstacle_start_y;
+		int obstacle_end_y;
+
+		obstacle_spec *obstacle_spec = get_obstacle_spec(our_obstacle->type);
+		round_automap_pos(our_obstacle->pos.x + obstacle_spec->left_border, our_obstacle->pos.x + obstacle_spec->right_border,
+				&obstacle_start_x, &obstacle_end_x);
+
+		round_automap_pos(our_obstacle->pos.y + obstacle_spec->upper_border, our_obstacle->pos.y + obstacle_spec->lower_border,
+				&obstacle_start_y, &obstacle_end_y);
+
+		if (obstacle_start_x < 0)
+			obstacle_start_x = 0;
+		if (obstacle_start_y < 0)
+			obstacle_start_y = 0;
+		if (obstacle_end_x < 0)
+			obstacle_end_x = 0;
+		if (obstacle_end_y < 0)
+			obstacle_end_y = 0;
+		if (obstacle_start_x >= automap_level->xlen)
+			obstacle_start_x = automap_level->xlen - 1;
+		if (obstacle_start_y >= automap_level->ylen)
+			obstacle_start_y = automap_level->ylen - 1;
+		if (obstacle_end_x >= automap_level->xlen)
+			obstacle_end_x = automap_level->xlen - 1;
+		if (obstacle_end_y >= automap_level->ylen)
+			obstacle_end_y = automap_level->ylen - 1;
+
+		//printf("pos %f %f - border %f %f to %f %f - xstart %d xend %d ystart %d yend %d\n", our_obstacle->pos.x, our_obstacle->pos.y, our_obstacle->pos.x + obstacle_map [ our_obstacle -> type ] . left_border, our_obstacle->pos.y + obstacle_map [ our_obstacle -> type ] . upper_border, our_obstacle->pos.x + obstacle_map [ our_obstacle -> type ] . right_border, our_obstacle->pos.y + obstacle_map [ our_obstacle -> type ] . lower_border, obstacle_start_x, obstacle_end_x, obstacle_start_y, obstacle_end_y);
+
+		int a, b;
+
+		for (a = obstacle_start_x; a <=  obstacle_end_x; a++) {
+			for (b = obstacle_start_y; b <=  obstacle_end_y; b++) {
+
+				if (obstacle_spec->block_area_type == COLLISION_TYPE_RECTANGLE) {
+
+					if (obstacle_spec->block_area_parm_1 > 0.80) {
+						automap_change_flags(am, a + b * am->xlen, EW_WALL_BIT, TRUE);
+					}
+					if (obstacle_spec->block_area_parm_2 > 0.80) {
+						automap_change_flags(am, a + b * am->xlen, NS_WALL_BIT, TRUE);
+					}
+				}
+			}
+		}
+	}
+
+	if (visible_event_at_location(x, y, automap_level->levelnum))
+		flags |= VISIBLE_EVENT_BIT;
+
+	automap_change_flags(am, x + y * am->xlen, (flags & VISIBLE_EVENT_BIT) | SQUARE_SEEN_AT_ALL_BIT, TRUE);
+
+	return updated;
+}
+
 /**
  * This function collects the automap data and stores it in the Me data
  * structure.
+ *
+ * Only the tiles that entered Tux's view since the last call are scanned.
+ * The whole view is scanned again when Tux changes level, or when an
+ * obstacle of the current level was changed.
  */
 void CollectAutomapData(void)
 {
 	int x, y;
 	int start_x, start_y, end_x, end_y;
-	static int TimePassed;
 	Level automap_level = curShip.AllLevels[Me.pos.z];
-	int i;
-	obstacle *our_obstacle;
 	int lvl = Me.pos.z;
 
-	// Checking the whole map for passability will surely take a lot
-	// of computation.  Therefore we only do this once every second of
-	// real time.
-	//
-	if (TimePassed == (int)Me.MissionTimeElapsed)
-		return;
-	TimePassed = (int)Me.MissionTimeElapsed;
-
-	// DebugPrintf ( -3 , "\nCollecting Automap data... " );
-
-	// Also if there is no map-maker present in inventory, then we need not
+	// If there is no map-maker present in inventory, then we need not
 	// do a thing here...
 	//
 	if (!Me.map_maker_is_present)
 		return;
 
-	// Earlier we had
-	//
-	// start_x = 0 ; start_y = 0 ; end_x = automap_level->xlen ; end_y = automap_level->ylen ;
-	//
-	// when maximal automap was generated.  Now we only add to the automap what really is on screen...
+	automap_data_t *am = get_automap(lvl, TRUE);
+	if (!am)
+		return;
+
+	// We only add to the automap what really is on screen...
 	//
 	start_x = Me.pos.x - FLOOR_TILES_VISIBLE_AROUND_TUX;
 	end_x = Me.pos.x + FLOOR_TILES_VISIBLE_AROUND_TUX;
@@ -157,91 +456,55 @@ void CollectAutomapData(void)
 		start_y = 0;
 	if (end_y >= automap_level->ylen)
 		end_y = automap_level->ylen;
-	
+
+	int full_scan = (automap_window.z != lvl);
+
+	if (!full_scan && start_x == automap_window.start_x && end_x == automap_window.end_x &&
+			start_y == automap_window.start_y && end_y == automap_window.end_y)
+		return;
+
+#ifdef WITH_RTPROF
+	probe_timer_set_in(automap_collect, "Automap collection time (us)", 5000);
+#endif
+
 	int tstamp = next_glue_timestamp();
+	int updated = FALSE;
+
+	if (full_scan) {
+		// Squares marked by update_obstacle_automap() forget about their
+		// neighbors, so handle all of them before to scan the view.
+		for (y = start_y; y < end_y; y++) {
+			for (x = start_x; x < end_x; x++) {
+				if (automap_flags(am, x + y * am->xlen) & UPDATE_SQUARE_BIT)
+					update_automap_square(am, x, y);
+			}
+		}
+	}
 
 	// Now we do the actual checking for visible wall components.
 	//
 	for (y = start_y; y < end_y; y++) {
 		for (x = start_x; x < end_x; x++) {
-			if (Me.Automap[lvl][y][x] & UPDATE_SQUARE_BIT)
-				update_automap_square(lvl, x, y);
-					
-			if (Me.Automap[lvl][y][x] & SQUARE_SEEN_AT_ALL_BIT)
+			if (!full_scan && y >= automap_window.start_y && y < automap_window.end_y &&
+					x >= automap_window.start_x && x < automap_window.end_x) {
+				// Already scanned, skip to the end of the old window on this row
+				x = automap_window.end_x - 1;
 				continue;
-
-			for (i = 0; i < automap_level->map[y][x].glued_obstacles.size; i++) {
-				int idx = ((int *)(automap_level->map[y][x].glued_obstacles.arr))[i];
-
-				our_obstacle = &(automap_level->obstacle_list[idx]);
-
-				if (our_obstacle->timestamp == tstamp)
-					continue;
-
-				our_obstacle->timestamp = tstamp;
-
-				if ((our_obstacle->type >= ISO_H_DOOR_000_OPEN) && (our_obstacle->type <= ISO_V_DOOR_100_OPEN))
-					continue;
-				if ((our_obstacle->type >= ISO_DH_DOOR_000_OPEN) && (our_obstacle->type <= ISO_DV_DOOR_100_OPEN))
-					continue;
-				if ((our_obstacle->type >= ISO_OUTER_DOOR_V_00) && (our_obstacle->type <= ISO_OUTER_DOOR_H_100))
-					continue;
-
-				int obstacle_start_x;
-				int obstacle_end_x;
-				int obstacle_start_y;
-				int obstacle_end_y;
-
-				obstacle_spec *obstacle_spec = get_obstacle_spec(our_obstacle->type);
-				round_automap_pos(our_obstacle->pos.x + obstacle_spec->left_border, our_obstacle->pos.x + obstacle_spec->right_border,
-						&obstacle_start_x, &obstacle_end_x);
-
-				round_automap_pos(our_obstacle->pos.y + obstacle_spec->upper_border, our_obstacle->pos.y + obstacle_spec->lower_border,
-						&obstacle_start_y, &obstacle_end_y);
-
-				if (obstacle_start_x < 0)
-					obstacle_start_x = 0;
-				if (obstacle_start_y < 0)
-					obstacle_start_y = 0;
-				if (obstacle_end_x < 0)
-					obstacle_end_x = 0;
-				if (obstacle_end_y < 0)
-					obstacle_end_y = 0;
-				if (obstacle_start_x >= automap_level->xlen)
-					obstacle_start_x = automap_level->xlen - 1;
-				if (obstacle_start_y >= automap_level->ylen)
-					obstacle_start_y = automap_level->ylen - 1;
-				if (obstacle_end_x >= automap_level->xlen)
-					obstacle_end_x = automap_level->xlen - 1;
-				if (obstacle_end_y >= automap_level->ylen)
-					obstacle_end_y = automap_level->ylen - 1;
-
-				//printf("pos %f %f - border %f %f to %f %f - xstart %d xend %d ystart %d yend %d\n", our_obstacle->pos.x, our_obstacle->pos.y, our_obstacle->pos.x + obstacle_map [ our_obstacle -> type ] . left_border, our_obstacle->pos.y + obstacle_map [ our_obstacle -> type ] . upper_border, our_obstacle->pos.x + obstacle_map [ our_obstacle -> type ] . right_border, our_obstacle->pos.y + obstacle_map [ our_obstacle -> type ] . lower_border, obstacle_start_x, obstacle_end_x, obstacle_start_y, obstacle_end_y);
-
-				int a, b;
-
-				for (a = obstacle_start_x; a <=  obstacle_end_x; a++) {
-					for (b = obstacle_start_y; b <=  obstacle_end_y; b++) {
-
-						if (obstacle_spec->block_area_type == COLLISION_TYPE_RECTANGLE) {
-
-							if (obstacle_spec->block_area_parm_1 > 0.80) {
-									Me.Automap[lvl][b][a] |= EW_WALL_BIT;
-							}
-							if (obstacle_spec->block_area_parm_2 > 0.80) {
-								Me.Automap[lvl][b][a] |= NS_WALL_BIT;
-							}
-						}
-					}
-				}
 			}
-			if (visible_event_at_location(x, y, lvl))
-				Me.Automap[lvl][y][x] |= VISIBLE_EVENT_BIT;
-
-			Me.Automap[lvl][y][x] = Me.Automap[lvl][y][x] | SQUARE_SEEN_AT_ALL_BIT;
+			updated |= collect_automap_square(am, automap_level, x, y, tstamp);
 		}
 	}
 
+	automap_window.z = updated ? -1 : lvl;
+	automap_window.start_x = start_x;
+	automap_window.start_y = start_y;
+	automap_window.end_x = end_x;
+	automap_window.end_y = end_y;
+
+#ifdef WITH_RTPROF
+	probe_timer_set_out(automap_collect);
+#endif
+
 };				// void CollectAutomapData ( void )
 
 /**
@@ -251,11 +514,20 @@ void CollectAutomapData(void)
 void update_obstacle_automap(int z, obstacle *our_obstacle)
 {
 	level *automap_level = curShip.AllLevels[z];
+	automap_data_t *am = get_automap(z, FALSE);
 	int obstacle_start_x;
 	int obstacle_end_x;
 	int obstacle_start_y;
 	int obstacle_end_y;
 
+	// Nothing was recorded yet on this level, so there is nothing to update.
+	if (!am)
+		return;
+
+	// Have the whole view scanned again, to handle the squares to update
+	if (automap_window.z == z)
+		automap_window.z = -1;
+
 	obstacle_spec *obstacle_spec = get_obstacle_spec(our_obstacle->type);
 	round_automap_pos(our_obstacle->pos.x + obstacle_spec->left_border,
 			our_obstacle->pos.x + obstacle_spec->right_border, &obstacle_start_x, &obstacle_end_x);
@@ -283,7 +555,7 @@ void update_obstacle_automap(int z, obstacle *our_obstacle)
 	int x, y;
 	for (x = obstacle_start_x; x <=  obstacle_end_x; x++) {
 		for (y = obstacle_start_y; y <=  obstacle_end_y; y++) {
-			Me.Automap[z][y][x] |= UPDATE_SQUARE_BIT;
+			automap_change_flags(am, x + y * am->xlen, UPDATE_SQUARE_BIT, TRUE);
 		}
 	}
 }
@@ -305,6 +577,181 @@ static inline void PutPixel_automap_wrapper(SDL_Surface * abc, int x, int y, int
 #endif
 }
 
+/**
+ * Draw one square of the automap in the cached picture of a level.
+ */
+static void draw_automap_image_square(struct automap_image *ai, automap_data_t *am, int x, int y)
+{
+	SDL_Surface *surf = ai->surface;
+	int flags = automap_flags(am, x + y * am->xlen);
+	int px = AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * (am->ylen - y);
+	int py = AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * y;
+	SDL_Rect rect = { .x = px, .y = py, .w = AUTOMAP_SQUARE_SIZE, .h = AUTOMAP_SQUARE_SIZE };
+
+	SDL_FillRect(surf, &rect, SDL_MapRGBA(surf->format, 0, 0, 0, 0));
+
+	if (flags & EW_WALL_BIT) {
+		sdl_put_pixel(surf, px + 1, py + 1, WALL_COLOR, 255);
+		sdl_put_pixel(surf, px + 2, py + 2, WALL_COLOR, 255);
+	}
+
+	if (flags & NS_WALL_BIT) {
+		sdl_put_pixel(surf, px + 1, py + 2, WALL_COLOR, 255);
+		sdl_put_pixel(surf, px + 2, py + 1, WALL_COLOR, 255);
+	}
+
+	// Now we draw known event triggers
+	if (flags & VISIBLE_EVENT_BIT)
+		SDL_FillRect(surf, &rect, SDL_MapRGBA(surf->format, EXIT_COLOR, 255));
+}
+
+#ifdef HAVE_LIBGL
+/**
+ * Get the size of the texture holding an automap picture of a given size.
+ */
+static int automap_texture_size(int size)
+{
+	int tex_size = 1;
+
+	if (GLEW_ARB_texture_non_power_of_two)
+		return size;
+
+	while (tex_size < size)
+		tex_size <<= 1;
+
+	return tex_size;
+}
+
+/**
+ * Copy a part of the cached automap picture of a level to its texture,
+ * creating the texture if needed.
+ */
+static void update_automap_texture(struct automap_image *ai, SDL_Rect *rect)
+{
+	struct image *img = &ai->img;
+	SDL_Rect tex_rect = *rect;
+
+	if (img->texture_type != TEXTURE_CREATED) {
+		img->tex_w = img->tex_h = automap_texture_size(img->w);
+		img->texture = create_empty_texture(img->tex_w, img->tex_h);
+		img->texture_type = TEXTURE_CREATED;
+
+		// The picture is stored at the bottom of the texture, as done by
+		// make_texture_out_of_surface()
+		img->tex_x0 = 0.0;
+		img->tex_y0 = 1.0 - (float)img->h / (float)img->tex_h;
+		img->tex_x1 = (float)img->w / (float)img->tex_w;
+		img->tex_y1 = 1.0;
+	}
+
+	tex_rect.y += img->tex_h - img->h;
+	update_texture_rect(img->texture, ai->surface, &tex_rect);
+}
+#endif
+
+/**
+ * Get the cached automap picture of a level, after having redrawn the
+ * squares that changed since the last call.
+ * In OpenGL mode, only the part of the texture covering the redrawn squares
+ * is updated.
+ *
+ * \return NULL if the picture of the level is too large to be a texture.
+ * The squares then have to be drawn one by one (see display_automap_squares()).
+ */
+static struct image *get_automap_image(int z, automap_data_t *am)
+{
+	struct automap_image *ai = &automap_images[z];
+	int size = AUTOMAP_SQUARE_SIZE * (am->xlen + am->ylen);
+	int x, y;
+
+#ifdef HAVE_LIBGL
+	if (use_open_gl && automap_texture_size(size) > gl_max_texture_size)
+		return NULL;
+#endif
+
+	if (!ai->surface) {
+		struct image empty = EMPTY_IMAGE;
+
+		ai->surface = SDL_CreateRGBSurface(SDL_SWSURFACE, size, size, 32, rmask, gmask, bmask, amask);
+		SDL_FillRect(ai->surface, NULL, SDL_MapRGBA(ai->surface->format, 0, 0, 0, 0));
+
+		ai->img = empty;
+		ai->img.w = size;
+		ai->img.h = size;
+
+		ai->dirty_x0 = 0;
+		ai->dirty_y0 = 0;
+		ai->dirty_x1 = am->xlen - 1;
+		ai->dirty_y1 = am->ylen - 1;
+	}
+
+	if (ai->dirty_x0 > ai->dirty_x1)
+		return &ai->img;
+
+	for (y = ai->dirty_y0; y <= ai->dirty_y1; y++) {
+		for (x = ai->dirty_x0; x <= ai->dirty_x1; x++) {
+			draw_automap_image_square(ai, am, x, y);
+		}
+	}
+
+	if (!use_open_gl) {
+		ai->img.surface = ai->surface;
+	} else {
+#ifdef HAVE_LIBGL
+		// Bounding box of the redrawn squares in the picture
+		SDL_Rect rect;
+		rect.x = AUTOMAP_SQUARE_SIZE * (ai->dirty_x0 + am->ylen - ai->dirty_y1);
+		rect.y = AUTOMAP_SQUARE_SIZE * (ai->dirty_x0 + ai->dirty_y0);
+		rect.w = AUTOMAP_SQUARE_SIZE * (ai->dirty_x1 + am->ylen - ai->dirty_y0 + 1) - rect.x;
+		rect.h = AUTOMAP_SQUARE_SIZE * (ai->dirty_x1 + ai->dirty_y1 + 1) - rect.y;
+		rect.w = min(rect.w, size - rect.x);
+		rect.h = min(rect.h, size - rect.y);
+
+		update_automap_texture(ai, &rect);
+#endif
+	}
+
+	ai->dirty_x0 = 1;
+	ai->dirty_x1 = 0;
+
+	return &ai->img;
+}
+
+/**
+ * Draw the known walls and events of a level square by square.
+ * Used when the automap picture of the level can not be cached in a texture.
+ */
+static void display_automap_squares(automap_data_t *am)
+{
+	int x, y, i, j;
+
+	for (y = 0; y < am->ylen; y++) {
+		for (x = 0; x < am->xlen; x++) {
+			int flags = automap_flags(am, x + y * am->xlen);
+			int px = AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * (am->ylen - y);
+			int py = AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * y;
+
+			if (flags & EW_WALL_BIT) {
+				PutPixel_automap_wrapper(Screen, px + 1, py + 1, WALL_COLOR);
+				PutPixel_automap_wrapper(Screen, px + 2, py + 2, WALL_COLOR);
+			}
+
+			if (flags & NS_WALL_BIT) {
+				PutPixel_automap_wrapper(Screen, px + 1, py + 2, WALL_COLOR);
+				PutPixel_automap_wrapper(Screen, px + 2, py + 1, WALL_COLOR);
+			}
+
+			// Now we draw known event triggers
+			if (flags & VISIBLE_EVENT_BIT) {
+				for (i = 0; i < AUTOMAP_SQUARE_SIZE; i++) {
+					for (j = 0; j < AUTOMAP_SQUARE_SIZE; j++)
+						PutPixel_automap_wrapper(Screen, px + i, py + j, EXIT_COLOR);
+				}
+			}
+		}
+	}
+}
+
 /**
  * Toggle automap visibility
  */
@@ -341,7 +788,7 @@ static void display_automap_compass()
  */
 void display_automap(void)
 {
-	int x, y, i, j;
+	int x, y;
 	Level automap_level = curShip.AllLevels[Me.pos.z];
 	int lvl = Me.pos.z;
 
@@ -360,6 +807,13 @@ void display_automap(void)
 	if (!Me.map_maker_is_present)
 		return;
 
+	// At first, we blit the known data about the pure wall-type
+	// obstacles and the event triggers on this level.
+	automap_data_t *am = get_automap(lvl, FALSE);
+	struct image *automap_img = am ? get_automap_image(lvl, am) : NULL;
+	if (automap_img)
+		display_image_on_screen(automap_img, 0, 0, IMAGE_NO_TRANSFO);
+
 #ifdef HAVE_LIBGL
 	if (use_open_gl) {
 		use_shader(NO_SHADER);
@@ -367,40 +821,8 @@ void display_automap(void)
 	}
 #endif
 
-	// At first, we only blit the known data about the pure wall-type
-	// obstacles on this level.
-	for (y = 0; y < automap_level->ylen; y++) {
-		for (x = 0; x < automap_level->xlen; x++) {
-			if (Me.Automap[lvl][y][x] & EW_WALL_BIT) {
-				PutPixel_automap_wrapper(Screen,
-							 1 + AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * (automap_level->ylen - y),
-							 1 + AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * y, WALL_COLOR);
-				PutPixel_automap_wrapper(Screen,
-							 2 + AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * (automap_level->ylen - y),
-							 2 + AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * y, WALL_COLOR);
-			}
-
-			if (Me.Automap[lvl][y][x] & NS_WALL_BIT) {
-				PutPixel_automap_wrapper(Screen,
-							 1 + AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * (automap_level->ylen - y),
-							 2 + AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * y, WALL_COLOR);
-				PutPixel_automap_wrapper(Screen,
-							 2 + AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * (automap_level->ylen - y),
-							 1 + AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * y, WALL_COLOR);
-			}
-
-			//Now we blit known event triggers
-			if (Me.Automap[lvl][y][x] & VISIBLE_EVENT_BIT) {
-				for (i = 0; i < AUTOMAP_SQUARE_SIZE; i++) {
-					for (j = 0; j < AUTOMAP_SQUARE_SIZE; j++) {
-						PutPixel_automap_wrapper(Screen,
-							i + AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * (automap_level->ylen - y),
-							j + AUTOMAP_SQUARE_SIZE * x + AUTOMAP_SQUARE_SIZE * y, EXIT_COLOR);
-					}
-				}
-			}
-		}
-	}
+	if (am && !automap_img)
+		display_automap_squares(am);
 
 	// Display enemies
 	enemy *erot;
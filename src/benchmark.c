@@ -30,6 +30,7 @@
 #include "struct.h"
 #include "global.h"
 #include "proto.h"
+#include "takeover.h"
 #include "lvledit/lvledit_validator.h"
 #include "lvledit/lvledit_display.h"
 
@@ -49,7 +50,7 @@ static void timer_stop()
 /* Text rendering performance measurement */
 static int text_bench()
 {
-    char *str = "abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz";
+	char *str = "abcdefghijklmnopqrstuvwxyz0123456789abcdefghijklmnopqrstuvwxyz";
 
 	// Make sure all glyphs are loaded
 	put_string(get_current_font(), 0, 0, str);
@@ -68,6 +69,33 @@ static int text_bench()
 	return 0;
 }
 
+/* Word-wrapped text performance measurement */
+static int textwrap_bench()
+{
+	char *paragraph = "Lorem ipsum dolor sit amet, \1consectetur adipiscing elit,\2 sed do eiusmod tempor "
+		"incididunt ut labore et dolore magna aliqua.\nUt enim ad minim veniam, quis nostrud "
+		"exercitation ullamco laboris nisi ut aliquip ex ea commodo consequat.";
+	SDL_Rect rect = { .x = 10, .y = 10, .w = 300, .h = 200 };
+
+	// Make sure all glyphs are loaded
+	display_text(paragraph, rect.x, rect.y, &rect, 1.0);
+
+	// Measure and display a word-wrapped paragraph many times, as the HUD
+	// or the quest browser would do
+	int nb = 10000;
+
+	timer_start();
+	while (nb--) {
+		if (get_lines_needed(paragraph, rect, 1.0) > 0)
+			display_text(paragraph, rect.x, rect.y, &rect, 1.0);
+	}
+
+	our_SDL_flip_wrapper();
+	timer_stop();
+
+	return 0;
+}
+
 /* Dialog validator (not an actual benchmark) */
 static int dialog_test()
 {
@@ -106,6 +134,7 @@ static int loadship_bench()
 		while (loop--) {
 			LoadShip(fp, 0);
 		}
+		wait_for_dungeons();
 		timer_stop();
 		failed = FALSE;
 	}
@@ -192,32 +221,132 @@ static int dynarray_test()
 		dyn = NULL;
 	}
 
+	// Sparse dynarray churn, as with bullets in a heavy fight: keep around
+	// 1000 members alive, deleting and adding some at each 'frame'.
+	loop = 5;
+	while (loop--) {
+		int i, n;
+		struct sparse_dynarray *sdyn = sparse_dynarray_alloc(0, sizeof(item));
+		for (i = 0; i < 1000; i++) {
+			dummy.type = i;
+			sparse_dynarray_add(sdyn, &dummy, sizeof(item));
+		}
+		for (i = 0; i < 20000; i++) {
+			for (n = sdyn->nb_live - 1; n >= 0; n--) {
+				int idx = sparse_dynarray_live_member(sdyn, n);
+				item *it = sparse_dynarray_member(sdyn, idx, sizeof(item));
+				if (!sparse_dynarray_member_used(sdyn, idx) || it->type < 0) {
+					fprintf(stderr, "Error reading out live member %d\n", idx);
+					return 1;
+				}
+				if ((it->type + i) % 7 == 0)
+					sparse_dynarray_del(sdyn, idx, sizeof(item));
+			}
+			while (sdyn->nb_live < 1000) {
+				dummy.type = i + sdyn->nb_live;
+				sparse_dynarray_add(sdyn, &dummy, sizeof(item));
+			}
+		}
+		sparse_dynarray_free(sdyn);
+		free(sdyn);
+		sdyn = NULL;
+	}
+
 	timer_stop();
 
 	return 0;
 }
 
+/* FNV-1a hash of the content of a generated level */
+static uint32_t hash_bytes(uint32_t h, const void *data, size_t len)
+{
+	const unsigned char *p = data;
+
+	while (len--) {
+		h ^= *p++;
+		h *= 16777619;
+	}
+
+	return h;
+}
+
+static uint32_t hash_level(level *l)
+{
+	uint32_t h = 2166136261u;
+	int i, x, y;
+
+	for (i = 0; i < l->obstacle_list.size; i++) {
+		obstacle *o = &ACCESS_OBSTACLE(l, i);
+		h = hash_bytes(h, &o->type, sizeof(o->type));
+		if (o->type != -1)
+			h = hash_bytes(h, &o->pos, sizeof(o->pos));
+	}
+
+	for (y = 0; y < l->ylen; y++) {
+		for (x = 0; x < l->xlen; x++)
+			h = hash_bytes(h, &l->map[y][x].floor_values[0], sizeof(l->map[y][x].floor_values[0]));
+	}
+
+	waypoint *wpts = l->waypoints.arr;
+	for (i = 0; i < l->waypoints.size; i++) {
+		h = hash_bytes(h, &wpts[i].x, sizeof(wpts[i].x));
+		h = hash_bytes(h, &wpts[i].y, sizeof(wpts[i].y));
+		h = hash_bytes(h, wpts[i].connections.arr, wpts[i].connections.size * sizeof(int));
+	}
+
+	return h;
+}
+
+/* Random dungeon generation: throughput, and determinism of the output */
 static int mapgen_bench()
 {
-	int loop = 100;
+	const int nb_levels = 16;
+	const int nb_loops = 10;
+	const unsigned int seed = 0x5eed;
+	int loop = nb_loops;
+	int failed = FALSE;
+	uint32_t reference[nb_levels];
+	level *levels[nb_levels];
+	int i;
 	extern void CreateNewMapLevel(int);
 	extern void delete_map_level(int);
+
 	timer_start();
 	while (loop--) {
-		CreateNewMapLevel(0);
-		curShip.num_levels = 1;
-		level *l = curShip.AllLevels[0];
-		l->xlen = 90;
-		l->ylen = 90;
-		l->random_dungeon = 2;
-		l->teleport_pair = 0;
-		set_dungeon_output(l);
-		generate_dungeon(l->xlen, l->ylen, l->random_dungeon, l->teleport_pair);
-		delete_map_level(0);
+		for (i = 0; i < nb_levels; i++) {
+			CreateNewMapLevel(i);
+			levels[i] = curShip.AllLevels[i];
+			levels[i]->xlen = 90;
+			levels[i]->ylen = 90;
+			levels[i]->random_dungeon = 2;
+			levels[i]->teleport_pair = i % 4;
+		}
+		curShip.num_levels = nb_levels;
+
+		// The last loop generates serially, the result must not change
+		if (loop)
+			generate_dungeons(levels, nb_levels, seed);
+		else
+			for (i = 0; i < nb_levels; i++)
+				generate_dungeon(levels[i], seed);
+
+		for (i = 0; i < nb_levels; i++) {
+			uint32_t h = hash_level(levels[i]);
+			if (loop == nb_loops - 1) {
+				reference[i] = h;
+			} else if (h != reference[i]) {
+				fprintf(stderr, "Level %d: hash %08x differs from the first generation (%08x)\n", i, h, reference[i]);
+				failed = TRUE;
+			}
+			delete_map_level(i);
+		}
 	}
 	timer_stop();
 
-	return 0;
+	printf("Generated %d dungeons, %.1f dungeons per second.\n", nb_loops * nb_levels,
+	       nb_loops * nb_levels * 1000.0 / max(1, stop_stamp - start_stamp));
+
+	return failed;
 }
 
 /* Levels validator (not an actual benchmark) */
@@ -234,6 +363,7 @@ static int level_test()
 		char fp[PATH_MAX];
 		if (find_file(fp, MAP_DIR, "levels.dat", NULL, NO_REPORT)) {
 			LoadShip(fp, 0);
+			wait_for_dungeons();
 			failed |= level_validation_on_console_only(act->name);
 		} else {
 			failed = TRUE;
@@ -253,6 +383,7 @@ static int graphics_bench()
 	char fp[PATH_MAX];
 	find_file(fp, MAP_DIR, "levels.dat", NULL, NO_REPORT);
 	LoadShip(fp, 0);
+	wait_for_dungeons();
 
 	// Prepare leveleditor zoomed-out benchmark
 	teleport_to_level_center(0);
@@ -269,20 +400,710 @@ static int graphics_bench()
 	}
 	timer_stop();
 
+	if (!use_open_gl)
+		printf("Images composited by %d threads.\n", sdl_compositor_thread_count());
+
 	return 0;
 }
 
-static int graphicsloading_bench()
+static void reload_graphics_timed(int iter, int *first_load)
 {
-	int iter = 5;
-
 	timer_start();
 	while (iter--) {
 		reload_graphics();
+		if (first_load && !*first_load)
+			*first_load = SDL_GetTicks() - start_stamp;
 	}
 
 	our_SDL_flip_wrapper();
 	timer_stop();
+}
+
+/* Graphics loading performance test
+ *
+ * When there is an asset pack, the graphics are first loaded from the image
+ * files, for comparison, and then from the asset pack. The first load of
+ * each run is the one with cold caches.
+ */
+static int graphicsloading_bench()
+{
+	int iter = 5;
+
+	if (!open_asset_pack()) {
+		reload_graphics_timed(iter, NULL);
+		return 0;
+	}
+
+	int files_first = 0, pack_first = 0;
+
+	close_asset_pack();
+	reload_graphics_timed(iter, &files_first);
+	int files_time = stop_stamp - start_stamp;
+
+	open_asset_pack();
+	reload_graphics_timed(iter, &pack_first);
+
+	printf("Image files: first load %d ms, %d loads in %d ms.\n", files_first, iter, files_time);
+	printf("Asset pack: first load %d ms, %d loads in %d ms.\n", pack_first, iter, stop_stamp - start_stamp);
+
+	return 0;
+}
+
+static int rects_overlap(SDL_Rect *a, SDL_Rect *b)
+{
+	return a->x < b->x + b->w && b->x < a->x + a->w && a->y < b->y + b->h && b->y < a->y + a->h;
+}
+
+/* Check that the packed images do not overlap, and still have their pixels */
+static int check_atlas_images(struct image *images, Uint32 *colors, int nb)
+{
+	int i, j;
+
+	for (i = 0; i < nb; i++) {
+		SDL_Rect rect_i, rect_j;
+		SDL_Surface *page_i, *page_j;
+
+		if (!images[i].atlas_slot)
+			continue;
+
+		page_i = get_atlas_image_surface(&images[i], &rect_i);
+		if (rect_i.x < 0 || rect_i.y < 0 || rect_i.x + rect_i.w > page_i->w || rect_i.y + rect_i.h > page_i->h) {
+			fprintf(stderr, "Image %d is out of its atlas page\n", i);
+			return 1;
+		}
+
+		SDL_LockSurface(page_i);
+		Uint32 pixel = *(Uint32 *)((Uint8 *)page_i->pixels + (rect_i.y + rect_i.h - 1) * page_i->pitch + (rect_i.x + rect_i.w - 1) * 4);
+		SDL_UnlockSurface(page_i);
+		if (pixel != colors[i]) {
+			fprintf(stderr, "Image %d lost its pixels in its atlas page\n", i);
+			return 1;
+		}
+
+		for (j = i + 1; j < nb; j++) {
+			if (!images[j].atlas_slot)
+				continue;
+			page_j = get_atlas_image_surface(&images[j], &rect_j);
+			if (page_i == page_j && rects_overlap(&rect_i, &rect_j)) {
+				fprintf(stderr, "Images %d and %d overlap in their atlas page\n", i, j);
+				return 1;
+			}
+		}
+	}
+
+	return 0;
+}
+
+/* Runtime texture atlas: occupancy of the pages, and validity of the layout
+ *
+ * The skyline packer is first tested alone, with sizes like the ones of the
+ * item images. Images are then packed in the current rendering mode, and
+ * deleted and replaced at random, as when the graphics of the items are
+ * evicted, which compacts the pages.
+ */
+static int atlas_test()
+{
+	const int page_size = 1024;
+	const int nb_rects = 3000;
+	struct dynarray rects;
+	struct atlas_skyline skyline;
+	int i, j, round;
+	int nb_pages = 1, page_start = 0;
+	int rects_area = 0;
+
+	srand(1);
+	timer_start();
+
+	dynarray_init(&rects, nb_rects, sizeof(SDL_Rect));
+	atlas_skyline_init(&skyline, page_size, page_size);
+	for (i = 0; i < nb_rects; i++) {
+		SDL_Rect rect = { .w = 16 + rand() % 128, .h = 16 + rand() % 128 };
+		int x, y;
+
+		if (!atlas_skyline_insert(&skyline, rect.w, rect.h, &x, &y)) {
+			// Page full, start a new one
+			atlas_skyline_free(&skyline);
+			atlas_skyline_init(&skyline, page_size, page_size);
+			page_start = rects.size;
+			nb_pages++;
+			if (!atlas_skyline_insert(&skyline, rect.w, rect.h, &x, &y)) {
+				fprintf(stderr, "A %dx%d rectangle does not fit in an empty page\n", rect.w, rect.h);
+				return 1;
+			}
+		}
+
+		rect.x = x;
+		rect.y = y;
+		if (x < 0 || y < 0 || x + rect.w > page_size || y + rect.h > page_size) {
+			fprintf(stderr, "Rectangle %d is out of the page\n", i);
+			return 1;
+		}
+		for (j = page_start; j < rects.size; j++) {
+			if (rects_overlap(&rect, dynarray_member(&rects, j, sizeof(SDL_Rect)))) {
+				fprintf(stderr, "Rectangles %d and %d overlap\n", i, j);
+				return 1;
+			}
+		}
+
+		dynarray_add(&rects, &rect, sizeof(SDL_Rect));
+		rects_area += rect.w * rect.h;
+	}
+	float packed_area = (float)(nb_pages - 1) * page_size * page_size + atlas_skyline_used_area(&skyline);
+	atlas_skyline_free(&skyline);
+	dynarray_free(&rects);
+
+	printf("Skyline packer: %d rectangles in %d pages, %.1f%% of the used space filled.\n",
+	       nb_rects, nb_pages, 100.0 * rects_area / packed_area);
+
+	// Images packed, deleted and replaced
+	const int nb_images = 600;
+	struct image images[nb_images];
+	Uint32 colors[nb_images];
+
+	for (i = 0; i < nb_images; i++) {
+		struct image empty = EMPTY_IMAGE;
+		images[i] = empty;
+	}
+
+	for (round = 0; round < 20; round++) {
+		for (i = 0; i < nb_images; i++) {
+			if (images[i].atlas_slot) {
+				// Evict about one third of the images at each round
+				if (rand() % 3 == 0)
+					delete_image(&images[i]);
+				continue;
+			}
+
+			SDL_Surface *surf = SDL_CreateRGBSurface(0, 16 + rand() % 112, 16 + rand() % 112, 32, rmask, gmask, bmask, amask);
+			images[i].surface = SDL_DisplayFormatAlpha(surf);
+			SDL_FreeSurface(surf);
+			colors[i] = SDL_MapRGBA(images[i].surface->format, i % 256, round * 10, i / 256, 255);
+			SDL_FillRect(images[i].surface, NULL, colors[i]);
+			images[i].w = images[i].surface->w;
+			images[i].h = images[i].surface->h;
+
+			if (!pack_image_in_atlas(&images[i])) {
+				fprintf(stderr, "Image %d could not be packed\n", i);
+				return 1;
+			}
+		}
+
+		if (check_atlas_images(images, colors, nb_images))
+			return 1;
+	}
+
+	int live_area;
+	int total_area = get_image_atlas_usage(&nb_pages, &live_area);
+	printf("Atlas pages: %d pages, %.1f%% used after the evictions.\n", nb_pages, 100.0 * live_area / total_area);
+
+	for (i = 0; i < nb_images; i++)
+		delete_image(&images[i]);
+
+	get_image_atlas_usage(&nb_pages, &live_area);
+	if (nb_pages) {
+		fprintf(stderr, "%d atlas pages are not freed\n", nb_pages);
+		return 1;
+	}
+
+	timer_stop();
+
+	return 0;
+}
+
+/* Mock image batch backend, recording what would be sent to the GPU */
+static struct {
+	struct dynarray vertices;
+	unsigned int bound[4];
+	int nb_draws;
+	int nb_binds;
+	int *drawn;              // Position of each quad in the drawing order, -1 if not drawn
+	int nb_drawn;
+	int error;
+} mock;
+
+struct mock_quad {
+	int x0, y0, x1, y1;
+	unsigned int texture;
+	float color[4];
+	int additive;
+};
+
+static struct mock_quad *mock_quads;
+
+static int mock_max_textures(void)
+{
+	return 4;
+}
+
+static void mock_upload(const float *vertices, int nb_quads)
+{
+	mock.vertices.size = 0;
+	while (nb_quads--) {
+		dynarray_add(&mock.vertices, (void *)vertices, 16 * sizeof(float));
+		vertices += 16;
+	}
+}
+
+static void mock_bind_texture(int unit, unsigned int texture)
+{
+	mock.bound[unit] = texture;
+	mock.nb_binds++;
+}
+
+static void mock_draw(int first_quad, int nb_quads, const float color[4], int additive)
+{
+	int i;
+
+	mock.nb_draws++;
+	for (i = first_quad; i < first_quad + nb_quads; i++) {
+		float *v = dynarray_member(&mock.vertices, i, 16 * sizeof(float));
+
+		// The quad number is stored in the t coordinate, the texture unit is
+		// encoded in the s coordinate
+		int id = v[3];
+		int unit = v[2] / 10;
+		struct mock_quad *q = &mock_quads[id];
+
+		if (mock.drawn[id] != -1 || mock.bound[unit] != q->texture || q->additive != additive ||
+		    memcmp(q->color, color, sizeof(q->color)) || v[0] != q->x0 || v[5] != q->y1) {
+			mock.error = TRUE;
+			return;
+		}
+		mock.drawn[id] = mock.nb_drawn++;
+	}
+}
+
+static void mock_done(void)
+{
+}
+
+/* Image batcher: number of draw calls, and drawing order of the overlapping
+ * quads, with a mock backend.
+ *
+ * The quads are recorded as the map would be: rows of tiles with a few
+ * textures, then objects on them, some of them highlighted.
+ */
+static int batch_test()
+{
+	struct image_batch_backend backend = {
+		.max_textures = mock_max_textures,
+		.upload = mock_upload,
+		.bind_texture = mock_bind_texture,
+		.draw = mock_draw,
+		.done = mock_done
+	};
+	const int nb_quads = 4000;
+	int frame, i, j;
+	int naive_draws = 0;
+
+	mock_quads = MyMalloc(nb_quads * sizeof(struct mock_quad));
+	mock.drawn = MyMalloc(nb_quads * sizeof(int));
+	dynarray_init(&mock.vertices, nb_quads, 16 * sizeof(float));
+
+	srand(1);
+	for (i = 0; i < nb_quads; i++) {
+		struct mock_quad *q = &mock_quads[i];
+		float white[4] = { 1.0, 1.0, 1.0, 1.0 };
+		float dark[4] = { 0.5, 0.5, 0.5, 1.0 };
+
+		memcpy(q->color, (rand() % 10) ? white : dark, sizeof(q->color));
+
+		if (i < nb_quads / 2) {
+			// Floor tiles
+			q->x0 = (i % 40) * 32;
+			q->y0 = (i / 40) * 16;
+			q->x1 = q->x0 + 32;
+			q->y1 = q->y0 + 16;
+			q->texture = 1 + rand() % 3;
+			q->additive = FALSE;
+		} else {
+			// Objects
+			q->x0 = rand() % 1280;
+			q->y0 = rand() % 800;
+			q->x1 = q->x0 + 16 + rand() % 64;
+			q->y1 = q->y0 + 16 + rand() % 96;
+			q->texture = 4 + rand() % 8;
+			q->additive = FALSE;
+
+			// Highlighted object, drawn again with additive blending
+			if (rand() % 20 == 0 && !mock_quads[i - 1].additive) {
+				*q = mock_quads[i - 1];
+				q->additive = TRUE;
+			}
+		}
+
+		if (!i || q->texture != mock_quads[i - 1].texture || q->additive != mock_quads[i - 1].additive ||
+		    memcmp(q->color, mock_quads[i - 1].color, sizeof(q->color)))
+			naive_draws++;
+	}
+
+	timer_start();
+	for (frame = 0; frame < 100; frame++) {
+		memset(mock.drawn, -1, nb_quads * sizeof(int));
+		mock.nb_drawn = 0;
+		mock.nb_draws = 0;
+		mock.nb_binds = 0;
+
+		for (i = 0; i < nb_quads; i++) {
+			struct mock_quad *q = &mock_quads[i];
+			image_batch_add_quad(q->texture, q->color, q->additive, q->x0, q->y0, q->x1, q->y1, 0.5, i, 0.5, i);
+		}
+		image_batch_flush(&backend);
+
+		if (mock.error || mock.nb_drawn != nb_quads) {
+			fprintf(stderr, "The quads were not drawn as they were recorded\n");
+			return 1;
+		}
+	}
+	timer_stop();
+
+	// The quads overlapping each other have to be drawn in the recording order
+	for (i = 0; i < nb_quads; i++) {
+		for (j = i + 1; j < nb_quads; j++) {
+			struct mock_quad *a = &mock_quads[i];
+			struct mock_quad *b = &mock_quads[j];
+			if (a->x0 < b->x1 && b->x0 < a->x1 && a->y0 < b->y1 && b->y0 < a->y1 && mock.drawn[i] > mock.drawn[j]) {
+				fprintf(stderr, "Quads %d and %d overlap, and are not drawn in order\n", i, j);
+				return 1;
+			}
+		}
+	}
+
+	printf("%d quads drawn with %d draw calls and %d texture bindings (%d state changes in the recording order).\n",
+	       nb_quads, mock.nb_draws, mock.nb_binds, naive_draws);
+
+	image_batch_forget_textures();
+	dynarray_free(&mock.vertices);
+	free(mock.drawn);
+	free(mock_quads);
+
+	return 0;
+}
+
+/* Reference blending of the compositor, one component at a time */
+static Uint8 tint_component(Uint8 c, float factor, int add)
+{
+	int f = (factor <= 0.0) ? 0 : (factor >= 1.0) ? 256 : (int)(factor * 256);
+	return min(((c * f) >> 8) + add, 255);
+}
+
+static Uint8 blend_component(Uint8 s, Uint8 d, Uint8 a)
+{
+	int v = s * a + d * (255 - a);
+	return (v + 1 + (v >> 8)) >> 8;
+}
+
+static Uint32 *surface_pixel(SDL_Surface *surf, int x, int y)
+{
+	return (Uint32 *)((Uint8 *)surf->pixels + y * surf->pitch) + x;
+}
+
+static int compositor_test()
+{
+	const int nb_surfaces = 16;
+	const int nb_blits = 3000;
+	const int nb_frames = 50;
+	SDL_Surface *surfaces[nb_surfaces];
+	struct {
+		SDL_Surface *surface;
+		SDL_Rect src;
+		int x, y;
+		float color[4];
+		int highlight;
+	} *blits;
+	Uint32 *expected;
+	int i, x, y, frame;
+
+	if (use_open_gl) {
+		fprintf(stderr, "The compositor is only used in SDL mode (-n)\n");
+		return 1;
+	}
+
+	if (Screen->format->BytesPerPixel != 4) {
+		fprintf(stderr, "The screen is not a 32 bits one, nothing would be composited\n");
+		return 1;
+	}
+
+	srand(1);
+	for (i = 0; i < nb_surfaces; i++) {
+		SDL_Surface *surf = SDL_CreateRGBSurface(0, 16 + rand() % 240, 16 + rand() % 240, 32, rmask, gmask, bmask, amask);
+		surfaces[i] = SDL_DisplayFormatAlpha(surf);
+		SDL_FreeSurface(surf);
+
+		// Mostly transparent and opaque pixels, as in the game images
+		SDL_LockSurface(surfaces[i]);
+		for (y = 0; y < surfaces[i]->h; y++) {
+			for (x = 0; x < surfaces[i]->w; x++) {
+				int alpha = rand() % 4;
+				alpha = (alpha == 0) ? 0 : (alpha == 1) ? 255 : rand() % 256;
+				*surface_pixel(surfaces[i], x, y) = SDL_MapRGBA(surfaces[i]->format, rand() % 256, rand() % 256, rand() % 256, alpha);
+			}
+		}
+		SDL_UnlockSurface(surfaces[i]);
+	}
+
+	// A surface whose alpha channel is ignored
+	SDL_SetAlpha(surfaces[0], 0, SDL_ALPHA_OPAQUE);
+
+	blits = MyMalloc(nb_blits * sizeof(*blits));
+	for (i = 0; i < nb_blits; i++) {
+		SDL_Surface *surf = surfaces[rand() % nb_surfaces];
+		blits[i].surface = surf;
+		blits[i].src.x = rand() % (surf->w / 2);
+		blits[i].src.y = rand() % (surf->h / 2);
+		blits[i].src.w = surf->w / 2 + rand() % (surf->w / 2 - blits[i].src.x + 1);
+		blits[i].src.h = surf->h / 2 + rand() % (surf->h / 2 - blits[i].src.y + 1);
+		blits[i].x = rand() % (Screen->w + 128) - 128;
+		blits[i].y = rand() % (Screen->h + 128) - 128;
+		for (x = 0; x < 4; x++)
+			blits[i].color[x] = (rand() % 4) ? 1.0 : (rand() % 256) / 255.0;
+		blits[i].highlight = (rand() % 10 == 0);
+	}
+
+	// Blend everything the slow way
+	Uint32 background = SDL_MapRGB(Screen->format, 30, 60, 90);
+	expected = MyMalloc(Screen->w * Screen->h * sizeof(Uint32));
+	for (i = 0; i < Screen->w * Screen->h; i++)
+		expected[i] = background;
+
+	for (i = 0; i < nb_blits; i++) {
+		SDL_Surface *surf = blits[i].surface;
+		for (y = max(0, -blits[i].y); y < blits[i].src.h && blits[i].y + y < Screen->h; y++) {
+			for (x = max(0, -blits[i].x); x < blits[i].src.w && blits[i].x + x < Screen->w; x++) {
+				Uint32 *d = &expected[(blits[i].y + y) * Screen->w + blits[i].x + x];
+				Uint8 s[4], c[3];
+				SDL_GetRGBA(*surface_pixel(surf, blits[i].src.x + x, blits[i].src.y + y), surf->format, &s[0], &s[1], &s[2], &s[3]);
+				SDL_GetRGB(*d, Screen->format, &c[0], &c[1], &c[2]);
+				int add = blits[i].highlight ? 64 : 0;
+				Uint8 a = (surf->flags & SDL_SRCALPHA) ? tint_component(s[3], blits[i].color[3], 0) : 255;
+				*d = SDL_MapRGB(Screen->format,
+				                blend_component(tint_component(s[0], blits[i].color[0], add), c[0], a),
+				                blend_component(tint_component(s[1], blits[i].color[1], add), c[1], a),
+				                blend_component(tint_component(s[2], blits[i].color[2], add), c[2], a));
+			}
+		}
+	}
+
+	SDL_SetClipRect(Screen, NULL);
+
+	timer_start();
+	for (frame = 0; frame < nb_frames; frame++) {
+		SDL_FillRect(Screen, NULL, background);
+		for (i = 0; i < nb_blits; i++)
+			sdl_compositor_blit(blits[i].surface, &blits[i].src, blits[i].x, blits[i].y, blits[i].color, blits[i].highlight);
+		sdl_compositor_flush();
+	}
+	timer_stop();
+
+	int failed = 0;
+	SDL_LockSurface(Screen);
+	for (y = 0; y < Screen->h && !failed; y++) {
+		for (x = 0; x < Screen->w; x++) {
+			Uint8 r, g, b, er, eg, eb;
+			SDL_GetRGB(*surface_pixel(Screen, x, y), Screen->format, &r, &g, &b);
+			SDL_GetRGB(expected[y * Screen->w + x], Screen->format, &er, &eg, &eb);
+			if (r != er || g != eg || b != eb) {
+				fprintf(stderr, "Pixel (%d, %d) is (%d, %d, %d) instead of (%d, %d, %d)\n", x, y, r, g, b, er, eg, eb);
+				failed = 1;
+				break;
+			}
+		}
+	}
+	SDL_UnlockSurface(Screen);
+
+	printf("%d blits composited by %d threads, %.1f ms per frame.\n", nb_blits, sdl_compositor_thread_count(),
+	       (stop_stamp - start_stamp) / (float)nb_frames);
+
+	for (i = 0; i < nb_surfaces; i++)
+		SDL_FreeSurface(surfaces[i]);
+	free(blits);
+	free(expected);
+
+	return failed;
+}
+
+/* Reference rules of the takeover game, one block at a time */
+static int ref_connects(int block)
+{
+	return block == CABLE || block == AMPLIFIER || block == COLOR_EXCHANGER ||
+	       block == SEPARATOR_H || block == SEPARATOR_L || block == GATE_M;
+}
+
+static int ref_active(int active[NUM_LAYERS][NUM_LINES], int layer, int row)
+{
+	return row >= 0 && row < NUM_LINES && active[layer][row];
+}
+
+static void ref_takeover_step(unsigned char blocks[TO_COLORS][NUM_LAYERS][NUM_LINES], int active[TO_COLORS][NUM_LAYERS][NUM_LINES],
+                              short countdown[TO_COLORS][NUM_LINES], int column[NUM_LINES], int *flicker)
+{
+	int color, layer, row, pass;
+
+	for (color = YELLOW; color < TO_COLORS; color++) {
+		for (row = 0; row < NUM_LINES; row++) {
+			if (countdown[color][row] > 0)
+				countdown[color][row]--;
+			if (countdown[color][row] == 0) {
+				countdown[color][row] = -1;
+				active[color][0][row] = FALSE;
+				blocks[color][0][row] = CABLE;
+			}
+		}
+	}
+
+	for (pass = 0; pass < TO_PROCESS_PASSES; pass++) {
+		for (color = YELLOW; color < TO_COLORS; color++) {
+			for (layer = 1; layer < NUM_LAYERS; layer++) {
+				for (row = 0; row < NUM_LINES; row++) {
+					int on = FALSE;
+
+					if (layer == NUM_LAYERS - 1) {
+						active[color][layer][row] = active[color][layer - 1][row] && ref_connects(blocks[color][layer - 1][row]);
+						continue;
+					}
+
+					switch (blocks[color][layer][row]) {
+					case COLOR_EXCHANGER:
+					case SEPARATOR_M:
+					case GATE_H:
+					case GATE_L:
+					case CABLE:
+						on = active[color][layer - 1][row];
+						break;
+					case AMPLIFIER:
+						on = active[color][layer - 1][row] || active[color][layer][row];
+						break;
+					case SEPARATOR_H:
+						on = ref_active(active[color], layer, row + 1);
+						break;
+					case SEPARATOR_L:
+						on = ref_active(active[color], layer, row - 1);
+						break;
+					case GATE_M:
+						on = ref_active(active[color], layer, row - 1) && ref_active(active[color], layer, row + 1);
+						break;
+					default:
+						break;
+					}
+
+					active[color][layer][row] = on;
+				}
+			}
+		}
+	}
+
+	*flicker = !*flicker;
+	for (row = 0; row < NUM_LINES; row++) {
+		int yellow = active[YELLOW][NUM_LAYERS - 1][row];
+		int purple = active[PURPLE][NUM_LAYERS - 1][row];
+		int yellow_exchange = blocks[YELLOW][NUM_LAYERS - 2][row] == COLOR_EXCHANGER;
+		int purple_exchange = blocks[PURPLE][NUM_LAYERS - 2][row] == COLOR_EXCHANGER;
+
+		if (yellow && !purple)
+			column[row] = yellow_exchange ? PURPLE : YELLOW;
+		else if (!yellow && purple)
+			column[row] = purple_exchange ? YELLOW : PURPLE;
+		else if (yellow && purple) {
+			if (yellow_exchange && !purple_exchange)
+				column[row] = PURPLE;
+			else if (!yellow_exchange && purple_exchange)
+				column[row] = YELLOW;
+			else
+				column[row] = *flicker ? PURPLE : YELLOW;
+		}
+	}
+}
+
+static int takeover_test()
+{
+	const int nb_boards = 200;
+	const int nb_playouts = 20000;
+	struct takeover_board board;
+	int active[TO_COLORS][NUM_LAYERS][NUM_LINES];
+	int column[NUM_LINES];
+	int flicker;
+	int i, step, color, layer, row;
+	uint32_t seed = 1;
+
+	srand(1);
+
+	// Check the bitboards against the reference rules
+	for (i = 0; i < nb_boards; i++) {
+		takeover_board_invent(&board);
+
+		unsigned char blocks[TO_COLORS][NUM_LAYERS][NUM_LINES];
+		short countdown[TO_COLORS][NUM_LINES];
+		memcpy(blocks, board.blocks, sizeof(blocks));
+		memcpy(countdown, board.capsule_countdown, sizeof(countdown));
+		memset(active, 0, sizeof(active));
+		for (row = 0; row < NUM_LINES; row++)
+			column[row] = takeover_board_row_color(&board, row);
+		flicker = board.flicker;
+
+		for (step = 0; step < 100 + TO_FINAL_STEPS; step++) {
+			color = rand() % TO_COLORS;
+			row = rand() % NUM_LINES;
+			if (rand() % 4 == 0) {
+				// A capsule can not be set on a capsule, nor on a cable end
+				int allowed = !active[color][0][row] && blocks[color][0][row] != CABLE_END;
+
+				if (takeover_board_set_capsule(&board, color, row, CAPSULE_COUNTDOWN) != allowed) {
+					fprintf(stderr, "Board %d, step %d: a capsule was %s on row %d of color %d\n", i, step,
+					        allowed ? "refused" : "set", row, color);
+					return 1;
+				}
+				if (allowed) {
+					blocks[color][0][row] = AMPLIFIER;
+					active[color][0][row] = TRUE;
+					countdown[color][row] = CAPSULE_COUNTDOWN;
+				}
+			}
+
+			takeover_board_step(&board);
+			ref_takeover_step(blocks, active, countdown, column, &flicker);
+
+			for (color = YELLOW; color < TO_COLORS; color++) {
+				for (layer = 0; layer < NUM_LAYERS; layer++) {
+					for (row = 0; row < NUM_LINES; row++) {
+						if (takeover_board_is_active(&board, color, layer, row) != active[color][layer][row]) {
+							fprintf(stderr, "Board %d, step %d: block (%d, %d, %d) is %s\n", i, step, color, layer, row,
+							        active[color][layer][row] ? "inactive" : "active");
+							return 1;
+						}
+					}
+				}
+			}
+
+			for (row = 0; row < NUM_LINES; row++) {
+				if (takeover_board_row_color(&board, row) != column[row]) {
+					fprintf(stderr, "Board %d, step %d: row %d of the column has the wrong color\n", i, step, row);
+					return 1;
+				}
+			}
+		}
+	}
+
+	// Play games out, as the opponent does
+	struct takeover_game game;
+	takeover_board_invent(&game.board);
+	game.capsules[YELLOW] = game.capsules[PURPLE] = 5;
+	game.lifetime[YELLOW] = 2 * CAPSULE_COUNTDOWN;
+	game.lifetime[PURPLE] = CAPSULE_COUNTDOWN;
+	game.ticks_left = 100 * TO_COUNT_TICK_LEN / TO_MOVE_TICK_LEN;
+
+	timer_start();
+	for (i = 0; i < nb_playouts; i++) {
+		struct takeover_game g = game;
+		takeover_playout(&g, &seed);
+	}
+	timer_stop();
+
+	printf("%d games played out, %.0f games per second.\n", nb_playouts,
+	       nb_playouts * 1000.0 / max(1, stop_stamp - start_stamp));
+
+	Uint32 search_start = SDL_GetTicks();
+	row = takeover_search_row(&game, PURPLE, -1, TO_SEARCH_PLAYOUTS_HARD, 0, seed);
+	printf("Search for the hard opponent: row %d, %d ms.\n", row, SDL_GetTicks() - search_start);
 
 	return 0;
 }
@@ -294,6 +1115,7 @@ int benchmark()
 		int (*func)();
 	} benchs[] = {
 			{ "text",            text_bench },
+			{ "textwrap",        textwrap_bench },
 			{ "dialog",          dialog_test },
 			{ "event",           event_test },
 			{ "loadship",        loadship_bench },
@@ -304,6 +1126,10 @@ int benchmark()
 			{ "leveltest",       level_test },
 			{ "graphics",        graphics_bench },
 			{ "graphicsloading", graphicsloading_bench },
+			{ "atlas",           atlas_test },
+			{ "batch",           batch_test },
+			{ "compositor",      compositor_test },
+			{ "takeover",        takeover_test },
 	};
 
 	int i;
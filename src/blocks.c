@@ -37,6 +37,9 @@
 
 static struct droidspec *current_droid_spec;
 
+static void mark_droid_graphics_used(int type);
+static void mark_item_graphics_used(int type);
+
 static int __enemy_animation(const char *filename, int *rotation, int *phase, int *first_image, int **last_image)
 {
 	int i;
@@ -134,6 +137,7 @@ static void load_enemy_graphics(struct droidspec *droid_spec)
 	droid_spec->death_animation_last_image = 0;
 	droid_spec->stand_animation_last_image = 0;
 
+	// No image is used, so that this only reads the atlas description
 	if (load_texture_atlas(atlas_filename, atlas_directory, compute_number_of_phases_for_enemy)) {
 		error_message(__FUNCTION__, "Unable to access the texture atlas for enemy '%s' at '%s'.",
 			PLEASE_INFORM | IS_FATAL, droid_spec->gfx_prefix, atlas_filename);
@@ -158,6 +162,7 @@ static void load_enemy_graphics(struct droidspec *droid_spec)
 			PLEASE_INFORM | IS_FATAL, droid_spec->droidname, droid_spec->stand_animation_last_image, MAX_ENEMY_MOVEMENT_PHASES);
 	}
 
+	prefetch_texture_atlas(atlas_filename, atlas_directory);
 	if (load_texture_atlas(atlas_filename, atlas_directory, get_storage_for_enemy_image)) {
 		error_message(__FUNCTION__, "Unable to load texture atlas for enemy '%s' at %s.",
 			PLEASE_INFORM | IS_FATAL, droid_spec->gfx_prefix, atlas_filename);
@@ -192,7 +197,7 @@ static void load_item_graphics(int item_type)
 	sprintf(our_filename, "items/%s", spec->item_inv_file_name);
 
 	if (use_open_gl) {
-		load_image(&spec->inventory_image, GRAPHICS_DIR, our_filename, 0);
+		load_image(&spec->inventory_image, GRAPHICS_DIR, our_filename, PACK_IN_ATLAS);
 		spec->shop_image = spec->inventory_image;
 
 		// Scale inventory image
@@ -240,6 +245,7 @@ static void load_item_graphics(int item_type)
 
 		spec->inventory_image.w = spec->inventory_image.surface->w;
 		spec->inventory_image.h = spec->inventory_image.surface->h;
+		pack_image_in_atlas(&spec->inventory_image);
 
 		// For the shop, we need versions of each image, where the image is scaled so
 		// that it takes up a whole 64x64 shop display square.  So we prepare scaled
@@ -265,12 +271,13 @@ static void load_item_graphics(int item_type)
 
 		spec->shop_image.w = spec->shop_image.surface->w;
 		spec->shop_image.h = spec->shop_image.surface->h;
+		pack_image_in_atlas(&spec->shop_image);
 	}
 
 	// Load ingame image
 	if (strcmp(spec->item_rotation_series_prefix, "NONE_AVAILABLE_YET")) {
 		sprintf(our_filename, "items/%s/ingame.png", spec->item_rotation_series_prefix);
-		load_image(&spec->ingame_image, GRAPHICS_DIR, our_filename, USE_OFFSET);
+		load_image(&spec->ingame_image, GRAPHICS_DIR, our_filename, USE_OFFSET | PACK_IN_ATLAS);
 	} else {
 		memcpy(&spec->ingame_image, &spec->inventory_image, sizeof(struct image));
 	}
@@ -280,6 +287,8 @@ static void load_if_needed(int type)
 {
 	itemspec *spec = &ItemMap[type];
 
+	mark_item_graphics_used(type);
+
 	if (!image_loaded(&spec->inventory_image)) {
 		load_item_graphics(type);
 	}
@@ -303,10 +312,35 @@ struct image *get_item_ingame_image(int type)
 	return &ItemMap[type].ingame_image;
 }
 
+/**
+ * Start decoding the images of an item, for load_item_graphics().
+ */
+static void prefetch_item_graphics(int item_type)
+{
+	char our_filename[PATH_MAX];
+	itemspec *spec = &ItemMap[item_type];
+
+	// In SDL mode, the inventory image is scaled before its conversion to
+	// the display format, and is therefore not loaded with load_image()
+	if (use_open_gl) {
+		sprintf(our_filename, "items/%s", spec->item_inv_file_name);
+		prefetch_image(GRAPHICS_DIR, our_filename, 0);
+	}
+
+	if (strcmp(spec->item_rotation_series_prefix, "NONE_AVAILABLE_YET")) {
+		sprintf(our_filename, "items/%s/ingame.png", spec->item_rotation_series_prefix);
+		prefetch_image(GRAPHICS_DIR, our_filename, USE_OFFSET);
+	}
+}
+
 void load_all_items(void)
 {
 	int i;
 
+	for (i = 0; i < Number_Of_Item_Types; i++) {
+		prefetch_item_graphics(i);
+	}
+
 	for (i = 0; i < Number_Of_Item_Types; i++) {
 		load_item_graphics(i);
 	}
@@ -315,29 +349,38 @@ void load_all_items(void)
 /**
  * Free all images associated with items.
  */
-void free_item_graphics(void)
+static void free_item_type_graphics(int type)
 {
-	int i;
 	struct image empty_image = EMPTY_IMAGE;
 
-	for (i = 0; i < Number_Of_Item_Types; i++) {
-		if (image_loaded(&ItemMap[i].inventory_image)) {
-			delete_image(&ItemMap[i].inventory_image);
-
-			// If the ingame image is not available for an item, then it is just a copy
-			// of the inventory image. In this case, the ingame image should not be
-			// deleted. The resources associated with this image will be freed when
-			// the inventory image is deleted.
-			if (strcmp(ItemMap[i].item_rotation_series_prefix, "NONE_AVAILABLE_YET"))
-				delete_image(&ItemMap[i].ingame_image);
-			else
-				memcpy(&ItemMap[i].ingame_image, &empty_image, sizeof(struct image));
-
-			delete_image(&ItemMap[i].shop_image);
-		}
+	if (image_loaded(&ItemMap[type].inventory_image)) {
+		delete_image(&ItemMap[type].inventory_image);
+
+		// If the ingame image is not available for an item, then it is just a copy
+		// of the inventory image. In this case, the ingame image should not be
+		// deleted. The resources associated with this image will be freed when
+		// the inventory image is deleted.
+		if (strcmp(ItemMap[type].item_rotation_series_prefix, "NONE_AVAILABLE_YET"))
+			delete_image(&ItemMap[type].ingame_image);
+		else
+			memcpy(&ItemMap[type].ingame_image, &empty_image, sizeof(struct image));
+
+		// In OpenGL mode, the shop image is a copy of the inventory image too
+		if (use_open_gl)
+			memcpy(&ItemMap[type].shop_image, &empty_image, sizeof(struct image));
+		else
+			delete_image(&ItemMap[type].shop_image);
 	}
 }
 
+void free_item_graphics(void)
+{
+	int i;
+
+	for (i = 0; i < Number_Of_Item_Types; i++)
+		free_item_type_graphics(i);
+}
+
 /**
  * This function loads the items image and decodes it into the multiple
  * small item surfaces.
@@ -387,7 +430,6 @@ void iso_load_bullet_surfaces(void)
 void get_offset_for_iso_image_from_file_and_path(const char *fpath, struct image * our_iso_image)
 {
 	char offset_file_name[10000];
-	FILE *OffsetFile;
 	char *offset_data;
 	// Now we try to load the associated offset file, that we'll be needing
 	// in order to properly fine-position the image later when blitting is to
@@ -399,7 +441,7 @@ void get_offset_for_iso_image_from_file_and_path(const char *fpath, struct image
 
 	// Let's see if we can find an offset file...
 	//
-	if ((OffsetFile = fopen(offset_file_name, "rb")) == NULL) {
+	if (!data_file_exists(offset_file_name)) {
 		error_message(__FUNCTION__, "\
 FreedroidRPG was unable to open offset file %s for an isometric image.\n\
 Since the offset could not be obtained from the offset file, 0 will be used instead.\n\
@@ -408,8 +450,6 @@ in graphics displayed, but FreedroidRPG will continue to work.", NO_REPORT, offs
 		our_iso_image->offset_x = 0;
 		our_iso_image->offset_y = 0;
 		return;
-	} else {
-		fclose(OffsetFile);
 	}
 
 	// So at this point we can be certain, that the offset file is there.
@@ -425,12 +465,52 @@ in graphics displayed, but FreedroidRPG will continue to work.", NO_REPORT, offs
 
 };				// void get_offset_for_iso_image_from_file_and_path ( fpath , our_iso_image )
 
+/**
+ * Find the atlas pages of the animation images of an enemy model, in
+ * OpenGL mode. The images are subtextures of the textures of the pages.
+ *
+ * \param droid Enemy model
+ * \param pages Filled with an image owning the texture of each page
+ * \return The number of pages
+ */
+static int get_droid_atlas_pages(struct droidspec *droid, struct image *pages)
+{
+	int rotation_index, phase_index;
+	int i, nb_pages = 0;
+
+	for (rotation_index = 0; rotation_index < ROTATION_ANGLES_PER_ROTATION_MODEL; rotation_index++) {
+		for (phase_index = 0; phase_index < MAX_ENEMY_MOVEMENT_PHASES; phase_index++) {
+			struct image *img = &droid->droid_images[rotation_index][phase_index];
+			if (!(img->texture_type & IS_SUBTEXTURE))
+				continue;
+
+			for (i = 0; i < nb_pages; i++) {
+				if (pages[i].texture == img->texture)
+					break;
+			}
+			if (i < nb_pages || nb_pages == MAX_DROID_ATLAS_PAGES)
+				continue;
+
+			struct image page = EMPTY_IMAGE;
+			page.texture = img->texture;
+			page.texture_type = TEXTURE_CREATED;
+			page.tex_w = img->tex_w;
+			page.tex_h = img->tex_h;
+			pages[nb_pages++] = page;
+		}
+	}
+
+	return nb_pages;
+}
+
 /**
  *
  *
  */
 void load_droid_animation_images(struct droidspec *this_droid_spec)
 {
+	mark_droid_graphics_used(this_droid_spec - Droidmap);
+
 	if (!this_droid_spec->can_move || this_droid_spec->gfx_prepared)
 		return;
 
@@ -440,22 +520,41 @@ void load_droid_animation_images(struct droidspec *this_droid_spec)
 	this_droid_spec->gfx_prepared = TRUE;
 }
 
-void free_enemy_graphics(void)
+/**
+ * Free the animation images and the portrait of an enemy model.
+ */
+static void free_droid_graphics(int type)
 {
-	int i;
+	struct droidspec *droid = &Droidmap[type];
+	struct image pages[MAX_DROID_ATLAS_PAGES];
 	int rotation_index, phase_index;
+	int i, nb_pages;
 
-	for (i = 0; i < Number_Of_Droid_Types; i++) {
-		if (Droidmap[i].gfx_prepared) {
-			for (rotation_index = 0; rotation_index < ROTATION_ANGLES_PER_ROTATION_MODEL; rotation_index++) {
-				for (phase_index = 0; phase_index < MAX_ENEMY_MOVEMENT_PHASES; phase_index++)
-					delete_image(&Droidmap[i].droid_images[rotation_index][phase_index]);
-			}
-			Droidmap[i].gfx_prepared = FALSE;
+	if (droid->gfx_prepared) {
+		// The textures of the atlas pages are only referenced by the
+		// animation images, and have to be freed along with them
+		nb_pages = get_droid_atlas_pages(droid, pages);
+
+		for (rotation_index = 0; rotation_index < ROTATION_ANGLES_PER_ROTATION_MODEL; rotation_index++) {
+			for (phase_index = 0; phase_index < MAX_ENEMY_MOVEMENT_PHASES; phase_index++)
+				delete_image(&droid->droid_images[rotation_index][phase_index]);
 		}
-		if (image_loaded(&Droidmap[i].portrait))
-			delete_image(&Droidmap[i].portrait);
+
+		for (i = 0; i < nb_pages; i++)
+			delete_image(&pages[i]);
+
+		droid->gfx_prepared = FALSE;
 	}
+	if (image_loaded(&droid->portrait))
+		delete_image(&droid->portrait);
+}
+
+void free_enemy_graphics(void)
+{
+	int i;
+
+	for (i = 0; i < Number_Of_Droid_Types; i++)
+		free_droid_graphics(i);
 }
 
 static void load_droid_portrait(int type)
@@ -585,6 +684,18 @@ static struct image *get_storage_for_obstacle_shadow_image(const char *filename)
 	return NULL;
 }
 
+/**
+ * Start decoding the images of the floor tiles and of the obstacles, so
+ * that load_floor_tiles() and load_all_obstacles() only have to create the
+ * images, while the next ones are still being decoded.
+ */
+void prefetch_floor_tiles_and_obstacles(void)
+{
+	prefetch_texture_atlas("floor_tiles/atlas.txt", "floor_tiles/");
+	prefetch_texture_atlas("obstacles/atlas.txt", "obstacles/");
+	prefetch_texture_atlas("obstacles/shadow_atlas.txt", "obstacles/");
+}
+
 void load_all_obstacles(int with_startup_bar)
 {
 	int i, j;
@@ -725,6 +836,7 @@ void load_tux_graphics(int motion_class, int tux_part_group, const char *part_st
 
 	current_tux_motion_class = motion_class;
 	current_tux_part_group = tux_part_group;
+	prefetch_texture_atlas(atlas_filename, atlas_directory);
 	if (load_texture_atlas(atlas_filename, atlas_directory, get_storage_for_tux_image)) {
 		error_message(__FUNCTION__, "Unable to load tux texture atlas at %s.",
 			PLEASE_INFORM | IS_FATAL, atlas_filename);
@@ -746,4 +858,345 @@ void reload_tux_graphics(void)
 	}
 }
 
+/*
+ * Prefetching of the enemy and item graphics.
+ *
+ * With lazy loading, the graphics of an enemy or of an item are loaded the
+ * first time they are displayed, and the game hangs a bit when a new kind of
+ * bot walks into view. update_graphics_prefetch() looks at the bots and items
+ * on the levels around Tux, starts decoding the images of the ones which are
+ * not loaded yet on the image decoder threads, and then loads them, one per
+ * frame, once their images are decoded.
+ *
+ * When the enemy and item graphics use more than
+ * GameConfig.graphics_memory_budget megabytes, the ones which are not needed
+ * around Tux are freed, least recently used first. They are loaded again
+ * when they are displayed.
+ */
+
+// Time between two scans of the levels around Tux (in ms)
+#define GRAPHICS_PREFETCH_INTERVAL 1000
+
+enum graphics_prefetch_kind {
+	PREFETCH_DROID,
+	PREFETCH_ITEM
+};
+
+struct graphics_prefetch_request {
+	enum graphics_prefetch_kind kind;
+	int type;
+};
+
+static struct {
+	int level;                      // Level of Tux at the last scan
+	uint32_t last_scan;             // Time of the last scan
+	struct dynarray requests;       // Graphics to load, in order
+
+	// Per droid type and per item type
+	uint32_t *droid_last_used;      // Time when the graphics were last needed
+	uint32_t *item_last_used;
+	size_t *droid_size;             // Memory used by the graphics
+	int *droid_size_state;          // Graphics loaded when droid_size was computed
+	size_t *item_size;              // Memory used by the graphics, 0 if not computed yet
+	char *droid_wanted;             // Needed around Tux
+	char *item_wanted;
+} prefetch = { .level = -1 };
+
+static void init_graphics_prefetch(void)
+{
+	if (prefetch.droid_last_used)
+		return;
+
+	dynarray_init(&prefetch.requests, 16, sizeof(struct graphics_prefetch_request));
+	prefetch.droid_last_used = MyMalloc(Number_Of_Droid_Types * sizeof(uint32_t));
+	prefetch.item_last_used = MyMalloc(Number_Of_Item_Types * sizeof(uint32_t));
+	prefetch.droid_size = MyMalloc(Number_Of_Droid_Types * sizeof(size_t));
+	prefetch.droid_size_state = MyMalloc(Number_Of_Droid_Types * sizeof(int));
+	prefetch.item_size = MyMalloc(Number_Of_Item_Types * sizeof(size_t));
+	prefetch.droid_wanted = MyMalloc(Number_Of_Droid_Types);
+	prefetch.item_wanted = MyMalloc(Number_Of_Item_Types);
+}
+
+static void mark_droid_graphics_used(int type)
+{
+	if (prefetch.droid_last_used)
+		prefetch.droid_last_used[type] = SDL_GetTicks();
+}
+
+static void mark_item_graphics_used(int type)
+{
+	if (prefetch.item_last_used)
+		prefetch.item_last_used[type] = SDL_GetTicks();
+}
+
+static int droid_graphics_loaded(int type)
+{
+	return Droidmap[type].gfx_prepared || image_loaded(&Droidmap[type].portrait);
+}
+
+static int item_graphics_loaded(int type)
+{
+	return image_loaded(&ItemMap[type].inventory_image);
+}
+
+/*
+ * Memory used by an image, not counting the texture it shares with other
+ * images if it is a subtexture. The part of the atlas page used by a
+ * packed image is counted.
+ */
+static size_t image_memory_size(struct image *img)
+{
+	size_t size = 0;
+
+	if (img->surface)
+		size += img->surface->pitch * img->surface->h;
+	if (img->texture_type == TEXTURE_CREATED)
+		size += img->tex_w * img->tex_h * 4;
+	if (img->atlas_slot)
+		size += img->atlas_slot->rect.w * img->atlas_slot->rect.h * 4;
+
+	return size;
+}
+
+static size_t droid_graphics_size(int type)
+{
+	struct droidspec *droid = &Droidmap[type];
+	struct image pages[MAX_DROID_ATLAS_PAGES];
+	int rotation_index, phase_index;
+	int i, nb_pages;
+
+	// The animation images and the portrait are loaded separately
+	int state = 1 + droid->gfx_prepared + 2 * image_loaded(&droid->portrait);
+
+	if (prefetch.droid_size_state[type] != state) {
+		size_t size = image_memory_size(&droid->portrait);
+
+		if (droid->gfx_prepared) {
+			nb_pages = get_droid_atlas_pages(droid, pages);
+			for (i = 0; i < nb_pages; i++)
+				size += image_memory_size(&pages[i]);
+
+			for (rotation_index = 0; rotation_index < ROTATION_ANGLES_PER_ROTATION_MODEL; rotation_index++) {
+				for (phase_index = 0; phase_index < MAX_ENEMY_MOVEMENT_PHASES; phase_index++)
+					size += image_memory_size(&droid->droid_images[rotation_index][phase_index]);
+			}
+		}
+
+		prefetch.droid_size[type] = size;
+		prefetch.droid_size_state[type] = state;
+	}
+
+	return prefetch.droid_size[type];
+}
+
+static size_t item_graphics_size(int type)
+{
+	itemspec *spec = &ItemMap[type];
+
+	if (!prefetch.item_size[type]) {
+		size_t size = image_memory_size(&spec->inventory_image);
+
+		// In OpenGL mode, the shop image is a copy of the inventory image
+		if (!use_open_gl)
+			size += image_memory_size(&spec->shop_image);
+
+		if (strcmp(spec->item_rotation_series_prefix, "NONE_AVAILABLE_YET"))
+			size += image_memory_size(&spec->ingame_image);
+
+		prefetch.item_size[type] = size;
+	}
+
+	return prefetch.item_size[type];
+}
+
+static void want_droid_graphics(int type)
+{
+	if (type < 0 || type >= Number_Of_Droid_Types || prefetch.droid_wanted[type])
+		return;
+
+	prefetch.droid_wanted[type] = TRUE;
+	prefetch.droid_last_used[type] = SDL_GetTicks();
+
+	if (!Droidmap[type].can_move || Droidmap[type].gfx_prepared)
+		return;
+
+	char atlas_filename[4096];
+	char atlas_directory[4096];
+	char portrait_filename[4096];
+
+	sprintf(atlas_filename, "%s/atlas.txt", Droidmap[type].gfx_prefix);
+	sprintf(atlas_directory, "%s/", Droidmap[type].gfx_prefix);
+	sprintf(portrait_filename, "%s/portrait.png", Droidmap[type].gfx_prefix);
+	prefetch_texture_atlas(atlas_filename, atlas_directory);
+	if (!image_loaded(&Droidmap[type].portrait))
+		prefetch_image(GRAPHICS_DIR, portrait_filename, NO_MOD);
+
+	struct graphics_prefetch_request req = { PREFETCH_DROID, type };
+	dynarray_add(&prefetch.requests, &req, sizeof(req));
+}
+
+static void want_item_graphics(int type)
+{
+	if (type < 0 || type >= Number_Of_Item_Types || prefetch.item_wanted[type])
+		return;
+
+	prefetch.item_wanted[type] = TRUE;
+	prefetch.item_last_used[type] = SDL_GetTicks();
+
+	if (item_graphics_loaded(type))
+		return;
+
+	prefetch_item_graphics(type);
+
+	struct graphics_prefetch_request req = { PREFETCH_ITEM, type };
+	dynarray_add(&prefetch.requests, &req, sizeof(req));
+}
+
+/*
+ * Find the graphics needed around Tux: the bots and the floor items of the
+ * current level and of its neighbors, and the items of Tux.
+ */
+static void scan_wanted_graphics(void)
+{
+	int i, x, y;
+
+	memset(prefetch.droid_wanted, 0, Number_Of_Droid_Types);
+	memset(prefetch.item_wanted, 0, Number_Of_Item_Types);
+	prefetch.requests.size = 0;
+
+	for (y = 0; y < 3; y++) {
+		for (x = 0; x < 3; x++) {
+			int levelnum = NEIGHBOR_ID(Me.pos.z, x, y);
+			if (levelnum == -1)
+				continue;
+
+			enemy *erot;
+			list_for_each_entry(erot, &level_bots_head[levelnum], level_list)
+				want_droid_graphics(erot->type);
+
+			level *lvl = curShip.AllLevels[levelnum];
+			for (i = 0; i < lvl->ItemList.size; i++)
+				want_item_graphics(ACCESS_FLOOR_ITEM(lvl, i).type);
+		}
+	}
+
+	for (i = 0; i < MAX_ITEMS_IN_INVENTORY; i++)
+		want_item_graphics(Me.Inventory[i].type);
+	want_item_graphics(Me.weapon_item.type);
+	want_item_graphics(Me.drive_item.type);
+	want_item_graphics(Me.armour_item.type);
+	want_item_graphics(Me.shield_item.type);
+	want_item_graphics(Me.special_item.type);
+}
+
+/*
+ * Free the least recently used graphics which are not needed around Tux,
+ * until the memory budget is respected.
+ */
+static void evict_graphics(void)
+{
+	size_t budget = (size_t)GameConfig.graphics_memory_budget * 1024 * 1024;
+	size_t used = 0;
+	int i;
+
+	if (GameConfig.graphics_memory_budget <= 0)
+		return;
+
+	for (i = 0; i < Number_Of_Droid_Types; i++) {
+		if (droid_graphics_loaded(i))
+			used += droid_graphics_size(i);
+	}
+	for (i = 0; i < Number_Of_Item_Types; i++) {
+		if (item_graphics_loaded(i))
+			used += item_graphics_size(i);
+	}
+
+	while (used > budget) {
+		int oldest_droid = -1, oldest_item = -1;
+
+		for (i = 0; i < Number_Of_Droid_Types; i++) {
+			if (!droid_graphics_loaded(i) || prefetch.droid_wanted[i])
+				continue;
+			if (oldest_droid == -1 || prefetch.droid_last_used[i] < prefetch.droid_last_used[oldest_droid])
+				oldest_droid = i;
+		}
+		for (i = 0; i < Number_Of_Item_Types; i++) {
+			if (!item_graphics_loaded(i) || prefetch.item_wanted[i])
+				continue;
+			if (oldest_item == -1 || prefetch.item_last_used[i] < prefetch.item_last_used[oldest_item])
+				oldest_item = i;
+		}
+
+		if (oldest_droid == -1 && oldest_item == -1)
+			break;
+
+		if (oldest_item == -1 || (oldest_droid != -1 && prefetch.droid_last_used[oldest_droid] <= prefetch.item_last_used[oldest_item])) {
+			used -= droid_graphics_size(oldest_droid);
+			free_droid_graphics(oldest_droid);
+		} else {
+			used -= item_graphics_size(oldest_item);
+			free_item_type_graphics(oldest_item);
+		}
+	}
+}
+
+/**
+ * Prefetch the graphics of the bots and items around Tux, and free the
+ * graphics which are not needed when over the memory budget.
+ * This function is to be called once per frame, when lazy loading is on.
+ */
+void update_graphics_prefetch(void)
+{
+	if (!GameConfig.lazyload)
+		return;
+
+	init_graphics_prefetch();
+
+	if (Me.pos.z != prefetch.level || SDL_GetTicks() - prefetch.last_scan >= GRAPHICS_PREFETCH_INTERVAL) {
+		prefetch.level = Me.pos.z;
+		prefetch.last_scan = SDL_GetTicks();
+		scan_wanted_graphics();
+		// The images prefetched for graphics not wanted anymore are dropped
+		release_unrenewed_images();
+		evict_graphics();
+	}
+
+	// Load the next graphics once all their images are decoded, so that
+	// only the creation of the textures is done during this frame
+	if (!prefetch.requests.size || image_decoder_busy())
+		return;
+
+	struct graphics_prefetch_request req = *(struct graphics_prefetch_request *)dynarray_member(&prefetch.requests, 0, sizeof(req));
+	dynarray_del(&prefetch.requests, 0, sizeof(req));
+
+	if (req.kind == PREFETCH_DROID) {
+		load_droid_animation_images(&Droidmap[req.type]);
+		if (!image_loaded(&Droidmap[req.type].portrait))
+			load_droid_portrait(req.type);
+	} else {
+		load_if_needed(req.type);
+	}
+}
+
+/**
+ * Forget the state of the graphics prefetcher, when the graphics are freed
+ * or when a new game starts.
+ */
+void reset_graphics_prefetch(void)
+{
+	if (!prefetch.droid_last_used)
+		return;
+
+	dynarray_free(&prefetch.requests);
+	free(prefetch.droid_last_used);
+	free(prefetch.item_last_used);
+	free(prefetch.droid_size);
+	free(prefetch.droid_size_state);
+	free(prefetch.item_size);
+	free(prefetch.droid_wanted);
+	free(prefetch.item_wanted);
+	memset(&prefetch, 0, sizeof(prefetch));
+	prefetch.level = -1;
+}
+
 #undef _blocks_c
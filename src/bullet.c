@@ -106,15 +106,12 @@ void delete_melee_shot(int melee_shot_number)
  * ----------------------------------------------------------------- */
 void do_melee_damage(void)
 {
-	int i;
+	int n;
 	float latest_frame_time = Frame_Time();
 
-	/* Browse all melee shots */
-	for (i = 0; i < all_melee_shots.size; i++) {
-		// Unused melee shot slot
-		if (!sparse_dynarray_member_used(&all_melee_shots, i))
-			continue;
-
+	/* Browse all melee shots, from the last one so that they can be deleted */
+	for (n = all_melee_shots.nb_live - 1; n >= 0; n--) {
+		int i = sparse_dynarray_live_member(&all_melee_shots, n);
 		struct melee_shot *current_melee_shot = (struct melee_shot *)sparse_dynarray_member(&all_melee_shots, i, sizeof(struct melee_shot));
 
 		// Wait the hit of the melee shot
@@ -172,13 +169,11 @@ void do_melee_damage(void)
  */
 void move_bullets(void)
 {
-	int i;
-
-	for (i = 0; i < all_bullets.size; i++) {
-		// Unused bullet slot
-		if (!sparse_dynarray_member_used(&all_bullets, i))
-			continue;
+	int n;
 
+	// Browse the live bullets from the last one, so that they can be deleted
+	for (n = all_bullets.nb_live - 1; n >= 0; n--) {
+		int i = sparse_dynarray_live_member(&all_bullets, n);
 		struct bullet *current_bullet = (struct bullet *)sparse_dynarray_member(&all_bullets, i, sizeof(struct bullet));
 
 		// if during its move, a bullet collides something, it has done its job !
@@ -274,46 +269,48 @@ void start_blast(float x, float y, int lvl, int type, int dmg, int faction, char
  */
 void animate_blasts(void)
 {
-	int i;
-
-	for (i = 0; i < all_blasts.size; i++) {
-		if (sparse_dynarray_member_used(&all_blasts, i)) {
-
-			struct blast *current_blast = (struct blast *)sparse_dynarray_member(&all_blasts, i, sizeof(struct blast));
-
-			// But maybe the blast is also outside the map already, which would
-			// cause a SEGFAULT directly afterwards, when the map is queried.
-			// Therefore we introduce some extra security here...
-
-			if (!pos_inside_level(current_blast->pos.x, current_blast->pos.y, curShip.AllLevels[current_blast->pos.z])) {
-				error_message(__FUNCTION__,
-				              "A BLAST WAS FOUND TO EXIST OUTSIDE THE BOUNDS OF THE MAP.\n"
-				              "This is an indication of an inconsistency in FreedroidRPG.\n"
-				              "\n"
-				              "However, the error is not fatal and will be silently compensated for now.\n"
-				              "When reporting a problem to the FreedroidRPG developers, please note if this\n"
-				              "warning message was created prior to the error in your report.\n"
-				              "However, it should NOT cause any serious trouble for FreedroidRPG.",
-				              NO_REPORT);
-				delete_blast(i);
-				continue;
-			}
-			
-			if (Blastmap[current_blast->type].do_damage)
-				check_blast_collisions(current_blast);
+	int n;
+
+	// Browse the live blasts from the last one, so that they can be deleted
+	for (n = all_blasts.nb_live - 1; n >= 0; n--) {
+		int i = sparse_dynarray_live_member(&all_blasts, n);
+		struct blast *current_blast = (struct blast *)sparse_dynarray_member(&all_blasts, i, sizeof(struct blast));
+
+		// But maybe the blast is also outside the map already, which would
+		// cause a SEGFAULT directly afterwards, when the map is queried.
+		// Therefore we introduce some extra security here...
+
+		if (!pos_inside_level(current_blast->pos.x, current_blast->pos.y, curShip.AllLevels[current_blast->pos.z])) {
+			error_message(__FUNCTION__,
+			              "A BLAST WAS FOUND TO EXIST OUTSIDE THE BOUNDS OF THE MAP.\n"
+			              "This is an indication of an inconsistency in FreedroidRPG.\n"
+			              "\n"
+			              "However, the error is not fatal and will be silently compensated for now.\n"
+			              "When reporting a problem to the FreedroidRPG developers, please note if this\n"
+			              "warning message was created prior to the error in your report.\n"
+			              "However, it should NOT cause any serious trouble for FreedroidRPG.",
+			              NO_REPORT);
+			delete_blast(i);
+			continue;
+		}
+		
+		if (Blastmap[current_blast->type].do_damage) {
+			check_blast_collisions(current_blast);
+			// Smashing an obstacle starts a new blast, which can move the array
+			current_blast = (struct blast *)sparse_dynarray_member(&all_blasts, i, sizeof(struct blast));
+		}
 
-			// And now we advance the phase of the blast according to the
-			// time that has passed since the last frame (approximately)
+		// And now we advance the phase of the blast according to the
+		// time that has passed since the last frame (approximately)
 
-			current_blast->phase += Frame_Time() * Blastmap[current_blast->type].phases / Blastmap[current_blast->type].total_animation_time;
+		current_blast->phase += Frame_Time() * Blastmap[current_blast->type].phases / Blastmap[current_blast->type].total_animation_time;
 
-			// Maybe the blast has lived over his normal lifetime already.
-			// Then of course it's time to delete the blast, which is done
-			// here.
+		// Maybe the blast has lived over his normal lifetime already.
+		// Then of course it's time to delete the blast, which is done
+		// here.
 
-			if ((int)floorf(current_blast->phase) >= Blastmap[current_blast->type].phases)
-				delete_blast(i);
-		}
+		if ((int)floorf(current_blast->phase) >= Blastmap[current_blast->type].phases)
+			delete_blast(i);
 	}
 }
 
@@ -330,7 +327,7 @@ void delete_blast(int blast_number)
  */
 void move_spells(void)
 {
-	int i;
+	int n;
 	float passed_time = Frame_Time();
 	float distance_from_center;
 	int direction_index;
@@ -338,11 +335,9 @@ void move_spells(void)
 	gps final_point;
 	float angle;
 
-	for (i = 0; i < all_spells.size; ++i) {
-		// skip unused spell slot
-		if (!sparse_dynarray_member_used(&all_spells, i))
-			continue;
-
+	// Browse the live spells from the last one, so that they can be deleted
+	for (n = all_spells.nb_live - 1; n >= 0; n--) {
+		int i = sparse_dynarray_live_member(&all_spells, n);
 		struct spell *current_spell = (struct spell *)sparse_dynarray_member(&all_spells, i, sizeof(struct spell));
 
 		// All spells should count their lifetime...
@@ -470,17 +465,11 @@ void delete_spell(int spell_number)
  */
 void clear_active_bullets(void)
 {
-	int i;
-
-	for (i = 0; i < all_blasts.size; i++) {
-		if (sparse_dynarray_member_used(&all_blasts, i))
-			delete_blast(i);
-	}
+	while (all_blasts.nb_live)
+		delete_blast(sparse_dynarray_live_member(&all_blasts, all_blasts.nb_live - 1));
 
-	for (i = 0; i < all_bullets.size; i++) {
-		if (sparse_dynarray_member_used(&all_bullets, i))
-			delete_bullet(i);
-	}
+	while (all_bullets.nb_live)
+		delete_bullet(sparse_dynarray_live_member(&all_bullets, all_bullets.nb_live - 1));
 }
 
 /**
@@ -812,6 +801,11 @@ void check_blast_collisions(struct blast *current_blast)
 	}
 }
 
+static const char *bullet_spec_name(int type)
+{
+	return ((struct bulletspec *)dynarray_member(&bullet_specs, type, sizeof(struct bulletspec)))->name;
+}
+
 /**
  * This function returns the bullet number of a specified bullet string.
  * Bullet strings are defined in map/bullet_archtypes.dat
@@ -820,16 +814,11 @@ void check_blast_collisions(struct blast *current_blast)
  */
 int GetBulletByName(const char *bullet_name)
 {
-	int i;
-	for (i=0; i < bullet_specs.size; i++) {
-		struct bulletspec *bullet_spec = dynarray_member(&bullet_specs, i, sizeof(struct bulletspec));
-
-		if (!bullet_spec->name)
-			return 0;
+	static struct name_map bullet_names;
+	int i = name_map_index_of(&bullet_names, bullet_name, bullet_spec_name, bullet_specs.size);
 
-		if (!strcmp(bullet_name, bullet_spec->name))
-			return i;
-	}
+	if (i != -1)
+		return i;
 	error_message(__FUNCTION__, "\
 The bullet name \"%s\" lacks a definition.", PLEASE_INFORM, bullet_name);
 	return 0;
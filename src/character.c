@@ -141,6 +141,7 @@ static void check_for_new_experience_level_reached()
 	if (Me.Experience >= exp_required) {
 		Me.exp_level++;
 		Me.points_to_distribute += 5;
+		invalidate_character_stats();
 
 		// When a droid reaches a new experience level, all health and 
 		// force are restored to full this one time no longer.  Gothic
@@ -290,17 +291,54 @@ static void update_damage_tux_can_do()
 	}
 };				// void update_damage_tux_can_do ( )
 
+/*
+ * The character stats only change when an item is equipped or removed, when
+ * a skill or a primary stat is improved, when a level is gained, or when a
+ * temporary bonus starts or ends. They are only computed again in these
+ * cases, instead of every frame.
+ */
+static int character_stats_changed = TRUE;
+static float character_stats_date;		// Game date of the last computation
+static float character_stats_expiration = -1;	// Game date at which a temporary bonus ends, -1 if none
+static int character_stats_fading;		// TRUE while a bonus fades out, the stats then change every frame
+
+// The stats computed by compute_character_stats()
+struct character_stats {
+	int strength;
+	int dexterity;
+	int cooling;
+	int physique;
+	float to_hit;
+	float maxenergy;
+	float max_temperature;
+	float max_running_power;
+	float health_recovery_rate;
+	float cooling_rate;
+	float base_damage;
+	float damage_modifier;
+	float armor_class;
+	int slowing_melee_targets;
+	int paralyzing_melee_targets;
+	int light_bonus_from_tux;
+	float experience_factor;
+};
+
+/**
+ * Ask for the character stats to be computed again by the next call to
+ * UpdateAllCharacterStats(). To be called whenever something the stats depend
+ * on is changed.
+ */
+void invalidate_character_stats(void)
+{
+	character_stats_changed = TRUE;
+}
+
 /**
  * This function should re-compute all character stats according to the
  * currently equipped items and currently distributed stats points.
  */
-void UpdateAllCharacterStats()
+static void compute_character_stats(void)
 {
-	// Maybe the influencer has reached a new experience level?
-	// Let's check this...
-	// 
-	check_for_new_experience_level_reached();
-
 	// The primary status must be computed/updated first, because
 	// the secondary status (chances and the like) will depend on
 	// them...
@@ -345,6 +383,101 @@ void UpdateAllCharacterStats()
 		float ratio = min(1.0, Me.light_bonus_end_date - Me.current_game_date);
 		Me.light_bonus_from_tux += 5 * ratio;
 	}
+}
+
+static void expire_character_stats_at(float date)
+{
+	if (date <= Me.current_game_date)
+		return;
+
+	if (character_stats_expiration < 0 || date < character_stats_expiration)
+		character_stats_expiration = date;
+}
+
+/**
+ * Find out when the temporary bonuses applied to the stats will change.
+ */
+static void update_character_stats_expiration(void)
+{
+	character_stats_date = Me.current_game_date;
+	character_stats_expiration = -1;
+
+	expire_character_stats_at(Me.dexterity_bonus_end_date);
+	expire_character_stats_at(Me.power_bonus_end_date);
+	expire_character_stats_at(Me.light_bonus_end_date - 1.0);
+	expire_character_stats_at(Me.light_bonus_end_date);
+
+	character_stats_fading = Me.light_bonus_end_date > Me.current_game_date &&
+	                         Me.light_bonus_end_date - Me.current_game_date < 1.0;
+}
+
+static void get_character_stats(struct character_stats *stats)
+{
+	stats->strength = Me.strength;
+	stats->dexterity = Me.dexterity;
+	stats->cooling = Me.cooling;
+	stats->physique = Me.physique;
+	stats->to_hit = Me.to_hit;
+	stats->maxenergy = Me.maxenergy;
+	stats->max_temperature = Me.max_temperature;
+	stats->max_running_power = Me.max_running_power;
+	stats->health_recovery_rate = Me.health_recovery_rate;
+	stats->cooling_rate = Me.cooling_rate;
+	stats->base_damage = Me.base_damage;
+	stats->damage_modifier = Me.damage_modifier;
+	stats->armor_class = Me.armor_class;
+	stats->slowing_melee_targets = Me.slowing_melee_targets;
+	stats->paralyzing_melee_targets = Me.paralyzing_melee_targets;
+	stats->light_bonus_from_tux = Me.light_bonus_from_tux;
+	stats->experience_factor = Me.experience_factor;
+}
+
+/**
+ * Debug check: compute the stats again although nothing was invalidated, and
+ * complain if they changed, meaning that some code forgot to call
+ * invalidate_character_stats().
+ */
+static void check_character_stats(void)
+{
+	struct character_stats cached, computed;
+
+	get_character_stats(&cached);
+	compute_character_stats();
+	get_character_stats(&computed);
+
+	if (memcmp(&cached, &computed, sizeof(struct character_stats))) {
+		error_once_message(ONCE_PER_GAME, __FUNCTION__,
+		                   "The character stats changed without being invalidated.\n"
+		                   "Something changes them without calling invalidate_character_stats().",
+		                   PLEASE_INFORM);
+	}
+}
+
+/**
+ * This function updates the character stats, if something they depend on
+ * changed since the last call.
+ */
+void UpdateAllCharacterStats()
+{
+	// Maybe the influencer has reached a new experience level?
+	// Let's check this...
+	// 
+	check_for_new_experience_level_reached();
+
+	if (character_stats_expiration >= 0 && Me.current_game_date >= character_stats_expiration)
+		character_stats_changed = TRUE;
+	if (character_stats_fading && Me.current_game_date != character_stats_date)
+		character_stats_changed = TRUE;
+
+	if (character_stats_changed) {
+		// Some items can be unequipped by the computation, invalidating
+		// the stats again
+		character_stats_changed = FALSE;
+		compute_character_stats();
+		update_character_stats_expiration();
+	} else if (debug_level >= 1) {
+		check_character_stats();
+	}
 
 	// Check player's health, temperature and stamina
 	if (Me.energy > Me.maxenergy)
@@ -570,18 +703,22 @@ void HandleCharacterScreen(void)
 		if (MouseCursorIsOnButton(MORE_STR_BUTTON, GetMousePos_x(), GetMousePos_y()) && MouseLeftClicked()) {
 			Me.base_strength++;
 			Me.points_to_distribute--;
+			invalidate_character_stats();
 		}
 		if (MouseCursorIsOnButton(MORE_DEX_BUTTON, GetMousePos_x(), GetMousePos_y()) && MouseLeftClicked()) {
 			Me.base_dexterity++;
 			Me.points_to_distribute--;
+			invalidate_character_stats();
 		}
 		if (MouseCursorIsOnButton(MORE_MAG_BUTTON, GetMousePos_x(), GetMousePos_y()) && MouseLeftClicked()) {
 			Me.base_cooling++;
 			Me.points_to_distribute--;
+			invalidate_character_stats();
 		}
 		if (MouseCursorIsOnButton(MORE_VIT_BUTTON, GetMousePos_x(), GetMousePos_y()) && MouseLeftClicked()) {
 			Me.base_physique++;
 			Me.points_to_distribute--;
+			invalidate_character_stats();
 		}
 
 	}
@@ -267,6 +267,46 @@ static inline char get_point_flag(float xmin, float ymin, float xmax, float ymax
 	return out;
 }
 
+// Number of slots of the set of the obstacles checked by one collision test
+// (a power of two)
+#define COLLDET_MARKS_SIZE 128
+
+/*
+ * Obstacles already checked during one collision test on one level.
+ * An obstacle is glued to all the tiles it covers, and is only checked once.
+ *
+ * The marks are kept in the context of the test, rather than in the obstacles,
+ * so that several tests can run at once (as the level validator does).
+ * When the set is half full, new obstacles are not marked anymore, and are
+ * then possibly checked several times, which does not change the result.
+ */
+struct colldet_marks {
+	int slots[COLLDET_MARKS_SIZE];	// obstacle index + 1, 0 being an empty slot
+	int count;
+};
+
+/*
+ * Mark an obstacle as checked.
+ * Return TRUE if it was already marked.
+ */
+static inline int colldet_mark_obstacle(struct colldet_marks *marks, int obstacle_index)
+{
+	unsigned int slot = ((unsigned int)obstacle_index * 2654435761u) & (COLLDET_MARKS_SIZE - 1);
+
+	while (marks->slots[slot]) {
+		if (marks->slots[slot] == obstacle_index + 1)
+			return TRUE;
+		slot = (slot + 1) & (COLLDET_MARKS_SIZE - 1);
+	}
+
+	if (2 * marks->count < COLLDET_MARKS_SIZE) {
+		marks->slots[slot] = obstacle_index + 1;
+		marks->count++;
+	}
+
+	return FALSE;
+}
+
 /**
  * This function checks if a given position is free of obstacles
  * 
@@ -293,7 +333,15 @@ static int dlc_on_one_level(int x_tile_start, int x_tile_end, int y_tile_start,
 			    gps * p1, gps * p2, level * lvl, colldet_filter * filter)
 {
 	int x_tile, y_tile;
-	int tstamp = next_glue_timestamp();
+	struct colldet_marks marks;
+
+	// An obstacle is glued only once to a tile, so there is nothing to mark
+	// when only one tile is checked (point tests, mostly)
+	int single_tile = (x_tile_start == x_tile_end && y_tile_start == y_tile_end);
+	if (!single_tile) {
+		marks.count = 0;
+		memset(marks.slots, 0, sizeof(marks.slots));
+	}
 
 	char ispoint = ((p1->x == p2->x) && (p1->y == p2->y));
 
@@ -309,13 +357,10 @@ static int dlc_on_one_level(int x_tile_start, int x_tile_end, int y_tile_start,
 				if (obstacle_index == (-1))
 					break;
 
-				obstacle *our_obs = &(lvl->obstacle_list[obstacle_index]);
+				obstacle *our_obs = &(ACCESS_OBSTACLE(lvl, obstacle_index));
 
-				if (our_obs->timestamp == tstamp) {
+				if (!single_tile && colldet_mark_obstacle(&marks, obstacle_index))
 					continue;
-				}
-
-				our_obs->timestamp = tstamp;
 
 				// If the obstacle doesn't even have a collision rectangle, then
 				// of course it's easy, cause then there can't be any collision
@@ -658,7 +703,7 @@ int EscapeFromObstacle(float *posX, float *posY, int posZ, colldet_filter * filt
 
 				obst_index = glued_obstacles[i];
 
-				obstacle *our_obs = &(ThisLevel->obstacle_list[obst_index]);
+				obstacle *our_obs = &(ACCESS_OBSTACLE(ThisLevel, obst_index));
 
 				if (filter && filter->callback(filter, our_obs, obst_index))
 					continue;
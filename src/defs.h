@@ -103,6 +103,7 @@ enum {
 #define ROTATION_ANGLES_PER_ROTATION_MODEL 8
 
 #define MAX_ENEMY_MOVEMENT_PHASES 999
+#define MAX_DROID_ATLAS_PAGES 32
 #define WALK_ANIMATION 113
 #define ATTACK_ANIMATION 114
 #define GETHIT_ANIMATION 115
@@ -112,10 +113,12 @@ enum {
 
 #define NUMBER_OF_SHADOW_IMAGES 20
 
-#define MAX_OBSTACLES_ON_MAP 4000
+// Pools store their members in pages of POOL_PAGE_SIZE members
+#define POOL_PAGE_SHIFT 8
+#define POOL_PAGE_SIZE (1 << POOL_PAGE_SHIFT)
+#define pool_member(pool, index) ((void *)((char *)(pool)->pages[(index) >> POOL_PAGE_SHIFT] + ((index) & (POOL_PAGE_SIZE - 1)) * (pool)->membersize))
 
 #define FLOOR_TILES_VISIBLE_AROUND_TUX ((GameConfig . screen_width >= 1024 ? 13 : GameConfig . screen_width >= 800 ? 9 : 7))
-#define MAX_ITEMS_PER_LEVEL 300
 #define MAX_ITEMS_IN_INVENTORY 100
 #define MAX_ITEMS_IN_NPC_SHOPLIST 200
 #define INVENTORY_GRID_WIDTH 10
@@ -508,6 +511,8 @@ enum {
 #define VISIBLE_EVENT_BIT 4
 #define SQUARE_SEEN_AT_ALL_BIT 8
 #define UPDATE_SQUARE_BIT 16
+#define AUTOMAP_NB_PLANES 5	// one bitplane per automap flag above
+#define AUTOMAP_PLANE_WORDS(xlen, ylen) (((xlen) * (ylen) + 31) / 32)
 
 #define MAX_INFLU_POSITION_HISTORY 500
 #define MAX_MISSION_DESCRIPTION_TEXTS 25
@@ -1542,6 +1547,8 @@ enum faction_state {
 };
 
 #define ACCESS_OBSTACLE_EXTENSION(X,Y) ((struct obstacle_extension *)(X.arr))[Y]
+#define ACCESS_OBSTACLE(L,Y) ((struct obstacle *)(L)->obstacle_list.pages[(Y) >> POOL_PAGE_SHIFT])[(Y) & (POOL_PAGE_SIZE - 1)]
+#define ACCESS_FLOOR_ITEM(L,Y) ((struct item *)(L)->ItemList.pages[(Y) >> POOL_PAGE_SHIFT])[(Y) & (POOL_PAGE_SIZE - 1)]
 #define ACCESS_MAP_LABEL(X,Y) ((struct map_label *)(X.arr))[Y]
 
 enum obstacle_extension_type {
@@ -1622,7 +1629,8 @@ enum texture_type {
 enum load_image_mod_flags {
 	NO_MOD = 0,
 	USE_OFFSET = 1 << 1,  // Use the offset file to translate the image
-	USE_WIDE   = 1 << 2   // Use the wide version of the file (if it exists)
+	USE_WIDE   = 1 << 2,  // Use the wide version of the file (if it exists)
+	PACK_IN_ATLAS = 1 << 3 // Put the image in a shared atlas page (if it is small enough)
 };
 
 // Draw quads borders (OpenGL only)
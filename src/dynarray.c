@@ -237,9 +237,13 @@ void sparse_dynarray_init(struct sparse_dynarray *array, int membernum, size_t m
 
 	if (membernum) {
 		array->used_members = calloc(membernum, sizeof(array->used_members[0]));
+		array->live_members = calloc(membernum, sizeof(array->live_members[0]));
 	} else {
 		array->used_members = NULL;
+		array->live_members = NULL;
 	}
+	array->nb_live = 0;
+	dynarray_init(&array->free_slots, 0, sizeof(int));
 }
 
 /**
@@ -271,6 +275,10 @@ void sparse_dynarray_free(struct sparse_dynarray *array)
 
 	free(array->used_members);
 	array->used_members = NULL;
+	free(array->live_members);
+	array->live_members = NULL;
+	array->nb_live = 0;
+	dynarray_free(&array->free_slots);
 }
 
 /**
@@ -297,13 +305,21 @@ static void sparse_dynarray_resize(struct sparse_dynarray *array, int membernum,
 	// set new slots as unused (not really needed since they are after the
 	// last used slot, but it can prevent a potential bug)
 	memset(&array->used_members[array->size], 0, (membernum - array->size) * sizeof(array->used_members[0]));
+
+	buffer = realloc(array->live_members, membernum * sizeof(array->live_members[0]));
+	if (!buffer) {
+		error_message(__FUNCTION__,
+		              "Not enough memory to realloc the live_members of a dynarray (requested size: " SIZE_T_F ")",
+		              IS_FATAL, membernum * sizeof(array->live_members[0]));
+	}
+	array->live_members = buffer;
 }
 
 /**
  * \brief Add an element to a sparse dynamic array. This function will extend the array capacity as required.
  *
- * \details The element is added to the first available slot.
- *          If the sparse dynarray is full, the element is added at the end of the sparse dynarray.
+ * \details The element is added to the last released slot.
+ *          If no slot was released, the element is added at the end of the sparse dynarray.
  *
  * \param array      Pointer to the sparse dynarray to which the element is to be added.
  * \param data       Pointer to the data to add.
@@ -313,11 +329,12 @@ void sparse_dynarray_add(struct sparse_dynarray *array, void *data, size_t membe
 {
 	int slot_index = -1;
 
-	// Check if a slot is available
-	int i;
-	for (i = 0; i < array->size; i++) {
-		if (!array->used_members[i]) {
-			slot_index = i;
+	// Pop a released slot. The stack can contain slots which were since
+	// then cut off the end of the array, or reused by an append.
+	while (array->free_slots.size) {
+		int index = ((int *)array->free_slots.arr)[--array->free_slots.size];
+		if (index < array->size && !array->used_members[index]) {
+			slot_index = index;
 			break;
 		}
 	}
@@ -334,9 +351,10 @@ void sparse_dynarray_add(struct sparse_dynarray *array, void *data, size_t membe
 		array->size++;
 	}
 
-	// Copy the data in the free slot and mark the slot as being used
+	// Copy the data in the free slot and add the slot to the live members
 	dynarray_store_data((struct dynarray *)array, slot_index, data, membersize);
-	array->used_members[slot_index] = TRUE;
+	array->live_members[array->nb_live++] = slot_index;
+	array->used_members[slot_index] = array->nb_live;
 
 	return;
 }
@@ -347,6 +365,9 @@ void sparse_dynarray_add(struct sparse_dynarray *array, void *data, size_t membe
  * \details The slot is marked as available for future insertion of a new
  *          element. If there are trailing unused slots, the size of the array
  *          is reduced to the last used slot.
+ *          The last live member takes the place of the removed one in the
+ *          live_members list, so that the list can be browsed from its end
+ *          while removing the current member.
  *
  * \param array       Pointer to the sparse dynarray to use
  * \param index       Index of the element to remove
@@ -365,16 +386,27 @@ void sparse_dynarray_del(struct sparse_dynarray *array, int index, size_t member
 		              "Out of scope member's index. Index: %d - Array size: %d",
 		              IS_FATAL, index, array->size);
 	}
+	if (!array->used_members[index])
+		return;
 
+	int live_pos = array->used_members[index] - 1;
+	int last_live = array->live_members[--array->nb_live];
+	array->live_members[live_pos] = last_live;
+	array->used_members[last_live] = live_pos + 1;
 	array->used_members[index] = 0;
 
 	// Check if we are removing the last element of the array
 	// If so, we decrement the size of the array up to the last used slot.
+	// Otherwise, the slot is kept for the next insertion.
 	int remove_last = (index == array->size - 1);
 	if (remove_last) {
 		do {
 			array->size--;
 		} while (array->size > 0 && array->used_members[array->size - 1] == 0);
+		if (array->size == 0)
+			array->free_slots.size = 0;
+	} else {
+		dynarray_add(&array->free_slots, &index, sizeof(int));
 	}
 }
 
@@ -403,5 +435,214 @@ void *sparse_dynarray_member(struct sparse_dynarray *array, int index, size_t me
  */
 int sparse_dynarray_member_used(struct sparse_dynarray *array, int index)
 {
-	return array->used_members[index];
+	return array->used_members[index] != 0;
+}
+
+/**
+ * \brief Get the slot of a live member of a sparse dynarray.
+ *
+ * \details Live members are numbered from 0 to nb_live - 1. To be able to
+ *          delete the current member while browsing them, browse them from
+ *          the last one down to the first one. Members added during the
+ *          loop are not browsed.
+ *
+ * \param array  Pointer to the array to use
+ * \param n      Number of the live member
+ *
+ * \return The index of the slot holding the member
+ */
+int sparse_dynarray_live_member(struct sparse_dynarray *array, int n)
+{
+	return array->live_members[n];
+}
+
+//===================================================================
+// Pool functions
+//===================================================================
+
+/**
+ * \brief Initializes an empty pool.
+ *
+ * \details A pool stores its members in fixed size pages, so that the
+ *          address of a member never changes, even when the pool grows.
+ *          Free slots are recognized with the 'slot_is_free' callback,
+ *          so that members can also be released by just marking them as
+ *          unused (for instance by setting their type to -1).
+ *
+ * \param pool          Pointer to the pool to initialize.
+ * \param membersize    Size of a member.
+ * \param slot_is_free  Function returning TRUE if a member is unused.
+ */
+void pool_init(struct pool *pool, size_t membersize, int (*slot_is_free)(void *))
+{
+	pool->pages = NULL;
+	pool->nb_pages = 0;
+	pool->size = 0;
+	pool->membersize = membersize;
+	pool->slot_is_free = slot_is_free;
+	dynarray_init(&pool->free_slots, 0, sizeof(int));
+}
+
+/**
+ * \brief Frees the contents of a pool and sets its size to zero.
+ *
+ * \param pool  Pointer to the pool to free.
+ */
+void pool_free(struct pool *pool)
+{
+	int i;
+
+	for (i = 0; i < pool->nb_pages; i++)
+		free(pool->pages[i]);
+	free(pool->pages);
+
+	pool->pages = NULL;
+	pool->nb_pages = 0;
+	pool->size = 0;
+	dynarray_free(&pool->free_slots);
+}
+
+/**
+ * \brief Collect the free slots of a pool on its free list.
+ *
+ * \param pool  Pointer to the pool to use.
+ */
+static void pool_collect_free_slots(struct pool *pool)
+{
+	int i;
+
+	pool->free_slots.size = 0;
+
+	// Push in reverse order, so that the lowest slots are reused first
+	for (i = pool->size - 1; i >= 0; i--) {
+		if (pool->slot_is_free(pool_member(pool, i)))
+			dynarray_add(&pool->free_slots, &i, sizeof(int));
+	}
+}
+
+/**
+ * \brief Double the capacity of a pool (at least one page is added).
+ *
+ * \param pool  Pointer to the pool to grow.
+ */
+static void pool_grow(struct pool *pool)
+{
+	int nb_new_pages = pool->nb_pages ? pool->nb_pages : 1;
+	int i;
+
+	void *buffer = realloc(pool->pages, (pool->nb_pages + nb_new_pages) * sizeof(void *));
+	if (!buffer) {
+		error_message(__FUNCTION__,
+		              "Not enough memory to grow a pool (requested pages: %d)",
+		              IS_FATAL, pool->nb_pages + nb_new_pages);
+	}
+	pool->pages = buffer;
+
+	for (i = 0; i < nb_new_pages; i++)
+		pool->pages[pool->nb_pages + i] = MyMalloc(POOL_PAGE_SIZE * pool->membersize);
+	pool->nb_pages += nb_new_pages;
+}
+
+/**
+ * \brief Get a free slot in a pool. The pool grows as required.
+ *
+ * \details Released slots are reused first. When none is known and the pool
+ *          is full, it is scanned for the slots which were freed without
+ *          being released. The pool grows if only a few of them are found,
+ *          so that the scan does not happen too often.
+ *          The content of the returned slot is undefined, it has to be
+ *          initialized by the caller.
+ *
+ * \param pool  Pointer to the pool to use.
+ *
+ * \return The index of the slot.
+ */
+int pool_add(struct pool *pool)
+{
+	if (!pool->free_slots.size && pool->size >= pool->nb_pages * POOL_PAGE_SIZE) {
+		pool_collect_free_slots(pool);
+		if (pool->free_slots.size < pool->nb_pages * POOL_PAGE_SIZE / 4)
+			pool_grow(pool);
+	}
+
+	while (pool->free_slots.size) {
+		int index = ((int *)pool->free_slots.arr)[--pool->free_slots.size];
+
+		// The slot could have been reused since it was released
+		if (index < pool->size && !pool->slot_is_free(pool_member(pool, index)))
+			continue;
+
+		if (index >= pool->size)
+			pool->size = index + 1;
+		return index;
+	}
+
+	if (pool->size >= pool->nb_pages * POOL_PAGE_SIZE)
+		pool_grow(pool);
+
+	return pool->size++;
+}
+
+/**
+ * \brief Release a slot of a pool, for it to be reused.
+ *
+ * \details The member has to be marked as unused before the call.
+ *          If there are trailing unused slots, the size of the pool is
+ *          reduced to the last used slot.
+ *
+ * \param pool   Pointer to the pool to use.
+ * \param index  Index of the slot to release.
+ */
+void pool_del(struct pool *pool, int index)
+{
+	if (index < 0 || index >= pool->size) {
+		error_message(__FUNCTION__,
+		              "Out of scope member's index. Index: %d - Pool size: %d",
+		              IS_FATAL, index, pool->size);
+	}
+
+	dynarray_add(&pool->free_slots, &index, sizeof(int));
+
+	if (index == pool->size - 1) {
+		do {
+			pool->size--;
+		} while (pool->size > 0 && pool->slot_is_free(pool_member(pool, pool->size - 1)));
+	}
+}
+
+/**
+ * \brief Forget the released slots of a pool.
+ *
+ * \details To be called when the members of a pool were moved around.
+ *          The free slots will be searched again when needed.
+ *
+ * \param pool  Pointer to the pool to use.
+ */
+void pool_reset_free_slots(struct pool *pool)
+{
+	pool->free_slots.size = 0;
+
+	while (pool->size > 0 && pool->slot_is_free(pool_member(pool, pool->size - 1)))
+		pool->size--;
+}
+
+/**
+ * \brief Get the index of a member of a pool.
+ *
+ * \param pool    Pointer to the pool to use.
+ * \param member  Pointer to the member.
+ *
+ * \return The index of the member, or -1 if it is not part of the pool.
+ */
+int pool_index(struct pool *pool, void *member)
+{
+	int i;
+
+	for (i = 0; i < pool->nb_pages; i++) {
+		char *page = pool->pages[i];
+		if ((char *)member >= page && (char *)member < page + POOL_PAGE_SIZE * pool->membersize)
+			return i * POOL_PAGE_SIZE + ((char *)member - page) / pool->membersize;
+	}
+
+	return -1;
 }
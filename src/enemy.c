@@ -57,7 +57,9 @@ LIST_HEAD(dead_bots_head);
 list_head_t level_bots_head[MAX_LEVELS];	//THIS IS NOT STATICALLY PROPERLY INITIALIZED, done in init functions
 
 /* Definition of the sensors. The flag_set values must be exclusive,
- * so that given a flag_set we can get a unique associated name. */
+ * so that given a flag_set we can get a unique associated name.
+ * The sensors of the droid specs are cached by spec_cache.c, so
+ * SPEC_CACHE_VERSION has to be increased when this table changes. */
 
 struct {
 	char *name;
@@ -215,10 +217,12 @@ void teleport_enemy(enemy *robot, int z, float x, float y)
 
 	// Does the robot change level?
 	if (z != robot->pos.z) {
+		mission_bot_changed(robot);
 		robot->pos.z = z;
 
 		// Add the bot on the new level
 		list_move(&robot->level_list, &(level_bots_head[robot->pos.z]));
+		mission_bot_changed(robot);
 	}
 
 	// Prevent the bot from moving this frame
@@ -360,6 +364,7 @@ void enemy_insert_into_lists(enemy *this_enemy, int is_living)
 	list_add(&(this_enemy->global_list), is_living ? &alive_bots_head : &dead_bots_head);
 	if (is_living) {
 		list_add(&this_enemy->level_list, &level_bots_head[this_enemy->pos.z]);
+		mission_bot_changed(this_enemy);
 	}
 }
 
@@ -407,6 +412,7 @@ void clear_enemies(void)
 	INIT_LIST_HEAD(&dead_bots_head);
 
 	enemy_reset_fabric();
+	mission_all_bots_changed();
 }
 
 /** Helper to modify the enemy state
@@ -591,6 +597,9 @@ static void move_enemy_to_spot(Enemy ThisRobot, pointf next_target_spot)
 	if (!resolve_virtual_position(&newpos, &newpos))
 		return;
 
+	if (newpos.z != ThisRobot->pos.z)
+		mission_bot_changed(ThisRobot);
+
 	old_map_level = ThisRobot->pos.z;
 	ThisRobot->pos.x = newpos.x;
 	ThisRobot->pos.y = newpos.y;
@@ -614,6 +623,7 @@ static void move_enemy_to_spot(Enemy ThisRobot, pointf next_target_spot)
 		}
 		// Move the bot to the appropriate level list
 		list_move(&ThisRobot->level_list, &(level_bots_head[ThisRobot->pos.z]));
+		mission_bot_changed(ThisRobot);
 	}
 
 	DetermineAngleOfFacing(ThisRobot);
@@ -2811,17 +2821,67 @@ static int is_potential_target(enemy * this_robot, gps * target_pos, float *squa
 
 }				// is_potential_target( enemy* this_robot, gps* target_pos, float* squared_best_dist )
 
+static const char *droid_spec_name(int type)
+{
+	return Droidmap[type].droidname;
+}
+
 /**
- * Return the numerical droid type corresponding to a given type name.
+ * Finish the initialization of the droid specs, once they were read from the
+ * data files or from the spec cache: prepare their graphics and adapt them to
+ * the difficulty level.
  */
-int get_droid_type(const char *type_name)
+void init_droid_specs(void)
 {
+	struct difficulty *diff = dynarray_member(&difficulties, GameConfig.difficulty_level, sizeof(struct difficulty));
+	struct image empty = EMPTY_IMAGE;
 	int i;
 
 	for (i = 0; i < Number_Of_Droid_Types; i++) {
-		if (!strcmp(Droidmap[i].droidname, type_name))
-			return i;
+		struct droidspec *droid = &Droidmap[i];
+
+		droid->gfx_prepared = FALSE;
+		if (!GameConfig.lazyload) {
+			load_droid_animation_images(droid);
+		} else {
+			// The animation cycle lengths will be taken from the image collection file
+			// the first time the droid will be displayed.
+			// But it might happen that some phase computation is done before the first
+			// blit already. Therefore we initialize some sane default values.
+			droid->walk_animation_first_image = 1;
+			droid->walk_animation_last_image = 1;
+			droid->attack_animation_first_image = 1;
+			droid->attack_animation_last_image = 1;
+			droid->gethit_animation_first_image = 1;
+			droid->gethit_animation_last_image = 1;
+			droid->death_animation_first_image = 1;
+			droid->death_animation_last_image = 1;
+			droid->stand_animation_first_image = 1;
+			droid->stand_animation_last_image = 1;
+		}
+
+		droid->portrait = empty;
+
+		// Adapt the droid's specs to the difficulty level
+		droid->maxspeed *= diff->droid_max_speed;
+		droid->maxenergy *= diff->droid_hpmax;
+		droid->experience_reward *= diff->droid_experience_reward;
+		droid->aggression_distance *= diff->droid_aggression_distance;
+		droid->healing_friendly *= diff->droid_friendly_healing;
+		droid->healing_hostile *= diff->droid_hostile_healing;
 	}
+}
+
+/**
+ * Return the numerical droid type corresponding to a given type name.
+ */
+int get_droid_type(const char *type_name)
+{
+	static struct name_map droid_names;
+	int i = name_map_index_of(&droid_names, type_name, droid_spec_name, Number_Of_Droid_Types);
+
+	if (i != -1)
+		return i;
 
 	error_message(__FUNCTION__, "Droid type \"%s\" does not exist.", PLEASE_INFORM, type_name);
 
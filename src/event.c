@@ -504,11 +504,13 @@ static void event_enemy(enemy *target, int event)
 
 void event_enemy_died(enemy *dead)
 {
+	mission_bot_changed(dead);
 	event_enemy(dead, ENEMY_DEATH);
 }
 
 void event_enemy_hacked(enemy *hacked)
 {
+	mission_bot_changed(hacked);
 	event_enemy(hacked, ENEMY_HACK);
 }
 
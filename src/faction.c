@@ -54,17 +54,21 @@ static struct {
 		{ FACTION_TEST, "test"} // extra faction for level 24, behaves neutral
 };
 
+static const char *faction_name(int i)
+{
+	return factions[i].name;
+}
+
 /**
   * Returns the numerical ID corresponding to the name of a faction given as parameter.
   */
 enum faction_id get_faction_id(const char *name) 
 {
-	int i;
+	static struct name_map faction_names;
+	int i = name_map_index_of(&faction_names, name, faction_name, sizeof(factions)/sizeof(factions[0]));
 
-	for (i = 0; i < sizeof(factions)/sizeof(factions[0]); i++) {
-		if (!strcmp(factions[i].name, name))
-			return factions[i].id;
-	}
+	if (i != -1)
+		return factions[i].id;
 
 	error_message(__FUNCTION__, "Faction name %s does not exist.", PLEASE_INFORM, name);
 	return FACTION_SELF;
@@ -98,6 +102,8 @@ void set_faction_state(enum faction_id fact1, enum faction_id fact2, enum factio
 
 	hostility_matrix[fact1][fact2] = state;
 	hostility_matrix[fact2][fact1] = state;
+
+	mission_all_bots_changed();
 }
 
 /**
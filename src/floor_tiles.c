@@ -55,9 +55,10 @@ int next_pathfinder_timestamp(void)
 }
 
 /**
- * In order to make sure that an obstacle is only displayed/checked once, the collision detection and display code use a timestamp.
- * Every time a new collision detection is started, and every time a new frame is displayed, the timestamp is increased.
+ * In order to make sure that an obstacle is only displayed/checked once, the display code uses a timestamp.
+ * Every time a new frame is displayed, the timestamp is increased.
  * Obstacles with the same timestamp are obstacles that have already been checked.
+ * The collision detection keeps its own marks (see dlc_on_one_level()), so that it is reentrant.
  */
 int next_glue_timestamp(void)
 {
@@ -84,10 +85,10 @@ void free_glued_obstacles(level *lvl)
 }
 
 /**
- * Return a floor tile image for a given floor type.
+ * Return the specification of a given floor type.
  * A floor type can be either underlay or overlay floor tile.
  */
-struct image *get_floor_tile_image(int floor_value)
+struct floor_tile_spec *get_floor_tile_spec(int floor_value)
 {
 	struct dynarray *floor_tiles = &underlay_floor_tiles;
 	// Overlay floor tiles are numbered starting with MAX_UNDERLAY_FLOOR_TILES.
@@ -97,8 +98,16 @@ struct image *get_floor_tile_image(int floor_value)
 		floor_value -= MAX_UNDERLAY_FLOOR_TILES;
 		floor_tiles = &overlay_floor_tiles;
 	}
-	struct floor_tile_spec *floor_tile = dynarray_member(floor_tiles, floor_value, sizeof(struct floor_tile_spec));
-	return floor_tile->current_image;
+	return dynarray_member(floor_tiles, floor_value, sizeof(struct floor_tile_spec));
+}
+
+/**
+ * Return a floor tile image for a given floor type.
+ * A floor type can be either underlay or overlay floor tile.
+ */
+struct image *get_floor_tile_image(int floor_value)
+{
+	return get_floor_tile_spec(floor_value)->current_image;
 }
 
 #undef _floor_tiles_c
@@ -90,6 +90,9 @@ void free_fonts(void)
 {
 	int i;
 
+	// Cached text layouts refer to the fonts' glyphs
+	text_layout_cache_clear();
+
 	for (i = 0; i < sizeof(fonts_def)/sizeof(fonts_def[0]); i++) {
 		free_bfont(&fonts_def[i].font);
 		*fonts_def[i].font_ref = NULL;
@@ -487,6 +487,10 @@ void InitPictures(void)
 	// could box the influencer out of the ship....
 	Activate_Conservative_Frame_Computation();
 
+	// The images are decoded by the image decoder threads, while they are
+	// created in order by the main thread
+	prefetch_floor_tiles_and_obstacles();
+
 	load_floor_tiles();
 
 	next_startup_percentage(19);
@@ -794,7 +798,11 @@ void init_video(void)
 			GameConfig.next_time_width_of_screen = GameConfig.screen_width;
 			GameConfig.next_time_height_of_screen = GameConfig.screen_height;
 		}
-		if (!(Screen = SDL_SetVideoMode(GameConfig.screen_width, GameConfig.screen_height, 0, video_flags))) {
+		// The images are only blended by the compositor on a 32 bits
+		// screen. Keep the depth of the desktop, unless it is a palette
+		// (the default of the dummy video driver).
+		int bpp = (vid_info->vfmt->BitsPerPixel < 15) ? 32 : 0;
+		if (!(Screen = SDL_SetVideoMode(GameConfig.screen_width, GameConfig.screen_height, bpp, video_flags))) {
 			fprintf(stderr, "Video mode set failed: %s\n", SDL_GetError());
 			Terminate(EXIT_FAILURE);
 		}
@@ -817,6 +825,9 @@ void init_video(void)
 		}
 	}
 
+	// Images are created from the asset pack, when there is one
+	open_asset_pack();
+
 	init_fonts();
 
 	blit_background("startup1.jpg");
@@ -851,6 +862,9 @@ void sdl_draw_rectangle(SDL_Rect *rect, int r, int g, int b, int a)
 	// callers of sdl_draw_rectangle expect it to be unchanged, so store it.
 	SDL_Rect old_rect = (*rect);
 
+	// The images recorded by the compositor have to be drawn first
+	sdl_compositor_flush();
+
 	if (a == SDL_ALPHA_OPAQUE) {
 		// Do a rectangle fill operation if the input rectangle is opaque.
 		SDL_FillRect(Screen, rect, SDL_MapRGB(Screen->format, r, g, b));
@@ -883,6 +897,8 @@ void sdl_draw_rectangle(SDL_Rect *rect, int r, int g, int b, int a)
  */
 void draw_rectangle(SDL_Rect *rect, int r, int g, int b, int a)
 {
+	capture_rectangle(rect, r, g, b, a);
+
 	if (use_open_gl) {
 		struct point vertices[] = {
 				{ rect->x,           rect->y           },
@@ -900,6 +916,7 @@ static void sdl_draw_quad(const struct point vertices[4], int r, int g, int b, i
 {
 	Sint16 vx[] = { vertices[0].x, vertices[1].x, vertices[2].x, vertices[3].x };
 	Sint16 vy[] = { vertices[0].y, vertices[1].y, vertices[2].y, vertices[3].y };
+	sdl_compositor_flush();
 	filledPolygonRGBA(Screen, vx, vy, 4, r, g, b, a);
 }
 
@@ -965,6 +982,8 @@ static void draw_line_sdl(int x1, int y1, int x2, int y2, uint8_t r, uint8_t g,
 	if (use_open_gl)
 		return;
 
+	sdl_compositor_flush();
+
 	int delta_x, incr_x;
 	int delta_y, incr_y;
 	int error_accum;
@@ -1099,6 +1118,7 @@ void save_screenshot(const char *filename, int width)
 
 void free_graphics(void)
 {
+	lvledit_overview_free();
 	free_floor_tiles();
 	free_obstacle_graphics();
 	// Free all items graphics. Graphics will be loaded when needed.
@@ -1106,11 +1126,16 @@ void free_graphics(void)
 	// Free all enemies graphics. Graphics for an enemy will be loaded
 	// when the enemy is encountered.
 	free_enemy_graphics();
+	reset_graphics_prefetch();
+	// Free the images which were decoded but never loaded
+	stop_image_decoder();
+	stop_sdl_compositor();
 }
 
 void reload_graphics(void)
 {
 	free_graphics();
+	prefetch_floor_tiles_and_obstacles();
 	load_floor_tiles();
 	load_all_obstacles(FALSE);
 	reload_tux_graphics();
@@ -378,9 +378,9 @@ static void prepare_text_window_content(struct auto_string *str, SDL_Rect *rect)
 		
 		if (index_of_floor_item_below_mouse_cursor != (-1) && obj_lvl != NULL) {
 			gps item_vpos;
-			update_virtual_position(&item_vpos, &(obj_lvl->ItemList[index_of_floor_item_below_mouse_cursor].pos), Me.pos.z);
+			update_virtual_position(&item_vpos, &(ACCESS_FLOOR_ITEM(obj_lvl, index_of_floor_item_below_mouse_cursor).pos), Me.pos.z);
 			if (item_vpos.x != -1) {
-				append_item_description(str, &(obj_lvl->ItemList[index_of_floor_item_below_mouse_cursor]));
+				append_item_description(str, &(ACCESS_FLOOR_ITEM(obj_lvl, index_of_floor_item_below_mouse_cursor)));
 				rect->x =	translate_map_point_to_screen_pixel_x(item_vpos.x, item_vpos.y) + 80;
 				rect->y =	translate_map_point_to_screen_pixel_y(item_vpos.x, item_vpos.y) - 30;
 			}
@@ -392,11 +392,11 @@ static void prepare_text_window_content(struct auto_string *str, SDL_Rect *rect)
 		int index_of_obst_below_mouse_cursor = clickable_obstacle_below_mouse_cursor(&obj_lvl, TRUE);
 		if (index_of_obst_below_mouse_cursor != (-1)) {
 			gps obst_vpos;
-			update_virtual_position(&obst_vpos, &(obj_lvl->obstacle_list[index_of_obst_below_mouse_cursor].pos), Me.pos.z);
+			update_virtual_position(&obst_vpos, &(ACCESS_OBSTACLE(obj_lvl, index_of_obst_below_mouse_cursor).pos), Me.pos.z);
 			if (obst_vpos.x != -1) {
-				char *label =  D_(get_obstacle_spec(obj_lvl->obstacle_list[index_of_obst_below_mouse_cursor].type)->label);
+				char *label =  D_(get_obstacle_spec(ACCESS_OBSTACLE(obj_lvl, index_of_obst_below_mouse_cursor).type)->label);
 				if (!label) {
-					error_message(__FUNCTION__, "Obstacle type %d is clickable, and as such requires a label to be displayed on mouseover.", PLEASE_INFORM, obj_lvl->obstacle_list[index_of_obst_below_mouse_cursor].type);
+					error_message(__FUNCTION__, "Obstacle type %d is clickable, and as such requires a label to be displayed on mouseover.", PLEASE_INFORM, ACCESS_OBSTACLE(obj_lvl, index_of_obst_below_mouse_cursor).type);
 					label = _("No label for this obstacle");
 				}
 
@@ -35,30 +35,37 @@
  * This file contains image related functions.
  * An image can be rendered using SDL, or using OpenGL.
  * In OpenGL mode, we define a "batch" as being a series of images
- * drawn in sequence. OpenGL is designed in such a way that batches should be 
- * emitted without changing the active texture, and in a single glBegin/glEnd pair.
+ * drawn in sequence. The quads of a batch are recorded, and sent to the GPU
+ * with as few draw calls as possible when the batch ends (see image_batch.c).
  */
 
 extern int gl_max_texture_size;	//defined in open_gl.c 
 
-/* Currently active OpenGL textures array.
-   Testing in zoomed out level editor in town showed:
-   1 texture  - 3872 flushes per frame - 71 FPS (Quadro M4000) - 58 FPS (i965) 
-   2 textures - 973 flushes per frame - 85 FPS (Quadro M4000)
-   4 textures - 171 flushes per frame - 100 FPS (Quadro M4000) - 75 FPS (i965)
-*/
-static int active_tex[] = { -1, -1, -1, -1 };
-
-// Requested OpenGL color
-static float requested_color[4];
-
-// Do we want to draw as a batch? (ie. not emit glBegin/glEnd pairs every time)
+// Do we want to draw as a batch? (ie. not send the images to the GPU one by one)
 static int batch_draw = FALSE;
 
 #ifdef HAVE_LIBGL
-static struct dynarray *vtx;
+static struct image_batch_backend gl_batch_backend;
 #endif
 
+/*
+ * An item of a display capture: an image, or a rectangle when img is NULL,
+ * with the clip rectangle it was drawn with.
+ */
+struct captured_item {
+	struct image *img;
+	SDL_Rect rect;
+	struct image_transformation t;
+	uint8_t color[4];
+	SDL_Rect clip;
+};
+
+// Capture being recorded, if any
+static struct display_capture *capture;
+
+// Incremented when an image is deleted, making the captures stale
+static int images_generation = 1;
+
 /**
  * Start rendering images as a batch.
  */
@@ -67,10 +74,6 @@ void start_image_batch()
 	batch_draw = TRUE;
 }
 
-#ifdef HAVE_LIBGL
-static void gl_emit_quads(void);
-#endif
-
 /**
  * End the image batch.
  * @reason is a free form string used for debugging performance issues.
@@ -79,105 +82,275 @@ void end_image_batch(const char *reason)
 {
 	batch_draw = FALSE;
 
-	char str[1024];
-	snprintf(str, 1023, "Flushing batch: %s", reason);
+	if (!use_open_gl) {
+		sdl_compositor_flush();
+		return;
+	}
+
 #ifdef HAVE_LIBGL
-	gl_debug_marker(str);
-	gl_emit_quads();
+	if (gl_debug_markers_enabled()) {
+		char str[1024];
+		snprintf(str, 1023, "Flushing batch: %s", reason);
+		gl_debug_marker(str);
+	}
+	image_batch_flush(&gl_batch_backend);
 #endif
-
-	requested_color[0] = -1;
 }
 
+static void get_display_clip_rect(SDL_Rect *clip)
+{
 #ifdef HAVE_LIBGL
-static void gl_emit_quads(void)
+	if (use_open_gl) {
+		if (!get_gl_clip_rect(clip)) {
+			clip->x = 0;
+			clip->y = 0;
+			clip->w = GameConfig.screen_width;
+			clip->h = GameConfig.screen_height;
+		}
+		return;
+	}
+#endif
+	SDL_GetClipRect(Screen, clip);
+}
+
+static void set_display_clip_rect(SDL_Rect *clip)
 {
-	if (vtx && vtx->size) {
-		use_shader(BLITTER_SHADER);
-#ifdef WITH_RTPROF
-		//probe_counter_set(my_probe, "Batch flushes/frame", 15000, 1);
+	if (use_open_gl)
+		set_gl_clip_rect(clip);
+	else
+		SDL_SetClipRect(Screen, clip);
+}
+
+/**
+ * Start recording the images and the rectangles drawn on the screen into
+ * a display capture, replacing its previous content.
+ * Captures can not be nested.
+ */
+void start_display_capture(struct display_capture *c)
+{
+	c->items.size = 0;
+	c->generation = images_generation;
+	capture = c;
+}
+
+void end_display_capture(void)
+{
+	// The clip rectangle left by the drawing code is restored after a replay
+	capture->end_clip_set = TRUE;
+	if (use_open_gl) {
+#ifdef HAVE_LIBGL
+		capture->end_clip_set = get_gl_clip_rect(&capture->end_clip);
 #endif
+	} else {
+		SDL_GetClipRect(Screen, &capture->end_clip);
+	}
 
-		glColor4fv(requested_color);
+	capture = NULL;
+}
 
-		glVertexPointer(2, GL_FLOAT, 4*sizeof(float), vtx->arr);
-		glTexCoordPointer(2, GL_FLOAT, 4*sizeof(float), (void*)((float*)(vtx->arr)+2));
+/**
+ * Check if a display capture is being recorded.
+ */
+int display_capture_active(void)
+{
+	return capture != NULL;
+}
 
-		glDrawArrays(GL_QUADS, 0, vtx->size * 4);
+static void capture_item(struct captured_item *item)
+{
+	get_display_clip_rect(&item->clip);
+	dynarray_add(&capture->items, item, sizeof(struct captured_item));
+}
 
-#if DEBUG_QUAD_BORDER
-		static float old_r = -1;
-		static float old_g = -1;
-		static float old_b = -1;
-		float r = old_r;
-		float g = old_g;
-		float b = old_b;
-		while (r == old_r) {
-			r = ((float)rand_r(&debug_quad_border_seed) / (float)RAND_MAX);
-			r = roundf(r * 4.0) / 4.0;
-		}
-		old_r = r;
-		while (g == old_g) {
-			g = ((float)rand_r(&debug_quad_border_seed) / (float)RAND_MAX);
-			g = roundf(g * 4.0) / 4.0;
+/**
+ * Record a rectangle drawn by draw_rectangle() in the current display
+ * capture, if any.
+ */
+void capture_rectangle(SDL_Rect *rect, int r, int g, int b, int a)
+{
+	if (!capture)
+		return;
+
+	struct captured_item item = { .img = NULL, .rect = *rect, .color = { r, g, b, a } };
+	capture_item(&item);
+}
+
+/**
+ * Draw again what was recorded in a display capture, with the same clip
+ * rectangles, and leave the clip rectangle the drawing code left.
+ *
+ * \return FALSE if the capture is stale (an image it uses may have been
+ * deleted), in which case nothing is drawn
+ */
+int display_captured(struct display_capture *c)
+{
+	struct captured_item *items = c->items.arr;
+	int i;
+
+	if (c->generation != images_generation)
+		return FALSE;
+
+	for (i = 0; i < c->items.size; i++) {
+		struct captured_item *item = &items[i];
+
+		if (i == 0 || memcmp(&item->clip, &items[i - 1].clip, sizeof(SDL_Rect))) {
+			end_image_batch(__FUNCTION__);
+			set_display_clip_rect(&item->clip);
 		}
-		old_g = g;
-		while (b == old_b) {
-			b = ((float)rand_r(&debug_quad_border_seed) / (float)RAND_MAX);
-			b = roundf(b * 4.0) / 4.0;
+
+		if (!item->img) {
+			end_image_batch(__FUNCTION__);
+			draw_rectangle(&item->rect, item->color[0], item->color[1], item->color[2], item->color[3]);
+			continue;
 		}
-		old_b = b;
-		glColor4f(r, g, b, 1.0);
-		glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-		glVertexPointer(2, GL_FLOAT, 4*sizeof(float), vtx->arr);
-		glDrawArrays(GL_QUADS, 0, vtx->size * 4);
-
-		glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-		glColor4fv(requested_color);
-#endif
 
-		vtx->size = 0;
+		start_image_batch();
+		display_image_on_screen(item->img, item->rect.x, item->rect.y, item->t);
+	}
+
+	end_image_batch(__FUNCTION__);
+
+	if (c->end_clip_set)
+		set_display_clip_rect(&c->end_clip);
+	else
+		unset_gl_clip_rect();
+
+	return TRUE;
+}
+
+#ifdef HAVE_LIBGL
+/* Vertex buffer object the batches are uploaded to, if supported.
+   The quads of a batch are drawn with as many textures as there are texture
+   units, up to 4. Testing in zoomed out level editor in town showed:
+   1 texture  - 3872 flushes per frame - 71 FPS (Quadro M4000) - 58 FPS (i965) 
+   2 textures - 973 flushes per frame - 85 FPS (Quadro M4000)
+   4 textures - 171 flushes per frame - 100 FPS (Quadro M4000) - 75 FPS (i965)
+*/
+static GLuint batch_vbo;
+static int batch_vbo_size;
+
+static int gl_batch_max_textures(void)
+{
+	static int max_texture_units = 0;
+
+	if (!max_texture_units) {
+		glGetIntegerv(GL_MAX_TEXTURE_UNITS, &max_texture_units);
 
-		// Clear the array of bound textures
-		// XXX as a future optimization, no need to clear them, just mark them unused
-		int i;
-		for (i = 0; i < sizeof(active_tex)/sizeof(active_tex[0]); i++) {
-			active_tex[i] = -1;
+		if (get_opengl_quirks() & DISABLE_SHADERS) {
+			// Use a max of 1 texture at once for image drawing if shaders aren't supported
+			max_texture_units = 1;
 		}
 	}
+
+	return max_texture_units;
 }
-#endif
 
-#ifdef HAVE_LIBGL
-static inline void gl_queue_quad(int x1, int y1, int x2, int y2, float tx0, float ty0, float tx1, float ty1, int8_t texunit)
+static void gl_batch_upload(const float *vertices, int nb_quads)
 {
-	if (!vtx) {
-		vtx = dynarray_alloc(16, 16 * sizeof(float));
+	const float *pointer = vertices;
+	int size = nb_quads * 16 * sizeof(float);
+
+	if (!batch_vbo && (GLEW_VERSION_1_5 || GLEW_ARB_vertex_buffer_object))
+		glGenBuffers(1, &batch_vbo);
+
+	if (batch_vbo) {
+		glBindBuffer(GL_ARRAY_BUFFER, batch_vbo);
+		if (size > batch_vbo_size) {
+			batch_vbo_size = max(size, 2 * batch_vbo_size);
+			glBufferData(GL_ARRAY_BUFFER, batch_vbo_size, NULL, GL_STREAM_DRAW);
+		}
+
+		// Orphan the storage used by the previous batch, so that the driver
+		// does not wait for the GPU to be done with it
+		glBufferData(GL_ARRAY_BUFFER, batch_vbo_size, NULL, GL_STREAM_DRAW);
+		glBufferSubData(GL_ARRAY_BUFFER, 0, size, vertices);
+		pointer = NULL;
 	}
-	
-    // Create the vertex attributes: position and texture coordinates. Mangle "tx0" and "tx1" to use them to encode the texture unit to be used. See open_gl_shaders.c for details
-	float v[16] ={ x1, y1, tx0 + 10*texunit, ty0, x1, y2, tx0 + 10*texunit, ty1, x2, y2, tx1 + 10*texunit, ty1, x2, y1, tx1 + 10*texunit, ty0 };
 
-	dynarray_add(vtx, v, 16 * sizeof(float));
+	glVertexPointer(2, GL_FLOAT, 4*sizeof(float), pointer);
+	glTexCoordPointer(2, GL_FLOAT, 4*sizeof(float), pointer + 2);
+}
 
-	/* We have to limit the number of vertices in a single glDrawArrays call.
-	   With the r300 driver, having more than 65532 vertices in a vertex array:
-	   	- Gallium 0.4 on ATI RV370, Mesa 7.10.2): locks up the GPU, forcing a reboot
-		- 2.1 Mesa 7.11-devel (git-fc8c4a3) : ignores vertices above the maximal value, corrupting the rendered image
-		
-	   This workaround is only justified by the state of the r300 driver at the time of this writing, and shall be
-	   removed as soon as r300 is confirmed to work fine with arbitrarily large vertex arrays.
-	   */
-#define MAX_QUADS 16383
-	if (vtx->size >= MAX_QUADS) {
-		gl_debug_marker("Flushing batch because MAX_QUADS reached");
-		gl_emit_quads();
+static void gl_batch_bind_texture(int unit, unsigned int texture)
+{
+	glActiveTexture(GL_TEXTURE0 + unit);
+	glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+static void gl_batch_draw(int first_quad, int nb_quads, const float color[4], int additive)
+{
+	use_shader(BLITTER_SHADER);
+#ifdef WITH_RTPROF
+	//probe_counter_set(my_probe, "Batch flushes/frame", 15000, 1);
+#endif
+
+	// Highlighted images are drawn again with additive blending factors
+	// This increases the lightness too much, but is a quick and easy solution
+	if (additive)
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE);
+
+	glColor4fv(color);
+	glDrawArrays(GL_QUADS, first_quad * 4, nb_quads * 4);
+
+	if (additive)
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+#if DEBUG_QUAD_BORDER
+	static float old_r = -1;
+	static float old_g = -1;
+	static float old_b = -1;
+	float r = old_r;
+	float g = old_g;
+	float b = old_b;
+	while (r == old_r) {
+		r = ((float)rand_r(&debug_quad_border_seed) / (float)RAND_MAX);
+		r = roundf(r * 4.0) / 4.0;
+	}
+	old_r = r;
+	while (g == old_g) {
+		g = ((float)rand_r(&debug_quad_border_seed) / (float)RAND_MAX);
+		g = roundf(g * 4.0) / 4.0;
 	}
+	old_g = g;
+	while (b == old_b) {
+		b = ((float)rand_r(&debug_quad_border_seed) / (float)RAND_MAX);
+		b = roundf(b * 4.0) / 4.0;
+	}
+	old_b = b;
+	glColor4f(r, g, b, 1.0);
+	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+	glDrawArrays(GL_QUADS, first_quad * 4, nb_quads * 4);
+
+	glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
+	glColor4fv(color);
+#endif
+}
+
+static void gl_batch_done(void)
+{
+	// The rest of the code uses client side vertex arrays, and binds its
+	// textures to the first texture unit
+	if (batch_vbo)
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glActiveTexture(GL_TEXTURE0);
+}
+
+static struct image_batch_backend gl_batch_backend = {
+	.max_textures = gl_batch_max_textures,
+	.upload = gl_batch_upload,
+	.bind_texture = gl_batch_bind_texture,
+	.draw = gl_batch_draw,
+	.done = gl_batch_done
+};
+
+static inline void gl_queue_quad(int x1, int y1, int x2, int y2, float tx0, float ty0, float tx1, float ty1, GLuint texture, const float color[4], int additive)
+{
+	image_batch_add_quad(texture, color, additive, x1, y1, x2, y2, tx0, ty0, tx1, ty1);
 }
 #endif
 
 #ifdef HAVE_LIBGL
-static inline void gl_repeat_quad(int x0, int y0, int w, int h, float tx0, float ty0, float tx1, float ty1, float rx, float ry, int8_t texunit)
+static inline void gl_repeat_quad(int x0, int y0, int w, int h, float tx0, float ty0, float tx1, float ty1, float rx, float ry, GLuint texture, const float color[4], int additive)
 {
 	int i, j;
 
@@ -233,7 +406,7 @@ static inline void gl_repeat_quad(int x0, int y0, int w, int h, float tx0, float
 
 				gl_queue_quad(current_x0, current_y0, current_x1, current_y1,
 				              current_tx0, current_ty0, current_tx1, current_ty1,
-				              texunit);
+				              texture, color, additive);
 
 				// Prepare for the next column
 				current_x0 += w;
@@ -247,56 +420,21 @@ static inline void gl_repeat_quad(int x0, int y0, int w, int h, float tx0, float
 }
 #endif
 
-/**
- * Get a texture unit number for the given texture name.
- * Returns the texture unit, or -1 if no texture unit is
- * free (in which case the batch must be flushed so other
- * textures can be bound).
- */
-static int get_texture_unit_for_tex(int tex)
-{
-	int i;
-
-	static int max_texture_units = 0;
-
-	if (!max_texture_units) {
-		glGetIntegerv(GL_MAX_TEXTURE_UNITS, &max_texture_units);
-
-		if (get_opengl_quirks() & DISABLE_SHADERS) {
-			// Use a max of 1 texture at once for image drawing if shaders aren't supported
-			max_texture_units = 1;
-		}
-	}
-
-	for (i = 0; i < sizeof(active_tex)/sizeof(active_tex[0]) && i < max_texture_units; i++) {
-		if (active_tex[i] == tex) {
-			// This texture is already bound, return the texture unit
-			return i;
-		} else if (active_tex[i] == -1) {
-			// There is a free texture unit: bind the texture to it
-			glActiveTexture(GL_TEXTURE0 + i);
-			glBindTexture(GL_TEXTURE_2D, tex);
-			active_tex[i] = tex;
-			return i;
-		}
-	}
-
-	// The texture isn't currently bound, and there is no free slot
-	// to bind it.
-	return -1;
-}
-
 #ifdef HAVE_LIBGL
 /**
  * Draw an image in OpenGL mode.
  *
- * Changes the active texture if necessary, and emits glBegin/glEnd pairs
- * according to the texture switches and whether a batch is required.
+ * Records the quads of the image in the image batch, and sends them to the
+ * GPU at once if no batch is requested.
  * Applies the image transformation.
  *
  */
 static void gl_display_image(struct image *img, int x0, int y0, struct image_transformation *t)
 {
+	// The place of an image in an atlas page changes when the page is compacted
+	if (img->atlas_slot)
+		update_atlas_image(img);
+
 	// If the image is empty, don't do anything
 	if (!img->texture)
 		return;
@@ -308,55 +446,26 @@ static void gl_display_image(struct image *img, int x0, int y0, struct image_tra
 	int xmax = x + img->w * t->scale_x;
 	int ymax = y + img->h * t->scale_y;
 
-	// Change the active color if required
-	if (memcmp(&requested_color[0], &t->c[0], sizeof(requested_color))) {
-		gl_debug_marker("Flushing batch because changing active color");
-		gl_emit_quads();
-		memcpy(&requested_color[0], &t->c[0], sizeof(requested_color));
-	}
-
-	// Bind the texture to a free unit if required
-	int texunit = get_texture_unit_for_tex(img->texture);
-	if (texunit == -1) {
-		gl_debug_marker("Flushing batch because no free texture unit slot");
-		gl_emit_quads();
-		texunit = get_texture_unit_for_tex(img->texture);
-	}
-
 	// Queue the image, once or several times depending on the transformation
-	// mode to apply
-
-	if (t->mode & REPEATED) {
-		gl_repeat_quad(x, y, img->w, img->h, img->tex_x0, img->tex_y0, img->tex_x1, img->tex_y1, t->scale_x, t->scale_y, texunit);
-	} else {
-		gl_queue_quad(x, y, xmax, ymax, img->tex_x0, img->tex_y0, img->tex_x1, img->tex_y1, texunit);
+	// mode to apply. A highlighted image is queued a second time, with
+	// additive blending.
+	int pass;
+	for (pass = 0; pass < ((t->mode & HIGHLIGHTED) ? 2 : 1); pass++) {
+		if (t->mode & REPEATED) {
+			gl_repeat_quad(x, y, img->w, img->h, img->tex_x0, img->tex_y0, img->tex_x1, img->tex_y1, t->scale_x, t->scale_y, img->texture, t->c, pass);
+		} else {
+			gl_queue_quad(x, y, xmax, ymax, img->tex_x0, img->tex_y0, img->tex_x1, img->tex_y1, img->texture, t->c, pass);
+		}
 	}
 
 	if (!batch_draw) {
 		gl_debug_marker("Batch drawing not requested");
-		gl_emit_quads();
-		requested_color[0] = -1; //XXX remove that to avoid redundant flushes
-	}
-
-	if (t->mode & HIGHLIGHTED) {
-		// Highlight? Draw the texture again with additive blending factors
-		// This increases the lightness too much, but is a quick and easy solution
-		gl_debug_marker("Flushing batch to change prepare highlight");
-		gl_emit_quads();
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE);
-		if (t->mode & REPEATED) {
-			gl_repeat_quad(x, y, img->w, img->h, img->tex_x0, img->tex_y0, img->tex_x1, img->tex_y1, t->scale_x, t->scale_y, texunit);
-		} else {
-			gl_queue_quad(x, y, xmax, ymax, img->tex_x0, img->tex_y0, img->tex_x1, img->tex_y1, texunit);
-		}
-		gl_debug_marker("Flushing batch to do highlight");
-		gl_emit_quads();
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		image_batch_flush(&gl_batch_backend);
 	}
 }
 #endif
 
-static struct SDL_Surface *repeatSurface(struct image *img, float rx, float ry)
+static struct SDL_Surface *repeatSurface(struct image *img, SDL_Surface *img_surf, float rx, float ry)
 {
 	// (see introduction comment of gl_repeat_quad())
 
@@ -367,7 +476,7 @@ static struct SDL_Surface *repeatSurface(struct image *img, float rx, float ry)
 	struct SDL_Surface *surf = SDL_CreateRGBSurface(0, img->w * rx, img->h * ry, 32, rmask, gmask, bmask, amask);
 	struct SDL_Surface *repeated_surf = SDL_DisplayFormatAlpha(surf);
 	SDL_FreeSurface(surf);
-	SDL_SetAlpha(img->surface, 0, 1);
+	SDL_SetAlpha(img_surf, 0, 1);
 	SDL_SetAlpha(repeated_surf, SDL_SRCALPHA | SDL_RLEACCEL, 0);
 
 	// Width and height to use on the last column and the last row
@@ -405,7 +514,7 @@ static struct SDL_Surface *repeatSurface(struct image *img, float rx, float ry)
 
 			SDL_Rect from_rect = { .x = 0, .y = 0, .w = blit_w, .h = blit_h };
 			SDL_Rect to_rect   = { .x = blit_x, .y = blit_y, .w = blit_w, .h = blit_h };
-			SDL_BlitSurface(img->surface, &from_rect, repeated_surf, &to_rect);
+			SDL_BlitSurface(img_surf, &from_rect, repeated_surf, &to_rect);
 
 			// Prepare for next column: increment X-position of the destination
 			blit_x += img->w;
@@ -417,65 +526,112 @@ static struct SDL_Surface *repeatSurface(struct image *img, float rx, float ry)
 
 	return repeated_surf;
 }
+
+static SDL_Surface *copy_subsurface(SDL_Surface *surface, SDL_Rect *rect);
+
+/**
+ * Get the zoomed, repeated and/or colored version of an image, creating it
+ * if it is not the one in cache.
+ */
+static SDL_Surface *get_transformed_surface(struct image *img, SDL_Surface *img_surf, SDL_Rect *source_rect, struct image_transformation *t)
+{
+	float white[4] = { 1.0, 1.0, 1.0, 1.0 };
+
+	// Check if the transformation is in cache, and create it if needed
+	struct image_transformation *cache = &img->cached_transformation;
+
+	if (!cache->surface || cache->scale_x != t->scale_x || cache->scale_y != t->scale_y || memcmp(&cache->c[0], &t->c[0], sizeof(t->c)) || cache->mode != t->mode) {
+
+		// The transformations work on a whole surface
+		if (source_rect)
+			img_surf = copy_subsurface(img_surf, source_rect);
+
+		// Transform (if needed) the image, holding it temporarily in the
+		// image_transformation structure
+		if (t->scale_x == 1.0 && t->scale_y == 1.0) {
+			t->surface = img_surf;
+		} else {
+			if (t->mode & REPEATED) {
+				t->surface = repeatSurface(img, img_surf, t->scale_x, t->scale_y);
+			} else {
+				t->surface = zoomSurface(img_surf, t->scale_x, t->scale_y, TRUE);
+			}
+		}
+
+		// Apply color filter on the image
+		if (memcmp(&t->c[0], &white[0], sizeof(white)) || (t->mode & HIGHLIGHTED)) {
+			SDL_Surface *tmp = sdl_create_colored_surface(t->surface, t->c[0], t->c[1], t->c[2], t->c[3], (t->mode & HIGHLIGHTED) ? 64 : 0);
+			if (t->surface != img_surf)
+				SDL_FreeSurface(t->surface);
+			t->surface = tmp;
+		}
+
+		if (source_rect && img_surf != t->surface)
+			SDL_FreeSurface(img_surf);
+
+		// Cache the transformation we have done
+		if (cache->surface) {
+			SDL_FreeSurface(cache->surface);
+		}
+		*cache = *t;
+	}
+
+	// Use the transformed surface in the cache
+	return cache->surface;
+}
+
 /**
  * Draw an image in SDL mode.
+ * The drawing is done by the compositor, at the end of the image batch.
+ * When the compositor can blend the image, it also applies the color
+ * filter, so that only the zoomed or repeated version of the image has to
+ * be created.
  */
 static void sdl_display_image(struct image *img, int x, int y, struct image_transformation *t)
 {
-	SDL_Rect target_rectangle = { .x = x, .y = y };
+	SDL_Rect atlas_rect;
+	SDL_Rect *source_rect = NULL;
+	SDL_Surface *img_surf = img->surface;
 	SDL_Surface *surf;
 
+	// The pixels of an image packed in an atlas are in the page surface
+	if (img->atlas_slot) {
+		img_surf = get_atlas_image_surface(img, &atlas_rect);
+		source_rect = &atlas_rect;
+	}
+
 	// If the image is empty, don't do anything
-	if (!img->surface)
+	if (!img_surf)
 		return;
 
-	// Check if the image must be transformed at all
 	float white[4] = { 1.0, 1.0, 1.0, 1.0 };
+	struct image_transformation geometry = *t;
+	int blend = sdl_compositor_can_blend(img_surf);
+
+	if (blend) {
+		memcpy(&geometry.c[0], &white[0], sizeof(white));
+		geometry.mode &= REPEATED;
+	}
 
-	if (t->scale_x == 1.0 && t->scale_y == 1.0 && !memcmp(&t->c[0], &white[0], sizeof(white)) && !(t->mode & HIGHLIGHTED)) {
+	// Check if the image must be transformed at all
+	if (geometry.scale_x == 1.0 && geometry.scale_y == 1.0 && !memcmp(&geometry.c[0], &white[0], sizeof(white)) && !(geometry.mode & HIGHLIGHTED)) {
 		// No transformation
-		surf = img->surface;
+		surf = img_surf;
 	} else {
-		// Check if the transformation is in cache, and create it if needed
-		struct image_transformation *cache = &img->cached_transformation;
-
-		if (!cache->surface || cache->scale_x != t->scale_x || cache->scale_y != t->scale_y || memcmp(&cache->c[0], &t->c[0], sizeof(t->c)) || cache->mode != t->mode) {
-
-			// Transform (if needed) the image, holding it temporarily in the
-			// image_transformation structure
-			if (t->scale_x == 1.0 && t->scale_y == 1.0) {
-				t->surface = img->surface;
-			} else {
-				if (t->mode & REPEATED) {
-					t->surface = repeatSurface(img, t->scale_x, t->scale_y);
-				} else {
-					t->surface = zoomSurface(img->surface, t->scale_x, t->scale_y, TRUE);
-				}
-			}
-
-			// Apply color filter on the image
-			if (memcmp(&t->c[0], &white[0], sizeof(white)) || (t->mode & HIGHLIGHTED)) {
-				SDL_Surface *tmp = sdl_create_colored_surface(t->surface, t->c[0], t->c[1], t->c[2], t->c[3], (t->mode & HIGHLIGHTED) ? 64 : 0);
-				if (t->surface != img->surface)
-					SDL_FreeSurface(t->surface);
-				t->surface = tmp;
-			}
-
-			// Cache the transformation we have done
-			if (cache->surface) {
-				SDL_FreeSurface(cache->surface);
-			}
-			*cache = *t;
-		}
-
-		// Use the transformed surface in the cache
-		surf = cache->surface;
+		surf = get_transformed_surface(img, img_surf, source_rect, &geometry);
+		source_rect = NULL;
 	}
 
-	target_rectangle.x += img->offset_x * t->scale_x;
-	target_rectangle.y += img->offset_y * t->scale_y;
+	x += img->offset_x * t->scale_x;
+	y += img->offset_y * t->scale_y;
+
+	if (blend)
+		sdl_compositor_blit(surf, source_rect, x, y, t->c, t->mode & HIGHLIGHTED);
+	else
+		sdl_compositor_blit(surf, source_rect, x, y, white, FALSE);
 
-	SDL_BlitSurface(surf, NULL, Screen, &target_rectangle);
+	if (!batch_draw)
+		sdl_compositor_flush();
 }
 
 /**
@@ -483,6 +639,12 @@ static void sdl_display_image(struct image *img, int x, int y, struct image_tran
  */
 void display_image_on_screen(struct image *img, int x, int y, struct image_transformation t)
 {
+	if (capture) {
+		struct captured_item item = { .img = img, .rect = { .x = x, .y = y }, .t = t };
+		item.t.surface = NULL;
+		capture_item(&item);
+	}
+
 #ifdef HAVE_LIBGL
 	if (use_open_gl)
 		gl_display_image(img, x, y, &t);
@@ -523,6 +685,7 @@ void create_subimage(struct image *source, struct image *new_img, SDL_Rect *rect
 {
 	// Set image width and height
 	*new_img = *source;
+	new_img->atlas_slot = NULL;
 	new_img->w = rect->w;
 	new_img->h = rect->h;
 
@@ -566,20 +729,25 @@ void create_subimage(struct image *source, struct image *new_img, SDL_Rect *rect
 }
 
 /**
- * Load an image from the disk into an SDL_Surface. Also, if needed, add a
- * transparency channel and swap color channels to suit the framebuffer
+ * Decode an image file into an SDL_Surface. Also add a transparency channel
+ * if needed, and swap color channels to suit the framebuffer.
  *
- * \param filepath Path the image
+ * This function does not report errors, so that it can be called by the
+ * image decoder threads.
+ *
+ * \param filepath   Path of the image
+ * \param error      Filled with the error message, on error
+ * \param error_size Size of the 'error' buffer
  *
  * \return A pointer to the created SDL_Surface, or NULL on error
  */
-SDL_Surface *load_surface_bitmap(const char *filepath)
+SDL_Surface *decode_surface_bitmap(const char *filepath, char *error, size_t error_size)
 {
 	SDL_Surface *surf, *prepared_surf;
 
 	surf = IMG_Load(filepath);
 	if (surf == NULL) {
-		error_message(__FUNCTION__, "Could not load image.\n File name: %s. IMG_GetError(): %s.", PLEASE_INFORM, filepath, IMG_GetError());
+		snprintf(error, error_size, "%s", IMG_GetError());
 		return (NULL);
 	}
 
@@ -589,9 +757,35 @@ SDL_Surface *load_surface_bitmap(const char *filepath)
 	prepared_surf = SDL_DisplayFormatAlpha(surf);
 	SDL_FreeSurface(surf);
 
+	if (prepared_surf == NULL)
+		snprintf(error, error_size, "%s", SDL_GetError());
+
 	return prepared_surf;
 }
 
+/**
+ * Load an image from the disk into an SDL_Surface. Also, if needed, add a
+ * transparency channel and swap color channels to suit the framebuffer
+ *
+ * \param filepath Path the image
+ *
+ * \return A pointer to the created SDL_Surface, or NULL on error
+ */
+SDL_Surface *load_surface_bitmap(const char *filepath)
+{
+	SDL_Surface *surf;
+	char error[256];
+
+	// The image may have been decoded by the image decoder threads already
+	if (!take_decoded_image(filepath, &surf, error, sizeof(error)))
+		surf = decode_surface_bitmap(filepath, error, sizeof(error));
+
+	if (surf == NULL)
+		error_message(__FUNCTION__, "Could not load image.\n File name: %s. IMG_GetError(): %s.", PLEASE_INFORM, filepath, error);
+
+	return surf;
+}
+
 /**
  * The concept of an image involves an SDL_Surface or an OpenGL
  * texture and also suitable offset values, such that the image can be
@@ -627,23 +821,66 @@ void load_image_surface(struct image *img, const char *filepath, int mod_flags)
 }
 
 /**
- * Load an image: load the SDL surface, and make a texture from it in OpenGL mode.
- * \param img Pointer towards the iso_image struct to fill in
- * \param filename Filename of the image
- * \param mod_flags Modifications to apply */
-void load_image(struct image *img, int subdir_handle, const char *filename, int mod_flags)
+ * Find the wide version of an image, if the image has one and the screen
+ * is wide.
+ *
+ * \return TRUE if the wide version is to be used, its path is then in 'fpath'
+ */
+static int find_wide_image_file(char *fpath, int subdir_handle, const char *filename, int mod_flags)
 {
-	char fpath[PATH_MAX];
-
 	if (mod_flags & USE_WIDE) {
 		int need_wide_version = (GameConfig.screen_width / (float)GameConfig.screen_height) >= ((16/9.0 + 4/3.0) / 2.0);
 		if (need_wide_version) {
 			// Try to load the wide version
 			if (find_suffixed_file(fpath, subdir_handle, filename, "_wide", SILENT))
-				goto IMAGE_FILE_FOUND;
+				return TRUE;
 		}
 	}
 
+	return FALSE;
+}
+
+/**
+ * Start decoding an image file on the image decoder threads. The image is
+ * to be loaded later with load_image(), using the same parameters, which
+ * will then take the decoded surface instead of decoding the file.
+ *
+ * Nothing is done if the image is in the asset pack, or if there is no
+ * decoder thread.
+ * \param filename Filename of the image
+ * \param mod_flags Modifications which will be applied by load_image() */
+void prefetch_image(int subdir_handle, const char *filename, int mod_flags)
+{
+	char fpath[PATH_MAX];
+
+	if (!find_wide_image_file(fpath, subdir_handle, filename, mod_flags)) {
+		if (subdir_handle == GRAPHICS_DIR && asset_pack_has_image(filename))
+			return;
+
+		// Errors are reported by load_image()
+		if (!find_file(fpath, subdir_handle, filename, NULL, SILENT))
+			return;
+	}
+
+	queue_image_decoding(fpath);
+}
+
+/**
+ * Load an image: load the SDL surface, and make a texture from it in OpenGL mode.
+ * \param img Pointer towards the iso_image struct to fill in
+ * \param filename Filename of the image
+ * \param mod_flags Modifications to apply */
+void load_image(struct image *img, int subdir_handle, const char *filename, int mod_flags)
+{
+	char fpath[PATH_MAX];
+
+	if (find_wide_image_file(fpath, subdir_handle, filename, mod_flags))
+		goto IMAGE_FILE_FOUND;
+
+	// Use the already decoded version of the image, if it is in the asset pack
+	if (subdir_handle == GRAPHICS_DIR && load_image_from_asset_pack(img, filename, mod_flags))
+		goto IMAGE_LOADED;
+
 	// Try to load the narrow version
 	if (!find_file(fpath, subdir_handle, filename, NULL, PLEASE_INFORM)) {
 		struct image empty = EMPTY_IMAGE;
@@ -655,6 +892,11 @@ IMAGE_FILE_FOUND:
 
 	load_image_surface(img, fpath, mod_flags);
 
+IMAGE_LOADED:
+
+	if ((mod_flags & PACK_IN_ATLAS) && pack_image_in_atlas(img))
+		return;
+
 #ifdef HAVE_LIBGL
 	if (use_open_gl && (img->w > gl_max_texture_size || img->h > gl_max_texture_size)) {
 		error_message(__FUNCTION__, "Your system only supports %dx%d textures. Image %s is %dx%d and therefore cannot be used as an OpenGL texture.",
@@ -691,12 +933,17 @@ void free_image_surface(struct image *img)
  */
 void delete_image(struct image *img)
 {
+	images_generation++;
 	free_image_surface(img);
 
+	if (img->atlas_slot)
+		release_atlas_image(img);
+
 #ifdef HAVE_LIBGL
 	// Only delete 'master' texture (i.e. no sub-texture)
 	if (img->texture_type == TEXTURE_CREATED) {
 		glDeleteTextures(1, &img->texture);
+		image_batch_forget_textures();
 	}
 #endif
 
@@ -715,7 +962,7 @@ void delete_image(struct image *img)
  */
 int image_loaded(struct image *img)
 {
-	if ((img->surface == NULL) && (img->texture_type == NO_TEXTURE)) {
+	if ((img->surface == NULL) && (img->texture_type == NO_TEXTURE) && (img->atlas_slot == NULL)) {
 		return FALSE;
 	}
 
@@ -0,0 +1,534 @@
+/*
+ *
+ *   Copyright (c) 2026 FreedroidRPG development team
+ *
+ *
+ *  This file is part of Freedroid
+ *
+ *  Freedroid is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Freedroid is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Freedroid; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ *  MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file image_atlas.c
+ * \brief Packing of the images loaded at runtime into shared atlas pages.
+ *
+ * The images loaded with the PACK_IN_ATLAS flag do not get their own
+ * surface or texture: their pixels are copied into a page shared with other
+ * images, so that they can be drawn in the same batch in OpenGL mode.
+ *
+ * The free space of a page is tracked with a skyline: the list of the top
+ * edges of the free space, from left to right. A new image is put at the
+ * position where the skyline is the lowest ('bottom-left' heuristic, the top
+ * of the page being the bottom here).
+ * The space of a deleted image is not given back to the skyline. When too
+ * much of the space under the skyline is lost, the page is compacted: its
+ * images are packed again from scratch, and the page is uploaded again.
+ *
+ * The pixels of the pages are kept in an SDL surface in both rendering
+ * modes. In SDL mode, the images are blitted from it. In OpenGL mode, it is
+ * used to re-upload the page texture after a compaction.
+ */
+
+#define _image_atlas_c 1
+
+#include "system.h"
+
+#include <limits.h>
+
+#include "defs.h"
+#include "struct.h"
+#include "global.h"
+#include "proto.h"
+
+#define ATLAS_PAGE_SIZE 1024
+#define ATLAS_MAX_IMAGE_SIZE 256
+
+// Transparent space kept at the right and at the bottom of each image, so
+// that the texture filtering does not bleed the neighbours into it
+#define ATLAS_PADDING 1
+
+struct atlas_page {
+	struct list_head node;
+	struct atlas_skyline skyline;
+	struct list_head slots;         // Images in the page
+	int live_area;                  // Area used by the images, padding included
+	SDL_Surface *surface;
+#ifdef HAVE_LIBGL
+	GLuint texture;
+#endif
+};
+
+static LIST_HEAD(atlas_pages);
+
+#ifdef HAVE_LIBGL
+extern int gl_max_texture_size;	//defined in open_gl.c
+#endif
+
+/**
+ * Initialize the skyline of an empty page.
+ */
+void atlas_skyline_init(struct atlas_skyline *skyline, int w, int h)
+{
+	struct atlas_skyline_node first = { .x = 0, .y = 0, .w = w };
+
+	skyline->w = w;
+	skyline->h = h;
+	dynarray_init(&skyline->nodes, 16, sizeof(struct atlas_skyline_node));
+	dynarray_add(&skyline->nodes, &first, sizeof(struct atlas_skyline_node));
+}
+
+void atlas_skyline_free(struct atlas_skyline *skyline)
+{
+	dynarray_free(&skyline->nodes);
+}
+
+/**
+ * Compute the height at which a rectangle would be put, if its left edge
+ * is on the given skyline node.
+ *
+ * \return The y position of the rectangle, or -1 if it does not fit
+ */
+static int skyline_fit(struct atlas_skyline *skyline, int index, int w, int h)
+{
+	struct atlas_skyline_node *nodes = skyline->nodes.arr;
+	int width_left = w;
+	int y = 0;
+
+	if (nodes[index].x + w > skyline->w)
+		return -1;
+
+	while (width_left > 0) {
+		y = max(y, nodes[index].y);
+		if (y + h > skyline->h)
+			return -1;
+		width_left -= nodes[index].w;
+		index++;
+	}
+
+	return y;
+}
+
+/**
+ * Find a place for a rectangle under the skyline, and raise the skyline
+ * over it.
+ *
+ * \return FALSE if the rectangle does not fit
+ */
+int atlas_skyline_insert(struct atlas_skyline *skyline, int w, int h, int *x, int *y)
+{
+	struct atlas_skyline_node *nodes = skyline->nodes.arr;
+	int best_index = -1;
+	int best_bottom = INT_MAX;
+	int best_width = INT_MAX;
+	int i;
+
+	for (i = 0; i < skyline->nodes.size; i++) {
+		int fit_y = skyline_fit(skyline, i, w, h);
+		if (fit_y < 0)
+			continue;
+
+		// Prefer the lowest position, then the narrowest gap
+		if (fit_y + h < best_bottom || (fit_y + h == best_bottom && nodes[i].w < best_width)) {
+			best_index = i;
+			best_bottom = fit_y + h;
+			best_width = nodes[i].w;
+			*x = nodes[i].x;
+			*y = fit_y;
+		}
+	}
+
+	if (best_index < 0)
+		return FALSE;
+
+	// Insert the top edge of the rectangle in the skyline
+	struct atlas_skyline_node new_node = { .x = *x, .y = *y + h, .w = w };
+	dynarray_add(&skyline->nodes, &new_node, sizeof(struct atlas_skyline_node));
+	nodes = skyline->nodes.arr;
+	memmove(&nodes[best_index + 1], &nodes[best_index], (skyline->nodes.size - 1 - best_index) * sizeof(struct atlas_skyline_node));
+	nodes[best_index] = new_node;
+
+	// Cut the nodes now hidden under the rectangle
+	i = best_index + 1;
+	while (i < skyline->nodes.size) {
+		int overlap = nodes[i - 1].x + nodes[i - 1].w - nodes[i].x;
+		if (overlap <= 0)
+			break;
+
+		if (overlap < nodes[i].w) {
+			nodes[i].x += overlap;
+			nodes[i].w -= overlap;
+			break;
+		}
+
+		dynarray_del(&skyline->nodes, i, sizeof(struct atlas_skyline_node));
+		nodes = skyline->nodes.arr;
+	}
+
+	// Merge the neighbours at the same height
+	for (i = 0; i < skyline->nodes.size - 1; i++) {
+		if (nodes[i].y == nodes[i + 1].y) {
+			nodes[i].w += nodes[i + 1].w;
+			dynarray_del(&skyline->nodes, i + 1, sizeof(struct atlas_skyline_node));
+			nodes = skyline->nodes.arr;
+			i--;
+		}
+	}
+
+	return TRUE;
+}
+
+/**
+ * Compute the area under the skyline, which is the area used by the
+ * rectangles inserted since the initialization, and the holes between them.
+ */
+int atlas_skyline_used_area(struct atlas_skyline *skyline)
+{
+	struct atlas_skyline_node *nodes = skyline->nodes.arr;
+	int area = 0;
+	int i;
+
+	for (i = 0; i < skyline->nodes.size; i++)
+		area += nodes[i].w * nodes[i].y;
+
+	return area;
+}
+
+static SDL_Surface *create_page_surface(int size)
+{
+	SDL_Surface *surf = SDL_CreateRGBSurface(0, size, size, 32, rmask, gmask, bmask, amask);
+	SDL_Surface *page_surf = SDL_DisplayFormatAlpha(surf);
+	SDL_FreeSurface(surf);
+
+	// No RLE acceleration: images are blitted into the page
+	if (page_surf)
+		SDL_SetAlpha(page_surf, SDL_SRCALPHA, 0);
+
+	return page_surf;
+}
+
+static int page_size(void)
+{
+#ifdef HAVE_LIBGL
+	if (use_open_gl)
+		return min(ATLAS_PAGE_SIZE, gl_max_texture_size);
+#endif
+	return ATLAS_PAGE_SIZE;
+}
+
+/**
+ * Send a part of the pixels of a page to its texture.
+ */
+static void upload_page_rect(struct atlas_page *page, SDL_Rect *rect)
+{
+#ifdef HAVE_LIBGL
+	if (use_open_gl)
+		update_texture_rect(page->texture, page->surface, rect);
+#endif
+}
+
+static struct atlas_page *new_atlas_page(void)
+{
+	int size = page_size();
+	SDL_Surface *surf = create_page_surface(size);
+
+	if (!surf) {
+		error_message(__FUNCTION__, "Could not create a %dx%d atlas page: %s", NO_REPORT, size, size, SDL_GetError());
+		return NULL;
+	}
+
+	struct atlas_page *page = MyMalloc(sizeof(struct atlas_page));
+	atlas_skyline_init(&page->skyline, size, size);
+	INIT_LIST_HEAD(&page->slots);
+	page->live_area = 0;
+	page->surface = surf;
+
+#ifdef HAVE_LIBGL
+	if (use_open_gl) {
+		SDL_Rect all = { .x = 0, .y = 0, .w = size, .h = size };
+		page->texture = create_empty_texture(size, size);
+		upload_page_rect(page, &all);
+	}
+#endif
+
+	list_add_tail(&page->node, &atlas_pages);
+	return page;
+}
+
+static void free_atlas_page(struct atlas_page *page)
+{
+#ifdef HAVE_LIBGL
+	if (use_open_gl) {
+		end_image_batch(__FUNCTION__);
+		glDeleteTextures(1, &page->texture);
+		image_batch_forget_textures();
+	}
+#endif
+
+	SDL_FreeSurface(page->surface);
+	atlas_skyline_free(&page->skyline);
+	list_del(&page->node);
+	free(page);
+}
+
+struct compacted_slot {
+	struct atlas_slot *slot;
+	SDL_Rect rect;
+};
+
+static int compare_slot_heights(const void *a, const void *b)
+{
+	const struct compacted_slot *sa = a;
+	const struct compacted_slot *sb = b;
+
+	if (sa->slot->rect.h != sb->slot->rect.h)
+		return sb->slot->rect.h - sa->slot->rect.h;
+	return sb->slot->rect.w - sa->slot->rect.w;
+}
+
+/**
+ * Pack the images of a page again from scratch, to give back the space
+ * of the deleted images to the skyline. The page is not changed if its
+ * images do not fit in the new layout.
+ *
+ * \return TRUE if the page was compacted
+ */
+static int compact_atlas_page(struct atlas_page *page)
+{
+	struct atlas_skyline skyline;
+	struct compacted_slot *slots;
+	struct atlas_slot *slot;
+	int nb_slots = 0;
+	int i;
+
+	list_for_each_entry(slot, &page->slots, node)
+		nb_slots++;
+
+	slots = MyMalloc(nb_slots * sizeof(struct compacted_slot));
+	i = 0;
+	list_for_each_entry(slot, &page->slots, node)
+		slots[i++].slot = slot;
+
+	// Tallest images first: they leave the smallest holes
+	qsort(slots, nb_slots, sizeof(struct compacted_slot), compare_slot_heights);
+
+	atlas_skyline_init(&skyline, page->skyline.w, page->skyline.h);
+	for (i = 0; i < nb_slots; i++) {
+		SDL_Rect *old_rect = &slots[i].slot->rect;
+		int x, y;
+
+		if (!atlas_skyline_insert(&skyline, old_rect->w + ATLAS_PADDING, old_rect->h + ATLAS_PADDING, &x, &y)) {
+			atlas_skyline_free(&skyline);
+			free(slots);
+			return FALSE;
+		}
+
+		slots[i].rect.x = x;
+		slots[i].rect.y = y;
+		slots[i].rect.w = old_rect->w;
+		slots[i].rect.h = old_rect->h;
+	}
+
+	SDL_Surface *surf = create_page_surface(page->skyline.w);
+	if (!surf) {
+		atlas_skyline_free(&skyline);
+		free(slots);
+		return FALSE;
+	}
+
+	// Move the pixels of the images to their new place
+	SDL_SetAlpha(page->surface, 0, SDL_ALPHA_OPAQUE);
+	for (i = 0; i < nb_slots; i++) {
+		SDL_Rect dst = slots[i].rect;
+		SDL_BlitSurface(page->surface, &slots[i].slot->rect, surf, &dst);
+		slots[i].slot->rect = slots[i].rect;
+	}
+	free(slots);
+
+	SDL_FreeSurface(page->surface);
+	page->surface = surf;
+	atlas_skyline_free(&page->skyline);
+	page->skyline = skyline;
+
+	SDL_Rect all = { .x = 0, .y = 0, .w = surf->w, .h = surf->h };
+	upload_page_rect(page, &all);
+
+	return TRUE;
+}
+
+/**
+ * Find a place for an image of the given size in the existing pages,
+ * compacting them if needed, or in a new page.
+ */
+static struct atlas_page *find_atlas_space(int w, int h, int *x, int *y)
+{
+	struct atlas_page *page;
+	int area = w * h;
+
+	list_for_each_entry(page, &atlas_pages, node) {
+		if (atlas_skyline_insert(&page->skyline, w, h, x, y))
+			return page;
+	}
+
+	// Compact the pages which lost enough space to take the image
+	list_for_each_entry(page, &atlas_pages, node) {
+		int lost_area = atlas_skyline_used_area(&page->skyline) - page->live_area;
+		if (lost_area < area)
+			continue;
+
+		if (compact_atlas_page(page) && atlas_skyline_insert(&page->skyline, w, h, x, y))
+			return page;
+	}
+
+	page = new_atlas_page();
+	if (page && atlas_skyline_insert(&page->skyline, w, h, x, y))
+		return page;
+
+	return NULL;
+}
+
+/**
+ * Fill in the texture and the texture coordinates of an image packed in an
+ * atlas page. They change when the page is compacted.
+ */
+void update_atlas_image(struct image *img)
+{
+#ifdef HAVE_LIBGL
+	struct atlas_page *page = img->atlas_slot->page;
+	SDL_Rect *rect = &img->atlas_slot->rect;
+	float page_w = page->skyline.w;
+	float page_h = page->skyline.h;
+
+	img->texture = page->texture;
+	img->tex_w = page->skyline.w;
+	img->tex_h = page->skyline.h;
+	img->tex_x0 = rect->x / page_w;
+	img->tex_x1 = (rect->x + rect->w) / page_w;
+	img->tex_y0 = rect->y / page_h;
+	img->tex_y1 = (rect->y + rect->h) / page_h;
+#endif
+}
+
+/**
+ * Get the surface holding the pixels of an image packed in an atlas page.
+ *
+ * \param rect Filled with the position of the image in the surface
+ */
+SDL_Surface *get_atlas_image_surface(struct image *img, SDL_Rect *rect)
+{
+	*rect = img->atlas_slot->rect;
+	return img->atlas_slot->page->surface;
+}
+
+/**
+ * Move the pixels of an image into an atlas page. The SDL surface of the
+ * image is freed, and the image then uses a part of the page.
+ * Images larger than ATLAS_MAX_IMAGE_SIZE are not packed.
+ *
+ * \return TRUE if the image was packed
+ */
+int pack_image_in_atlas(struct image *img)
+{
+	SDL_Surface *surf = img->surface;
+	int x, y;
+
+	if (!surf || img->texture_type != NO_TEXTURE || img->atlas_slot)
+		return FALSE;
+
+	if (surf->w > ATLAS_MAX_IMAGE_SIZE || surf->h > ATLAS_MAX_IMAGE_SIZE)
+		return FALSE;
+
+	struct atlas_page *page = find_atlas_space(surf->w + ATLAS_PADDING, surf->h + ATLAS_PADDING, &x, &y);
+	if (!page)
+		return FALSE;
+
+	struct atlas_slot *slot = MyMalloc(sizeof(struct atlas_slot));
+	slot->page = page;
+	slot->rect.x = x;
+	slot->rect.y = y;
+	slot->rect.w = surf->w;
+	slot->rect.h = surf->h;
+	list_add_tail(&slot->node, &page->slots);
+	page->live_area += (surf->w + ATLAS_PADDING) * (surf->h + ATLAS_PADDING);
+
+	// Copy the pixels, alpha channel included
+	SDL_Rect dst = slot->rect;
+	SDL_SetAlpha(surf, 0, SDL_ALPHA_OPAQUE);
+	SDL_BlitSurface(surf, NULL, page->surface, &dst);
+	upload_page_rect(page, &slot->rect);
+
+	free_image_surface(img);
+	img->atlas_slot = slot;
+
+#ifdef HAVE_LIBGL
+	if (use_open_gl) {
+		img->texture_type = TEXTURE_CREATED | IS_SUBTEXTURE;
+		update_atlas_image(img);
+	}
+#endif
+
+	return TRUE;
+}
+
+/**
+ * Give back the space of an image to its atlas page. The page is freed
+ * when its last image is released, and compacted when more than half of
+ * the space under its skyline is lost.
+ */
+void release_atlas_image(struct image *img)
+{
+	struct atlas_slot *slot = img->atlas_slot;
+	struct atlas_page *page = slot->page;
+
+	page->live_area -= (slot->rect.w + ATLAS_PADDING) * (slot->rect.h + ATLAS_PADDING);
+	list_del(&slot->node);
+	free(slot);
+	img->atlas_slot = NULL;
+
+	if (list_empty(&page->slots)) {
+		free_atlas_page(page);
+		return;
+	}
+
+	int lost_area = atlas_skyline_used_area(&page->skyline) - page->live_area;
+	if (lost_area > page->live_area && lost_area > page->skyline.w * page->skyline.h / 8)
+		compact_atlas_page(page);
+}
+
+/**
+ * Compute the occupancy of the atlas pages, for statistics.
+ *
+ * \param nb_pages  Filled with the number of pages
+ * \param live_area Filled with the area used by the images, in pixels
+ * \return The total area of the pages, in pixels
+ */
+int get_image_atlas_usage(int *nb_pages, int *live_area)
+{
+	struct atlas_page *page;
+	int total_area = 0;
+
+	*nb_pages = 0;
+	*live_area = 0;
+	list_for_each_entry(page, &atlas_pages, node) {
+		(*nb_pages)++;
+		*live_area += page->live_area;
+		total_area += page->skyline.w * page->skyline.h;
+	}
+
+	return total_area;
+}
+
+#undef _image_atlas_c
@@ -0,0 +1,302 @@
+/*
+ *
+ *   Copyright (c) 2026 FreedroidRPG development team
+ *
+ *
+ *  This file is part of Freedroid
+ *
+ *  Freedroid is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Freedroid is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Freedroid; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ *  MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file image_batch.c
+ * \brief Recording and sorting of the image draws of a batch.
+ *
+ * In OpenGL mode, the quads of the images drawn during an image batch are
+ * recorded, with their texture, color and blending mode, and are only sent
+ * to the GPU when the batch ends.
+ *
+ * The recorded quads are grouped by state: a quad joins the last group
+ * with the same state, unless it overlaps one of the groups recorded after
+ * it, in which case the drawing order (the isometric order, for the map) has
+ * to be kept. The vertices of all the groups are then uploaded at once, and
+ * the groups are drawn with as few draw calls as possible: consecutive
+ * groups with the same color and blending mode are drawn together, each
+ * texture being bound to its own texture unit.
+ *
+ * Nothing here calls OpenGL: the upload, the texture bindings and the draw
+ * calls are done by a backend, so that the batching can be tested without
+ * a GPU.
+ */
+
+#define _image_batch_c 1
+
+#include "system.h"
+
+#include "defs.h"
+#include "struct.h"
+#include "global.h"
+#include "proto.h"
+
+#define IMAGE_BATCH_MAX_TEXTURES 4
+
+// Number of groups a quad can be moved over, to join a group with the same
+// state
+#define IMAGE_BATCH_LOOKBACK 32
+
+/* We have to limit the number of vertices in a single draw call.
+   With the r300 driver, having more than 65532 vertices in a vertex array:
+   	- Gallium 0.4 on ATI RV370, Mesa 7.10.2): locks up the GPU, forcing a reboot
+	- 2.1 Mesa 7.11-devel (git-fc8c4a3) : ignores vertices above the maximal value, corrupting the rendered image
+
+   This workaround is only justified by the state of the r300 driver at the time of this writing, and shall be
+   removed as soon as r300 is confirmed to work fine with arbitrarily large vertex arrays.
+   */
+#define IMAGE_BATCH_MAX_QUADS 16383
+
+struct batch_quad {
+	float x0, y0, x1, y1;
+	float tx0, ty0, tx1, ty1;
+	int next;                   // Next quad of the group, -1 for the last one
+};
+
+struct batch_group {
+	unsigned int texture;
+	float color[4];
+	int additive;
+	float x0, y0, x1, y1;       // Bounding box of the quads
+	int first_quad;
+	int last_quad;
+};
+
+struct batch_draw {
+	int first_quad;
+	int nb_quads;
+	float color[4];
+	int additive;
+	unsigned int used[IMAGE_BATCH_MAX_TEXTURES];    // Texture used by the draw on each unit, 0 if unused
+	unsigned int binds[IMAGE_BATCH_MAX_TEXTURES];   // Texture to bind before the draw, 0 if none
+};
+
+static struct {
+	struct dynarray quads;
+	struct dynarray groups;
+	struct dynarray draws;
+	struct dynarray vertices;
+	unsigned int bound[IMAGE_BATCH_MAX_TEXTURES];   // Texture bound to each unit, 0 if not known
+	int initialized;
+} batch;
+
+static void init_image_batch(void)
+{
+	dynarray_init(&batch.quads, 1024, sizeof(struct batch_quad));
+	dynarray_init(&batch.groups, 256, sizeof(struct batch_group));
+	dynarray_init(&batch.draws, 16, sizeof(struct batch_draw));
+	dynarray_init(&batch.vertices, 1024, 16 * sizeof(float));
+	batch.initialized = TRUE;
+}
+
+static int same_state(struct batch_group *group, unsigned int texture, const float color[4], int additive)
+{
+	return group->texture == texture && group->additive == additive && !memcmp(group->color, color, sizeof(group->color));
+}
+
+/**
+ * Record a textured quad.
+ *
+ * \param texture  Texture of the quad (never 0)
+ * \param color    Color to multiply the texture with
+ * \param additive TRUE to add the quad to the framebuffer, instead of
+ *                 blending it
+ */
+void image_batch_add_quad(unsigned int texture, const float color[4], int additive,
+                          float x0, float y0, float x1, float y1,
+                          float tx0, float ty0, float tx1, float ty1)
+{
+	struct batch_quad quad = { .x0 = x0, .y0 = y0, .x1 = x1, .y1 = y1,
+	                           .tx0 = tx0, .ty0 = ty0, .tx1 = tx1, .ty1 = ty1, .next = -1 };
+	float left = min(x0, x1), right = max(x0, x1);
+	float top = min(y0, y1), bottom = max(y0, y1);
+	struct batch_group *groups;
+	int i;
+
+	if (!batch.initialized)
+		init_image_batch();
+
+	dynarray_add(&batch.quads, &quad, sizeof(struct batch_quad));
+	int index = batch.quads.size - 1;
+
+	// Look for a group with the same state, which the quad can join without
+	// being drawn before something it overlaps
+	groups = batch.groups.arr;
+	for (i = batch.groups.size - 1; i >= 0 && i >= batch.groups.size - IMAGE_BATCH_LOOKBACK; i--) {
+		struct batch_group *group = &groups[i];
+
+		if (same_state(group, texture, color, additive)) {
+			struct batch_quad *last = dynarray_member(&batch.quads, group->last_quad, sizeof(struct batch_quad));
+			last->next = index;
+			group->last_quad = index;
+			group->x0 = min(group->x0, left);
+			group->y0 = min(group->y0, top);
+			group->x1 = max(group->x1, right);
+			group->y1 = max(group->y1, bottom);
+			return;
+		}
+
+		if (left < group->x1 && group->x0 < right && top < group->y1 && group->y0 < bottom)
+			break;
+	}
+
+	struct batch_group group = { .texture = texture, .additive = additive,
+	                             .x0 = left, .y0 = top, .x1 = right, .y1 = bottom,
+	                             .first_quad = index, .last_quad = index };
+	memcpy(group.color, color, sizeof(group.color));
+	dynarray_add(&batch.groups, &group, sizeof(struct batch_group));
+}
+
+static struct batch_draw *open_draw(struct batch_group *group, int first_quad)
+{
+	struct batch_draw draw = { .first_quad = first_quad, .nb_quads = 0, .additive = group->additive };
+	memcpy(draw.color, group->color, sizeof(draw.color));
+	dynarray_add(&batch.draws, &draw, sizeof(struct batch_draw));
+	return dynarray_member(&batch.draws, batch.draws.size - 1, sizeof(struct batch_draw));
+}
+
+/**
+ * Find the texture unit to use for a texture in a draw, binding the texture
+ * to a unit not used by the draw if needed.
+ *
+ * \return The texture unit, or -1 if all the units are used by the draw
+ */
+static int get_texture_unit(struct batch_draw *draw, unsigned int texture, int nb_units)
+{
+	int unit;
+
+	for (unit = 0; unit < nb_units; unit++) {
+		if (draw->used[unit] == texture)
+			return unit;
+	}
+
+	// The texture may still be bound from a previous draw
+	for (unit = 0; unit < nb_units; unit++) {
+		if (!draw->used[unit] && batch.bound[unit] == texture) {
+			draw->used[unit] = texture;
+			return unit;
+		}
+	}
+
+	for (unit = 0; unit < nb_units; unit++) {
+		if (!draw->used[unit]) {
+			draw->used[unit] = texture;
+			draw->binds[unit] = texture;
+			batch.bound[unit] = texture;
+			return unit;
+		}
+	}
+
+	return -1;
+}
+
+/**
+ * Put the vertices of a quad in the vertex array. The texture unit is
+ * encoded in the texture coordinates, see open_gl_shaders.c for details.
+ */
+static void add_vertices(struct batch_quad *q, int unit)
+{
+	float tx0 = q->tx0 + 10 * unit;
+	float tx1 = q->tx1 + 10 * unit;
+	float v[16] = { q->x0, q->y0, tx0, q->ty0, q->x0, q->y1, tx0, q->ty1, q->x1, q->y1, tx1, q->ty1, q->x1, q->y0, tx1, q->ty0 };
+
+	dynarray_add(&batch.vertices, v, 16 * sizeof(float));
+}
+
+/**
+ * Draw the recorded quads with the given backend, and forget them.
+ */
+void image_batch_flush(struct image_batch_backend *backend)
+{
+	struct batch_group *groups = batch.groups.arr;
+	struct batch_draw *draw = NULL;
+	int nb_units;
+	int i, unit;
+
+	if (!batch.initialized || !batch.groups.size)
+		return;
+
+	nb_units = max(1, min(backend->max_textures(), IMAGE_BATCH_MAX_TEXTURES));
+
+	// Split the groups into draws, and build the vertex array in the order
+	// of the draws
+	for (i = 0; i < batch.groups.size; i++) {
+		struct batch_group *group = &groups[i];
+		int index;
+
+		if (draw && (draw->additive != group->additive || memcmp(draw->color, group->color, sizeof(draw->color))))
+			draw = NULL;
+
+		for (index = group->first_quad; index != -1; ) {
+			struct batch_quad *q = dynarray_member(&batch.quads, index, sizeof(struct batch_quad));
+
+			if (draw && draw->nb_quads >= IMAGE_BATCH_MAX_QUADS)
+				draw = NULL;
+
+			unit = draw ? get_texture_unit(draw, group->texture, nb_units) : -1;
+			if (unit == -1) {
+				draw = open_draw(group, batch.vertices.size);
+				unit = get_texture_unit(draw, group->texture, nb_units);
+			}
+
+			add_vertices(q, unit);
+			draw->nb_quads++;
+			index = q->next;
+		}
+	}
+
+	// Send everything
+	backend->upload(batch.vertices.arr, batch.vertices.size);
+
+	struct batch_draw *draws = batch.draws.arr;
+	for (i = 0; i < batch.draws.size; i++) {
+		for (unit = 0; unit < nb_units; unit++) {
+			if (draws[i].binds[unit])
+				backend->bind_texture(unit, draws[i].binds[unit]);
+		}
+		backend->draw(draws[i].first_quad, draws[i].nb_quads, draws[i].color, draws[i].additive);
+	}
+
+	backend->done();
+
+	// The texture bound to the first unit is changed by the rest of the code
+	batch.bound[0] = 0;
+
+	batch.quads.size = 0;
+	batch.groups.size = 0;
+	batch.draws.size = 0;
+	batch.vertices.size = 0;
+}
+
+/**
+ * Forget which textures are bound to the texture units, so that they are
+ * bound again by the next draws. To be called when a texture is deleted,
+ * since its name can then be given to a new texture.
+ */
+void image_batch_forget_textures(void)
+{
+	memset(batch.bound, 0, sizeof(batch.bound));
+}
+
+#undef _image_batch_c
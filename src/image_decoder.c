@@ -0,0 +1,411 @@
+/*
+ *
+ *   Copyright (c) 2026 FreedroidRPG development team
+ *
+ *
+ *  This file is part of Freedroid
+ *
+ *  Freedroid is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Freedroid is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Freedroid; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ *  MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file image_decoder.c
+ * \brief Decoding of image files on a pool of threads.
+ *
+ * Most of the time spent to load an image is used to decode the file and
+ * to convert it to the display format. prefetch_image() queues image files
+ * to be decoded by the threads of the pool, and load_image() then takes
+ * the decoded surface instead of decoding the file by itself.
+ *
+ * Everything else (looking for the files, reading the offsets, creating
+ * the OpenGL textures, reporting errors) is still done by the main thread,
+ * in the order of the load_image() calls.
+ *
+ * The requests are found by the path of their image file, in a hash table.
+ * The number of requests is limited, the images which can not be queued
+ * are decoded by load_image().
+ *
+ * Requests are renewed by queueing their image again. The graphics prefetcher
+ * calls release_unrenewed_images() after each of its scans, so that the
+ * images it does not want anymore do not stay in memory.
+ */
+
+#define _image_decoder_c 1
+
+#include "system.h"
+
+#include "defs.h"
+#include "struct.h"
+#include "global.h"
+#include "proto.h"
+
+#define IMAGE_DECODER_MAX_THREADS 8
+
+// Maximum number of queued and decoded images not taken by load_image() yet
+#define IMAGE_DECODER_MAX_IMAGES 256
+
+// Number of buckets of the hash table of the requests (a power of two)
+#define IMAGE_DECODER_HASH_SIZE 512
+
+enum decoded_image_state {
+	IMAGE_QUEUED,
+	IMAGE_DECODING,
+	IMAGE_DECODED
+};
+
+struct decoded_image {
+	struct list_head node;           // In the queue, then in the list of decoded images
+	struct list_head hash_node;      // In the bucket of the request
+	char *fpath;                     // Full path of the image file (allocated)
+	enum decoded_image_state state;
+	SDL_Surface *surface;            // Decoded surface, NULL on error
+	char error[256];                 // Error message, if the decoding failed
+	int round;                       // Round during which the request was last renewed
+	int released;                    // To be freed once decoded
+};
+
+static struct {
+	struct list_head queue;          // Queued images, in the order of the requests
+	struct list_head decoded;        // Images being decoded or decoded
+	struct list_head buckets[IMAGE_DECODER_HASH_SIZE];
+	int nb_queued;
+	int nb_decoding;
+	int nb_images;
+	int round;                       // Incremented by release_unrenewed_images()
+	SDL_mutex *lock;
+	SDL_cond *wakeup;                // Signaled when an image is queued
+	SDL_cond *image_decoded;         // Signaled when an image is decoded
+	SDL_Thread *threads[IMAGE_DECODER_MAX_THREADS];
+	int nb_threads;
+	int started;
+	int quit;
+} decoder;
+
+static void free_decoded_image(struct decoded_image *img)
+{
+	list_del(&img->node);
+	list_del(&img->hash_node);
+	decoder.nb_images--;
+	if (img->surface)
+		SDL_FreeSurface(img->surface);
+	free(img->fpath);
+	free(img);
+}
+
+/*
+ * Decoder threads' main loop.
+ * Take the oldest queued image, and decode it.
+ */
+static int image_decoder_thread(void *data)
+{
+	struct decoded_image *img;
+
+	SDL_LockMutex(decoder.lock);
+	while (TRUE) {
+		while (!decoder.nb_queued && !decoder.quit)
+			SDL_CondWait(decoder.wakeup, decoder.lock);
+		if (decoder.quit)
+			break;
+
+		img = list_entry(decoder.queue.next, struct decoded_image, node);
+		list_del(&img->node);
+		list_add_tail(&img->node, &decoder.decoded);
+		img->state = IMAGE_DECODING;
+		decoder.nb_queued--;
+		decoder.nb_decoding++;
+		SDL_UnlockMutex(decoder.lock);
+
+		// The image can not be removed from the list while it is being decoded
+		SDL_Surface *surface = decode_surface_bitmap(img->fpath, img->error, sizeof(img->error));
+
+		SDL_LockMutex(decoder.lock);
+		img->surface = surface;
+		img->state = IMAGE_DECODED;
+		decoder.nb_decoding--;
+		if (img->released)
+			free_decoded_image(img);
+		SDL_CondBroadcast(decoder.image_decoded);
+	}
+	SDL_UnlockMutex(decoder.lock);
+
+	return 0;
+}
+
+static int image_decoder_thread_count(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+	long nb_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nb_cpus > 0)
+		return min(nb_cpus, IMAGE_DECODER_MAX_THREADS);
+#endif
+	return 2;
+}
+
+/*
+ * Start the decoder threads.
+ * If no thread can be created, images are decoded by load_image().
+ */
+static void image_decoder_start(void)
+{
+	int nb_threads = image_decoder_thread_count();
+	int i;
+
+	decoder.started = TRUE;
+
+	// The main thread is busy creating the textures, so that there is
+	// nothing to gain with a single CPU
+	if (nb_threads <= 1)
+		return;
+
+#ifdef HAVE_IMG_INIT
+	// SDL_image loads its codecs the first time they are needed, which is
+	// not thread safe
+	IMG_Init(IMG_INIT_PNG | IMG_INIT_JPG);
+#else
+	// The codecs can not be loaded beforehand, images are decoded by
+	// the main thread
+	return;
+#endif
+
+	INIT_LIST_HEAD(&decoder.queue);
+	INIT_LIST_HEAD(&decoder.decoded);
+	for (i = 0; i < IMAGE_DECODER_HASH_SIZE; i++)
+		INIT_LIST_HEAD(&decoder.buckets[i]);
+	decoder.nb_queued = 0;
+	decoder.nb_decoding = 0;
+	decoder.nb_images = 0;
+	decoder.quit = FALSE;
+	decoder.lock = SDL_CreateMutex();
+	decoder.wakeup = SDL_CreateCond();
+	decoder.image_decoded = SDL_CreateCond();
+	if (!decoder.lock || !decoder.wakeup || !decoder.image_decoded)
+		return;
+
+	for (i = 0; i < nb_threads; i++) {
+		SDL_Thread *thread = SDL_CreateThread(image_decoder_thread, NULL);
+		if (thread)
+			decoder.threads[decoder.nb_threads++] = thread;
+	}
+
+	if (!decoder.nb_threads) {
+		error_message(__FUNCTION__, "Could not create the image decoder threads: %s\n"
+		              "Images will be decoded when they are loaded.",
+		              NO_REPORT, SDL_GetError());
+	}
+}
+
+/**
+ * Stop the decoder threads, and free the images which were decoded but
+ * never loaded. The threads are started again by the next call to
+ * queue_image_decoding().
+ */
+void stop_image_decoder(void)
+{
+	struct decoded_image *img, *next;
+	int i;
+
+	if (decoder.nb_threads) {
+		SDL_LockMutex(decoder.lock);
+		decoder.quit = TRUE;
+		SDL_CondBroadcast(decoder.wakeup);
+		SDL_UnlockMutex(decoder.lock);
+		for (i = 0; i < decoder.nb_threads; i++)
+			SDL_WaitThread(decoder.threads[i], NULL);
+		decoder.nb_threads = 0;
+
+		list_for_each_entry_safe(img, next, &decoder.queue, node)
+			free_decoded_image(img);
+		list_for_each_entry_safe(img, next, &decoder.decoded, node)
+			free_decoded_image(img);
+	}
+
+	if (decoder.image_decoded)
+		SDL_DestroyCond(decoder.image_decoded);
+	if (decoder.wakeup)
+		SDL_DestroyCond(decoder.wakeup);
+	if (decoder.lock)
+		SDL_DestroyMutex(decoder.lock);
+	decoder.image_decoded = NULL;
+	decoder.wakeup = NULL;
+	decoder.lock = NULL;
+	decoder.started = FALSE;
+}
+
+static struct list_head *request_bucket(const char *fpath)
+{
+	return &decoder.buckets[name_map_hash(fpath) & (IMAGE_DECODER_HASH_SIZE - 1)];
+}
+
+static struct decoded_image *find_decoded_image(const char *fpath)
+{
+	struct decoded_image *img;
+
+	list_for_each_entry(img, request_bucket(fpath), hash_node) {
+		if (!strcmp(img->fpath, fpath))
+			return img;
+	}
+
+	return NULL;
+}
+
+/**
+ * Ask the decoder threads to decode an image file.
+ *
+ * \param fpath Full path of the image file
+ * \return FALSE if there is no decoder thread, or if too many images are
+ * already queued or decoded
+ */
+int queue_image_decoding(const char *fpath)
+{
+	int queued = TRUE;
+
+	if (!decoder.started)
+		image_decoder_start();
+
+	if (!decoder.nb_threads)
+		return FALSE;
+
+	SDL_LockMutex(decoder.lock);
+	struct decoded_image *found = find_decoded_image(fpath);
+	if (found) {
+		found->round = decoder.round;
+		found->released = FALSE;
+	} else {
+		if (decoder.nb_images < IMAGE_DECODER_MAX_IMAGES) {
+			struct decoded_image *img = MyMalloc(sizeof(struct decoded_image));
+			img->fpath = my_strdup(fpath);
+			img->state = IMAGE_QUEUED;
+			img->surface = NULL;
+			img->error[0] = '\0';
+			img->round = decoder.round;
+			list_add_tail(&img->node, &decoder.queue);
+			list_add(&img->hash_node, request_bucket(fpath));
+			decoder.nb_queued++;
+			decoder.nb_images++;
+			SDL_CondSignal(decoder.wakeup);
+		} else {
+			queued = FALSE;
+		}
+	}
+	SDL_UnlockMutex(decoder.lock);
+
+	return queued;
+}
+
+/**
+ * Check if some of the queued images are not decoded yet.
+ */
+int image_decoder_busy(void)
+{
+	int busy;
+
+	if (!decoder.nb_threads)
+		return FALSE;
+
+	SDL_LockMutex(decoder.lock);
+	busy = decoder.nb_queued || decoder.nb_decoding;
+	SDL_UnlockMutex(decoder.lock);
+
+	return busy;
+}
+
+/**
+ * Take the result of the decoding of an image file, waiting for the end of
+ * the decoding if needed.
+ *
+ * \param fpath      Full path of the image file
+ * \param surface    Filled with the decoded surface, NULL on error
+ * \param error      Filled with the error message, on error
+ * \param error_size Size of the 'error' buffer
+ * \return FALSE if the image was not queued, the caller is then to decode
+ * the file by itself
+ */
+int take_decoded_image(const char *fpath, SDL_Surface **surface, char *error, size_t error_size)
+{
+	struct decoded_image *img;
+
+	if (!decoder.nb_threads)
+		return FALSE;
+
+	SDL_LockMutex(decoder.lock);
+
+	img = find_decoded_image(fpath);
+	if (!img) {
+		SDL_UnlockMutex(decoder.lock);
+		return FALSE;
+	}
+
+	if (img->state == IMAGE_QUEUED) {
+		// No thread started to decode it yet, the caller can do it at once
+		decoder.nb_queued--;
+		free_decoded_image(img);
+		SDL_UnlockMutex(decoder.lock);
+		return FALSE;
+	}
+
+	// The image is wanted again, if it was released
+	img->released = FALSE;
+	while (img->state != IMAGE_DECODED)
+		SDL_CondWait(decoder.image_decoded, decoder.lock);
+
+	*surface = img->surface;
+	snprintf(error, error_size, "%s", img->error);
+	img->surface = NULL;
+	free_decoded_image(img);
+
+	SDL_UnlockMutex(decoder.lock);
+
+	return TRUE;
+}
+
+/**
+ * Free the images whose request was not renewed since the previous call,
+ * whether they are queued, being decoded or decoded, and start a new round.
+ */
+void release_unrenewed_images(void)
+{
+	struct decoded_image *img, *next;
+
+	if (!decoder.nb_threads)
+		return;
+
+	SDL_LockMutex(decoder.lock);
+
+	list_for_each_entry_safe(img, next, &decoder.queue, node) {
+		if (img->round != decoder.round) {
+			decoder.nb_queued--;
+			free_decoded_image(img);
+		}
+	}
+
+	list_for_each_entry_safe(img, next, &decoder.decoded, node) {
+		if (img->round == decoder.round)
+			continue;
+
+		// The decoder thread frees it once decoded
+		if (img->state == IMAGE_DECODING)
+			img->released = TRUE;
+		else
+			free_decoded_image(img);
+	}
+
+	decoder.round++;
+
+	SDL_UnlockMutex(decoder.lock);
+}
+
+#undef _image_decoder_c
@@ -615,14 +615,14 @@ static void move_tux_towards_intermediate_point(void)
 		case NO_COMBO_ACTION_SET:
 			break;
 		case COMBO_ACTION_OBSTACLE:
-			get_obstacle_spec(lvl->obstacle_list[Me.mouse_move_target_combo_action_parameter].type)->action_fn(
+			get_obstacle_spec(ACCESS_OBSTACLE(lvl, Me.mouse_move_target_combo_action_parameter).type)->action_fn(
                     lvl,
                     Me.mouse_move_target_combo_action_parameter);
 			break;
 		case COMBO_ACTION_PICK_UP_ITEM:
 			// If Tux arrived at destination, pick up the item and give it to the player
 			if (check_for_items_to_pickup(lvl, Me.mouse_move_target_combo_action_parameter)) {
-				item *it = &lvl->ItemList[Me.mouse_move_target_combo_action_parameter];
+				item *it = &ACCESS_FLOOR_ITEM(lvl, Me.mouse_move_target_combo_action_parameter);
 
 				if (GameConfig.Inventory_Visible) {
 					// Special case: when the inventory screen is open, and there
@@ -1317,7 +1317,7 @@ int perform_tux_attack(int use_mouse_cursor_for_targeting)
 		gps targeted_obstacle_vpos = { -1, -1, -1 };
 		int targeted_obstacle_index = clickable_obstacle_below_mouse_cursor(&obs_lvl, FALSE);
 		if (targeted_obstacle_index != -1) {
-			update_virtual_position(&targeted_obstacle_vpos, &obs_lvl->obstacle_list[targeted_obstacle_index].pos, Me.pos.z);
+			update_virtual_position(&targeted_obstacle_vpos, &ACCESS_OBSTACLE(obs_lvl, targeted_obstacle_index).pos, Me.pos.z);
 			target_location.x = targeted_obstacle_vpos.x;
 			target_location.y = targeted_obstacle_vpos.y;
 		}
@@ -1578,7 +1578,7 @@ static void analyze_players_mouse_click()
 
 		int tmp = clickable_obstacle_below_mouse_cursor(&obj_lvl, TRUE);
 		if (tmp != -1) {
-			get_obstacle_spec(obj_lvl->obstacle_list[tmp].type)->action_fn(obj_lvl, tmp);
+			get_obstacle_spec(ACCESS_OBSTACLE(obj_lvl, tmp).type)->action_fn(obj_lvl, tmp);
 			if (Me.mouse_move_target_combo_action_type != NO_COMBO_ACTION_SET)
 				wait_mouseleft_release = TRUE;
 			return;
@@ -1593,7 +1593,7 @@ static void analyze_players_mouse_click()
 			if ((tmp = get_floor_item_index_under_mouse_cursor(&obj_lvl)) != -1) {
 				if (check_for_items_to_pickup(obj_lvl, tmp)) {
 					// The item can be picked up immediately , so give it to the player
-					give_item(&obj_lvl->ItemList[tmp]);
+					give_item(&ACCESS_FLOOR_ITEM(obj_lvl, tmp));
 					wait_mouseleft_release = TRUE;
 				}
 				return;
@@ -1792,6 +1792,7 @@ void init_tux()
 	Me.base_dexterity = 15;
 	Me.base_cooling = 25;
 
+	invalidate_character_stats();
 	UpdateAllCharacterStats();
 
 	Me.energy = Me.maxenergy;
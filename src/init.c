@@ -327,17 +327,27 @@ void init_game_data()
 	// Load Tux animation and rendering specifications.
 	tux_rendering_load_specs("tuxrender_specs.lua");
 
+	// The item and droid archetypes are read from the spec cache, unless
+	// their data files were modified since it was written
+	int specs_cached = load_spec_cache();
+
 	// Item archetypes must be loaded too
-	find_file(fpath, BASE_DIR, "item_specs.lua", NULL, PLEASE_INFORM | IS_FATAL);
-	run_lua_file(LUA_CONFIG, fpath);
+	if (!specs_cached) {
+		find_file(fpath, BASE_DIR, "item_specs.lua", NULL, PLEASE_INFORM | IS_FATAL);
+		run_lua_file(LUA_CONFIG, fpath);
+	}
 
 	// Load add-on specifications.
 	find_file(fpath, BASE_DIR, "addon_specs.lua", NULL, PLEASE_INFORM | IS_FATAL);
 	run_lua_file(LUA_CONFIG, fpath);
 
 	// Time to eat some droid archetypes...
-	find_file(fpath, BASE_DIR, "droid_specs.lua", NULL, PLEASE_INFORM | IS_FATAL);
-	run_lua_file(LUA_CONFIG, fpath);
+	if (!specs_cached) {
+		find_file(fpath, BASE_DIR, "droid_specs.lua", NULL, PLEASE_INFORM | IS_FATAL);
+		run_lua_file(LUA_CONFIG, fpath);
+		save_spec_cache();
+	}
+	init_droid_specs();
 
 	// Load obstacle specifications.
 	dynarray_init(&obstacle_map, 512, sizeof(struct obstacle_spec));
@@ -369,9 +379,10 @@ char usage_string[] = ""
 "                    [-r Y | --resolution=Y]  Y = 99 lists hardcoded resolutions.\n"
 "                                             Y may also be of the form 'WxH' e.g. '800x600'\n"
 "                    [-d X | --debug=X]       X = 0-5; default 1\n"
-"                    [-b Z | --benchmark=Z]   Z = text | dialog | loadship | loadgame |\n"
+"                    [-b Z | --benchmark=Z]   Z = text | textwrap | dialog | loadship | loadgame |\n"
 "                                                 savegame | dynarray | mapgen | leveltest |\n"
-"                                                 graphicsloading\n"
+"                                                 graphicsloading | atlas |\n"
+"                                                 batch | compositor | takeover\n"
 "\n"
 "Please report bugs either by entering them into the bug tracker on our website at:\n\n"
 "http://bugs.freedroid.org\n\n"
@@ -593,6 +604,11 @@ void prepare_start_of_new_game(char *start_label, int new_tux)
 	// We do the same as above for lua state
 	reset_lua_state();
 
+	// The random dungeons were generated in the background while the
+	// above was done. The events and the bots need their map labels and
+	// waypoints.
+	wait_for_dungeons();
+
 	GetEventTriggers("events.dat");
 
 	init_npcs();
@@ -692,6 +708,7 @@ void ResetGameConfigToDefaultValues(void)
 	GameConfig.xray_vision_for_tux = FALSE;
 	GameConfig.cheat_running_stamina = FALSE;
 	GameConfig.lazyload = 1;
+	GameConfig.graphics_memory_budget = 128;
 	GameConfig.show_item_labels = 0;
 	GameConfig.last_edited_level = -1;
 	GameConfig.show_all_floor_layers = 1;
@@ -925,6 +942,11 @@ void InitFreedroid(int argc, char **argv)
 
 	load_game_config();
 
+	// The benchmarks do not need to show anything, so that they can run
+	// the SDL renderer on a box without a display
+	if (do_benchmark && !use_open_gl && !getenv("SDL_VIDEODRIVER"))
+		fd_setenv("SDL_VIDEODRIVER", "dummy", FALSE);
+
 	if (SDL_Init(SDL_INIT_VIDEO) == -1)
 		error_message(__FUNCTION__, "Couldn't initialize SDL: %s", PLEASE_INFORM | IS_FATAL, SDL_GetError());
 
@@ -428,6 +428,9 @@ static void apply_addon_bonus(item *it, struct addon_bonus *bonus)
  */
 void calculate_item_bonuses(item *it)
 {
+	if (item_is_currently_equipped(it))
+		invalidate_character_stats();
+
 	// Reset all the bonuses to defaults.
 	it->bonus_to_dex = 0;
 	it->bonus_to_str = 0;
@@ -42,6 +42,9 @@
  */
 void init_item(item *it)
 {
+	if (item_is_currently_equipped(it))
+		invalidate_character_stats();
+
 	memset(it, 0, sizeof(item));
 	it->type = -1;
 	it->pos.x = -1;
@@ -591,26 +594,17 @@ void DamageProtectiveEquipment()
  */
 static void MakeHeldFloorItemOutOf(item * SourceItem)
 {
-	int i;
+	int i = pool_add(&CURLEVEL()->ItemList);
 
-	for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
-		if (CURLEVEL()->ItemList[i].type == (-1))
-			break;
-	}
-	if (i >= MAX_ITEMS_PER_LEVEL) {
-		DebugPrintf(0, "\n No free position to drop item!!! ");
-		i = 0;
-		Terminate(EXIT_FAILURE);
-	}
 	// Now we enter the item into the item list of this level
 	//
-	CopyItem(SourceItem, &(CURLEVEL()->ItemList[i]));
+	CopyItem(SourceItem, &(ACCESS_FLOOR_ITEM(CURLEVEL(), i)));
 
-	CURLEVEL()->ItemList[i].pos.x = Me.pos.x;
-	CURLEVEL()->ItemList[i].pos.y = Me.pos.y;
-	CURLEVEL()->ItemList[i].pos.z = Me.pos.z;
+	ACCESS_FLOOR_ITEM(CURLEVEL(), i).pos.x = Me.pos.x;
+	ACCESS_FLOOR_ITEM(CURLEVEL(), i).pos.y = Me.pos.y;
+	ACCESS_FLOOR_ITEM(CURLEVEL(), i).pos.z = Me.pos.z;
 
-	item_held_in_hand = &(CURLEVEL()->ItemList[i]);
+	item_held_in_hand = &(ACCESS_FLOOR_ITEM(CURLEVEL(), i));
 
 	DeleteItem(SourceItem);
 };				// void MakeHeldFloorItemOutOf( item* SourceItem )
@@ -632,6 +626,8 @@ void CopyItem(item * SourceItem, item * DestItem)
 {
 
 	memcpy(DestItem, SourceItem, sizeof(item));
+	if (item_is_currently_equipped(DestItem))
+		invalidate_character_stats();
 
 	// Create a soft copy of the upgrade sockets. Memcpy just copied the
 	// pointer but we want the actual data to be duplicated.
@@ -647,6 +643,8 @@ void MoveItem(item *source_item, item *dest_item)
 {
 	if (source_item != dest_item) {
 		memcpy(dest_item, source_item, sizeof(item));
+		if (item_is_currently_equipped(dest_item))
+			invalidate_character_stats();
 		init_item(source_item);
 	}
 }
@@ -672,6 +670,11 @@ void Quick_ApplyItem(int ItemKey)
 
 };				// void Quick_ApplyItem( item* CurItem )
 
+static const char *item_spec_id(int type)
+{
+	return ItemMap[type].id;
+}
+
 /**
  * This function checks whether a given item has the name specified. This is
  * used to match an item which its type in a flexible way (match by name instead
@@ -679,11 +682,11 @@ void Quick_ApplyItem(int ItemKey)
  */
 int get_item_type_by_id(const char *id)
 {
-	int cidx = 0;
-	for (; cidx < Number_Of_Item_Types; cidx++) {
-		if (!strcmp(ItemMap[cidx].id, id))
-			return cidx;
-	}
+	static struct name_map item_ids;
+	int cidx = name_map_index_of(&item_ids, id, item_spec_id, Number_Of_Item_Types);
+
+	if (cidx != -1)
+		return cidx;
 
 	error_message(__FUNCTION__, "Unable to find item id %s", PLEASE_INFORM, id);
 	return -1;
@@ -829,6 +832,9 @@ void apply_item(item * CurItem)
 
 		play_item_sound(CurItem->type, &Me.pos);
 
+		// Most of the items change the character stats
+		invalidate_character_stats();
+
 		// Apply busy time and busy type
 		Me.busy_time = ItemMap[CurItem->type].right_use.busy_time;
 		Me.busy_type = ItemMap[CurItem->type].right_use.busy_type;
@@ -1167,24 +1173,6 @@ int ItemCanBeDroppedInInv(int ItemType, int InvPos_x, int InvPos_y)
 
 };				// int ItemCanBeDroppedInInv ( int ItemType , int InvPos_x , int InvPos_y )
 
-/**
- * Find a free index in the item array of the drop level.
- */
-static int find_free_floor_index(level* drop_level)
-{
-	int i;
-	for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
-		if (drop_level->ItemList[i].type == -1) {
-			return i;
-		}
-	}
-
-	// We did not find a free index.
-	error_message(__FUNCTION__, "The item array for level %d was full.",
-	            PLEASE_INFORM, drop_level->levelnum);
-	return -1;
-}
-
 /**
  * Drop an item to the floor in the given location.  No checks are done to
  * verify this location is unobstructed or otherwise reasonable.
@@ -1193,31 +1181,26 @@ item *drop_item(item *item_pointer, float x, float y, int level_num)
 {
 	level *drop_level = curShip.AllLevels[level_num];
 
-	int index = find_free_floor_index(drop_level);
-
-	// Cancel the drop if we did not find an empty index to use.
-	if (index == -1) {
-		return NULL;
-	}
+	int index = pool_add(&drop_level->ItemList);
 
 	// Create the item
-	init_item(&(drop_level->ItemList[index]));
-	MoveItem(item_pointer, &(drop_level->ItemList[index]));
+	init_item(&(ACCESS_FLOOR_ITEM(drop_level, index)));
+	MoveItem(item_pointer, &(ACCESS_FLOOR_ITEM(drop_level, index)));
 
 	// Place item on level
-	drop_level->ItemList[index].inventory_position.x = -1;
-	drop_level->ItemList[index].inventory_position.y = -1;
-	drop_level->ItemList[index].pos.x = x;
-	drop_level->ItemList[index].pos.y = y;
-	drop_level->ItemList[index].pos.z = level_num;
-	drop_level->ItemList[index].throw_time = 0.01;  // something > 0
+	ACCESS_FLOOR_ITEM(drop_level, index).inventory_position.x = -1;
+	ACCESS_FLOOR_ITEM(drop_level, index).inventory_position.y = -1;
+	ACCESS_FLOOR_ITEM(drop_level, index).pos.x = x;
+	ACCESS_FLOOR_ITEM(drop_level, index).pos.y = y;
+	ACCESS_FLOOR_ITEM(drop_level, index).pos.z = level_num;
+	ACCESS_FLOOR_ITEM(drop_level, index).throw_time = 0.01;  // something > 0
 
 	timeout_from_item_drop = 0.4;
 
 	if (item_pointer == item_held_in_hand)
 		item_held_in_hand = NULL;
 
-	return &(drop_level->ItemList[index]);
+	return &(ACCESS_FLOOR_ITEM(drop_level, index));
 }
 
 /**
@@ -1488,11 +1471,11 @@ int get_floor_item_index_under_mouse_cursor(level **item_lvl)
 		BROWSE_VISIBLE_LEVELS(vis_lvl, n) {	
 			level *lvl = vis_lvl->lvl_pointer;
 
-			for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
-				if (lvl->ItemList[i].type == (-1))
+			for (i = 0; i < lvl->ItemList.size; i++) {
+				if (ACCESS_FLOOR_ITEM(lvl, i).type == (-1))
 					continue;
 	
-				if (MouseCursorIsInRect(&(lvl->ItemList[i].text_slot_rectangle), GetMousePos_x(), GetMousePos_y())) {
+				if (MouseCursorIsInRect(&(ACCESS_FLOOR_ITEM(lvl, i).text_slot_rectangle), GetMousePos_x(), GetMousePos_y())) {
 					*item_lvl = lvl;
 					return (i);
 				}
@@ -1516,12 +1499,12 @@ int get_floor_item_index_under_mouse_cursor(level **item_lvl)
 			level *lvl = vis_lvl->lvl_pointer;
 			update_virtual_position(&virt_mouse_pos, &mouse_pos, lvl->levelnum);
 			
-			for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
-				if (lvl->ItemList[i].type == (-1))
+			for (i = 0; i < lvl->ItemList.size; i++) {
+				if (ACCESS_FLOOR_ITEM(lvl, i).type == (-1))
 					continue;
 	
-				if ((fabsf(virt_mouse_pos.x - lvl->ItemList[i].pos.x) < 0.5) &&
-					(fabsf(virt_mouse_pos.y - lvl->ItemList[i].pos.y) < 0.5)) {
+				if ((fabsf(virt_mouse_pos.x - ACCESS_FLOOR_ITEM(lvl, i).pos.x) < 0.5) &&
+					(fabsf(virt_mouse_pos.y - ACCESS_FLOOR_ITEM(lvl, i).pos.y) < 0.5)) {
 					*item_lvl = lvl;
 					return (i);
 				}
@@ -1619,7 +1602,7 @@ void HandleInventoryScreen(void)
 			// Try to auto-put or auto-equip the item. If it's not possible,
 			// the item will be 'put in hand'.
 			if (check_for_items_to_pickup(item_lvl, item_idx)) {
-				item *it = &item_lvl->ItemList[item_idx];
+				item *it = &ACCESS_FLOOR_ITEM(item_lvl, item_idx);
 				if (!try_give_item(it)) {
 					item_held_in_hand = it;
 				}
@@ -1690,6 +1673,7 @@ void HandleInventoryScreen(void)
 				int shield_item_type = Me.shield_item.type;
 				Me.shield_item.type = (-1);
 				update_all_primary_stats();
+				invalidate_character_stats();
 				if (HeldItemUsageRequirementsMet()) {
 					DropHeldItemToSlot(&(Me.weapon_item));
 					Me.shield_item.type = shield_item_type;
@@ -1741,6 +1725,7 @@ void HandleInventoryScreen(void)
 			int weapon_item_type = Me.weapon_item.type;
 			Me.weapon_item.type = (-1);
 			update_all_primary_stats();
+			invalidate_character_stats();
 			if (HeldItemUsageRequirementsMet()) {
 				DropHeldItemToSlot(&(Me.shield_item));
 				Me.weapon_item.type = weapon_item_type;
@@ -2081,6 +2066,8 @@ int item_is_currently_equipped(item * Item)
 	return 0;
 }
 
+// Used by get_one_item(): SPEC_CACHE_VERSION (spec_cache.c) has to be
+// increased when the names or the slots change
 enum slot_type get_slot_type_by_name(char *name)
 {
 	struct { 
@@ -2115,6 +2102,8 @@ const char *item_specs_get_name(int type)
 	return "BUG - UNNAMED ITEM";
 }
 
+// Used by get_one_item(): SPEC_CACHE_VERSION (spec_cache.c) has to be
+// increased when the names or the busy types change
 enum _busytype get_busy_type_by_name(char *name)
 {
 	if (!strcmp(name, "drinking")) {
@@ -521,18 +521,22 @@ static int input_key(int keynum, int value)
 		} else if (KEYPRESS("cheat_melee")) {
 			if (Me.melee_weapon_skill < 9)
 				Me.melee_weapon_skill += 1;
+			invalidate_character_stats();
 		} else if (KEYPRESS("cheat_range")) {
 			if (Me.ranged_weapon_skill < 9)
 				Me.ranged_weapon_skill += 1;
+			invalidate_character_stats();
 		} else if (KEYPRESS("cheat_programing")) {
 			if (Me.spellcasting_skill < 9)
 				Me.spellcasting_skill += 1;
 		} else if (KEYPRESS("cheat_melee_down")) {
 			if (Me.melee_weapon_skill > 0)
 				Me.melee_weapon_skill -= 1;
+			invalidate_character_stats();
 		} else if (KEYPRESS("cheat_range_down")) {
 			if (Me.ranged_weapon_skill > 0)
 				Me.ranged_weapon_skill -= 1;
+			invalidate_character_stats();
 		} else if (KEYPRESS("cheat_programing_down")) {
 			if (Me.spellcasting_skill > 0)
 				Me.spellcasting_skill -= 1;
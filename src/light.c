@@ -539,12 +539,9 @@ void update_light_list()
 	// Now we can fill in any explosions, that are currently going on.
 	// These will typically emanate a lot of light.
 
-	for (blast_idx = 0; blast_idx < all_blasts.size; blast_idx++) {
-		// Unused blast slot
-		if (!sparse_dynarray_member_used(&all_blasts, blast_idx))
-			continue;
-
-		struct blast *current_blast = (struct blast *)sparse_dynarray_member(&all_blasts, blast_idx, sizeof(struct blast));
+	for (blast_idx = 0; blast_idx < all_blasts.nb_live; blast_idx++) {
+		struct blast *current_blast = (struct blast *)sparse_dynarray_member(&all_blasts,
+				sparse_dynarray_live_member(&all_blasts, blast_idx), sizeof(struct blast));
 
 		if (current_blast->type != DROIDBLAST)
 			continue;
@@ -600,7 +597,7 @@ void update_light_list()
 				for (glue_index = 0; glue_index < curr_lvl->map[map_y][map_x].glued_obstacles.size; glue_index++) {
 
 					obs_index = ((int *)(curr_lvl->map[map_y][map_x].glued_obstacles.arr))[glue_index];
-					emitter = &(curr_lvl->obstacle_list[obs_index]);
+					emitter = &(ACCESS_OBSTACLE(curr_lvl, obs_index));
 
 					if (emitter->timestamp == tstamp)
 						continue;
@@ -560,6 +560,7 @@ static int lua_event_change_stat(lua_State * L)
 	}
 
 	*statptr += nb;
+	invalidate_character_stats();
 	return 0;
 }
 
@@ -858,6 +859,7 @@ static int lua_set_npc_faction(lua_State *L)
 	const char *fact = luaL_checkstring(L, 1);
 	enemy *en = get_enemy_arg(L, 2);
 	en->faction = get_faction_id(fact);
+	mission_bot_changed(en);
 	return 0;
 }
 
@@ -221,6 +221,7 @@ static int _set_faction(lua_State *L)
 
 	const char *faction = luaL_checkstring(L, 2);
 	self->enemy_ref->faction = get_faction_id(faction);
+	mission_bot_changed(self->enemy_ref);
 	return 0;
 }
 
@@ -570,6 +570,7 @@ static int _change_stat(lua_State * L)
 	}
 
 	*statptr += nb;
+	invalidate_character_stats();
 	return 0;
 }
 
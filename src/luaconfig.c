@@ -1016,6 +1016,9 @@ static int lua_npc_shop_ctor(lua_State *L)
 /**
  * \brief
  * \param L Lua state.
+ *
+ * The item specs are cached by spec_cache.c: SPEC_CACHE_VERSION has to be
+ * increased when the conversion of the item specs changes.
  */
 static int get_one_item(lua_State *L, void *data)
 {
@@ -1159,6 +1162,8 @@ static int lua_item_list_ctor(lua_State *L)
 	return 0;
 }
 
+// The droid specs are cached by spec_cache.c: SPEC_CACHE_VERSION has to be
+// increased when the conversion of the droid specs changes.
 static int get_one_droid(lua_State *L, void *data)
 {
 	struct droidspec *droid = (struct droidspec *)data;
@@ -1243,29 +1248,6 @@ static int get_one_droid(lua_State *L, void *data)
 		droid->voice_samples_probability = 20;
 	}
 
-	droid->gfx_prepared = FALSE;
-	if (!GameConfig.lazyload) {
-		load_droid_animation_images(droid);
-	} else {
-		// The animation cycle lengths will be taken from the image collection file
-		// the first time the droid will be displayed.
-		// But it might happen that some phase computation is done before the first
-		// blit already. Therefore we initialize some sane default values.
-		droid->walk_animation_first_image = 1;
-		droid->walk_animation_last_image = 1;
-		droid->attack_animation_first_image = 1;
-		droid->attack_animation_last_image = 1;
-		droid->gethit_animation_first_image = 1;
-		droid->gethit_animation_last_image = 1;
-		droid->death_animation_first_image = 1;
-		droid->death_animation_last_image = 1;
-		droid->stand_animation_first_image = 1;
-		droid->stand_animation_last_image = 1;
-	}
-
-	struct image empty = EMPTY_IMAGE;
-	droid->portrait = empty;
-
 	return TRUE;
 }
 
@@ -1282,18 +1264,6 @@ static int lua_droid_list_ctor(lua_State *L)
 
 	dynarray_free(&droid_specs);
 
-	// Adapt the droids' specs to the difficulty level
-	struct difficulty *diff = dynarray_member(&difficulties, GameConfig.difficulty_level, sizeof(struct difficulty));
-	int i;
-	for (i = 0; i < Number_Of_Droid_Types; i++) {
-		Droidmap[i].maxspeed *= diff->droid_max_speed;
-		Droidmap[i].maxenergy *= diff->droid_hpmax;
-		Droidmap[i].experience_reward *= diff->droid_experience_reward;
-		Droidmap[i].aggression_distance *= diff->droid_aggression_distance;
-		Droidmap[i].healing_friendly *= diff->droid_friendly_healing;
-		Droidmap[i].healing_hostile *= diff->droid_hostile_healing;
-	}
-
 	return 0;
 }
 
@@ -285,6 +285,7 @@ void LevelEditor()
 		}
 
 		leveleditor_display();
+		update_audio();
 
 		ComputeFPSForThisFrame();
 	}
@@ -65,20 +65,38 @@ enum ActionType {
 	ACT_CREATE_MAP_LABEL,
 	ACT_REMOVE_MAP_LABEL,
 	ACT_CREATE_ENEMY,
-	ACT_REMOVE_ENEMY
+	ACT_REMOVE_ENEMY,
+	ACT_RESIZE_LEVEL
 };
 
+/* An obstacle to create again, in a batch of obstacle creations */
+struct undo_obstacle {
+	double x, y;
+	int type;
+};
+
+/*
+ * Consecutive actions of the same kind are stored in a single action when
+ * possible: obstacles created in a batch, obstacles removed in a range of
+ * indices, floor tiles set along a run. Each of them still counts as one
+ * action to undo, and the last one stored is the first one to undo.
+ */
 typedef struct {
 	struct list_head node;
 	enum ActionType type;
 
 	union {
 		struct {
-			double x, y;
-			int new_obstacle_type;
+			int count;
+			struct undo_obstacle *obstacles;
 		} create_obstacle;
 
-		obstacle *delete_obstacle;
+		struct {
+			int levelnum;
+			int first;		/* index of the first obstacle */
+			int step;		/* offset between two consecutive indices */
+			int count;
+		} delete_obstacles;
 
 		struct {
 			obstacle *obstacle;
@@ -122,9 +140,11 @@ typedef struct {
 		} toggle_waypoint_connection;
 
 		struct {
-			int x, y;
+			int x, y;		/* first tile of the run */
+			int dx, dy;		/* offset between two consecutive tiles */
 			int layer;
-			int type;
+			int count;
+			int *types;
 		} change_floor;
 
 		int number_actions;
@@ -160,6 +180,11 @@ typedef struct {
 
 		enemy *create_enemy;
 		enemy *delete_enemy;
+
+		struct {
+			int edge;		/* NORTH, EAST, SOUTH or WEST */
+			int insert;		/* TRUE to insert a line, FALSE to remove one */
+		} resize_level;
 	} d;
 } action;
 
@@ -40,6 +40,8 @@
 #include "lvledit/lvledit_widgets.h"
 #include "lvledit/lvledit_tool_select.h"
 #include "lvledit/lvledit_tool_place.h"
+#include "lvledit/lvledit_map.h"
+#include "lvledit/lvledit_overview.h"
 
 /* Undo/redo action lists */
 LIST_HEAD(to_undo);
@@ -47,12 +49,87 @@ LIST_HEAD(to_redo);
 
 static int push_mode = NORMAL;
 
+// Memory the undo/redo actions can use. When it is exceeded, the oldest
+// actions are forgotten, until the actions use 3/4 of it.
+#define UNDO_MEMORY_BUDGET (16 * 1024 * 1024)
+
+// Memory used by the actions of both lists
+static size_t actions_size;
+
+// Number of actions pushed since the end of the last multiple action.
+// They may be part of a multiple action still being built.
+static int unfinished_actions;
+
 /**
- *  @fn void clear_action(action * pos)
- *
- *  @brief clears an action from its list, and pointers held within the action
+ * Get the number of actions stored in an action.
  */
-static void clear_action(action * action)
+static int action_count(action *a)
+{
+	switch (a->type) {
+	case ACT_CREATE_OBSTACLE:
+		return a->d.create_obstacle.count;
+	case ACT_REMOVE_OBSTACLE:
+		return a->d.delete_obstacles.count;
+	case ACT_TILE_FLOOR_SET:
+		return a->d.change_floor.count;
+	default:
+		return 1;
+	}
+}
+
+/**
+ * Get the memory used by one of the actions stored in an action.
+ */
+static size_t action_item_size(action *a)
+{
+	switch (a->type) {
+	case ACT_CREATE_OBSTACLE:
+		return sizeof(struct undo_obstacle);
+	case ACT_TILE_FLOOR_SET:
+		return sizeof(int);
+	default:
+		return 0;
+	}
+}
+
+/**
+ * Get the memory used by an action, without the actions stored in it.
+ */
+static size_t action_base_size(action *a)
+{
+	size_t size = sizeof(action);
+
+	if (a->type == ACT_SET_OBSTACLE_LABEL && a->d.change_obstacle_name.new_name != NULL)
+		size += strlen(a->d.change_obstacle_name.new_name) + 1;
+	else if (a->type == ACT_SET_MAP_LABEL && a->d.change_label_name.new_name != NULL)
+		size += strlen(a->d.change_label_name.new_name) + 1;
+	else if (a->type == ACT_CREATE_MAP_LABEL && a->d.create_map_label.label_name != NULL)
+		size += strlen(a->d.create_map_label.label_name) + 1;
+
+	return size;
+}
+
+static size_t action_size(action *a)
+{
+	return action_base_size(a) + action_count(a) * action_item_size(a);
+}
+
+/**
+ * Make room for one more action in the array of a batch. The arrays are
+ * allocated with a power of two size.
+ */
+static void *grow_batch(void *arr, int count, size_t size)
+{
+	if (count & (count - 1))
+		return arr;
+
+	return realloc(arr, 2 * count * size);
+}
+
+/**
+ * Free an action and the data held within the action.
+ */
+static void free_action(action *action)
 {
 	if (action->type == ACT_SET_OBSTACLE_LABEL && action->d.change_obstacle_name.new_name != NULL)
 		free(action->d.change_obstacle_name.new_name);
@@ -62,9 +139,25 @@ static void clear_action(action * action)
 		free(action->d.create_map_label.label_name);
 	else if (action->type == ACT_CREATE_ENEMY && action->d.create_enemy != NULL)
 		enemy_free(action->d.create_enemy);
+	else if (action->type == ACT_CREATE_OBSTACLE)
+		free(action->d.create_obstacle.obstacles);
+	else if (action->type == ACT_TILE_FLOOR_SET)
+		free(action->d.change_floor.types);
+
+	free(action);
+}
+
+/**
+ *  @fn void clear_action(action * pos)
+ *
+ *  @brief clears an action from its list, and pointers held within the action
+ */
+static void clear_action(action * action)
+{
+	actions_size -= action_size(action);
 
 	list_del(&action->node);	//< removes an action from a list
-	free(action);		//< frees the action
+	free_action(action);
 }
 
 /**
@@ -89,6 +182,7 @@ void action_freestack(void)
 {
 	clear_action_list(&to_redo);
 	clear_action_list(&to_undo);
+	unfinished_actions = 0;
 }
 
 static action *action_create(int type, va_list args)
@@ -97,13 +191,20 @@ static action *action_create(int type, va_list args)
 	act->type = type;
 	switch (type) {
 		case ACT_CREATE_OBSTACLE:
-			act->d.create_obstacle.x = va_arg(args, double);
-			act->d.create_obstacle.y = va_arg(args, double);
-			act->d.create_obstacle.new_obstacle_type = va_arg(args, int);
+			act->d.create_obstacle.count = 1;
+			act->d.create_obstacle.obstacles = MyMalloc(sizeof(struct undo_obstacle));
+			act->d.create_obstacle.obstacles[0].x = va_arg(args, double);
+			act->d.create_obstacle.obstacles[0].y = va_arg(args, double);
+			act->d.create_obstacle.obstacles[0].type = va_arg(args, int);
 			break;
-		case ACT_REMOVE_OBSTACLE:
-			act->d.delete_obstacle = va_arg(args, obstacle *);
+		case ACT_REMOVE_OBSTACLE: {
+			obstacle *o = va_arg(args, obstacle *);
+			act->d.delete_obstacles.levelnum = o->pos.z;
+			act->d.delete_obstacles.first = get_obstacle_index(curShip.AllLevels[o->pos.z], o);
+			act->d.delete_obstacles.step = 0;
+			act->d.delete_obstacles.count = 1;
 			break;
+		}
 		case ACT_MOVE_OBSTACLE:
 			act->d.move_obstacle.obstacle = va_arg(args, obstacle *);
 			act->d.move_obstacle.newx = va_arg(args, double);
@@ -147,8 +248,12 @@ static action *action_create(int type, va_list args)
 		case ACT_TILE_FLOOR_SET:
 			act->d.change_floor.x = va_arg(args, int);
 			act->d.change_floor.y = va_arg(args, int);
+			act->d.change_floor.dx = 0;
+			act->d.change_floor.dy = 0;
 			act->d.change_floor.layer = va_arg(args, int);
-			act->d.change_floor.type = va_arg(args, int);
+			act->d.change_floor.count = 1;
+			act->d.change_floor.types = MyMalloc(sizeof(int));
+			act->d.change_floor.types[0] = va_arg(args, int);
 			break;
 		case ACT_MULTIPLE_ACTIONS:
 			act->d.number_actions = va_arg(args, int);
@@ -186,6 +291,10 @@ static action *action_create(int type, va_list args)
 		case ACT_REMOVE_ENEMY:
 			act->d.delete_enemy = va_arg(args, enemy *);
 			break;
+		case ACT_RESIZE_LEVEL:
+			act->d.resize_level.edge = va_arg(args, int);
+			act->d.resize_level.insert = va_arg(args, int);
+			break;
 		default:
 			error_message(__FUNCTION__, "Unknown action type %d", PLEASE_INFORM | IS_FATAL, type);
 	}
@@ -193,6 +302,228 @@ static action *action_create(int type, va_list args)
 	return act;
 }
 
+/**
+ * Tell if the next element of a run can be found at a given offset from
+ * the last one.
+ */
+static int continues_run(int step, int offset, int count)
+{
+	if (count == 1)
+		return offset == 1 || offset == -1;
+
+	return offset == step;
+}
+
+/**
+ * Store a new action in the last action of a list, if they are of the same
+ * kind.
+ * @return TRUE if the new action was stored, and can be freed.
+ */
+static int merge_action(action *last, action *act)
+{
+	if (last->type != act->type)
+		return FALSE;
+
+	switch (act->type) {
+	case ACT_CREATE_OBSTACLE: {
+		int count = last->d.create_obstacle.count;
+
+		last->d.create_obstacle.obstacles = grow_batch(last->d.create_obstacle.obstacles, count, sizeof(struct undo_obstacle));
+		last->d.create_obstacle.obstacles[count] = act->d.create_obstacle.obstacles[0];
+		last->d.create_obstacle.count++;
+		return TRUE;
+	}
+
+	case ACT_REMOVE_OBSTACLE: {
+		int count = last->d.delete_obstacles.count;
+		int offset = act->d.delete_obstacles.first - (last->d.delete_obstacles.first + (count - 1) * last->d.delete_obstacles.step);
+
+		if (last->d.delete_obstacles.levelnum != act->d.delete_obstacles.levelnum ||
+		    !continues_run(last->d.delete_obstacles.step, offset, count))
+			return FALSE;
+
+		last->d.delete_obstacles.step = offset;
+		last->d.delete_obstacles.count++;
+		return TRUE;
+	}
+
+	case ACT_TILE_FLOOR_SET: {
+		int count = last->d.change_floor.count;
+		int offset_x = act->d.change_floor.x - (last->d.change_floor.x + (count - 1) * last->d.change_floor.dx);
+		int offset_y = act->d.change_floor.y - (last->d.change_floor.y + (count - 1) * last->d.change_floor.dy);
+
+		if (last->d.change_floor.layer != act->d.change_floor.layer)
+			return FALSE;
+
+		if (!(offset_y == 0 && continues_run(last->d.change_floor.dx, offset_x, count) && (count == 1 || last->d.change_floor.dy == 0)) &&
+		    !(offset_x == 0 && continues_run(last->d.change_floor.dy, offset_y, count) && (count == 1 || last->d.change_floor.dx == 0)))
+			return FALSE;
+
+		last->d.change_floor.types = grow_batch(last->d.change_floor.types, count, sizeof(int));
+		last->d.change_floor.types[count] = act->d.change_floor.types[0];
+		last->d.change_floor.dx = offset_x;
+		last->d.change_floor.dy = offset_y;
+		last->d.change_floor.count++;
+		return TRUE;
+	}
+
+	default:
+		return FALSE;
+	}
+}
+
+/**
+ * Add an action on top of a list, storing it in the last action of the list
+ * when possible.
+ */
+static void add_action(action *act, struct list_head *list)
+{
+	if (!list_empty(list)) {
+		action *last = list_entry(list->next, action, node);
+		size_t old_size = action_size(last);
+
+		if (merge_action(last, act)) {
+			actions_size += action_size(last) - old_size;
+			free_action(act);
+			return;
+		}
+	}
+
+	list_add(&act->node, list);
+	actions_size += action_size(act);
+}
+
+/**
+ * Forget the first actions stored in an action, keeping the last 'keep'
+ * ones.
+ */
+static void keep_last_actions(action *a, int keep)
+{
+	int drop = action_count(a) - keep;
+
+	actions_size -= action_size(a);
+
+	switch (a->type) {
+	case ACT_CREATE_OBSTACLE:
+		memmove(a->d.create_obstacle.obstacles, a->d.create_obstacle.obstacles + drop, keep * sizeof(struct undo_obstacle));
+		a->d.create_obstacle.count = keep;
+		break;
+	case ACT_REMOVE_OBSTACLE:
+		a->d.delete_obstacles.first += drop * a->d.delete_obstacles.step;
+		a->d.delete_obstacles.count = keep;
+		break;
+	case ACT_TILE_FLOOR_SET:
+		memmove(a->d.change_floor.types, a->d.change_floor.types + drop, keep * sizeof(int));
+		a->d.change_floor.x += drop * a->d.change_floor.dx;
+		a->d.change_floor.y += drop * a->d.change_floor.dy;
+		a->d.change_floor.count = keep;
+		break;
+	default:
+		break;
+	}
+
+	actions_size += action_size(a);
+}
+
+/**
+ * Forget the last action stored in an action, once it has been undone or
+ * redone.
+ */
+static void drop_last_action(action *a)
+{
+	if (action_count(a) == 1) {
+		clear_action(a);
+		return;
+	}
+
+	actions_size -= action_item_size(a);
+
+	switch (a->type) {
+	case ACT_CREATE_OBSTACLE:
+		a->d.create_obstacle.count--;
+		break;
+	case ACT_REMOVE_OBSTACLE:
+		a->d.delete_obstacles.count--;
+		break;
+	case ACT_TILE_FLOOR_SET:
+		a->d.change_floor.count--;
+		break;
+	default:
+		break;
+	}
+}
+
+/**
+ * Forget the oldest actions of the undo list, when the actions use more
+ * memory than their budget.
+ *
+ * The undo list is cut between two undoable steps, a multiple action
+ * being a single step, and the most recent step is always kept.
+ */
+static void trim_undo_list(void)
+{
+	struct list_head *pos = to_undo.next;
+	int used = 0;		// Number of actions stored in 'pos' already counted
+	int first_step = TRUE;
+	size_t size = 0;
+
+	if (actions_size <= UNDO_MEMORY_BUDGET)
+		return;
+
+	while (pos != &to_undo) {
+		struct list_head *step_pos = pos;
+		int step_used = used;
+		int nb;
+
+		// Find the number of actions of the step
+		action *a = list_entry(pos, action, node);
+		if (first_step && unfinished_actions) {
+			nb = unfinished_actions;
+		} else if (a->type == ACT_MULTIPLE_ACTIONS && !used) {
+			nb = a->d.number_actions;
+			size += action_size(a);
+			pos = pos->next;
+		} else {
+			nb = 1;
+		}
+
+		// Add the size of the actions of the step
+		while (nb > 0 && pos != &to_undo) {
+			a = list_entry(pos, action, node);
+			int count = action_count(a);
+			int taken = min(nb, count - used);
+
+			if (!used)
+				size += action_base_size(a);
+			size += taken * action_item_size(a);
+
+			used += taken;
+			nb -= taken;
+			if (used == count) {
+				pos = pos->next;
+				used = 0;
+			}
+		}
+
+		if (!first_step && size > UNDO_MEMORY_BUDGET / 4 * 3) {
+			// Forget this step and all the older ones
+			if (step_used) {
+				keep_last_actions(list_entry(step_pos, action, node), step_used);
+				step_pos = step_pos->next;
+			}
+
+			while (step_pos != &to_undo) {
+				struct list_head *next = step_pos->next;
+				clear_action(list_entry(step_pos, action, node));
+				step_pos = next;
+			}
+			return;
+		}
+
+		first_step = FALSE;
+	}
+}
+
 void action_push(int type, ...)
 {
 	va_list args;
@@ -202,19 +533,26 @@ void action_push(int type, ...)
 
 	switch (push_mode) {
 		case UNDO:
-			list_add(&act->node, &to_redo);
+			add_action(act, &to_redo);
 			break;
 		case REDO:
-			list_add(&act->node, &to_undo);
+			add_action(act, &to_undo);
 			break;
 		case NORMAL:
-			list_add(&act->node, &to_undo);
+			add_action(act, &to_undo);
 			clear_action_list(&to_redo);
+
+			if (type == ACT_MULTIPLE_ACTIONS)
+				unfinished_actions = 0;
+			else
+				unfinished_actions++;
+
+			trim_undo_list();
 			break;
 		default:
 			// Should not happen, so this is a protection against a bug in the
 			// calling stack, to avoid a memory leak.
-			free(act);
+			free_action(act);
 			break;
 	}
 
@@ -557,6 +895,7 @@ void action_set_floor_layer(Level EditLevel, int x, int y, int layer, int type)
 
 	int old = EditLevel->map[y][x].floor_values[layer];
 	EditLevel->map[y][x].floor_values[layer] = type;
+	lvledit_overview_invalidate_tile(EditLevel->levelnum, x, y);
 	action_push(ACT_TILE_FLOOR_SET, x, y, layer, old);
 }
 
@@ -699,6 +1038,120 @@ void action_remove_map_label(level *lvl, int x, int y)
 	}
 }
 
+/**
+ * Insert or remove a line or a column on an edge of a level, and push the
+ * opposite change on the undo/redo stack.
+ * \param lvl Pointer towards the level to resize
+ * \param edge The edge of the level: NORTH, EAST, SOUTH or WEST
+ * \param insert TRUE to insert a line or column, FALSE to remove one
+ */
+void action_resize_level(level *lvl, int edge, int insert)
+{
+	if (resize_level(lvl, edge, insert)) {
+		gps_transform_map_dirty_flag = TRUE;
+		lvledit_overview_invalidate_level(lvl->levelnum);
+		action_push(ACT_RESIZE_LEVEL, edge, !insert);
+	}
+}
+
+/**
+ * Insert or remove a line or a column on an edge of a level, in an undoable
+ * way.
+ *
+ * Before a line or column is removed, the objects on it are removed and its
+ * floor tiles are saved with their own undoable actions, so that undoing the
+ * removal only has to insert an empty line or column again.
+ * \param lvl Pointer towards the level to resize
+ * \param edge The edge of the level: NORTH, EAST, SOUTH or WEST
+ * \param insert TRUE to insert a line or column, FALSE to remove one
+ */
+void action_resize_level_user(level *lvl, int edge, int insert)
+{
+	int x0 = 0, y0 = 0, x1 = lvl->xlen, y1 = lvl->ylen;
+	int nb_actions = 0;
+	int i, x, y, layer;
+
+	if (insert) {
+		action_resize_level(lvl, edge, TRUE);
+		return;
+	}
+
+	if (((edge == NORTH || edge == SOUTH) ? lvl->ylen : lvl->xlen) - 1 < MIN_MAP_LINES)
+		return;
+
+	// Area of the line or column to remove
+	switch (edge) {
+	case NORTH:
+		y1 = 1;
+		break;
+	case SOUTH:
+		y0 = lvl->ylen - 1;
+		break;
+	case WEST:
+		x1 = 1;
+		break;
+	case EAST:
+		x0 = lvl->xlen - 1;
+		break;
+	}
+
+#define ON_REMOVED_AREA(X, Y) ((X) >= x0 && (X) < x1 && (Y) >= y0 && (Y) < y1)
+
+	for (i = 0; i < lvl->obstacle_list.size; i++) {
+		obstacle *o = &ACCESS_OBSTACLE(lvl, i);
+		if (o->type != -1 && ON_REMOVED_AREA(o->pos.x, o->pos.y)) {
+			action_remove_obstacle_user(lvl, o);
+			nb_actions++;
+		}
+	}
+
+	for (i = 0; i < lvl->ItemList.size; i++) {
+		item *it = &ACCESS_FLOOR_ITEM(lvl, i);
+		if (it->type != -1 && ON_REMOVED_AREA(it->pos.x, it->pos.y)) {
+			action_remove_item(lvl, it);
+			nb_actions++;
+		}
+	}
+
+	// The waypoints and map labels are removed from their arrays
+	for (i = lvl->waypoints.size - 1; i >= 0; i--) {
+		waypoint *w = &((waypoint *)lvl->waypoints.arr)[i];
+		if (ON_REMOVED_AREA(w->x, w->y)) {
+			action_remove_waypoint(lvl, w->x, w->y);
+			nb_actions++;
+		}
+	}
+
+	for (i = lvl->map_labels.size - 1; i >= 0; i--) {
+		struct map_label *m = &ACCESS_MAP_LABEL(lvl->map_labels, i);
+		if (ON_REMOVED_AREA(m->pos.x, m->pos.y)) {
+			action_remove_map_label(lvl, m->pos.x, m->pos.y);
+			nb_actions++;
+		}
+	}
+
+#undef ON_REMOVED_AREA
+
+	// The floor tiles are pushed along the line or column, to be stored
+	// in a single run per floor layer
+	for (layer = 0; layer < lvl->floor_layers; layer++) {
+		for (y = y0; y < y1; y++) {
+			for (x = x0; x < x1; x++) {
+				action_push(ACT_TILE_FLOOR_SET, x, y, layer, lvl->map[y][x].floor_values[layer]);
+				nb_actions++;
+			}
+		}
+	}
+
+	if (resize_level(lvl, edge, FALSE)) {
+		gps_transform_map_dirty_flag = TRUE;
+		action_push(ACT_RESIZE_LEVEL, edge, TRUE);
+		nb_actions++;
+	}
+
+	action_push(ACT_MULTIPLE_ACTIONS, nb_actions);
+}
+
 void action_create_enemy(level *lvl, enemy *en)
 {
 	enemy_insert_into_lists(en, TRUE);
@@ -726,6 +1179,8 @@ void action_remove_enemy(level *lvl, enemy *en)
 			list_del(&current_enemy->level_list);
 	}
 
+	mission_bot_changed(en);
+
 	action_push(ACT_CREATE_ENEMY, en);
 }
 
@@ -758,15 +1213,25 @@ void action_jump_to_level_center(int level_num)
 	action_jump_to_level(level_num, x, y);
 }
 
+/**
+ * Do the last action stored in an action.
+ */
 static void action_do(level * level, action * a)
 {
+	int last = action_count(a) - 1;
+
 	switch (a->type) {
-	case ACT_CREATE_OBSTACLE:
-		action_create_obstacle_user(level, a->d.create_obstacle.x, a->d.create_obstacle.y, a->d.create_obstacle.new_obstacle_type);
+	case ACT_CREATE_OBSTACLE: {
+		struct undo_obstacle *o = &a->d.create_obstacle.obstacles[last];
+		action_create_obstacle_user(level, o->x, o->y, o->type);
 		break;
-	case ACT_REMOVE_OBSTACLE:
-		action_remove_obstacle_user(level, a->d.delete_obstacle);
+	}
+	case ACT_REMOVE_OBSTACLE: {
+		struct level *lvl = curShip.AllLevels[a->d.delete_obstacles.levelnum];
+		int index = a->d.delete_obstacles.first + last * a->d.delete_obstacles.step;
+		action_remove_obstacle_user(lvl, &ACCESS_OBSTACLE(lvl, index));
 		break;
+	}
 	case ACT_MOVE_OBSTACLE:
 		action_move_obstacle(level, a->d.move_obstacle.obstacle, a->d.move_obstacle.newx, a->d.move_obstacle.newy);
 		break;
@@ -795,7 +1260,9 @@ static void action_do(level * level, action * a)
 		action_toggle_waypoint_connection(level, a->d.toggle_waypoint_connection.x, a->d.toggle_waypoint_connection.y, 1, 1);
 		break;
 	case ACT_TILE_FLOOR_SET:
-		action_set_floor_layer(level, a->d.change_floor.x, a->d.change_floor.y, a->d.change_floor.layer, a->d.change_floor.type);
+		action_set_floor_layer(level, a->d.change_floor.x + last * a->d.change_floor.dx,
+				       a->d.change_floor.y + last * a->d.change_floor.dy,
+				       a->d.change_floor.layer, a->d.change_floor.types[last]);
 		break;
 	case ACT_MULTIPLE_ACTIONS:
 		error_message(__FUNCTION__, "Passed a multiple actions meta-action as parameter. A real action is needed.", PLEASE_INFORM);
@@ -825,6 +1292,9 @@ static void action_do(level * level, action * a)
 	case ACT_REMOVE_ENEMY:
 		action_remove_enemy(level, a->d.delete_enemy);
 		break;
+	case ACT_RESIZE_LEVEL:
+		action_resize_level(level, a->d.resize_level.edge, a->d.resize_level.insert);
+		break;
 	}
 }
 
@@ -855,12 +1325,14 @@ static void __level_editor_do_action_from_stack(struct list_head *stack)
 		action_push(ACT_MULTIPLE_ACTIONS, max);
 	} else {
 		action_do(EditLevel(), a);
-		clear_action(a);
+
+		drop_last_action(a);
 	}
 }
 
 void level_editor_action_undo()
 {
+	unfinished_actions = 0;
 	push_mode = UNDO;
 	__level_editor_do_action_from_stack(&to_undo);
 	push_mode = NORMAL;
@@ -868,6 +1340,7 @@ void level_editor_action_undo()
 
 void level_editor_action_redo()
 {
+	unfinished_actions = 0;
 	push_mode = REDO;
 	__level_editor_do_action_from_stack(&to_redo);
 	push_mode = NORMAL;
@@ -961,24 +1434,9 @@ void CreateNewMapLevel(int level_num)
 	NewLevel->jump_target_east = (-1);
 	NewLevel->jump_target_west = (-1);
 
-	// Now we initialize the map obstacles with 'empty' information
-	//
-	for (i = 0; i < MAX_OBSTACLES_ON_MAP; i++) {
-		NewLevel->obstacle_list[i].type = (-1);
-		NewLevel->obstacle_list[i].pos.x = (-1);
-		NewLevel->obstacle_list[i].pos.y = (-1);
-		NewLevel->obstacle_list[i].pos.z = level_num;
-	}
-
-	// First we initialize the items arrays with 'empty' information
+	// Now we initialize the (empty) obstacle and item lists
 	//
-	for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
-		NewLevel->ItemList[i].pos.x = (-1);
-		NewLevel->ItemList[i].pos.y = (-1);
-		NewLevel->ItemList[i].pos.z = (-1);
-		NewLevel->ItemList[i].type = (-1);
-
-	}
+	init_level_pools(NewLevel);
 
 	// Initialize obstacle extensions
 	dynarray_init(&NewLevel->obstacle_extensions, 10, sizeof(struct obstacle_extension));
@@ -56,6 +56,8 @@ void action_change_floor_layer(level *, int);
 void level_editor_action_change_map_label_user(level *, float, float);
 void action_jump_to_level(int, double, double);
 void action_jump_to_level_center(int);
+void action_resize_level(level *, int, int);
+void action_resize_level_user(level *, int, int);
 void CreateNewMapLevel(int);
 void delete_map_level(int);
 
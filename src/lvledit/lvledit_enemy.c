@@ -169,7 +169,9 @@ static void edit_special_force_info(enemy *en)
 		RestoreMenuBackground(0);
 	}
 
+	mission_bot_changed(en);
 	en->marker = numb;
+	mission_bot_changed(en);
 	autostr_append(displayed_text, _("%d\n Faction: "), numb);
 	sprintf(suggested_val, "%s", get_faction_from_id(en->faction));
 
@@ -179,6 +181,7 @@ static void edit_special_force_info(enemy *en)
 		goto out;
 
 	en->faction = get_faction_id(user_input);
+	mission_bot_changed(en);
 
 	autostr_append(displayed_text, _("%s\n Dialog name: "), get_faction_from_id(en->faction));
 	sprintf(suggested_val, "%s", en->dialog_section_name);
@@ -77,9 +77,9 @@ static void move_items(level *EditLevel, int x, int y)
 
 	int i;
 
-	for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
+	for (i = 0; i < EditLevel->ItemList.size; i++) {
 		// Get the item
-		item *item = &EditLevel->ItemList[i];
+		item *item = &ACCESS_FLOOR_ITEM(EditLevel, i);
 
 		// Maybe the item entry isn't used at all. That's the simplest
 		// case...: do nothing
@@ -107,9 +107,9 @@ static void move_obstacles(struct level *edit_level, int x, int y)
 {
 	int i;
 
-	for (i = 0; i < MAX_OBSTACLES_ON_MAP; i++) {
+	for (i = 0; i < edit_level->obstacle_list.size; i++) {
 		// Get the obstacle
-		struct obstacle *o = &edit_level->obstacle_list[i];
+		struct obstacle *o = &ACCESS_OBSTACLE(edit_level, i);
 
 		// Maybe the obstacle entry isn't used at all. That's the simplest
 		// case...: do nothing
@@ -171,14 +171,15 @@ static void move_all_objects(level *EditLevel, int x, int y)
 /**
  * Insert a line at the very north of a map
  * \param EditLevel Pointer towards the editing level
+ * \return TRUE if the line was inserted
  */
-void insert_line_north(level *EditLevel)
+int insert_line_north(level *EditLevel)
 {
 	int i;
 	map_tile *tmp;
 
 	if (EditLevel->ylen + 1 >= MAX_MAP_LINES)
-		return;
+		return FALSE;
 
 	// To insert a north line, we first extend the level to the south, and then
 	// we 'rotate' the map lines
@@ -191,18 +192,21 @@ void insert_line_north(level *EditLevel)
 
 	// Now we also have to shift the position of all elements
 	move_all_objects(EditLevel, 0, 1);
+
+	return TRUE;
 }
 
 /**
  * Insert a line at the very south of a map
  * \param EditLevel Pointer towards the editing level
+ * \return TRUE if the line was inserted
  */
-void insert_line_south(level *EditLevel)
+int insert_line_south(level *EditLevel)
 {
 	int i;
 
 	if (EditLevel->ylen + 1 >= MAX_MAP_LINES)
-		return;
+		return FALSE;
 
 	EditLevel->ylen++;
 	
@@ -211,19 +215,22 @@ void insert_line_south(level *EditLevel)
 	for (i = 0; i < EditLevel->xlen; i++) {
 		init_map_tile(&EditLevel->map[EditLevel->ylen - 1][i]);
 	}
+
+	return TRUE;
 }
 
 /**
  * Insert a column at the very east of a map
  * \param EditLevel Pointer towards the editing level
+ * \return TRUE if the column was inserted
  */
-void insert_column_east(level *EditLevel)
+int insert_column_east(level *EditLevel)
 {
 	int i;
 	map_tile *MapPointer;
 
 	if (EditLevel->xlen + 1 >= MAX_MAP_LINES)
-		return;
+		return FALSE;
 
 	EditLevel->xlen++;
 
@@ -233,19 +240,22 @@ void insert_column_east(level *EditLevel)
 		init_map_tile(&MapPointer[EditLevel->xlen - 1]);
 		EditLevel->map[i] = MapPointer;
 	}
+
+	return TRUE;
 }
 
 /**
  * Insert a column at the very west of a map
  * \param EditLevel Pointer towards the editing level
+ * \return TRUE if the column was inserted
  */
-void insert_column_west(level *EditLevel)
+int insert_column_west(level *EditLevel)
 {
 	int i;
 	map_tile MapTile;
 
 	if (EditLevel->xlen + 1 >= MAX_MAP_LINES)
-		return;
+		return FALSE;
 
 	// To insert a west column, we first extend the level to the east, and then
 	// we 'rotate' each line
@@ -260,16 +270,19 @@ void insert_column_west(level *EditLevel)
 
 	// Now we also have to shift the position of all elements
 	move_all_objects(EditLevel, 1, 0);
+
+	return TRUE;
 }
 
 /**
  * Remove a column at the very east of a map
  * \param EditLevel Pointer towards the editing level
+ * \return TRUE if the column was removed
  */
-void remove_column_east(level *EditLevel)
+int remove_column_east(level *EditLevel)
 {
 	if (EditLevel->xlen - 1 < MIN_MAP_LINES)
-		return;
+		return FALSE;
 
 	free_glued_obstacles(EditLevel);
 
@@ -290,19 +303,22 @@ void remove_column_east(level *EditLevel)
 	// outside of the map
 	move_all_objects(EditLevel, 0, 0);
 	teleport_to_level_center(EditLevel->levelnum);
+
+	return TRUE;
 }
 
 /**
  * Remove a column at the very west of a map
  * \param EditLevel Pointer towards the editing level
+ * \return TRUE if the column was removed
  */
-void remove_column_west(level *EditLevel)
+int remove_column_west(level *EditLevel)
 {
 	int i;
 	map_tile *MapPointer;
 
 	if (EditLevel->xlen - 1 < MIN_MAP_LINES)
-		return;
+		return FALSE;
 
 	free_glued_obstacles(EditLevel);
 
@@ -324,18 +340,21 @@ void remove_column_west(level *EditLevel)
 	// Now we also have to shift the position of all elements
 	move_all_objects(EditLevel, -1, 0);
 	teleport_to_level_center(EditLevel->levelnum);
+
+	return TRUE;
 }
 
 /**
  * Remove a line at the very north of a map
  * \param EditLevel Pointer towards the editing level
+ * \return TRUE if the line was removed
  */
-void remove_line_north(level *EditLevel)
+int remove_line_north(level *EditLevel)
 {
 	int i;
 
 	if (EditLevel->ylen - 1 < MIN_MAP_LINES)
-		return;
+		return FALSE;
 
 	free_glued_obstacles(EditLevel);
 
@@ -356,18 +375,21 @@ void remove_line_north(level *EditLevel)
 	// Now we also have to shift the position of all elements
 	move_all_objects(EditLevel, 0, -1);
 	teleport_to_level_center(EditLevel->levelnum);
+
+	return TRUE;
 }
 
 /**
  * Remove a line at the very south of a map
  * \param EditLevel Pointer towards the editing level
+ * \return TRUE if the line was removed
  */
-void remove_line_south(level *EditLevel)
+int remove_line_south(level *EditLevel)
 {
 	int i;
 
 	if (EditLevel->ylen - 1 < MIN_MAP_LINES)
-		return;
+		return FALSE;
 
 	free_glued_obstacles(EditLevel);
 
@@ -390,6 +412,32 @@ void remove_line_south(level *EditLevel)
 	// outside of the map
 	move_all_objects(EditLevel, 0, 0);
 	teleport_to_level_center(EditLevel->levelnum);
+
+	return TRUE;
+}
+
+/**
+ * Insert or remove a line or a column on an edge of a map
+ * \param EditLevel Pointer towards the editing level
+ * \param edge The edge of the map: NORTH, EAST, SOUTH or WEST
+ * \param insert TRUE to insert a line or column, FALSE to remove one
+ * \return TRUE if the size of the map changed
+ */
+int resize_level(level *EditLevel, int edge, int insert)
+{
+	switch (edge) {
+	case NORTH:
+		return insert ? insert_line_north(EditLevel) : remove_line_north(EditLevel);
+	case SOUTH:
+		return insert ? insert_line_south(EditLevel) : remove_line_south(EditLevel);
+	case EAST:
+		return insert ? insert_column_east(EditLevel) : remove_column_east(EditLevel);
+	case WEST:
+		return insert ? insert_column_west(EditLevel) : remove_column_west(EditLevel);
+	default:
+		error_message(__FUNCTION__, "Unknown edge %d", PLEASE_INFORM, edge);
+		return FALSE;
+	}
 }
 
 /**
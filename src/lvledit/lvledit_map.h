@@ -23,14 +23,16 @@
  *
  */
 
-void insert_line_north(level *);
-void insert_line_south(level *);
-void insert_column_west(level *);
-void insert_column_east(level *);
+int insert_line_north(level *);
+int insert_line_south(level *);
+int insert_column_west(level *);
+int insert_column_east(level *);
 
-void remove_line_north(level *);
-void remove_line_south(level *);
-void remove_column_west(level *);
-void remove_column_east(level *);
+int remove_line_north(level *);
+int remove_line_south(level *);
+int remove_column_west(level *);
+int remove_column_east(level *);
+
+int resize_level(level *, int, int);
 
 void save_map(void);
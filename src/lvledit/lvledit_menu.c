@@ -36,6 +36,7 @@
 #include "lvledit/lvledit_map.h"
 #include "lvledit/lvledit_validator.h"
 #include "lvledit/lvledit_menu.h"
+#include "lvledit/lvledit_overview.h"
 #include "lvledit/lvledit_widgets.h"
 
 #include "mapgen/mapgen.h"
@@ -129,11 +130,11 @@ void edit_level_dimensions(void)
 		switch (menu_position) {
 		case INSERTREMOVE_COLUMN_VERY_EAST:
 			if (RightPressed()) {
-				insert_column_east(edit_level);
+				action_resize_level_user(edit_level, EAST, TRUE);
 				while (RightPressed()) ;
 			}
 			if (LeftPressed()) {
-				remove_column_east(edit_level);
+				action_resize_level_user(edit_level, EAST, FALSE);
 				while (LeftPressed()) ;
 			}
 			gps_transform_map_dirty_flag = TRUE;
@@ -141,11 +142,11 @@ void edit_level_dimensions(void)
 
 		case INSERTREMOVE_COLUMN_VERY_WEST:
 			if (RightPressed()) {
-				insert_column_west(edit_level);
+				action_resize_level_user(edit_level, WEST, TRUE);
 				while (RightPressed()) ;
 			}
 			if (LeftPressed()) {
-				remove_column_west(edit_level);
+				action_resize_level_user(edit_level, WEST, FALSE);
 				while (LeftPressed()) ;
 			}
 			gps_transform_map_dirty_flag = TRUE;
@@ -153,11 +154,11 @@ void edit_level_dimensions(void)
 
 		case INSERTREMOVE_LINE_VERY_SOUTH:
 			if (RightPressed()) {
-				insert_line_south(edit_level);
+				action_resize_level_user(edit_level, SOUTH, TRUE);
 				while (RightPressed()) ;
 			}
 			if (LeftPressed()) {
-				remove_line_south(edit_level);
+				action_resize_level_user(edit_level, SOUTH, FALSE);
 				while (LeftPressed()) ;
 			}
 			gps_transform_map_dirty_flag = TRUE;
@@ -165,11 +166,11 @@ void edit_level_dimensions(void)
 
 		case INSERTREMOVE_LINE_VERY_NORTH:
 			if (RightPressed()) {
-				insert_line_north(edit_level);
+				action_resize_level_user(edit_level, NORTH, TRUE);
 				while (RightPressed()) ;
 			}
 			if (LeftPressed()) {
-				remove_line_north(edit_level);
+				action_resize_level_user(edit_level, NORTH, FALSE);
 				while (LeftPressed()) ;
 			}
 			gps_transform_map_dirty_flag = TRUE;
@@ -791,6 +792,7 @@ static void level_options(void)
 								EditLevel()->map[y][x].floor_values[new_layers] = ISO_FLOOR_EMPTY;
 							}
 						}
+						lvledit_overview_invalidate_level(EditLevel()->levelnum);
 					}
 					if (current_floor_layer >= EditLevel()->floor_layers)
 						current_floor_layer = EditLevel()->floor_layers - 1;
@@ -0,0 +1,704 @@
+/*
+ *
+ *   Copyright (c) 2026 FreedroidRPG development team
+ *
+ *
+ *  This file is part of Freedroid
+ *
+ *  Freedroid is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Freedroid is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Freedroid; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ *  MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file lvledit_overview.c
+ * \brief Cached pictures of the floor of the levels, for the zoomed out
+ * level editor and its minimap.
+ *
+ * The floor of a level is drawn, at the largest zoom out factor of the level
+ * editor, into pictures ("chunks") of OVERVIEW_CHUNK_SIZE x OVERVIEW_CHUNK_SIZE
+ * tiles. The editor actions changing a floor tile mark its chunk, which is
+ * drawn again the next time it is displayed.
+ *
+ * When the map is zoomed out at that factor, the visible chunks are displayed
+ * instead of each floor tile. The animated floor tiles, the selected floor
+ * tiles, and the tiles of the chunks only partly shown (on the borders of the
+ * neighbor levels) are still drawn one by one. The minimap displays the
+ * chunks of the current level and of its neighbors, scaled down.
+ *
+ * The pixels of the floor tiles are taken from their SDL surface, or read
+ * back from their texture in OpenGL mode.
+ */
+
+#define _lvledit_overview_c 1
+
+#include "system.h"
+
+#include "defs.h"
+#include "struct.h"
+#include "global.h"
+#include "proto.h"
+
+#include "lvledit/lvledit.h"
+#include "lvledit/lvledit_display.h"
+#include "lvledit/lvledit_overview.h"
+#include "lvledit/lvledit_tool_select.h"
+
+#define OVERVIEW_CHUNK_SIZE 16
+
+struct overview_thumbnail {
+	SDL_Surface *surface;   // Floor tile at the overview scale, NULL if empty
+	int offset_x;
+	int offset_y;
+	int created;
+};
+
+struct overview_chunk {
+	struct image img;
+	int x, y;                      // Position of the picture, relative to the level's origin
+	int dirty;
+	struct dynarray live_tiles;    // Animated tiles (x + y * 65536), drawn one by one
+};
+
+struct level_overview {
+	struct overview_chunk *chunks;
+	int nb_chunks_x;
+	int nb_chunks_y;
+	int xlen;
+	int ylen;
+	int layer_start;
+	int layer_end;
+};
+
+static struct level_overview overviews[MAX_LEVELS];
+static struct overview_thumbnail thumbnails[MAX_FLOOR_TILES];
+
+// Texture read back in OpenGL mode, kept while the chunks are being drawn
+static struct {
+	unsigned int texture;
+	SDL_Surface *surface;
+} readback;
+
+// Range of floor layers displayed, see show_floor()
+static void get_displayed_layers(int *layer_start, int *layer_end)
+{
+	*layer_start = 0;
+	*layer_end = MAX_FLOOR_LAYERS;
+	if (!GameConfig.show_all_floor_layers) {
+		*layer_start = current_floor_layer;
+		*layer_end = current_floor_layer + 1;
+	}
+}
+
+/*
+ * Position of a floor tile in the overview of its level. This is where
+ * translate_map_point_to_screen_pixel() puts the center of the tile, at the
+ * overview zoom factor, relative to the level's origin.
+ */
+static float overview_zoom_inv(void)
+{
+	return 1.0 / OVERVIEW_ZOOM_FACTOR;
+}
+
+static int tile_pixel_x(int x, int y)
+{
+	return floor(FLOOR_TILE_WIDTH * 0.5 * overview_zoom_inv() * (x - y));
+}
+
+static int tile_pixel_y(int x, int y)
+{
+	return floor(FLOOR_TILE_HEIGHT * 0.5 * overview_zoom_inv() * (x + y + 1));
+}
+
+static SDL_Surface *create_overview_surface(int w, int h)
+{
+	SDL_Surface *surface = SDL_CreateRGBSurface(SDL_SWSURFACE, w, h, 32, rmask, gmask, bmask, amask);
+	SDL_FillRect(surface, NULL, SDL_MapRGBA(surface->format, 0, 0, 0, 0));
+	return surface;
+}
+
+static void release_readback(void)
+{
+	if (readback.surface) {
+		SDL_FreeSurface(readback.surface);
+		readback.surface = NULL;
+	}
+	readback.texture = 0;
+}
+
+/**
+ * Copy the pixels of an image into a new surface, with the alpha channel.
+ */
+static SDL_Surface *get_image_pixels(struct image *img)
+{
+	SDL_Surface *surface;
+	SDL_Rect rect = { .x = 0, .y = 0, .w = img->w, .h = img->h };
+
+	if (!img->w || !img->h)
+		return NULL;
+
+	if (!use_open_gl) {
+		SDL_Surface *img_surf = img->surface;
+
+		// The pixels of an image packed in an atlas are in the page surface
+		if (img->atlas_slot)
+			img_surf = get_atlas_image_surface(img, &rect);
+		if (!img_surf)
+			return NULL;
+
+		// Copy the alpha channel, instead of blending with it
+		Uint32 alpha_flags = img_surf->flags & (SDL_SRCALPHA | SDL_RLEACCEL);
+		Uint8 alpha = img_surf->format->alpha;
+
+		surface = create_overview_surface(img->w, img->h);
+		SDL_SetAlpha(img_surf, 0, 0);
+		SDL_BlitSurface(img_surf, &rect, surface, NULL);
+		SDL_SetAlpha(img_surf, alpha_flags, alpha);
+		return surface;
+	}
+
+#ifdef HAVE_LIBGL
+	if (!img->texture)
+		return NULL;
+
+	// Floor tiles are parts of the same few atlas textures, which are read
+	// back once
+	if (readback.texture != img->texture) {
+		release_readback();
+
+		end_image_batch(__FUNCTION__);
+		readback.surface = create_overview_surface(img->tex_w, img->tex_h);
+		readback.texture = img->texture;
+		glBindTexture(GL_TEXTURE_2D, img->texture);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_BGRA, GL_UNSIGNED_BYTE, readback.surface->pixels);
+		open_gl_check_error_status(__FUNCTION__);
+	}
+
+	rect.x = rintf(img->tex_x0 * img->tex_w);
+	rect.y = rintf(img->tex_y0 * img->tex_h);
+
+	surface = create_overview_surface(img->w, img->h);
+	SDL_SetAlpha(readback.surface, 0, 0);
+	SDL_BlitSurface(readback.surface, &rect, surface, NULL);
+	return surface;
+#else
+	return NULL;
+#endif
+}
+
+/**
+ * Get a floor tile scaled down to the overview zoom factor, the same way
+ * images are scaled when the map is zoomed out in SDL mode.
+ */
+static struct overview_thumbnail *get_thumbnail(int floor_value)
+{
+	struct overview_thumbnail *thumb = &thumbnails[floor_value];
+	struct image *img;
+	SDL_Surface *pixels;
+
+	if (thumb->created)
+		return thumb;
+	thumb->created = TRUE;
+
+	img = get_floor_tile_spec(floor_value)->current_image;
+	pixels = get_image_pixels(img);
+	if (!pixels)
+		return thumb;
+
+	thumb->surface = zoomSurface(pixels, overview_zoom_inv(), overview_zoom_inv(), TRUE);
+	thumb->offset_x = floor(img->offset_x * overview_zoom_inv());
+	thumb->offset_y = floor(img->offset_y * overview_zoom_inv());
+	SDL_FreeSurface(pixels);
+
+	return thumb;
+}
+
+/**
+ * Draw a surface over another one, with the same pixel format, blending
+ * the colors and the alpha channels.
+ */
+static void blend_surface(SDL_Surface *dst, SDL_Surface *src, int dst_x, int dst_y)
+{
+	SDL_PixelFormat *fmt = dst->format;
+	int x, y;
+
+	for (y = 0; y < src->h; y++) {
+		Uint32 *s = (Uint32 *)((Uint8 *)src->pixels + y * src->pitch);
+		Uint32 *d = (Uint32 *)((Uint8 *)dst->pixels + (y + dst_y) * dst->pitch) + dst_x;
+
+		for (x = 0; x < src->w; x++) {
+			Uint32 sa = (s[x] & fmt->Amask) >> fmt->Ashift;
+			Uint32 da = (d[x] & fmt->Amask) >> fmt->Ashift;
+
+			if (!sa)
+				continue;
+
+			if (sa == 255 || !da) {
+				d[x] = s[x];
+				continue;
+			}
+
+			Uint32 dw = da * (255 - sa) / 255;
+			Uint32 oa = sa + dw;
+			Uint32 r = (((s[x] & fmt->Rmask) >> fmt->Rshift) * sa + ((d[x] & fmt->Rmask) >> fmt->Rshift) * dw) / oa;
+			Uint32 g = (((s[x] & fmt->Gmask) >> fmt->Gshift) * sa + ((d[x] & fmt->Gmask) >> fmt->Gshift) * dw) / oa;
+			Uint32 b = (((s[x] & fmt->Bmask) >> fmt->Bshift) * sa + ((d[x] & fmt->Bmask) >> fmt->Bshift) * dw) / oa;
+
+			d[x] = (r << fmt->Rshift) | (g << fmt->Gshift) | (b << fmt->Bshift) | (oa << fmt->Ashift);
+		}
+	}
+}
+
+static int tile_is_animated(map_tile *tile, int layer_start, int layer_end)
+{
+	int layer;
+
+	for (layer = layer_start; layer < layer_end; layer++) {
+		if (tile->floor_values[layer] != ISO_FLOOR_EMPTY && get_floor_tile_spec(tile->floor_values[layer])->frames > 1)
+			return TRUE;
+	}
+
+	return FALSE;
+}
+
+/**
+ * Draw the floor tiles of a chunk into its picture.
+ */
+static void build_chunk(level *lvl, struct level_overview *ov, int cx, int cy)
+{
+	struct overview_chunk *chunk = &ov->chunks[cx + cy * ov->nb_chunks_x];
+	int x0 = cx * OVERVIEW_CHUNK_SIZE;
+	int y0 = cy * OVERVIEW_CHUNK_SIZE;
+	int x1 = min(x0 + OVERVIEW_CHUNK_SIZE, lvl->xlen);
+	int y1 = min(y0 + OVERVIEW_CHUNK_SIZE, lvl->ylen);
+	int left = INT_MAX, top = INT_MAX, right = INT_MIN, bottom = INT_MIN;
+	int x, y, layer;
+	struct overview_thumbnail *thumb;
+
+	chunk->dirty = FALSE;
+	chunk->live_tiles.size = 0;
+
+	// Compute the extent of the picture, and find the animated tiles
+	for (y = y0; y < y1; y++) {
+		for (x = x0; x < x1; x++) {
+			map_tile *tile = &lvl->map[y][x];
+
+			if (tile_is_animated(tile, ov->layer_start, ov->layer_end)) {
+				int coords = x + y * 65536;
+				dynarray_add(&chunk->live_tiles, &coords, sizeof(int));
+				continue;
+			}
+
+			for (layer = ov->layer_start; layer < ov->layer_end; layer++) {
+				if (tile->floor_values[layer] == ISO_FLOOR_EMPTY)
+					continue;
+
+				thumb = get_thumbnail(tile->floor_values[layer]);
+				if (!thumb->surface)
+					continue;
+
+				int px = tile_pixel_x(x, y) + thumb->offset_x;
+				int py = tile_pixel_y(x, y) + thumb->offset_y;
+				left = min(left, px);
+				top = min(top, py);
+				right = max(right, px + thumb->surface->w);
+				bottom = max(bottom, py + thumb->surface->h);
+			}
+		}
+	}
+
+	if (left >= right) {
+		struct image empty = EMPTY_IMAGE;
+		delete_image(&chunk->img);
+		chunk->img = empty;
+		return;
+	}
+
+	SDL_Surface *surface = create_overview_surface(right - left, bottom - top);
+
+	for (y = y0; y < y1; y++) {
+		for (x = x0; x < x1; x++) {
+			map_tile *tile = &lvl->map[y][x];
+
+			if (tile_is_animated(tile, ov->layer_start, ov->layer_end))
+				continue;
+
+			for (layer = ov->layer_start; layer < ov->layer_end; layer++) {
+				if (tile->floor_values[layer] == ISO_FLOOR_EMPTY)
+					continue;
+
+				thumb = get_thumbnail(tile->floor_values[layer]);
+				if (!thumb->surface)
+					continue;
+
+				blend_surface(surface, thumb->surface,
+				              tile_pixel_x(x, y) + thumb->offset_x - left,
+				              tile_pixel_y(x, y) + thumb->offset_y - top);
+			}
+		}
+	}
+
+	chunk->x = left;
+	chunk->y = top;
+
+	// In OpenGL mode, the surface is consumed by the texture creation, and
+	// the texture object is reused
+	free_image_surface(&chunk->img);
+	chunk->img.w = surface->w;
+	chunk->img.h = surface->h;
+	chunk->img.offset_x = 0;
+	chunk->img.offset_y = 0;
+	if (use_open_gl) {
+#ifdef HAVE_LIBGL
+		chunk->img.surface = surface;
+		make_texture_out_of_surface(&chunk->img);
+#endif
+	} else {
+		chunk->img.surface = SDL_DisplayFormatAlpha(surface);
+		SDL_FreeSurface(surface);
+	}
+}
+
+static void free_overview(int levelnum)
+{
+	struct level_overview *ov = &overviews[levelnum];
+	int i;
+
+	if (!ov->chunks)
+		return;
+
+	for (i = 0; i < ov->nb_chunks_x * ov->nb_chunks_y; i++) {
+		delete_image(&ov->chunks[i].img);
+		dynarray_free(&ov->chunks[i].live_tiles);
+	}
+
+	free(ov->chunks);
+	ov->chunks = NULL;
+}
+
+/**
+ * Get the overview of a level, with its floor layers in the given range.
+ * Its chunks are drawn when they are displayed.
+ */
+static struct level_overview *get_overview(level *lvl, int layer_start, int layer_end)
+{
+	struct level_overview *ov = &overviews[lvl->levelnum];
+	int i;
+
+	if (ov->chunks && (ov->xlen != lvl->xlen || ov->ylen != lvl->ylen))
+		free_overview(lvl->levelnum);
+
+	if (!ov->chunks) {
+		ov->xlen = lvl->xlen;
+		ov->ylen = lvl->ylen;
+		ov->nb_chunks_x = (lvl->xlen + OVERVIEW_CHUNK_SIZE - 1) / OVERVIEW_CHUNK_SIZE;
+		ov->nb_chunks_y = (lvl->ylen + OVERVIEW_CHUNK_SIZE - 1) / OVERVIEW_CHUNK_SIZE;
+		ov->chunks = MyMalloc(ov->nb_chunks_x * ov->nb_chunks_y * sizeof(struct overview_chunk));
+		for (i = 0; i < ov->nb_chunks_x * ov->nb_chunks_y; i++) {
+			struct image empty = EMPTY_IMAGE;
+			ov->chunks[i].img = empty;
+			ov->chunks[i].dirty = TRUE;
+		}
+		ov->layer_start = layer_start;
+		ov->layer_end = layer_end;
+	}
+
+	if (ov->layer_start != layer_start || ov->layer_end != layer_end) {
+		for (i = 0; i < ov->nb_chunks_x * ov->nb_chunks_y; i++)
+			ov->chunks[i].dirty = TRUE;
+		ov->layer_start = layer_start;
+		ov->layer_end = layer_end;
+	}
+
+	return ov;
+}
+
+/**
+ * Mark the floor tile of a level as changed.
+ */
+void lvledit_overview_invalidate_tile(int levelnum, int x, int y)
+{
+	struct level_overview *ov = &overviews[levelnum];
+
+	if (!ov->chunks || x < 0 || y < 0 || x >= ov->xlen || y >= ov->ylen)
+		return;
+
+	ov->chunks[x / OVERVIEW_CHUNK_SIZE + (y / OVERVIEW_CHUNK_SIZE) * ov->nb_chunks_x].dirty = TRUE;
+}
+
+/**
+ * Mark the whole floor of a level as changed.
+ */
+void lvledit_overview_invalidate_level(int levelnum)
+{
+	struct level_overview *ov = &overviews[levelnum];
+	int i;
+
+	if (!ov->chunks)
+		return;
+
+	for (i = 0; i < ov->nb_chunks_x * ov->nb_chunks_y; i++)
+		ov->chunks[i].dirty = TRUE;
+}
+
+/**
+ * Forget the overview of a level, when the level is freed.
+ */
+void lvledit_overview_forget_level(int levelnum)
+{
+	free_overview(levelnum);
+}
+
+/**
+ * Free all the overviews and the scaled down floor tiles, when the
+ * graphics are freed.
+ */
+void lvledit_overview_free(void)
+{
+	int i;
+
+	for (i = 0; i < MAX_LEVELS; i++)
+		free_overview(i);
+
+	for (i = 0; i < MAX_FLOOR_TILES; i++) {
+		if (thumbnails[i].surface)
+			SDL_FreeSurface(thumbnails[i].surface);
+		thumbnails[i].surface = NULL;
+		thumbnails[i].created = FALSE;
+	}
+
+	release_readback();
+}
+
+/**
+ * Part of the map, around the current level, where the tiles of a level are
+ * shown. The tile (x, y) of the level is shown at the virtual position
+ * (x - dx, y - dy) on the current level.
+ */
+struct overview_part {
+	level *lvl;
+	int dx, dy;
+	int rx0, ry0, rx1, ry1;   // Tiles of the level shown in this part of the map
+	int x0, y0, x1, y1;       // Tiles of the level which are visible
+};
+
+/**
+ * Get the part of the map where the current level (i = j = 1) or one of its
+ * neighbors is shown, and the visible tiles of that level.
+ *
+ * \return FALSE if no tile of the level is visible
+ */
+static int get_level_part(struct overview_part *part, int i, int j, int line_start, int line_end, int col_start, int col_end)
+{
+	level *cur = curShip.AllLevels[Me.pos.z];
+
+	if (i == 1 && j == 1) {
+		part->lvl = cur;
+		part->dx = 0;
+		part->dy = 0;
+	} else {
+		struct neighbor_data_cell *ngb = level_neighbors_map[Me.pos.z][j][i];
+		if (!ngb || !ngb->valid)
+			return FALSE;
+		part->lvl = curShip.AllLevels[ngb->lvl_idx];
+		part->dx = ngb->delta_x;
+		part->dy = ngb->delta_y;
+	}
+
+	// Virtual positions resolved to this level (see resolve_virtual_position())
+	part->rx0 = (i == 0) ? 0 : (i == 1) ? part->dx : cur->xlen + part->dx;
+	part->rx1 = (i == 0) ? part->dx : (i == 1) ? cur->xlen + part->dx : part->lvl->xlen;
+	part->ry0 = (j == 0) ? 0 : (j == 1) ? part->dy : cur->ylen + part->dy;
+	part->ry1 = (j == 0) ? part->dy : (j == 1) ? cur->ylen + part->dy : part->lvl->ylen;
+
+	part->rx0 = max(part->rx0, 0);
+	part->ry0 = max(part->ry0, 0);
+	part->rx1 = min(part->rx1, part->lvl->xlen);
+	part->ry1 = min(part->ry1, part->lvl->ylen);
+
+	part->x0 = max(part->rx0, col_start + part->dx);
+	part->x1 = min(part->rx1, col_end + part->dx);
+	part->y0 = max(part->ry0, line_start + part->dy);
+	part->y1 = min(part->ry1, line_end + part->dy);
+
+	return part->x0 < part->x1 && part->y0 < part->y1;
+}
+
+/**
+ * Iterate over the chunks of a level overlapping the given tiles.
+ */
+#define for_each_chunk_in_rect(cx, cy, x0, y0, x1, y1) \
+	for (cy = (y0) / OVERVIEW_CHUNK_SIZE; cy * OVERVIEW_CHUNK_SIZE < (y1); cy++) \
+		for (cx = (x0) / OVERVIEW_CHUNK_SIZE; cx * OVERVIEW_CHUNK_SIZE < (x1); cx++)
+
+static int chunk_inside_part(struct overview_part *part, int cx, int cy)
+{
+	int x0 = cx * OVERVIEW_CHUNK_SIZE;
+	int y0 = cy * OVERVIEW_CHUNK_SIZE;
+	int x1 = min(x0 + OVERVIEW_CHUNK_SIZE, part->lvl->xlen);
+	int y1 = min(y0 + OVERVIEW_CHUNK_SIZE, part->lvl->ylen);
+
+	return x0 >= part->rx0 && y0 >= part->ry0 && x1 <= part->rx1 && y1 <= part->ry1;
+}
+
+static void blit_live_tile(struct overview_part *part, int x, int y, int layer_start, int layer_end)
+{
+	blit_one_floor_tile(curShip.AllLevels[Me.pos.z], x - part->dx, y - part->dy, layer_start, layer_end, lvledit_zoomfact_inv());
+}
+
+/**
+ * Display the visible chunks of a level in the zoomed out map.
+ * The tiles of the chunks only partly shown in this part of the map are
+ * displayed one by one.
+ */
+static void display_level_part(struct overview_part *part, int layer_start, int layer_end)
+{
+	struct level_overview *ov = get_overview(part->lvl, layer_start, layer_end);
+	int cx, cy, i, x, y;
+	int ox, oy;
+
+	// Position on screen of the origin of the level
+	translate_map_point_to_screen_pixel(0, 0, &ox, &oy);
+	ox += floor(FLOOR_TILE_WIDTH * 0.5 * overview_zoom_inv() * (part->dy - part->dx));
+	oy += floor(FLOOR_TILE_HEIGHT * 0.5 * overview_zoom_inv() * (-part->dx - part->dy));
+
+	for_each_chunk_in_rect(cx, cy, part->x0, part->y0, part->x1, part->y1) {
+		struct overview_chunk *chunk = &ov->chunks[cx + cy * ov->nb_chunks_x];
+
+		if (!chunk_inside_part(part, cx, cy)) {
+			int x1 = min((cx + 1) * OVERVIEW_CHUNK_SIZE, part->x1);
+			int y1 = min((cy + 1) * OVERVIEW_CHUNK_SIZE, part->y1);
+			for (y = max(cy * OVERVIEW_CHUNK_SIZE, part->y0); y < y1; y++) {
+				for (x = max(cx * OVERVIEW_CHUNK_SIZE, part->x0); x < x1; x++)
+					blit_live_tile(part, x, y, layer_start, layer_end);
+			}
+			continue;
+		}
+
+		if (chunk->img.w)
+			display_image_on_screen(&chunk->img, ox + chunk->x, oy + chunk->y, IMAGE_NO_TRANSFO);
+
+		for (i = 0; i < chunk->live_tiles.size; i++) {
+			int coords = ((int *)chunk->live_tiles.arr)[i];
+			blit_live_tile(part, coords % 65536, coords / 65536, layer_start, layer_end);
+		}
+	}
+}
+
+/**
+ * Draw the dirty chunks of a level visible in the zoomed out map.
+ */
+static void build_level_part(struct overview_part *part, int layer_start, int layer_end)
+{
+	struct level_overview *ov = get_overview(part->lvl, layer_start, layer_end);
+	int cx, cy;
+
+	for_each_chunk_in_rect(cx, cy, part->x0, part->y0, part->x1, part->y1) {
+		if (ov->chunks[cx + cy * ov->nb_chunks_x].dirty && chunk_inside_part(part, cx, cy))
+			build_chunk(part->lvl, ov, cx, cy);
+	}
+}
+
+static void blit_selected_tile(int x, int y, void *data)
+{
+	int *layers = data;
+
+	blit_one_floor_tile(curShip.AllLevels[Me.pos.z], x, y, layers[0], layers[1], lvledit_zoomfact_inv());
+}
+
+/**
+ * Display the floor of the zoomed out map from the overviews of the current
+ * level and of its neighbors, if the map is zoomed out at the overview zoom
+ * factor.
+ *
+ * \return TRUE if the floor was displayed, FALSE if it has to be drawn tile
+ * by tile
+ */
+int lvledit_overview_show_floor(int line_start, int line_end, int col_start, int col_end, int layer_start, int layer_end)
+{
+	struct overview_part parts[9];
+	int nb_parts = 0;
+	int layers[2] = { layer_start, layer_end };
+	int i, j;
+
+	if (game_status != INSIDE_LVLEDITOR || lvledit_zoomfact() != OVERVIEW_ZOOM_FACTOR)
+		return FALSE;
+
+	for (j = 0; j < 3; j++) {
+		for (i = 0; i < 3; i++) {
+			if (get_level_part(&parts[nb_parts], i, j, line_start, line_end, col_start, col_end))
+				nb_parts++;
+		}
+	}
+
+	// Chunks are drawn outside of the image batch, because their textures
+	// are created or read back
+	for (i = 0; i < nb_parts; i++)
+		build_level_part(&parts[i], layer_start, layer_end);
+	release_readback();
+
+	start_image_batch();
+
+	for (i = 0; i < nb_parts; i++)
+		display_level_part(&parts[i], layer_start, layer_end);
+
+	// Selected floor tiles are colorized
+	for_each_selected_floor_tile(blit_selected_tile, layers);
+
+	end_image_batch(__FUNCTION__);
+
+	return TRUE;
+}
+
+/**
+ * Display the overview of a level, scaled, for the minimap.
+ * The animated floor tiles are not displayed.
+ *
+ * \param x X position on screen of the level's origin (map position (0, 0))
+ * \param y Y position on screen of the level's origin
+ * \param scale Scale of the overview
+ * \param nb_builds Number of dirty chunks that can still be drawn during
+ * this frame, decremented for each chunk drawn. The other dirty chunks are
+ * displayed as they were.
+ */
+void lvledit_overview_display_level(int levelnum, int x, int y, float scale, int *nb_builds)
+{
+	struct level_overview *ov;
+	int layer_start, layer_end;
+	int i;
+
+	if (!level_exists(levelnum))
+		return;
+
+	get_displayed_layers(&layer_start, &layer_end);
+	ov = get_overview(curShip.AllLevels[levelnum], layer_start, layer_end);
+
+	for (i = 0; i < ov->nb_chunks_x * ov->nb_chunks_y; i++) {
+		struct overview_chunk *chunk = &ov->chunks[i];
+
+		if (chunk->dirty && *nb_builds > 0) {
+			build_chunk(curShip.AllLevels[levelnum], ov, i % ov->nb_chunks_x, i / ov->nb_chunks_x);
+			(*nb_builds)--;
+		}
+	}
+	release_readback();
+
+	for (i = 0; i < ov->nb_chunks_x * ov->nb_chunks_y; i++) {
+		struct overview_chunk *chunk = &ov->chunks[i];
+
+		if (chunk->img.w)
+			display_image_on_screen(&chunk->img, x + chunk->x * scale, y + chunk->y * scale, IMAGE_SCALE_TRANSFO(scale));
+	}
+}
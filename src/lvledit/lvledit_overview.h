@@ -0,0 +1,37 @@
+/*
+ *
+ *   Copyright (c) 2026 FreedroidRPG development team
+ *
+ *
+ *  This file is part of Freedroid
+ *
+ *  Freedroid is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Freedroid is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Freedroid; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ *  MA  02111-1307  USA
+ *
+ */
+
+#undef EXTERN
+#ifndef _lvledit_overview_c
+#define EXTERN extern
+#else
+#define EXTERN
+#endif
+
+// Zoom factor of the level overviews, the largest one of the level editor
+#define OVERVIEW_ZOOM_FACTOR 9.0
+
+void lvledit_overview_invalidate_tile(int levelnum, int x, int y);
+void lvledit_overview_invalidate_level(int levelnum);
+void lvledit_overview_display_level(int levelnum, int x, int y, float scale, int *nb_builds);
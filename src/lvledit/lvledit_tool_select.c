@@ -72,7 +72,181 @@ struct lvledit_map_tile {
 static LIST_HEAD(selected_elements);
 static LIST_HEAD(clipboard_elements);
 
+/* The selected elements are also kept in a hash set, so that the editor can
+ * tell whether an object is selected without walking the whole selection.
+ * Waypoints and map labels are selected as copies, so they are looked up by
+ * their coordinates, and floor tiles by the address of the map tile. */
+enum selection_key_kind {
+	SELECTION_KEY_NONE = 0,
+	SELECTION_KEY_POINTER,
+	SELECTION_KEY_WAYPOINT,
+	SELECTION_KEY_MAP_LABEL
+};
+
+struct selection_slot {
+	enum selection_key_kind kind;
+	uint64_t key;
+	struct selected_element *element;
+};
+
+static struct {
+	struct selection_slot *slots;
+	int nb_slots;                   // Always a power of 2
+	int nb_used;
+	int nb_waypoints;
+	int nb_map_labels;
+} selection_set;
+
+static uint64_t coord_key(int x, int y)
+{
+	return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+}
+
+static enum selection_key_kind element_key(struct selected_element *e, uint64_t *key)
+{
+	switch (e->type) {
+	case OBJECT_FLOOR:
+		*key = (uintptr_t)((struct lvledit_map_tile *)e->data)->tile;
+		return SELECTION_KEY_POINTER;
+	case OBJECT_WAYPOINT:
+		*key = coord_key(((waypoint *)e->data)->x, ((waypoint *)e->data)->y);
+		return SELECTION_KEY_WAYPOINT;
+	case OBJECT_MAP_LABEL:
+		*key = coord_key(((map_label *)e->data)->pos.x, ((map_label *)e->data)->pos.y);
+		return SELECTION_KEY_MAP_LABEL;
+	default:
+		*key = (uintptr_t)e->data;
+		return SELECTION_KEY_POINTER;
+	}
+}
+
+static int slot_home(enum selection_key_kind kind, uint64_t key)
+{
+	uint64_t hash = (key ^ (key >> 29) ^ kind) * 0x9E3779B97F4A7C15ULL;
+	return (hash >> 32) & (selection_set.nb_slots - 1);
+}
+
+static void selection_set_add(struct selected_element *e)
+{
+	uint64_t key;
+	enum selection_key_kind kind = element_key(e, &key);
+	int i;
+
+	if ((selection_set.nb_used + 1) * 4 > selection_set.nb_slots * 3) {
+		struct selection_slot *old = selection_set.slots;
+		int nb_old = selection_set.nb_slots;
+
+		selection_set.nb_slots = nb_old ? nb_old * 2 : 64;
+		selection_set.slots = MyMalloc(selection_set.nb_slots * sizeof(struct selection_slot));
+		selection_set.nb_used = 0;
+		selection_set.nb_waypoints = 0;
+		selection_set.nb_map_labels = 0;
+
+		for (i = 0; i < nb_old; i++) {
+			if (old[i].kind != SELECTION_KEY_NONE)
+				selection_set_add(old[i].element);
+		}
+		free(old);
+	}
+
+	for (i = slot_home(kind, key); selection_set.slots[i].kind != SELECTION_KEY_NONE; i = (i + 1) & (selection_set.nb_slots - 1))
+		;
+
+	selection_set.slots[i].kind = kind;
+	selection_set.slots[i].key = key;
+	selection_set.slots[i].element = e;
+	selection_set.nb_used++;
+	if (kind == SELECTION_KEY_WAYPOINT)
+		selection_set.nb_waypoints++;
+	else if (kind == SELECTION_KEY_MAP_LABEL)
+		selection_set.nb_map_labels++;
+}
+
+static void selection_set_del(struct selected_element *e)
+{
+	uint64_t key;
+	enum selection_key_kind kind = element_key(e, &key);
+	int mask = selection_set.nb_slots - 1;
+	int i, j;
+
+	if (!selection_set.nb_used)
+		return;
+
+	for (i = slot_home(kind, key); selection_set.slots[i].element != e; i = (i + 1) & mask) {
+		if (selection_set.slots[i].kind == SELECTION_KEY_NONE)
+			return;
+	}
+
+	selection_set.nb_used--;
+	if (kind == SELECTION_KEY_WAYPOINT)
+		selection_set.nb_waypoints--;
+	else if (kind == SELECTION_KEY_MAP_LABEL)
+		selection_set.nb_map_labels--;
 
+	// Move back the following slots of the probe sequence, so that no
+	// lookup stops on the freed slot
+	for (j = (i + 1) & mask; selection_set.slots[j].kind != SELECTION_KEY_NONE; j = (j + 1) & mask) {
+		int home = slot_home(selection_set.slots[j].kind, selection_set.slots[j].key);
+
+		if (((j - home) & mask) >= ((j - i) & mask)) {
+			selection_set.slots[i] = selection_set.slots[j];
+			i = j;
+		}
+	}
+	selection_set.slots[i].kind = SELECTION_KEY_NONE;
+	selection_set.slots[i].element = NULL;
+}
+
+static struct selected_element *selection_set_find(enum selection_key_kind kind, uint64_t key)
+{
+	int i;
+
+	if (!selection_set.nb_used)
+		return NULL;
+
+	for (i = slot_home(kind, key); selection_set.slots[i].kind != SELECTION_KEY_NONE; i = (i + 1) & (selection_set.nb_slots - 1)) {
+		if (selection_set.slots[i].kind == kind && selection_set.slots[i].key == key)
+			return selection_set.slots[i].element;
+	}
+
+	return NULL;
+}
+
+/**
+ * Rebuild the hash set of the selection, after the keys of its elements
+ * were changed.
+ */
+static void selection_set_rebuild(void)
+{
+	struct selected_element *e;
+
+	if (selection_set.nb_slots)
+		memset(selection_set.slots, 0, selection_set.nb_slots * sizeof(struct selection_slot));
+	selection_set.nb_used = 0;
+	selection_set.nb_waypoints = 0;
+	selection_set.nb_map_labels = 0;
+
+	list_for_each_entry(e, &selected_elements, node)
+		selection_set_add(e);
+}
+
+/**
+ * Find the selected element holding the given object.
+ * As the selection does not know the type of the object, it is compared
+ * as a waypoint or as a map label only when such elements are selected.
+ */
+static struct selected_element *find_selected_element(void *data)
+{
+	struct selected_element *e;
+
+	e = selection_set_find(SELECTION_KEY_POINTER, (uintptr_t)data);
+	if (!e && selection_set.nb_waypoints)
+		e = selection_set_find(SELECTION_KEY_WAYPOINT, coord_key(((waypoint *)data)->x, ((waypoint *)data)->y));
+	if (!e && selection_set.nb_map_labels)
+		e = selection_set_find(SELECTION_KEY_MAP_LABEL, coord_key(((map_label *)data)->pos.x, ((map_label *)data)->pos.y));
+
+	return e;
+}
 
 /**
  * Check whether the selection is currently empty.
@@ -108,33 +282,7 @@ void *single_tile_selection(int type)
  */
 int element_in_selection(void *data)
 {
-	struct selected_element *e;
-	list_for_each_entry(e, &selected_elements, node) {
-		switch(e->type) {
-		case OBJECT_FLOOR:
-			// We must compare the floor tiles in the wrapper structure
-			if (((struct lvledit_map_tile *) (e->data))->tile == data)
-				return 1;
-			break;
-		case OBJECT_WAYPOINT:
-			// We must compare the coordinates of the two waypoints
-			if (((waypoint *)e->data)->x == ((waypoint *)data)->x &&
-				((waypoint *)e->data)->y == ((waypoint *)data)->y)
-				return 1;
-			break;
-		case OBJECT_MAP_LABEL:
-			// We must compare the coordinates of the two map labels
-			if (((map_label *)e->data)->pos.x == ((map_label *)data)->pos.x &&
-				((map_label *)e->data)->pos.y == ((map_label *)data)->pos.y)
-				return 1;
-			break;
-		default:
-			if (e->data == data)
-				return 1;
-		}		
-	}
-
-	return 0;
+	return find_selected_element(data) != NULL;
 }
 
 /**
@@ -143,62 +291,35 @@ int element_in_selection(void *data)
  */
 int remove_element_from_selection(void *data)
 {
-	struct selected_element *e, *next;
-	list_for_each_entry_safe(e, next, &selected_elements, node) {
-		switch(e->type) {
-		case OBJECT_FLOOR:
-			{
-				// We must compare the floor tiles in the wrapper structure
-				struct lvledit_map_tile *t = e->data;
-				if (t->tile == data) {
-					free(t->tile);
-					t->tile = NULL;
-					free(e->data);
-					e->data = NULL;
-					list_del(&e->node);
-					free(e);
-					e = NULL;
-					return 1;
-				}
-			}
-			break;
-		case OBJECT_WAYPOINT:
-			// We must compare the coordinates of the two waypoints
-			if (((waypoint *)e->data)->x == ((waypoint *)data)->x &&
-				((waypoint *)e->data)->y == ((waypoint *)data)->y) {
-				dynarray_free(&((struct waypoint *)(e->data))->connections);
-				free(e->data);
-				e->data = NULL;
-				list_del(&e->node);
-				free(e);
-				e = NULL;
-				return 1;
-			}
-			break;
-		case OBJECT_MAP_LABEL:
-			// We must compare the coordinates of the two map labels
-			if (((map_label *)e->data)->pos.x == ((map_label *)data)->pos.x &&
-				((map_label *)e->data)->pos.y == ((map_label *)data)->pos.y) {
-				free(e->data);
-				e->data = NULL;
-				list_del(&e->node);
-				free(e);
-				e = NULL;
-				return 1;
-			}
-			break;
-		default:
-			if (e->data == data) {
-				list_del(&e->node);
-				free(e);
-				e = NULL;
-				return 1;
-			}
-			break;
+	struct selected_element *e = find_selected_element(data);
+	if (!e)
+		return 0;
+
+	selection_set_del(e);
+
+	switch(e->type) {
+	case OBJECT_FLOOR:
+		{
+			struct lvledit_map_tile *t = e->data;
+			free(t->tile);
+			t->tile = NULL;
+			free(e->data);
 		}
+		break;
+	case OBJECT_WAYPOINT:
+		dynarray_free(&((struct waypoint *)(e->data))->connections);
+		free(e->data);
+		break;
+	case OBJECT_MAP_LABEL:
+		free(e->data);
+		break;
+	default:
+		break;
 	}
 
-	return 0;
+	list_del(&e->node);
+	free(e);
+	return 1;
 }
 
 static void __calc_min_max(float x, float y, pointf *cmin, pointf *cmax)
@@ -295,6 +416,22 @@ point selection_len() {
 	return state.rect_len;
 }
 
+/**
+ * Call a function on the coordinates of each selected floor tile.
+ */
+void for_each_selected_floor_tile(void (*fn)(int x, int y, void *data), void *data)
+{
+	struct selected_element *e;
+
+	list_for_each_entry(e, &selected_elements, node) {
+		if (e->type != OBJECT_FLOOR)
+			continue;
+
+		struct lvledit_map_tile *t = e->data;
+		fn(t->coord.x, t->coord.y, data);
+	}
+}
+
 int selection_type()
 {
 	struct widget_lvledit_categoryselect *cs = get_current_object_type();
@@ -313,6 +450,8 @@ static void add_object_to_list(struct list_head *list, void *data, enum lvledit_
 	e->data = data;
 
 	list_add(&e->node, list);
+	if (list == &selected_elements)
+		selection_set_add(e);
 }
 
 static void __clear_selected_list(struct list_head *lst, int nbelem, int is_clipboard)
@@ -322,6 +461,9 @@ static void __clear_selected_list(struct list_head *lst, int nbelem, int is_clip
 		if (nbelem-- == 0)
 			return;
 
+		if (lst == &selected_elements)
+			selection_set_del(e);
+
 		switch (e->type) {
 		case OBJECT_WAYPOINT:
 		{
@@ -377,25 +519,41 @@ static void select_floor_on_tile(int x, int y)
 	}
 }
 
-static void select_obstacles_on_tile(int x, int y)
+static void select_floor_in_rect(int x0, int y0, int x1, int y1)
 {
-	int a;
-	for (a = 0; a < EditLevel()->map[y][x].glued_obstacles.size; a++) {
-		int idx = ((int *)(EditLevel()->map[y][x].glued_obstacles.arr))[a];
-		if (!element_in_selection(&EditLevel()->obstacle_list[idx])) {
-		add_object_to_list(&selected_elements, &EditLevel()->obstacle_list[idx], OBJECT_OBSTACLE);
-			state.rect_nbelem_selected++;
+	int x, y;
+
+	for (y = y0; y <= y1; y++) {
+		for (x = x0; x <= x1; x++)
+			select_floor_on_tile(x, y);
+	}
+}
+
+static void select_obstacles_in_rect(int x0, int y0, int x1, int y1)
+{
+	int x, y, a;
+
+	// Obstacles are found through the obstacles glued to each tile
+	for (y = y0; y <= y1; y++) {
+		for (x = x0; x <= x1; x++) {
+			for (a = 0; a < EditLevel()->map[y][x].glued_obstacles.size; a++) {
+				int idx = ((int *)(EditLevel()->map[y][x].glued_obstacles.arr))[a];
+				if (!element_in_selection(&ACCESS_OBSTACLE(EditLevel(), idx))) {
+					add_object_to_list(&selected_elements, &ACCESS_OBSTACLE(EditLevel(), idx), OBJECT_OBSTACLE);
+					state.rect_nbelem_selected++;
+				}
+			}
 		}
 	}
 }
 
-static void select_waypoint_on_tile(int x, int y)
+static void select_waypoints_in_rect(int x0, int y0, int x1, int y1)
 {
 	waypoint *wpts = EditLevel()->waypoints.arr;
 	int i;
 
 	for (i = 0; i < EditLevel()->waypoints.size; i++) {
-		if (wpts[i].x == x && wpts[i].y == y) {
+		if (wpts[i].x >= x0 && wpts[i].x <= x1 && wpts[i].y >= y0 && wpts[i].y <= y1) {
 			if (!element_in_selection(&wpts[i])) {
 				waypoint *w = MyMalloc(sizeof(waypoint));
 				memcpy(w, &wpts[i], sizeof(waypoint));
@@ -408,18 +566,28 @@ static void select_waypoint_on_tile(int x, int y)
 	}
 }
 
-static void select_item_on_tile(int x, int y)
+/**
+ * An item is selected from the tile it lies on, and from the tiles on its
+ * north and west sides. Check whether one of those tiles is in the range
+ * [lo, hi] along an axis.
+ */
+static int item_in_range(float pos, int lo, int hi)
+{
+	return max(lo, (int)ceil(pos - 1)) <= min(hi, (int)floor(pos));
+}
+
+static void select_items_in_rect(int x0, int y0, int x1, int y1)
 {
 	int i;
 
-	for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
+	for (i = 0; i < EditLevel()->ItemList.size; i++) {
 		// Get the item
-		struct item *it = &EditLevel()->ItemList[i];
+		struct item *it = &ACCESS_FLOOR_ITEM(EditLevel(), i);
 
 		if (it->type == -1)
 			continue;
 
-		if ((it->pos.x - x) >= 0 && (it->pos.x - x) <= 1 && (it->pos.y - y) >= 0 && (it->pos.y - y) <= 1) {
+		if (item_in_range(it->pos.x, x0, x1) && item_in_range(it->pos.y, y0, y1)) {
 			if (!element_in_selection(it)) {
 				add_object_to_list(&selected_elements, it, OBJECT_ITEM);
 				state.rect_nbelem_selected++;
@@ -428,13 +596,13 @@ static void select_item_on_tile(int x, int y)
 	}
 }
 
-static void select_map_label_on_tile(int x, int y)
+static void select_map_labels_in_rect(int x0, int y0, int x1, int y1)
 {
 	map_label *labels = EditLevel()->map_labels.arr;
 	int i;
 
 	for (i = 0; i < EditLevel()->map_labels.size; i++) {
-		if (labels[i].pos.x == x && labels[i].pos.y == y) {
+		if (labels[i].pos.x >= x0 && labels[i].pos.x <= x1 && labels[i].pos.y >= y0 && labels[i].pos.y <= y1) {
 			if (!element_in_selection(&labels[i])) {
 				map_label *m = MyMalloc(sizeof(map_label));
 				memcpy(m, &labels[i], sizeof(map_label));
@@ -446,7 +614,7 @@ static void select_map_label_on_tile(int x, int y)
 	}
 }
 
-static void select_special_forces_on_tile(int x, int y)
+static void select_special_forces_in_rect(int x0, int y0, int x1, int y1)
 {
 	enemy *en;
 
@@ -454,7 +622,7 @@ static void select_special_forces_on_tile(int x, int y)
 		if (!en->SpecialForce)
 			continue;
 
-		if ((int)en->pos.x == x && (int)en->pos.y == y) {
+		if ((int)en->pos.x >= x0 && (int)en->pos.x <= x1 && (int)en->pos.y >= y0 && (int)en->pos.y <= y1) {
 			if (!element_in_selection(en)) {
 				add_object_to_list(&selected_elements, en, OBJECT_ENEMY);
 				state.rect_nbelem_selected++;
@@ -463,26 +631,31 @@ static void select_special_forces_on_tile(int x, int y)
 	}
 }
 
-static void select_object_on_tile(int x, int y)
+/**
+ * Select the objects of the current type on the tiles of a rectangle.
+ * The objects not indexed by tile are browsed only once for the whole
+ * rectangle.
+ */
+static void select_objects_in_rect(int x0, int y0, int x1, int y1)
 {
 	switch (selection_type()) {
 	case OBJECT_OBSTACLE:
-		select_obstacles_on_tile(x, y);
+		select_obstacles_in_rect(x0, y0, x1, y1);
 		break;
 	case OBJECT_FLOOR:
-		select_floor_on_tile(x, y);
+		select_floor_in_rect(x0, y0, x1, y1);
 		break;
 	case OBJECT_WAYPOINT:
-		select_waypoint_on_tile(x, y);
+		select_waypoints_in_rect(x0, y0, x1, y1);
 		break;
 	case OBJECT_ITEM:
-		select_item_on_tile(x, y);
+		select_items_in_rect(x0, y0, x1, y1);
 		break;
 	case OBJECT_MAP_LABEL:
-		select_map_label_on_tile(x, y);
+		select_map_labels_in_rect(x0, y0, x1, y1);
 		break;
 	case OBJECT_ENEMY:
-		select_special_forces_on_tile(x, y);
+		select_special_forces_in_rect(x0, y0, x1, y1);
 		break;
 	default:
 		error_message(__FUNCTION__,
@@ -529,7 +702,7 @@ static void start_rect_select()
 		return;
 
 	// Select elements on the starting tile
-	select_object_on_tile(state.rect_start.x, state.rect_start.y);
+	select_objects_in_rect(state.rect_start.x, state.rect_start.y, state.rect_start.x, state.rect_start.y);
 }
 
 static void do_rect_select()
@@ -565,20 +738,14 @@ static void do_rect_select()
 		clear_selection(state.rect_nbelem_selected);
 		state.rect_nbelem_selected = 0;
 
-		// Then redo a correct one
-		int i, j;
-		for (j = state.rect_start.y; j < state.rect_start.y + state.rect_len.y; ++j) {
-			if (j < 0 || j >= EditLevel()->ylen)
-				continue;
-
-			for (i = state.rect_start.x; i < state.rect_start.x + state.rect_len.x; ++i) {
-				if (i < 0 || i >= EditLevel()->xlen)
-					continue;
-
-				select_object_on_tile(i, j);
-			}
+		// Then redo a correct one, on the part of the rectangle inside the level
+		int x0 = max(state.rect_start.x, 0);
+		int y0 = max(state.rect_start.y, 0);
+		int x1 = min(state.rect_start.x + state.rect_len.x - 1, EditLevel()->xlen - 1);
+		int y1 = min(state.rect_start.y + state.rect_len.y - 1, EditLevel()->ylen - 1);
 
-		}
+		if (x0 <= x1 && y0 <= y1)
+			select_objects_in_rect(x0, y0, x1, y1);
 	}
 }
 
@@ -702,8 +869,10 @@ static void do_drag_drop_waypoint(struct pointf diff)
 	// Move the selection if the displacement exceeds half a tile
 	if (fabsf(diff.x) >= 0.5 || fabsf(diff.y) >= 0.5 ) {
 		list_for_each_entry(e, &selected_elements, node) {
-			if (e->type != OBJECT_WAYPOINT)
+			if (e->type != OBJECT_WAYPOINT) {
+				selection_set_rebuild();
 				return;
+			}
 
 			struct waypoint *w = e->data;
 
@@ -721,6 +890,10 @@ static void do_drag_drop_waypoint(struct pointf diff)
 			move_waypoint(EditLevel(), w2, w->x, w->y);
 		}
 
+		// The selected waypoints are looked up by their coordinates, so the
+		// selection set is updated once all of them have moved
+		selection_set_rebuild();
+
 		state.cur_drag_pos.x += (int)rintf(diff.x);
 		state.cur_drag_pos.y += (int)rintf(diff.y);
 	}
@@ -822,8 +995,8 @@ static int level_editor_number_of_marked_items()
 {
 	int i, num = 0;
 
-	for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
-		struct item *it = &EditLevel()->ItemList[i];
+	for (i = 0; i < EditLevel()->ItemList.size; i++) {
+		struct item *it = &ACCESS_FLOOR_ITEM(EditLevel(), i);
 
 		if (it->type == -1)
 			continue;
@@ -876,7 +1049,7 @@ static void level_editor_cycle_marked_obstacle()
 	}
 
 	int idx = ((int *)(EditLevel()->map[state.rect_start.y][state.rect_start.x].glued_obstacles.arr))[state.single_tile_mark_index];
-	add_object_to_list(&selected_elements, &EditLevel()->obstacle_list[idx], OBJECT_OBSTACLE);
+	add_object_to_list(&selected_elements, &ACCESS_OBSTACLE(EditLevel(), idx), OBJECT_OBSTACLE);
 }
 
 static void level_editor_cycle_marked_item()
@@ -888,8 +1061,8 @@ static void level_editor_cycle_marked_item()
 		state.single_tile_mark_index = 0;
 	}
 
-	for (i = 0,j = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
-		it = &EditLevel()->ItemList[i];
+	for (i = 0,j = 0; i < EditLevel()->ItemList.size; i++) {
+		it = &ACCESS_FLOOR_ITEM(EditLevel(), i);
 
 		if (it->type == -1)
 			continue;
@@ -1167,7 +1340,7 @@ void level_editor_paste_selection()
 
 			// Add and select
 			action_create_waypoint(EditLevel(), w->x, w->y, w->suppress_random_spawn);
-			select_waypoint_on_tile(w->x, w->y);
+			select_waypoints_in_rect(w->x, w->y, w->x, w->y);
 
 			nbact++;
 			break;
@@ -1198,7 +1371,7 @@ void level_editor_paste_selection()
 
 			// Add and select
 			action_create_map_label(EditLevel(), m->pos.x, m->pos.y, str->value);
-			select_map_label_on_tile(m->pos.x, m->pos.y);
+			select_map_labels_in_rect(m->pos.x, m->pos.y, m->pos.x, m->pos.y);
 
 			free_autostr(str);
 			nbact++;
@@ -35,6 +35,7 @@ int element_in_selection(void *);
 point selection_start(void);
 point selection_len(void);
 int selection_type(void);
+void for_each_selected_floor_tile(void (*fn)(int x, int y, void *data), void *data);
 
 int level_editor_can_cycle_marked_object(void);
 void level_editor_cycle_marked_object(void);
@@ -44,6 +44,13 @@ static char *bigline = "========================================================
 static char *line = "--------------------------------------------------------------------";
 static char *sepline = "+------------------------------";
 
+#define LVLVAL_MAX_THREADS 8
+
+// The pathfinder marks the map tiles it goes through, so that it can not be
+// run by several validation tasks at once. The collision detection itself
+// can.
+static SDL_mutex *pathfinder_lock;
+
 static void lvlval_chest_execute(struct level_validator *this, struct lvlval_ctx *validator_ctx);
 static void *lvlval_chest_parse_excpt(char *str);
 static int lvlval_chest_cmp_data(void *opaque_data1, void *opaque_data2);
@@ -96,7 +103,8 @@ struct level_validator level_validators[] = {
 	 LIST_HEAD_INIT(level_validators[5].excpt_list),
 	 lvlval_map_labels_execute,
 	 NULL,
-	 NULL},
+	 NULL,
+	 TRUE},
 	{.initial = '\0'}
 };
 
@@ -116,50 +124,49 @@ static void compose_return_code(enum validator_return_code *old_code, enum valid
 }
 
 /**
- * Output to the console the validator's title and associated comment
+ * Add the validator's title and associated comment to its report
  */
 
 static void validator_print_header(struct lvlval_ctx *val_ctx, char *title, char *comment)
 {
+	struct auto_string *report = val_ctx->report;
 	int cpt = 0;
 	char *ptr = comment;
 
-	putchar('\n');
-	puts(bigline);
-	printf("| %s - Level %d on act '%s'\n", title, val_ctx->this_level->levelnum, val_ctx->act);
-	puts(sepline);
+	autostr_append(report, "\n%s\n", bigline);
+	autostr_append(report, "| %s - Level %d on act '%s'\n", title, val_ctx->this_level->levelnum, val_ctx->act);
+	autostr_append(report, "%s\n", sepline);
 
-	printf("| ");
+	autostr_append(report, "| ");
 	// Split the text at the first whitespace after the 60th character
 	while (*ptr) {
 		if (*ptr == '\n') {
-			printf("\n| ");
+			autostr_append(report, "\n| ");
 			cpt = 0;
 			++ptr;
 			continue;
 		}
 		if (cpt < 60) {
-			putchar(*ptr);
+			autostr_append(report, "%c", *ptr);
 			++cpt;
 			++ptr;
 			continue;
 		}
 		if (*ptr == ' ') {
-			printf("\n| ");
+			autostr_append(report, "\n| ");
 			cpt = 0;
 			++ptr;
 			continue;
 		} else {
-			putchar(*ptr);
+			autostr_append(report, "%c", *ptr);
 			++ptr;
 		}		// continue until a whitespace is found
 	}
-	putchar('\n');
-	puts(line);
+	autostr_append(report, "\n%s\n", line);
 }
 
 /**
- * Output to the console a validator's error, with the associated header, on first output
+ * Add a validator's error to its report, with the associated header, on first output
  */
 
 static void validator_print_error(struct lvlval_ctx *validator_ctx, struct lvlval_error *validator_error, ...)
@@ -175,15 +182,15 @@ static void validator_print_error(struct lvlval_ctx *validator_ctx, struct lvlva
 	
 	compose_return_code(&validator_ctx->return_code, validator_error->code);
 	
-	vprintf(validator_error->format, args);
-	printf("\n");
+	autostr_vappend(validator_ctx->report, validator_error->format, args);
+	autostr_append(validator_ctx->report, "\n");
 	va_end(args);
 }
 
 static void validator_print_separator(struct lvlval_ctx *validator_ctx)
 {
 	if (validator_ctx->in_report_section)
-		puts(line);
+		autostr_append(validator_ctx->report, "%s\n", line);
 	validator_ctx->in_report_section = FALSE;
 }
 
@@ -209,7 +216,11 @@ static enum connect_validity waypoints_connection_valid(gps * from_pos, gps * to
 
 	pathfinder_context pf_ctx = { &WalkablePassFilter, NULL };
 
+	if (pathfinder_lock)
+		SDL_LockMutex(pathfinder_lock);
 	int path_found = set_up_intermediate_course_between_positions(from_pos, &mfp_to_pos, mid_pos, 40, &pf_ctx);
+	if (pathfinder_lock)
+		SDL_UnlockMutex(pathfinder_lock);
 	if (!path_found)
 		return NO_PATH;
 
@@ -329,9 +340,11 @@ static void load_excpt_lists(char *filename)
 /*
  * This function will compare one set of data to all the exceptions of a validator
  * Return FALSE if the data was not found in the list of exceptions
+ * The caught exception is recorded in the validator context, and marked as
+ * caught when the reports are merged.
  */
 
-static int lookup_exception(struct level_validator *this, void *opaque_data)
+static int lookup_exception(struct level_validator *this, struct lvlval_ctx *validator_ctx, void *opaque_data)
 {
 	if (this->cmp == NULL)
 		return FALSE;
@@ -343,7 +356,7 @@ static int lookup_exception(struct level_validator *this, void *opaque_data)
 	list_for_each_entry(item, &(this->excpt_list), node) {
 		int rtn = this->cmp(item->opaque_data, opaque_data);
 		if (rtn) {
-			item->caught = TRUE;	// Mark the exception has caught
+			dynarray_add(&validator_ctx->caught_excpts, &item, sizeof(struct lvlval_excpt_item *));
 			return TRUE;
 		}
 	}
@@ -479,12 +492,12 @@ static void lvlval_chest_execute(struct level_validator *this, struct lvlval_ctx
 			for (glue_index = 0; glue_index < validator_ctx->this_level->map[y_tile][x_tile].glued_obstacles.size; ++glue_index) {
 				int obs_index = ((int *)(validator_ctx->this_level->map[y_tile][x_tile].glued_obstacles.arr))[glue_index];
 
-				obstacle *this_obs = &(validator_ctx->this_level->obstacle_list[obs_index]);
+				obstacle *this_obs = &(ACCESS_OBSTACLE(validator_ctx->this_level, obs_index));
 
 				struct chest_excpt_data to_check =
 				    { obs_index, {this_obs->pos.x, this_obs->pos.y, validator_ctx->this_level->levelnum} };
 
-				if (lookup_exception(this, &to_check))
+				if (lookup_exception(this, validator_ctx, &to_check))
 					continue;
 
 				if (!(IS_CHEST(this_obs->type) || IS_BARREL(this_obs->type)))
@@ -669,7 +682,7 @@ static void lvlval_waypoint_execute(struct level_validator *this, struct lvlval_
 			}
 		};
 
-		if (lookup_exception(this, &to_check))
+		if (lookup_exception(this, validator_ctx, &to_check))
 			continue;
 
 		if (!SinglePointColldet(wpts[i].x + 0.5, wpts[i].y + 0.5, validator_ctx->this_level->levelnum, &WalkablePassFilter)) {
@@ -691,7 +704,7 @@ static void lvlval_waypoint_execute(struct level_validator *this, struct lvlval_
 			}
 		};
 
-		if (!lookup_exception(this, &to_check) && wpts[i].connections.size == 0) {
+		if (!lookup_exception(this, validator_ctx, &to_check) && wpts[i].connections.size == 0) {
 			validator_print_error(validator_ctx, &conn_error,
 			                      wpts[i].x + 0.5, wpts[i].y + 0.5, validator_ctx->this_level->levelnum);
 		}
@@ -701,7 +714,7 @@ static void lvlval_waypoint_execute(struct level_validator *this, struct lvlval_
 		to_check.subtest = 'S';
 		conn_error.format = "[Type=\"WS\"] WP X=%f:Y=%f:L=%d";
 		
-		if (lookup_exception(this, &to_check))
+		if (lookup_exception(this, validator_ctx, &to_check))
 			continue;
 
 		int *connections = wpts[i].connections.arr;
@@ -735,7 +748,7 @@ static void lvlval_waypoint_execute(struct level_validator *this, struct lvlval_
 				}
 			};
 
-			if (lookup_exception(this, &to_check))
+			if (lookup_exception(this, validator_ctx, &to_check))
 				continue;
 
 			gps wp_j = { to_wp->x + 0.5, to_wp->y + 0.5, validator_ctx->this_level->levelnum };
@@ -777,7 +790,7 @@ static void lvlval_waypoint_execute(struct level_validator *this, struct lvlval_
 				}
 			};
 
-			if (lookup_exception(this, &to_check))
+			if (lookup_exception(this, validator_ctx, &to_check))
 				continue;
 
 			gps to_pos = { to_wp->x + 0.5, to_wp->y + 0.5, validator_ctx->this_level->levelnum };
@@ -820,7 +833,7 @@ static void lvlval_waypoint_execute(struct level_validator *this, struct lvlval_
 				}
 			};
 
-			if (lookup_exception(this, &to_check))
+			if (lookup_exception(this, validator_ctx, &to_check))
 				continue;
 
 			gps from_pos = { from_wp->x + 0.5, from_wp->y + 0.5, validator_ctx->this_level->levelnum };
@@ -974,7 +987,7 @@ static void lvlval_neighborhood_execute(struct level_validator *this, struct lvl
 			struct neighborhood_excpt_data to_check =
 		    		{ 'N', validator_ctx->this_level->levelnum, validator_ctx->this_level->jump_target_north };
 
-			if (!lookup_exception(this, &to_check)) {
+			if (!lookup_exception(this, validator_ctx, &to_check)) {
 				validator_print_error(validator_ctx, &ngb_error,
 				                      validator_ctx->this_level->levelnum, validator_ctx->this_level->jump_target_north);
 			}
@@ -987,7 +1000,7 @@ static void lvlval_neighborhood_execute(struct level_validator *this, struct lvl
 			struct neighborhood_excpt_data to_check =
 		    		{ 'W', validator_ctx->this_level->levelnum, validator_ctx->this_level->jump_target_west };
 
-			if (!lookup_exception(this, &to_check)) {
+			if (!lookup_exception(this, validator_ctx, &to_check)) {
 				validator_print_error(validator_ctx, &ngb_error,
 				                      validator_ctx->this_level->levelnum, validator_ctx->this_level->jump_target_west);
 			}
@@ -1000,7 +1013,7 @@ static void lvlval_neighborhood_execute(struct level_validator *this, struct lvl
 			struct neighborhood_excpt_data to_check =
 		    		{ 'E', validator_ctx->this_level->levelnum, validator_ctx->this_level->jump_target_east };
 
-			if (!lookup_exception(this, &to_check)) {
+			if (!lookup_exception(this, validator_ctx, &to_check)) {
 				validator_print_error(validator_ctx, &ngb_error,
 				                      validator_ctx->this_level->levelnum, validator_ctx->this_level->jump_target_east);
 			}
@@ -1013,7 +1026,7 @@ static void lvlval_neighborhood_execute(struct level_validator *this, struct lvl
 			struct neighborhood_excpt_data to_check =
 		    		{ 'S', validator_ctx->this_level->levelnum, validator_ctx->this_level->jump_target_south };
 
-			if (!lookup_exception(this, &to_check)) {
+			if (!lookup_exception(this, validator_ctx, &to_check)) {
 				validator_print_error(validator_ctx, &ngb_error,
 				                      validator_ctx->this_level->levelnum, validator_ctx->this_level->jump_target_south);
 			}
@@ -1189,8 +1202,8 @@ static void lvlval_obstacles_execute(struct level_validator *this, struct lvlval
 	float max_x = (float)l->xlen;
 	float max_y = (float)l->ylen;
 
-	for (i = 0; i < MAX_OBSTACLES_ON_MAP; i++) {
-		obstacle *o = &l->obstacle_list[i];
+	for (i = 0; i < l->obstacle_list.size; i++) {
+		obstacle *o = &ACCESS_OBSTACLE(l, i);
 
 		if (o->type == -1)
 			continue;
@@ -1207,7 +1220,7 @@ static void lvlval_obstacles_execute(struct level_validator *this, struct lvlval
 			struct obstacle_excpt_data to_check =
 			    { 'W', {o->pos.x, o->pos.y, l->levelnum}, o->type, border };
 
-			if (!lookup_exception(this, &to_check)) {
+			if (!lookup_exception(this, validator_ctx, &to_check)) {
 				obs_error.format = "[Type=\"OW\"] X=%f:Y=%f:L=%d T=%d -> west border=%f (warning)";
 				obs_error.code = VALIDATION_WARNING;
 				validator_print_error(validator_ctx, &obs_error, o->pos.x, o->pos.y, l->levelnum, o->type, border);
@@ -1219,7 +1232,7 @@ static void lvlval_obstacles_execute(struct level_validator *this, struct lvlval
 			struct obstacle_excpt_data to_check =
 			    { 'E', {o->pos.x, o->pos.y, l->levelnum}, o->type, border };
 
-			if (!lookup_exception(this, &to_check)) {
+			if (!lookup_exception(this, validator_ctx, &to_check)) {
 				obs_error.format = "[Type=\"OE\"] X=%f:Y=%f:L=%d T=%d -> east border=%f (warning)";
 				obs_error.code = VALIDATION_WARNING;
 				validator_print_error(validator_ctx, &obs_error, o->pos.x, o->pos.y, l->levelnum, o->type, border);
@@ -1231,7 +1244,7 @@ static void lvlval_obstacles_execute(struct level_validator *this, struct lvlval
 			struct obstacle_excpt_data to_check =
 			    { 'N', {o->pos.x, o->pos.y, l->levelnum}, o->type, border };
 
-			if (!lookup_exception(this, &to_check)) {
+			if (!lookup_exception(this, validator_ctx, &to_check)) {
 				obs_error.format = "[Type=\"ON\"] X=%f:Y=%f:L=%d T=%d -> north border=%f (warning)";
 				obs_error.code = VALIDATION_WARNING;
 				validator_print_error(validator_ctx, &obs_error, o->pos.x, o->pos.y, l->levelnum, o->type, border);
@@ -1244,7 +1257,7 @@ static void lvlval_obstacles_execute(struct level_validator *this, struct lvlval
 			struct obstacle_excpt_data to_check =
 			    { 'S', {o->pos.x, o->pos.y, l->levelnum}, o->type, border };
 
-			if (!lookup_exception(this, &to_check)) {
+			if (!lookup_exception(this, validator_ctx, &to_check)) {
 				obs_error.format = "[Type=\"OS\"] X=%f:Y=%f:L=%d T=%d -> south border=%f (warning)";
 				obs_error.code = VALIDATION_WARNING;
 				validator_print_error(validator_ctx, &obs_error, o->pos.x, o->pos.y, l->levelnum, o->type, border);
@@ -1379,8 +1392,8 @@ static void lvlval_extensions_execute(struct level_validator *this, struct lvlva
 
 	// Check that all signs have an extension
 
-	for (i = 0; i < MAX_OBSTACLES_ON_MAP; i++) {
-		obstacle *o = &l->obstacle_list[i];
+	for (i = 0; i < l->obstacle_list.size; i++) {
+		obstacle *o = &ACCESS_OBSTACLE(l, i);
 
 		if (o->type == -1)
 			continue;
@@ -1389,7 +1402,7 @@ static void lvlval_extensions_execute(struct level_validator *this, struct lvlva
 			struct extension_excpt_data to_check =
 				{ 'S', {o->pos.x, o->pos.y, l->levelnum}, get_obstacle_index(l, o), o->type, -1 };
 
-			if (!lookup_exception(this, &to_check)) {
+			if (!lookup_exception(this, validator_ctx, &to_check)) {
 				const char *msg = (const char *)get_obstacle_extension(l, o, OBSTACLE_EXTENSION_SIGNMESSAGE);
 				if (!msg || *msg == '\0') {
 					const char *img = ((char **)get_obstacle_spec(o->type)->filenames.arr)[0];
@@ -1413,7 +1426,7 @@ static void lvlval_extensions_execute(struct level_validator *this, struct lvlva
 		struct extension_excpt_data to_check =
 			{ 'V', {o->pos.x, o->pos.y, l->levelnum}, get_obstacle_index(l, o), o->type, ext->type };
 
-		if (lookup_exception(this, &to_check))
+		if (lookup_exception(this, validator_ctx, &to_check))
 			continue;
 
 		char *action = get_obstacle_spec(o->type)->action;
@@ -1437,7 +1450,7 @@ static void lvlval_extensions_execute(struct level_validator *this, struct lvlva
 		struct extension_excpt_data to_check =
 			{ 'T', {o->pos.x, o->pos.y, l->levelnum}, get_obstacle_index(l, o), o->type, ext->type };
 
-		if (lookup_exception(this, &to_check))
+		if (lookup_exception(this, validator_ctx, &to_check))
 			continue;
 
 		char *action = get_obstacle_spec(o->type)->action;
@@ -1507,6 +1520,168 @@ static void lvlval_map_labels_execute(struct level_validator *this, struct lvlva
 	validator_print_separator(validator_ctx);
 }
 
+//===========================================================
+// Validation Tasks
+//
+// Each validator is run on each level as a separate task.
+// The tasks of the validators looking at a single level are
+// run on a pool of threads.
+//===========================================================
+
+struct lvlval_task {
+	struct level_validator *validator;
+	struct lvlval_ctx ctx;
+};
+
+static struct {
+	struct lvlval_task *tasks;
+	int nb_tasks;
+	int next_task;
+	SDL_mutex *lock;
+} lvlval_pool;
+
+static void run_lvlval_task(struct lvlval_task *task)
+{
+	task->validator->execute(task->validator, &task->ctx);
+}
+
+/*
+ * Validation threads' main loop.
+ * Take the next task, until all the tasks are started.
+ */
+static int lvlval_thread(void *data)
+{
+	while (TRUE) {
+		SDL_LockMutex(lvlval_pool.lock);
+		int index = lvlval_pool.next_task;
+		while (index < lvlval_pool.nb_tasks && lvlval_pool.tasks[index].validator->sequential)
+			index++;
+		lvlval_pool.next_task = index + 1;
+		SDL_UnlockMutex(lvlval_pool.lock);
+
+		if (index >= lvlval_pool.nb_tasks)
+			break;
+
+		run_lvlval_task(&lvlval_pool.tasks[index]);
+	}
+
+	return 0;
+}
+
+static int lvlval_thread_count(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+	long nb_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nb_cpus > 0)
+		return min(nb_cpus, LVLVAL_MAX_THREADS);
+#endif
+	return 1;
+}
+
+/*
+ * Run the tasks of the validators which only look at one level, the main
+ * thread taking its share.
+ */
+static void run_parallel_lvlval_tasks(struct lvlval_task *tasks, int nb_tasks)
+{
+	SDL_Thread *threads[LVLVAL_MAX_THREADS];
+	int nb_threads = 0;
+	int i;
+
+	lvlval_pool.tasks = tasks;
+	lvlval_pool.nb_tasks = nb_tasks;
+	lvlval_pool.next_task = 0;
+	lvlval_pool.lock = SDL_CreateMutex();
+	pathfinder_lock = SDL_CreateMutex();
+
+	if (lvlval_pool.lock && pathfinder_lock) {
+		for (i = 1; i < lvlval_thread_count(); i++) {
+			SDL_Thread *thread = SDL_CreateThread(lvlval_thread, NULL);
+			if (thread)
+				threads[nb_threads++] = thread;
+		}
+	}
+
+	if (nb_threads) {
+		lvlval_thread(NULL);
+		for (i = 0; i < nb_threads; i++)
+			SDL_WaitThread(threads[i], NULL);
+	} else {
+		for (i = 0; i < nb_tasks; i++) {
+			if (!tasks[i].validator->sequential)
+				run_lvlval_task(&tasks[i]);
+		}
+	}
+
+	if (pathfinder_lock)
+		SDL_DestroyMutex(pathfinder_lock);
+	if (lvlval_pool.lock)
+		SDL_DestroyMutex(lvlval_pool.lock);
+	pathfinder_lock = NULL;
+	lvlval_pool.lock = NULL;
+}
+
+/*
+ * Run all the validators on a list of levels.
+ *
+ * The reports of the tasks are printed in the order of the levels, and of
+ * the validators, as if the validators were run one after the other. The
+ * validators depending on the levels validated before are run at that time.
+ *
+ * \param levels   Numbers of the levels to validate
+ * \param level_rc Filled with the result of the validation of each level
+ */
+static void run_level_validators(int *levels, int nb_levels, char *act, SDL_Rect *report_rect, enum validator_return_code *level_rc)
+{
+	int nb_validators = 0;
+	int l, v, i;
+
+	while (level_validators[nb_validators].initial != '\0')
+		nb_validators++;
+
+	int nb_tasks = nb_levels * nb_validators;
+	struct lvlval_task *tasks = MyMalloc(nb_tasks * sizeof(struct lvlval_task));
+
+	for (l = 0; l < nb_levels; l++) {
+		for (v = 0; v < nb_validators; v++) {
+			struct lvlval_task *task = &tasks[l * nb_validators + v];
+			struct lvlval_ctx ctx = { report_rect, curShip.AllLevels[levels[l]], act, FALSE, VALIDATION_PASS };
+
+			task->validator = &level_validators[v];
+			task->ctx = ctx;
+			task->ctx.report = alloc_autostr(256);
+			dynarray_init(&task->ctx.caught_excpts, 0, sizeof(struct lvlval_excpt_item *));
+		}
+	}
+
+	run_parallel_lvlval_tasks(tasks, nb_tasks);
+
+	// Merge the reports
+	for (l = 0; l < nb_levels; l++) {
+		level_rc[l] = VALIDATION_PASS;
+
+		for (v = 0; v < nb_validators; v++) {
+			struct lvlval_task *task = &tasks[l * nb_validators + v];
+
+			if (task->validator->sequential)
+				run_lvlval_task(task);
+
+			fputs(task->ctx.report->value, stdout);
+			compose_return_code(&level_rc[l], task->ctx.return_code);
+
+			for (i = 0; i < task->ctx.caught_excpts.size; i++) {
+				struct lvlval_excpt_item *item = ((struct lvlval_excpt_item **)task->ctx.caught_excpts.arr)[i];
+				item->caught = TRUE;
+			}
+
+			free_autostr(task->ctx.report);
+			dynarray_free(&task->ctx.caught_excpts);
+		}
+	}
+
+	free(tasks);
+}
+
 //===========================================================
 // ENTRY POINT
 //
@@ -1547,15 +1722,25 @@ int level_validation()
 	// Init map labels validator data
 	dynarray_init(&map_labels, 1024, sizeof(struct lvlval_map_label));
 
-	// Loop on each level
+	// Validate all the levels
 
 	int l;
 	int col_pos = 0;
 	int row_pos = 0;
+	int *levels = MyMalloc(curShip.num_levels * sizeof(int));
+	enum validator_return_code *level_rc = MyMalloc(curShip.num_levels * sizeof(enum validator_return_code));
+	int nb_levels = 0;
 
 	for (l = 0; l < curShip.num_levels; ++l) {
-		struct lvlval_ctx validator_ctx = { &report_rect, curShip.AllLevels[l], game_act_get_current()->name, FALSE, VALIDATION_PASS };
+		if (level_exists(l))
+			levels[nb_levels++] = l;
+	}
 
+	run_level_validators(levels, nb_levels, game_act_get_current()->name, &report_rect, level_rc);
+
+	// Loop on each level
+
+	for (l = 0, nb_levels = 0; l < curShip.num_levels; ++l) {
 		// Compute row and column position, when a new column of text starts
 		if ((l % max_rows) == 0) {
 			col_pos = report_rect.x + (l / max_rows) * column_width;
@@ -1570,16 +1755,11 @@ int level_validation()
  			row_pos += lines * row_height;
 			set_current_font(current_font);	// Reset font
 		} else {
-			// Loop on each validation function
-			int v = 0;
-			struct level_validator *one_validator;
-
-			while (one_validator = &(level_validators[v++]), one_validator->execute != NULL)
-				one_validator->execute(one_validator, &validator_ctx);
+			enum validator_return_code return_code = level_rc[nb_levels++];
 
 			// Display report
 			char txt[40];
-			switch (validator_ctx.return_code) {
+			switch (return_code) {
 			case VALIDATION_ERROR:
 				sprintf(txt, "[w]%03d: [r]fail", l);
 				break;
@@ -1596,10 +1776,13 @@ int level_validation()
 			set_current_font(current_font);	// Reset font in case of the red "fail" was displayed
 
 			// Set final return code
-			compose_return_code(&final_rc, validator_ctx.return_code);
+			compose_return_code(&final_rc, return_code);
 		}
 	}
 
+	free(levels);
+	free(level_rc);
+
 	// Outputs uncaught exception rules
 
 	uncaught_excpt = print_uncaught_exceptions(game_act_get_current()->name);
@@ -1652,29 +1835,30 @@ int level_validation_on_console_only(char *act_name)
 	// Init map labels validator data
 	dynarray_init(&map_labels, 1024, sizeof(struct lvlval_map_label));
 
-	// Loop on each level
+	// Validate the levels
 
 	int l;
+	int *levels = MyMalloc(curShip.num_levels * sizeof(int));
+	enum validator_return_code *level_rc = MyMalloc(curShip.num_levels * sizeof(enum validator_return_code));
+	int nb_levels = 0;
 
 	for (l = 0; l < curShip.num_levels; ++l) {
-		struct lvlval_ctx validator_ctx = { &report_rect, curShip.AllLevels[l], act_name, FALSE, VALIDATION_PASS };
-
 		// Nota: we do not currently validate random dungeons, due to a known
 		// invalid waypoint generation.
-		
-		if (level_exists(l) && !curShip.AllLevels[l]->random_dungeon) {
-			// Loop on each validation function
-			int v = 0;
-			struct level_validator *one_validator;
 
-			while (one_validator = &(level_validators[v++]), one_validator->execute != NULL)
-				one_validator->execute(one_validator, &validator_ctx);
-
-			// Set final return code
-			compose_return_code(&final_rc, validator_ctx.return_code);
-		}
+		if (level_exists(l) && !curShip.AllLevels[l]->random_dungeon)
+			levels[nb_levels++] = l;
 	}
 
+	run_level_validators(levels, nb_levels, act_name, &report_rect, level_rc);
+
+	// Set final return code
+	for (l = 0; l < nb_levels; ++l)
+		compose_return_code(&final_rc, level_rc[l]);
+
+	free(levels);
+	free(level_rc);
+
 	// Outputs uncaught exception rules
 
 	uncaught_excpt = print_uncaught_exceptions(act_name);
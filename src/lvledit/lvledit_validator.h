@@ -55,6 +55,8 @@ struct lvlval_ctx {
 	char *act;
 	int in_report_section;
 	enum validator_return_code return_code;
+	struct auto_string *report;            // Console report of the validator
+	struct dynarray caught_excpts;         // Exceptions caught by the validator (struct lvlval_excpt_item *)
 };
 
 struct lvlval_error {
@@ -78,6 +80,7 @@ struct level_validator {
 	void (*execute) (struct level_validator * this, struct lvlval_ctx * validator_ctx);
 	void *(*parse_excpt) (char *str);
 	int (*cmp) (void *opaque_data1, void *opaque_data2);
+	int sequential;                        // TRUE if the result on a level depends on the levels validated before
 };
 
 EXTERN int level_validation(void);
@@ -31,6 +31,7 @@
 
 #include "lvledit/lvledit.h"
 #include "lvledit/lvledit_actions.h"
+#include "lvledit/lvledit_overview.h"
 #include "lvledit/lvledit_widgets.h"
 
 /**
@@ -40,6 +41,9 @@
 
 static float minimap_scale = 240.0;
 
+// Number of changed parts of the levels drawn again per frame
+#define MINIMAP_OVERVIEW_BUILDS 4
+
 // The center position of the minimap on the screen
 #define MINIMAP_CENTER_X (GameConfig.screen_width - (WIDGET_MINIMAP_WIDTH / 2))
 #define MINIMAP_CENTER_Y (GameConfig.screen_height - (WIDGET_MINIMAP_HEIGHT / 2))
@@ -116,6 +120,28 @@ static void minimap_display(struct widget *w)
 	// Display the background
 	draw_rectangle(&w->rect, 85, 100, 100, 150);
 
+	// Display the floor of the levels, drawing only a few changed parts of
+	// them per frame
+	int nb_builds = MINIMAP_OVERVIEW_BUILDS;
+	for (j = 0; j < 3; j++) {
+		for (i = 0; i < 3; i++) {
+			int levelnum = EditLevel()->levelnum;
+			int x, y, dx = 0, dy = 0;
+
+			if (i != 1 || j != 1) {
+				struct neighbor_data_cell *ngb = level_neighbors_map[levelnum][j][i];
+				if (!ngb || !ngb->valid)
+					continue;
+				levelnum = ngb->lvl_idx;
+				dx = ngb->delta_x;
+				dy = ngb->delta_y;
+			}
+
+			minimap_to_screen(-dx, -dy, &x, &y);
+			lvledit_overview_display_level(levelnum, x, y, OVERVIEW_ZOOM_FACTOR / minimap_scale, &nb_builds);
+		}
+	}
+
 	// Display the grid
 	for (i = -1; i <= 2; i++) {
 		draw_line_at_minimap_position(90.0 * i, 180.0, 90.0 * i, -90.0);
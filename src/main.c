@@ -115,6 +115,10 @@ void Game()
 
 		check_if_mission_is_complete();
 
+		update_audio();
+
+		update_graphics_prefetch();
+
 		if (!world_frozen() && game_act_finished()) {
 			game_act_switch_to_next();
 		}
@@ -298,13 +302,13 @@ void UpdateCountersForThisFrame()
 	
 	BROWSE_VISIBLE_LEVELS(vis_lvl, n) {
 		level *lvl = vis_lvl->lvl_pointer;
-		for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
-			if (lvl->ItemList[i].type == (-1))
+		for (i = 0; i < lvl->ItemList.size; i++) {
+			if (ACCESS_FLOOR_ITEM(lvl, i).type == (-1))
 				continue;
-			if (lvl->ItemList[i].throw_time > 0)
-				lvl->ItemList[i].throw_time += latest_frame_time;
-			if (lvl->ItemList[i].throw_time > (M_PI / 3.0))
-				lvl->ItemList[i].throw_time = 0;
+			if (ACCESS_FLOOR_ITEM(lvl, i).throw_time > 0)
+				ACCESS_FLOOR_ITEM(lvl, i).throw_time += latest_frame_time;
+			if (ACCESS_FLOOR_ITEM(lvl, i).throw_time > (M_PI / 3.0))
+				ACCESS_FLOOR_ITEM(lvl, i).throw_time = 0;
 		}
 	}
 	
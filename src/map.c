@@ -92,6 +92,7 @@ void respawn_level(int level_num)
 		list_move(&(erot->global_list), &alive_bots_head);
 		/* Reinsert it into the current level list */
 		list_add(&(erot->level_list), &level_bots_head[level_num]);
+		mission_bot_changed(erot);
 	}
 
 	// Finally, we reset the runtime attributes of the bots, place them
@@ -426,18 +427,6 @@ static int decode_header(level *loadlevel, char *data)
  */
 static char *decode_obstacles(level *load_level, char *data_pointer)
 {
-	// First we initialize the obstacles with 'empty' information
-
-	int i;
-	for (i = 0; i < MAX_OBSTACLES_ON_MAP; i++) {
-		load_level->obstacle_list[i].type = -1;
-		load_level->obstacle_list[i].pos.x = -1;
-		load_level->obstacle_list[i].pos.y = -1;
-		load_level->obstacle_list[i].pos.z = load_level->levelnum;
-		load_level->obstacle_list[i].timestamp = 0;
-		load_level->obstacle_list[i].frame_index = 0;
-	}
-
 	if (load_level->random_dungeon && !load_level->dungeon_generated)
 		return data_pointer;
 
@@ -696,6 +685,10 @@ static char *decode_obstacle_extensions(level *loadlevel, char *data)
 		int type;
 		void *ext_data = NULL;
 		sscanf(ext_begin, "idx=%d type=%d", &index, &type);
+		if (index < 0 || index >= loadlevel->obstacle_list.size) {
+			error_message(__FUNCTION__, "Level %d has an obstacle extension on obstacle %d, which does not exist.",
+				      PLEASE_INFORM | IS_FATAL, loadlevel->levelnum, index);
+		}
 
 		// Move to the extension data definition
 		ext_begin = strstr(ext_begin, "data={\n");
@@ -723,7 +716,7 @@ static char *decode_obstacle_extensions(level *loadlevel, char *data)
 				// The actual use of an obstacle extension, and thus its actual type,
 				// is defined by the 'action' set to the obstacle (see action.c).
 				// TODO: To be removed in the future
-				obstacle *obs = &(loadlevel->obstacle_list[index]);
+				obstacle *obs = &(ACCESS_OBSTACLE(loadlevel, index));
 				obstacle_spec *spec = get_obstacle_spec(obs->type);
 
 				if (spec->action && strcmp(spec->action, "sign")) {
@@ -743,7 +736,7 @@ static char *decode_obstacle_extensions(level *loadlevel, char *data)
 		}
 
 		// Add the obstacle extension on the level
-		add_obstacle_extension(loadlevel, &(loadlevel->obstacle_list[index]), type, ext_data);
+		add_obstacle_extension(loadlevel, &(ACCESS_OBSTACLE(loadlevel, index)), type, ext_data);
 	}
 
 	*ext_end = OBSTACLE_EXTENSIONS_END_STRING[0];
@@ -759,12 +752,6 @@ static char *decode_item_section(level *loadlevel, char *data)
 	char *ItemsSectionBegin;
 	char *ItemsSectionEnd;
 
-	// First we initialize the items arrays with 'empty' information
-	//
-	for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
-		init_item(&loadlevel->ItemList[i]);
-	}
-
 	if (loadlevel->random_dungeon && !loadlevel->dungeon_generated)
 		return data;
 
@@ -787,8 +774,10 @@ static char *decode_item_section(level *loadlevel, char *data)
 			NextItemPointer = strstr(ItemPointer + 1, ITEM_ID_STRING);
 			if (NextItemPointer)
 				NextItemPointer[0] = 0;
-			ReadInOneItem(ItemPointer, ItemsSectionEnd, &(loadlevel->ItemList[i]));
-			loadlevel->ItemList[i].pos.z = loadlevel->levelnum;
+			item *it = &ACCESS_FLOOR_ITEM(loadlevel, pool_add(&loadlevel->ItemList));
+			init_item(it);
+			ReadInOneItem(ItemPointer, ItemsSectionEnd, it);
+			it->pos.z = loadlevel->levelnum;
 			if (NextItemPointer)
 				NextItemPointer[0] = ITEM_ID_STRING[0];
 		}
@@ -978,7 +967,7 @@ static int smash_obstacles_only_on_tile(float x, float y, int lvl, int map_x, in
 
 		target_idx = ((int *)(box_level->map[map_y][map_x].glued_obstacles.arr))[i];
 
-		target_obstacle = &(box_level->obstacle_list[target_idx]);
+		target_obstacle = &(ACCESS_OBSTACLE(box_level, target_idx));
 
 		struct obstacle_spec *obstacle_spec = get_obstacle_spec(target_obstacle->type);
 		if (!(obstacle_spec->flags & IS_SMASHABLE))
@@ -1106,6 +1095,7 @@ static level *decode_level(char **buffer)
 	char *data = *buffer;
 
 	loadlevel = (level *)MyMalloc(sizeof(level));
+	init_level_pools(loadlevel);
 	
 	if (decode_header(loadlevel, data)) {
 		error_message(__FUNCTION__, "Unable to decode level header!", PLEASE_INFORM | IS_FATAL);
@@ -1130,8 +1120,8 @@ static level *decode_level(char **buffer)
 	int need_defrag = FALSE;
 	struct auto_string *error_msg = alloc_autostr(256);
 
-	for (i = 0; i < MAX_OBSTACLES_ON_MAP; i++) {
-		struct obstacle *obs = &loadlevel->obstacle_list[i];
+	for (i = 0; i < loadlevel->obstacle_list.size; i++) {
+		struct obstacle *obs = &ACCESS_OBSTACLE(loadlevel, i);
 		if (obs->type == -1)
 			continue;
 		if (!pos_inside_level(obs->pos.x, obs->pos.y, loadlevel)) {
@@ -1168,21 +1158,56 @@ static level *decode_level(char **buffer)
 
 
 /** 
- * Call the random dungeon generator on this level  if this level is marked
- * as being randomly generated and if we are not in the "leveleditor" mode
- * in which case random dungeons must not be considered as generated (so that
- * they will be exported as being non-generated random levels).
+ * Call the random dungeon generator on the levels of the ship which are
+ * marked as being randomly generated and which are not yet generated.
+ * The dungeons are generated in parallel. A new seed is drawn for each
+ * call, so that each new game has its own dungeons.
+ *
+ * The generation runs in the background, so that the rest of the game
+ * loading is not delayed by it. wait_for_dungeons() has to be called
+ * before the random levels are used.
  */
-static void generate_dungeon_if_needed(level *l)
+static void generate_dungeons_if_needed(void)
 {
-	if (!l->random_dungeon || l->dungeon_generated) {
-		return;
+	level *to_generate[MAX_LEVELS];
+	int nb = 0;
+	int i;
+
+	for (i = 0; i < MAX_LEVELS; i++) {
+		if (!level_exists(i))
+			continue;
+
+		level *l = curShip.AllLevels[i];
+		if (l->random_dungeon && !l->dungeon_generated)
+			to_generate[nb++] = l;
 	}
 
-	// Generate random dungeon now
-	set_dungeon_output(l);
-	generate_dungeon(l->xlen, l->ylen, l->random_dungeon, l->teleport_pair);
-	l->dungeon_generated = 1;
+	if (!nb)
+		return;
+
+	for (i = 0; i < nb; i++)
+		to_generate[i]->dungeon_generated = 1;
+
+	generate_dungeons_in_background(to_generate, nb, rand());
+}
+
+static int obstacle_slot_is_free(void *o)
+{
+	return ((obstacle *)o)->type == -1;
+}
+
+static int floor_item_slot_is_free(void *it)
+{
+	return ((item *)it)->type == -1;
+}
+
+/**
+ * Initialize the (empty) obstacle and floor item pools of a new level.
+ */
+void init_level_pools(level *lvl)
+{
+	pool_init(&lvl->obstacle_list, sizeof(obstacle), obstacle_slot_is_free);
+	pool_init(&lvl->ItemList, sizeof(item), floor_item_slot_is_free);
 }
 
 void free_ship_level(level *lvl)
@@ -1190,6 +1215,8 @@ void free_ship_level(level *lvl)
 	int row = 0;
 	int col = 0;
 
+	lvledit_overview_forget_level(lvl->levelnum);
+
 	// Map tiles
 	remove_volatile_obstacles(lvl->levelnum);
 	for (row = 0; row < lvl->ylen; row++) {
@@ -1234,11 +1261,15 @@ void free_ship_level(level *lvl)
 	lvl->random_droids.types_size = 0;
 
 	// Items
-	for (w = 0; w < MAX_ITEMS_PER_LEVEL; w++) {
-		if (lvl->ItemList[w].type != -1) {
-			delete_upgrade_sockets(&(lvl->ItemList[w]));
+	for (w = 0; w < lvl->ItemList.size; w++) {
+		if (ACCESS_FLOOR_ITEM(lvl, w).type != -1) {
+			delete_upgrade_sockets(&(ACCESS_FLOOR_ITEM(lvl, w)));
 		}
 	}
+	pool_free(&lvl->ItemList);
+
+	// Obstacles
+	pool_free(&lvl->obstacle_list);
 
 	free(lvl);
 }
@@ -1246,6 +1277,10 @@ void free_ship_level(level *lvl)
 void free_current_ship()
 {
 	struct level *lvl;
+
+	// The dungeon generator could still be filling some levels
+	wait_for_dungeons();
+
 	BROWSE_LEVELS(lvl) {
 		int lvlnum = lvl->levelnum;
 		free_ship_level(lvl);
@@ -1305,8 +1340,6 @@ int LoadShip(char *filename, int compressed)
 
 		curShip.AllLevels[this_levelnum] = this_level;
 		curShip.num_levels = this_levelnum + 1;
-		
-		generate_dungeon_if_needed(this_level);
 
 		// Move to the level termination marker
 		pos = strstr(pos, LEVEL_END_STRING);
@@ -1323,6 +1356,8 @@ int LoadShip(char *filename, int compressed)
 	//
 	free(ShipData);
 
+	generate_dungeons_if_needed();
+
 	// Compute the gps transform acceleration data
 	gps_transform_map_dirty_flag = TRUE;
 	gps_transform_map_init();
@@ -1344,14 +1379,14 @@ static void encode_obstacles_of_this_level(struct auto_string *shipstr, struct l
 
 	autostr_append(shipstr, "%s\n", OBSTACLE_DATA_BEGIN_STRING);
 
-	for (i = 0; i < MAX_OBSTACLES_ON_MAP; i++) {
-		if (lvl->obstacle_list[i].type == (-1))
+	for (i = 0; i < lvl->obstacle_list.size; i++) {
+		if (ACCESS_OBSTACLE(lvl, i).type == (-1))
 			continue;
 
 		// Invalid obstacles are saved, but with a warning message unless we
 		// are playtesting, to enable further inspection of the bug.
 		// Anyhow, invalid obstacles are not loaded.
-		if (!pos_inside_level(lvl->obstacle_list[i].pos.x, lvl->obstacle_list[i].pos.y, lvl)) {
+		if (!pos_inside_level(ACCESS_OBSTACLE(lvl, i).pos.x, ACCESS_OBSTACLE(lvl, i).pos.y, lvl)) {
 			if (game_root_mode != ROOT_IS_LVLEDIT) {
 				error_once_message(ONCE_PER_GAME, __FUNCTION__,
 					"Some obstacles with an invalid position were found"
@@ -1359,8 +1394,8 @@ static void encode_obstacles_of_this_level(struct auto_string *shipstr, struct l
 			}
 			if (game_root_mode != ROOT_IS_LVLEDIT || game_status == INSIDE_LVLEDITOR) {
 				autostr_append(error_msg, "Invalid obstacle (%s) position on level %d: t%d x%3.2f y%3.2f\n",
-						((char **)get_obstacle_spec(lvl->obstacle_list[i].type)->filenames.arr)[0],
-						lvl->levelnum, lvl->obstacle_list[i].type, lvl->obstacle_list[i].pos.x, lvl->obstacle_list[i].pos.y);
+						((char **)get_obstacle_spec(ACCESS_OBSTACLE(lvl, i).type)->filenames.arr)[0],
+						lvl->levelnum, ACCESS_OBSTACLE(lvl, i).type, ACCESS_OBSTACLE(lvl, i).pos.x, ACCESS_OBSTACLE(lvl, i).pos.y);
 			}
 			// If we are inside the lvleditor, also display an alert
 			if (game_root_mode == ROOT_IS_LVLEDIT && game_status == INSIDE_LVLEDITOR) {
@@ -1371,9 +1406,9 @@ static void encode_obstacles_of_this_level(struct auto_string *shipstr, struct l
 						  "See the report in your terminal console."));
 			}
 		}
-		autostr_append(shipstr, "%s%d %s%3.2f %s%3.2f\n", OBSTACLE_TYPE_STRING, lvl->obstacle_list[i].type,
-				OBSTACLE_X_POSITION_STRING, lvl->obstacle_list[i].pos.x, OBSTACLE_Y_POSITION_STRING,
-				lvl->obstacle_list[i].pos.y);
+		autostr_append(shipstr, "%s%d %s%3.2f %s%3.2f\n", OBSTACLE_TYPE_STRING, ACCESS_OBSTACLE(lvl, i).type,
+				OBSTACLE_X_POSITION_STRING, ACCESS_OBSTACLE(lvl, i).pos.x, OBSTACLE_Y_POSITION_STRING,
+				ACCESS_OBSTACLE(lvl, i).pos.y);
 	}
 
 	autostr_append(shipstr, "%s\n", OBSTACLE_DATA_END_STRING);
@@ -1449,11 +1484,11 @@ static void EncodeItemSectionOfThisLevel(struct auto_string *shipstr, level *Lev
 
 	// Now we write out the bulk of items infos
 	//
-	for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
-		if (Lev->ItemList[i].type == (-1))
+	for (i = 0; i < Lev->ItemList.size; i++) {
+		if (ACCESS_FLOOR_ITEM(Lev, i).type == (-1))
 			continue;
 
-		WriteOutOneItem(shipstr, &(Lev->ItemList[i]));
+		WriteOutOneItem(shipstr, &(ACCESS_FLOOR_ITEM(Lev, i)));
 
 	}
 
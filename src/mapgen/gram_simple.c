@@ -12,10 +12,6 @@
 /* Minimum surface of a room */
 static const int Smin = 100;
 
-/* Dimensions of the dungeon */
-static int dim_x_init;
-static int dim_y_init;
-
 /* Worst y/x and x/y ratios accepted. */
 #define WORST_ROOM_RATIO 2.0
 
@@ -41,7 +37,7 @@ static int check_surf(int w_creator, int h_creator, int w_newroom, int h_newroom
  *
  * This function picks a ratio for the cut and sets r accordingly.
  */
-static int trycut(int dim_x, int dim_y, int *r, enum cut_axis vert)
+static int trycut(struct mapgen_context *ctx, int dim_x, int dim_y, int *r, enum cut_axis vert)
 {
 	/*
 	 * Example computation for a vertical cut : 
@@ -83,7 +79,7 @@ static int trycut(int dim_x, int dim_y, int *r, enum cut_axis vert)
 		return 0;
 	}
 	// Pick a cut ratio
-	*r = 100.0 * (rmin + (rmax - rmin) * ((float)rand() / (float)RAND_MAX));
+	*r = 100.0 * (rmin + (rmax - rmin) * ((float)mapgen_rand(ctx) / (float)MAPGEN_RAND_MAX));
 
 	return 1;
 }
@@ -92,24 +88,24 @@ static int trycut(int dim_x, int dim_y, int *r, enum cut_axis vert)
  * Make a decision about a cut in a room: whether to cut at all,
  *  what way to cut, and at what position
  */
-static enum cut_axis cut(int dim_x, int dim_y, int *r)
+static enum cut_axis cut(struct mapgen_context *ctx, int dim_x, int dim_y, int *r)
 {
 	enum cut_axis ret = DO_NOT_CUT;
 	// linear probability of cut
-	float chancetocut = (1 / (dim_x_init * dim_y_init)) * dim_x * dim_y - (Smin / (dim_x_init * dim_y_init - Smin));
-	float p = rand() % 10000 + 1;
+	float chancetocut = (1 / (ctx->dim_x_init * ctx->dim_y_init)) * dim_x * dim_y - (Smin / (ctx->dim_x_init * ctx->dim_y_init - Smin));
+	float p = mapgen_rand(ctx) % 10000 + 1;
 
 	// Test whether to cut at all
 	if (p / 10000 < chancetocut) {
 		return DO_NOT_CUT;
 	}
 	// Pick a random direction to cut along
-	ret = rand() % 2;
+	ret = mapgen_rand(ctx) % 2;
 
 	// Try to cut along this direction
-	if (!trycut(dim_x, dim_y, r, ret)) {
+	if (!trycut(ctx, dim_x, dim_y, r, ret)) {
 		// If we cannot, try the other direction
-		if (!trycut(dim_x, dim_y, r, !ret))
+		if (!trycut(ctx, dim_x, dim_y, r, !ret))
 			return DO_NOT_CUT;
 		else
 			ret = !ret;
@@ -131,17 +127,17 @@ static enum cut_axis cut(int dim_x, int dim_y, int *r)
 	return ret;
 }
 
-static void deriv_P(int id)
+static void deriv_P(struct mapgen_context *ctx, int id)
 {
 	int p;
 	int prop;
-	int x = rooms[id].x;
-	int y = rooms[id].y;
+	int x = ctx->rooms[id].x;
+	int y = ctx->rooms[id].y;
 	int creator = id;
-	int dim_x = rooms[creator].w;
-	int dim_y = rooms[creator].h;
+	int dim_x = ctx->rooms[creator].w;
+	int dim_y = ctx->rooms[creator].h;
 	int newroom;
-	p = cut(dim_x, dim_y, &prop);
+	p = cut(ctx, dim_x, dim_y, &prop);
 
 	int w_creator = dim_x;
 	int h_creator = dim_y;
@@ -159,13 +155,13 @@ static void deriv_P(int id)
 	 */
 	switch (p) {
 	case CUT_HORIZONTALLY:
-		h_creator = rooms[creator].h * prop / 100.0;
+		h_creator = ctx->rooms[creator].h * prop / 100.0;
 
 		h_newroom = dim_y - h_creator - 1;
 		y_newroom = y + h_creator + 1;
 		break;
 	case CUT_VERTICALLY:
-		w_creator = rooms[creator].w * prop / 100.0;
+		w_creator = ctx->rooms[creator].w * prop / 100.0;
 
 		w_newroom = dim_x - w_creator - 1;
 		x_newroom = x + w_creator + 1;
@@ -178,15 +174,15 @@ static void deriv_P(int id)
 		return;
 	}
 
-	newroom = mapgen_add_room(x_newroom, y_newroom, w_newroom, h_newroom);
+	newroom = mapgen_add_room(ctx, x_newroom, y_newroom, w_newroom, h_newroom);
 
-	rooms[creator].w = w_creator;
-	rooms[creator].h = h_creator;
+	ctx->rooms[creator].w = w_creator;
+	ctx->rooms[creator].h = h_creator;
 
-	mapgen_draw_room(newroom);
-	mapgen_draw_room(creator);
-	deriv_P(id);
-	deriv_P(newroom);
+	mapgen_draw_room(ctx, newroom);
+	mapgen_draw_room(ctx, creator);
+	deriv_P(ctx, id);
+	deriv_P(ctx, newroom);
 }
 
 static void adj(struct cplist_t *cplist, int *nx, int *ny)
@@ -201,12 +197,12 @@ static void adj(struct cplist_t *cplist, int *nx, int *ny)
 	*ny = cplist->y + dy[cplist->t];
 }
 
-static int set_internal_door(int room1, int room2)
+static int set_internal_door(struct mapgen_context *ctx, int room1, int room2)
 {
 	int i;
-	for (i = 0; i < rooms[room1].num_doors; i++) {
-		if (rooms[room1].doors[i].room == room2) {
-			rooms[room1].doors[i].internal = 1;
+	for (i = 0; i < ctx->rooms[room1].num_doors; i++) {
+		if (ctx->rooms[room1].doors[i].room == room2) {
+			ctx->rooms[room1].doors[i].internal = 1;
 			return 1;
 		}
 	}
@@ -217,7 +213,7 @@ static int set_internal_door(int room1, int room2)
 /**
  * Join two rooms by breaking the wall between them
  */
-void fusion(int id, int cible)
+void fusion(struct mapgen_context *ctx, int id, int cible)
 {
 	int new_owner;
 	struct cplist_t cplist[100];
@@ -227,7 +223,7 @@ void fusion(int id, int cible)
 	memset(cplist, -1, 100 * sizeof(struct cplist_t));
 
 	int nb_max;
-	nb_max = find_connection_points(id, cplist, 0);
+	nb_max = find_connection_points(ctx, id, cplist, 0);
 	int k = 0;
 	int l = 0;		//index du tableau correct_directory
 	while (k < nb_max) {
@@ -240,35 +236,35 @@ void fusion(int id, int cible)
 
 	// Owner of the new space should be that room whose side length
 	// is equal to the length of the deleted wall
-	if (l == rooms[id].w || l == rooms[id].h)
+	if (l == ctx->rooms[id].w || l == ctx->rooms[id].h)
 		new_owner = id;
 	else
 		new_owner = cible;
 	for (k = 0; k < l; k++) {
 		int x = cplist[correct_directory[k]].x;
 		int y = cplist[correct_directory[k]].y;
-		mapgen_put_tile(x, y, TILE_PARTITION, new_owner);
+		mapgen_put_tile(ctx, x, y, TILE_PARTITION, new_owner);
 	}
 
 	// Find the door between the given rooms and set its internal flag
-	if (l && !set_internal_door(id, cible))
-		set_internal_door(cible, id);
+	if (l && !set_internal_door(ctx, id, cible))
+		set_internal_door(ctx, cible, id);
 }
 
-static void add_rel(int x, int y, enum connection_type type, int r, int cible)
+static void add_rel(struct mapgen_context *ctx, int x, int y, enum connection_type type, int r, int cible)
 {
-	MakeConnect(x, y, type);
-	if ((((rooms[r].x != rooms[cible].x) || (rooms[r].w != rooms[cible].w)) && (type == UP || type == DOWN))
-	    || (((rooms[r].y != rooms[cible].y) || (rooms[r].h != rooms[cible].h)) && (type == RIGHT || type == LEFT))) {
-		if (!(rand() % 4))
-			fusion(r, cible);
+	MakeConnect(ctx, x, y, type);
+	if ((((ctx->rooms[r].x != ctx->rooms[cible].x) || (ctx->rooms[r].w != ctx->rooms[cible].w)) && (type == UP || type == DOWN))
+	    || (((ctx->rooms[r].y != ctx->rooms[cible].y) || (ctx->rooms[r].h != ctx->rooms[cible].h)) && (type == RIGHT || type == LEFT))) {
+		if (!(mapgen_rand(ctx) % 4))
+			fusion(ctx, r, cible);
 	}
 }
 
-static void bulldozer(unsigned char *seen, int r)
+static void bulldozer(struct mapgen_context *ctx, unsigned char *seen, int r)
 {
 	struct cplist_t cplist[300];
-	int max_connections = find_connection_points(r, cplist, 3);
+	int max_connections = find_connection_points(ctx, r, cplist, 3);
 	if (!max_connections)
 		error_message(__FUNCTION__, "Room %d does not have any connection points.", PLEASE_INFORM | IS_FATAL, r);
 
@@ -276,33 +272,33 @@ static void bulldozer(unsigned char *seen, int r)
 	seen[r] = 1;
 
 	// Pick a random connection to do
-	int i = rand() % max_connections;
+	int i = mapgen_rand(ctx) % max_connections;
 	int x2 = cplist[i].x;
 	int y2 = cplist[i].y;
 	adj(&cplist[i], &x2, &y2);
 
 	// if the rooms are already connected we do not create a new connection and stop the bulldozer
-	if (mapgen_are_connected(r, cplist[i].r))
+	if (mapgen_are_connected(ctx, r, cplist[i].r))
 		return;
 
 	// else we create a connection
-	add_rel(cplist[i].x, cplist[i].y, cplist[i].t, r, cplist[i].r);
+	add_rel(ctx, cplist[i].x, cplist[i].y, cplist[i].t, r, cplist[i].r);
 
 	// and move the bulldozer to the next room
-	bulldozer(seen, mapgen_get_room(x2, y2));
+	bulldozer(ctx, seen, mapgen_get_room(ctx, x2, y2));
 }
 
-static void launch_buldo()
+static void launch_buldo(struct mapgen_context *ctx)
 {
-	unsigned char seen[total_rooms];
-	unsigned char connected_to_room_0[total_rooms];
-	memset(seen, 0, total_rooms);
+	unsigned char seen[ctx->total_rooms];
+	unsigned char connected_to_room_0[ctx->total_rooms];
+	memset(seen, 0, ctx->total_rooms);
 
 	// Start bulldozers so that every room has been seen
 	int r;
-	for (r = 0; r < total_rooms; r++) {
+	for (r = 0; r < ctx->total_rooms; r++) {
 		if (!(seen[r])) {
-			bulldozer(seen, r);
+			bulldozer(ctx, seen, r);
 		}
 	}
 
@@ -310,17 +306,17 @@ static void launch_buldo()
 	// If it is not, ensure connectivity by connecting each vertex from 
 	// a component that is not 0's to 0's whenever possible, until we have
 	// connectivity.
-	while (!mapgen_is_connected(connected_to_room_0)) {
+	while (!mapgen_is_connected(ctx, connected_to_room_0)) {
 		int recalculate_components = 0;
 		// Find the first room that is not connected to room 0
 		int i;
-		for (i = 1; i < total_rooms && !recalculate_components; i++) {
+		for (i = 1; i < ctx->total_rooms && !recalculate_components; i++) {
 			if (!connected_to_room_0[i]) {
 				// See if we can connect it to a room that belongs to 0's connected component
 				int n;
 				struct cplist_t neigh[100];
 				int nbconn, prevneigh = -1;
-				nbconn = find_connection_points(i, neigh, 3);
+				nbconn = find_connection_points(ctx, i, neigh, 3);
 				for (n = 0; n < nbconn; n++) {
 					if (neigh[n].r == prevneigh) {
 						continue;
@@ -329,7 +325,7 @@ static void launch_buldo()
 						while (n + next < nbconn && neigh[n + next].r == neigh[n].r)
 							next++;
 
-						int pick = n + rand() % next;
+						int pick = n + mapgen_rand(ctx) % next;
 
 						n = pick;
 					}
@@ -337,9 +333,9 @@ static void launch_buldo()
 					prevneigh = neigh[n].r;
 
 					if (connected_to_room_0[neigh[n].r]) {
-						add_rel(neigh[n].x, neigh[n].y, neigh[n].t, i, neigh[n].r);
+						add_rel(ctx, neigh[n].x, neigh[n].y, neigh[n].t, i, neigh[n].r);
 
-						if (!(rand() % 3)) {
+						if (!(mapgen_rand(ctx) % 3)) {
 							recalculate_components = 1;
 						}
 
@@ -351,20 +347,20 @@ static void launch_buldo()
 	}
 }
 
-int generate_dungeon_gram(int dim_x, int dim_y)
+int generate_dungeon_gram(struct mapgen_context *ctx, int dim_x, int dim_y)
 {
-	dim_x_init = dim_x;
-	dim_y_init = dim_y;
-	total_rooms = 0;
+	ctx->dim_x_init = dim_x;
+	ctx->dim_y_init = dim_y;
+	ctx->total_rooms = 0;
 
 	// Create first room
-	mapgen_add_room(1, 1, dim_x - 2, dim_y - 2);
-	mapgen_draw_room(0);
+	mapgen_add_room(ctx, 1, 1, dim_x - 2, dim_y - 2);
+	mapgen_draw_room(ctx, 0);
 
 	// Recursively cut
-	deriv_P(0);
+	deriv_P(ctx, 0);
 
 	// Make connections between rooms
-	launch_buldo();
+	launch_buldo(ctx);
 	return 0;
 }
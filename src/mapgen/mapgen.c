@@ -14,13 +14,6 @@
 
 #define		SET_PILLAR_PROB		70
 
-static struct mapgen_gamelevel map;
-static level *target_level;
-
-struct roominfo *rooms;
-int total_rooms = 0;
-int max_rooms = 0;
-
 const struct { int enter, exit; } teleport_pairs[] = {
 	{ ISO_TELEPORTER_1, ISO_TELEPORTER_1},	// enter: cloud, exit: cloud
 	{ ISO_TELEPORTER_1, ISO_EXIT_5 },		// enter: cloud, exit: ladder to upstairs
@@ -28,79 +21,125 @@ const struct { int enter, exit; } teleport_pairs[] = {
 	{ ISO_EXIT_3, ISO_EXIT_5}				// enter: ladder to downstairs, exit: ladder to upstairs
 };
 
-static void new_level(int w, int h)
+static uint32_t mapgen_hash(uint32_t x)
+{
+	x ^= x >> 16;
+	x *= 0x7feb352d;
+	x ^= x >> 15;
+	x *= 0x846ca68b;
+	x ^= x >> 16;
+	return x;
+}
+
+// Seed the generator of a context, from the seed of the generation and the
+// characteristics of the level.
+static void mapgen_seed(struct mapgen_context *ctx, unsigned int seed, int levelnum, int tpair)
+{
+	ctx->rand_state = mapgen_hash(seed ^ mapgen_hash(levelnum * 4 + tpair + 1));
+
+	// A xorshift generator never leaves the zero state
+	if (!ctx->rand_state)
+		ctx->rand_state = 1;
+}
+
+/**
+ * Same as rand(), but using the generator of the context.
+ * Return a random number in [0, MAPGEN_RAND_MAX].
+ */
+int mapgen_rand(struct mapgen_context *ctx)
+{
+	uint32_t x = ctx->rand_state;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	ctx->rand_state = x;
+
+	return x >> 1;
+}
+
+/**
+ * Same as MyRandom(), but using the generator of the context.
+ * Return a random number in [0, upper_bound].
+ */
+int mapgen_random(struct mapgen_context *ctx, int upper_bound)
+{
+	if (upper_bound == 0)
+		return 0;
+
+	float tmp = 1.0 * mapgen_rand(ctx) / MAPGEN_RAND_MAX;
+
+	return (int)(tmp * (1.0 * upper_bound + 0.99999));
+}
+
+static void new_level(struct mapgen_context *ctx, int w, int h)
 {
 	int x, y;
 	unsigned char *map_p;
 
-	map.w = w;
-	map.h = h;
+	ctx->map.w = w;
+	ctx->map.h = h;
 
-	map.m = malloc(map.w * map.h * sizeof(unsigned char));
-	map.r = malloc(map.w * map.h * sizeof(int));
-	map_p = map.m;
+	ctx->map.m = malloc(ctx->map.w * ctx->map.h * sizeof(unsigned char));
+	ctx->map.r = malloc(ctx->map.w * ctx->map.h * sizeof(int));
+	map_p = ctx->map.m;
 
-	for (y = 0; y < map.h; y++) {
-		for (x = 0; x < map.w; x++) {
+	for (y = 0; y < ctx->map.h; y++) {
+		for (x = 0; x < ctx->map.w; x++) {
 			*(map_p++) = TILE_EMPTY;
-			map.r[y * map.w + x] = -1;
+			ctx->map.r[y * ctx->map.w + x] = -1;
 		}
 	}
 
-	rooms = MyMalloc(100 * sizeof(struct roominfo));
-	max_rooms = 100;
-	total_rooms = 0;
+	ctx->rooms = MyMalloc(100 * sizeof(struct roominfo));
+	ctx->max_rooms = 100;
+	ctx->total_rooms = 0;
 }
 
-static void free_level()
+static void free_level(struct mapgen_context *ctx)
 {
 	int i;
 
-	free(map.m);
-	free(map.r);
+	free(ctx->map.m);
+	free(ctx->map.r);
 
-	for (i = 0; i < total_rooms; i++) {
-		free(rooms[i].neighbors);
+	for (i = 0; i < ctx->total_rooms; i++) {
+		free(ctx->rooms[i].neighbors);
 	}
 
-	free(rooms);
-	total_rooms = 0;
-	max_rooms = 0;
-	rooms = NULL;
-}
-
-void set_dungeon_output(level * output)
-{
-	target_level = output;
+	free(ctx->rooms);
+	ctx->total_rooms = 0;
+	ctx->max_rooms = 0;
+	ctx->rooms = NULL;
 }
 
-void mapgen_add_obstacle(double x, double y, int type)
+void mapgen_add_obstacle(struct mapgen_context *ctx, double x, double y, int type)
 {
-	add_obstacle(target_level, x, y, type);
+	add_obstacle(ctx->target_level, x, y, type);
 }
 
-void mapgen_set_floor(int x, int y, int type)
+void mapgen_set_floor(struct mapgen_context *ctx, int x, int y, int type)
 {
-	target_level->map[y][x].floor_values[0] = type;
+	ctx->target_level->map[y][x].floor_values[0] = type;
 }
 
-static void split_wall(int w, int h, unsigned char *tiles) 
+static void split_wall(struct mapgen_context *ctx, int w, int h, unsigned char *tiles) 
 {
 	int y, x; 
 	int room;
-#define SET(X,Y,TILE) mapgen_put_tile(X, Y, TILE, room)
+#define SET(X,Y,TILE) mapgen_put_tile(ctx, X, Y, TILE, room)
 
 	// Reduce the size of the rooms, not lying on the map's boundary.
-	for (x = 0; x < total_rooms; x++) {
-		if (rooms[x].x + rooms[x].w < w - 1 )
-			rooms[x].w--;
-		if (rooms[x].y + rooms[x].h < h - 1)
-			rooms[x].h--;
+	for (x = 0; x < ctx->total_rooms; x++) {
+		if (ctx->rooms[x].x + ctx->rooms[x].w < w - 1 )
+			ctx->rooms[x].w--;
+		if (ctx->rooms[x].y + ctx->rooms[x].h < h - 1)
+			ctx->rooms[x].h--;
 	}
 
 	for (y = 1; y < h - 1; y++) 
 		for (x = 1; x < w - 1; x++) {
-			room = mapgen_get_room(x, y);
+			room = mapgen_get_room(ctx, x, y);
 			if (tiles[y * w + x] == TILE_WALL) {
 				SET(x - 1, y    , TILE_WALL);
 				SET(x    , y - 1, TILE_WALL);
@@ -113,7 +152,7 @@ static void split_wall(int w, int h, unsigned char *tiles)
 // room border and check whether we can shift the current wall
 // tile closer to the center of rooms. Therefore the room size
 // becomes smaller and free space between rooms increases.
-static void reduce_room_space() {
+static void reduce_room_space(struct mapgen_context *ctx) {
 	int x, y;
 	int i, j;
 	int point_x[4];
@@ -122,66 +161,66 @@ static void reduce_room_space() {
 	const int point_dx[4] = { 1,  0, -1,  0};
 	const int point_dy[4] = { 0,  1,  0, -1};
 	const int check_dir[4] = { 3, 1, 2, 0 };
-	for (i = 0; i < total_rooms; i++) {
-		if (rooms[i].w < 4 || rooms[i].h < 4)
+	for (i = 0; i < ctx->total_rooms; i++) {
+		if (ctx->rooms[i].w < 4 || ctx->rooms[i].h < 4)
 			continue;
 
 		// 4 start points, one per room corner
-		point_x[0] = rooms[i].x;
-		point_y[0] = rooms[i].y;
-		count[0] = rooms[i].w;
+		point_x[0] = ctx->rooms[i].x;
+		point_y[0] = ctx->rooms[i].y;
+		count[0] = ctx->rooms[i].w;
 
-		point_x[1] = rooms[i].x + rooms[i].w - 1;
-		point_y[1] = rooms[i].y; 
-		count[1] = rooms[i].h;
+		point_x[1] = ctx->rooms[i].x + ctx->rooms[i].w - 1;
+		point_y[1] = ctx->rooms[i].y; 
+		count[1] = ctx->rooms[i].h;
 
-		point_x[2] = rooms[i].x + rooms[i].w - 1;
-		point_y[2] = rooms[i].y + rooms[i].h - 1;
-		count[2] = rooms[i].w;
+		point_x[2] = ctx->rooms[i].x + ctx->rooms[i].w - 1;
+		point_y[2] = ctx->rooms[i].y + ctx->rooms[i].h - 1;
+		count[2] = ctx->rooms[i].w;
 
-		point_x[3] = rooms[i].x;
-		point_y[3] = rooms[i].y + rooms[i].h - 1;
-		count[3] = rooms[i].h;
+		point_x[3] = ctx->rooms[i].x;
+		point_y[3] = ctx->rooms[i].y + ctx->rooms[i].h - 1;
+		count[3] = ctx->rooms[i].h;
 
 		for (j = 0; j < 4; j++) {
-			if (MyRandom(100) > 40)
+			if (mapgen_random(ctx, 100) > 40)
 				continue;
 
 			x = point_x[j];
 			y = point_y[j];
-			if (mapgen_get_tile(x + point_dx[check_dir[j]], y + point_dy[check_dir[j]]) != TILE_WALL)
+			if (mapgen_get_tile(ctx, x + point_dx[check_dir[j]], y + point_dy[check_dir[j]]) != TILE_WALL)
 				continue;
 
 			switch(j) {
 				case 0:
-					rooms[i].y++;
-					rooms[i].h--;
+					ctx->rooms[i].y++;
+					ctx->rooms[i].h--;
 					break;
 				case 1:
-					rooms[i].w--;
+					ctx->rooms[i].w--;
 					break;
 				case 2:
-					rooms[i].h--;
+					ctx->rooms[i].h--;
 					break;
 				case 3:
-					rooms[i].x++;
-					rooms[i].w--;
+					ctx->rooms[i].x++;
+					ctx->rooms[i].w--;
 					break;
 			}
 			while (count[j]--) {
-				mapgen_put_tile(x, y, TILE_WALL, -1);
+				mapgen_put_tile(ctx, x, y, TILE_WALL, -1);
 				x +=  point_dx[j];
 				y +=  point_dy[j];
 			}
 			// If the given room took part in fusion there may be additional tile ahead
 			// that should be removed
-			if (mapgen_get_tile(x, y) == TILE_PARTITION)
-				mapgen_put_tile(x, y, TILE_WALL, -1);
+			if (mapgen_get_tile(ctx, x, y) == TILE_PARTITION)
+				mapgen_put_tile(ctx, x, y, TILE_WALL, -1);
 		}
 	}
 }
 
-static void place_internal_door(int x, int y, enum connection_type dir)
+static void place_internal_door(struct mapgen_context *ctx, int x, int y, enum connection_type dir)
 {
 	const int check_horz[] = { 0, -1 };
 	const int check_vert[] = { -1, 0 };
@@ -204,15 +243,15 @@ static void place_internal_door(int x, int y, enum connection_type dir)
 		dy = dy_vert;
 		door = ISO_V_DOOR_000_OPEN;
 	}
-	room = mapgen_get_room(x, y);
-	mapgen_put_tile(x, y, TILE_FLOOR, room);
-	if (mapgen_get_room(x + check[0], y + check[1]) != room)
-		mapgen_add_obstacle(x + dx[0], y + dy[0], door);
+	room = mapgen_get_room(ctx, x, y);
+	mapgen_put_tile(ctx, x, y, TILE_FLOOR, room);
+	if (mapgen_get_room(ctx, x + check[0], y + check[1]) != room)
+		mapgen_add_obstacle(ctx, x + dx[0], y + dy[0], door);
 	else
-		mapgen_add_obstacle(x + dx[1], y + dy[1], door);
+		mapgen_add_obstacle(ctx, x + dx[1], y + dy[1], door);
 }
 
-static void place_doors()
+static void place_doors(struct mapgen_context *ctx)
 {
 	int i, j, room;
 	int x, y;
@@ -222,51 +261,51 @@ static void place_doors()
 	int id, id1, id2;
 	int place_door;
 
-	for (i = 0; i < total_rooms; i++) {
-		for (j = 0; j < rooms[i].num_doors; j++) {
-			x = rooms[i].doors[j].x;
-			y = rooms[i].doors[j].y;
-			room = rooms[i].doors[j].room;
+	for (i = 0; i < ctx->total_rooms; i++) {
+		for (j = 0; j < ctx->rooms[i].num_doors; j++) {
+			x = ctx->rooms[i].doors[j].x;
+			y = ctx->rooms[i].doors[j].y;
+			room = ctx->rooms[i].doors[j].room;
 			w = 2;
 			id1 = -1;
 			id2 = -1;
 			place_door = 1;
 			// Place door only if both rooms have its side length greater then 2
 			// If one of the rooms is a corridor then whole doorway should belong to it
-			if (rooms[i].w < 3 || rooms[i].h < 3) {
+			if (ctx->rooms[i].w < 3 || ctx->rooms[i].h < 3) {
 				id1 = i;
 				id2 = i;
 				place_door = 0;
 			}
-			if (rooms[room].w < 3 || rooms[room].h < 3) {
+			if (ctx->rooms[room].w < 3 || ctx->rooms[room].h < 3) {
 				id1 = room;
 				id2 = room;
 				place_door = 0;
 			}
 
-			if (rooms[i].x < x - 1 && x - 1 <= (rooms[i].x + rooms[i].w - 1)) {
+			if (ctx->rooms[i].x < x - 1 && x - 1 <= (ctx->rooms[i].x + ctx->rooms[i].w - 1)) {
 				// Place horizontal wall
 
 				// Set single horizontal door if the wall is internal
-				if (mapgen_get_tile(x, y) == TILE_PARTITION) {
-					place_internal_door(x, y, UP);
+				if (mapgen_get_tile(ctx, x, y) == TILE_PARTITION) {
+					place_internal_door(ctx, x, y, UP);
 					continue;
 				}
 
 				// Shift to left by 1 due to split done
 				x1 = x - w;
 				x2 = x;
-				if (y < rooms[i].y) {
-					y1 = rooms[room].y + rooms[room].h;
-					y2 = rooms[i].y;
+				if (y < ctx->rooms[i].y) {
+					y1 = ctx->rooms[room].y + ctx->rooms[room].h;
+					y2 = ctx->rooms[i].y;
 					dir = UP;
 					if (id1 == -1) {
 						id1 = room;
 						id2 = i;
 					}
 				} else {
-					y1 = rooms[i].y + rooms[i].h;
-					y2 = rooms[room].y;
+					y1 = ctx->rooms[i].y + ctx->rooms[i].h;
+					y2 = ctx->rooms[room].y;
 					dir = DOWN;
 					if (id1 == -1) {
 						id1 = i;
@@ -274,46 +313,46 @@ static void place_doors()
 					}
 				}
 				if (place_door)
-					mapgen_add_obstacle(x1 + 0.5, (y1 + y2) / 2.0, ISO_DH_DOOR_000_OPEN);
+					mapgen_add_obstacle(ctx, x1 + 0.5, (y1 + y2) / 2.0, ISO_DH_DOOR_000_OPEN);
 
-				if (MyRandom(100) < SET_PILLAR_PROB &&  y2 - y1 > 2) {
-					if (rooms[i].x <= x - w - 1 && rooms[i].x + rooms[i].w > x &&
-						rooms[room].x <= x - w - 1 && rooms[room].x + rooms[room].w > x) {
-						mapgen_put_tile(x1-1, y1, TILE_FLOOR, id1);
-						mapgen_add_obstacle(x1 - 0.5, y1 + 0.5, ISO_PILLAR_SHORT);
+				if (mapgen_random(ctx, 100) < SET_PILLAR_PROB &&  y2 - y1 > 2) {
+					if (ctx->rooms[i].x <= x - w - 1 && ctx->rooms[i].x + ctx->rooms[i].w > x &&
+						ctx->rooms[room].x <= x - w - 1 && ctx->rooms[room].x + ctx->rooms[room].w > x) {
+						mapgen_put_tile(ctx, x1-1, y1, TILE_FLOOR, id1);
+						mapgen_add_obstacle(ctx, x1 - 0.5, y1 + 0.5, ISO_PILLAR_SHORT);
 
-						mapgen_put_tile(x1 + w, y1, TILE_FLOOR, id1);
-						mapgen_add_obstacle(x1 + w + 0.5, y1 + 0.5, ISO_PILLAR_SHORT);
+						mapgen_put_tile(ctx, x1 + w, y1, TILE_FLOOR, id1);
+						mapgen_add_obstacle(ctx, x1 + w + 0.5, y1 + 0.5, ISO_PILLAR_SHORT);
 
-						mapgen_put_tile(x1-1, y2 - 1, TILE_FLOOR, id2);
-						mapgen_add_obstacle(x1 - 0.5, y2 - 0.5, ISO_PILLAR_SHORT);
+						mapgen_put_tile(ctx, x1-1, y2 - 1, TILE_FLOOR, id2);
+						mapgen_add_obstacle(ctx, x1 - 0.5, y2 - 0.5, ISO_PILLAR_SHORT);
 
-						mapgen_put_tile(x1 + w, y2 - 1, TILE_FLOOR, id2);
-						mapgen_add_obstacle(x1 + w + 0.5, y2 - 0.5, ISO_PILLAR_SHORT);
+						mapgen_put_tile(ctx, x1 + w, y2 - 1, TILE_FLOOR, id2);
+						mapgen_add_obstacle(ctx, x1 + w + 0.5, y2 - 0.5, ISO_PILLAR_SHORT);
 					}
 				} 
 			} else {
 				// Place vertical wall
 
 				// Set signle vertical door if the wall is internal
-				if (mapgen_get_tile(x, y) == TILE_PARTITION) {
-					place_internal_door(x, y, LEFT);
+				if (mapgen_get_tile(ctx, x, y) == TILE_PARTITION) {
+					place_internal_door(ctx, x, y, LEFT);
 					continue;
 				}
 				// Shift to top by 1 due to split done
 				y1 = y - w;
 				y2 = y;
-				if (x < rooms[i].x) {
-					x1 = rooms[room].x + rooms[room].w;
-					x2 = rooms[i].x;
+				if (x < ctx->rooms[i].x) {
+					x1 = ctx->rooms[room].x + ctx->rooms[room].w;
+					x2 = ctx->rooms[i].x;
 					dir = LEFT;
 					if (id1 == -1) {
 						id1 = room;
 						id2 = i;
 					}
 				} else {
-					x1 = rooms[i].x + rooms[i].w;
-					x2 = rooms[room].x;
+					x1 = ctx->rooms[i].x + ctx->rooms[i].w;
+					x2 = ctx->rooms[room].x;
 					dir = RIGHT;
 					if (id1 == -1) {
 						id1 = i;
@@ -321,22 +360,22 @@ static void place_doors()
 					}
 				}
 				if (place_door)
-					mapgen_add_obstacle((x1 + x2) / 2.0, y1 + 0.5, ISO_DV_DOOR_000_OPEN);
+					mapgen_add_obstacle(ctx, (x1 + x2) / 2.0, y1 + 0.5, ISO_DV_DOOR_000_OPEN);
 
-				if (MyRandom(100) < SET_PILLAR_PROB &&  x2 - x1 > 2) {
-					if (rooms[i].y <= y - w - 1 && rooms[i].y + rooms[i].h > y &&
-						rooms[room].y <= y - w - 1 && rooms[room].y + rooms[room].h > y) {
-						mapgen_put_tile(x1, y1 - 1, TILE_FLOOR, id1);
-						mapgen_add_obstacle(x1 + 0.5, y1 - 0.5, ISO_PILLAR_SHORT);
+				if (mapgen_random(ctx, 100) < SET_PILLAR_PROB &&  x2 - x1 > 2) {
+					if (ctx->rooms[i].y <= y - w - 1 && ctx->rooms[i].y + ctx->rooms[i].h > y &&
+						ctx->rooms[room].y <= y - w - 1 && ctx->rooms[room].y + ctx->rooms[room].h > y) {
+						mapgen_put_tile(ctx, x1, y1 - 1, TILE_FLOOR, id1);
+						mapgen_add_obstacle(ctx, x1 + 0.5, y1 - 0.5, ISO_PILLAR_SHORT);
 
-						mapgen_put_tile(x1, y1 + w, TILE_FLOOR, id2);
-						mapgen_add_obstacle(x1 + 0.5, y1 + w + 0.5, ISO_PILLAR_SHORT);
+						mapgen_put_tile(ctx, x1, y1 + w, TILE_FLOOR, id2);
+						mapgen_add_obstacle(ctx, x1 + 0.5, y1 + w + 0.5, ISO_PILLAR_SHORT);
 
-						mapgen_put_tile(x2 - 1, y1 - 1, TILE_FLOOR, id1);
-						mapgen_add_obstacle(x2 - 0.5, y1 - 0.5, ISO_PILLAR_SHORT);
+						mapgen_put_tile(ctx, x2 - 1, y1 - 1, TILE_FLOOR, id1);
+						mapgen_add_obstacle(ctx, x2 - 0.5, y1 - 0.5, ISO_PILLAR_SHORT);
 
-						mapgen_put_tile(x2 - 1, y1 + w, TILE_FLOOR, id2);
-						mapgen_add_obstacle(x2 - 0.5, y1 + w + 0.5, ISO_PILLAR_SHORT);
+						mapgen_put_tile(ctx, x2 - 1, y1 + w, TILE_FLOOR, id2);
+						mapgen_add_obstacle(ctx, x2 - 0.5, y1 + w + 0.5, ISO_PILLAR_SHORT);
 					}
 				}
 			}
@@ -348,7 +387,7 @@ static void place_doors()
 						id = x < (x1 + x2) / 2 ? id1 : id2;
 					else
 						id = y < (y1 + y2) / 2 ? id1 : id2;
-					mapgen_put_tile(x, y, TILE_FLOOR, id);
+					mapgen_put_tile(ctx, x, y, TILE_FLOOR, id);
 				}
 			}
 		}
@@ -357,40 +396,40 @@ static void place_doors()
 
 // Turn the given room into corridor and return whether
 // the transformation was successful
-static int make_corridor(int room)
+static int make_corridor(struct mapgen_context *ctx, int room)
 {
 #define	MAX_DOORS_IN_CORRIDOR	3
 	struct doorinfo doors[3];
 	int num_doors = 0;
 	int i, j;
-	int x1 = rooms[room].x;
-	int y1 = rooms[room].y;
-	int x2 = x1 + rooms[room].w - 1;
-	int y2 = y1 + rooms[room].h - 1;
+	int x1 = ctx->rooms[room].x;
+	int y1 = ctx->rooms[room].y;
+	int x2 = x1 + ctx->rooms[room].w - 1;
+	int y2 = y1 + ctx->rooms[room].h - 1;
 	int xmin = x2 + 1;
 	int ymin = y2 + 1;
 	int xmax = x1;
 	int ymax = y1;
 
-	if (rooms[room].num_doors > MAX_DOORS_IN_CORRIDOR)
+	if (ctx->rooms[room].num_doors > MAX_DOORS_IN_CORRIDOR)
 		return 0;
 
 
-	for (i = 0; i < rooms[room].num_doors; i++) {
+	for (i = 0; i < ctx->rooms[room].num_doors; i++) {
 		// We don't connect internal door to the corridor so exit
-		if (rooms[room].doors[i].internal)
+		if (ctx->rooms[room].doors[i].internal)
 			return 0;
-		doors[num_doors++] = rooms[room].doors[i];
+		doors[num_doors++] = ctx->rooms[room].doors[i];
 	}
 	// Find the doors of other rooms leading to the given room
-	for (i = 0; i < total_rooms; i++) {
-		for (j = 0; j < rooms[i].num_doors; j++) {
-			if (rooms[i].doors[j].room == room) {
-				if (rooms[i].doors[j].internal)
+	for (i = 0; i < ctx->total_rooms; i++) {
+		for (j = 0; j < ctx->rooms[i].num_doors; j++) {
+			if (ctx->rooms[i].doors[j].room == room) {
+				if (ctx->rooms[i].doors[j].internal)
 					return 0;
 				if (num_doors == MAX_DOORS_IN_CORRIDOR)
 					return 0;
-				doors[num_doors++] = rooms[i].doors[j];
+				doors[num_doors++] = ctx->rooms[i].doors[j];
 			}
 		}
 	}
@@ -419,56 +458,61 @@ static int make_corridor(int room)
 		ymax = ymin + 1;
 	}
 	// Remove old tiles and redraw room
-	rooms[room].x = xmin - 2;
-	rooms[room].y = ymin - 2;
-	rooms[room].w = max(xmax - xmin, 2);
-	rooms[room].h = max(ymax - ymin, 2);
+	ctx->rooms[room].x = xmin - 2;
+	ctx->rooms[room].y = ymin - 2;
+	ctx->rooms[room].w = max(xmax - xmin, 2);
+	ctx->rooms[room].h = max(ymax - ymin, 2);
 	for (i = y1; i <= y2; i++) {
 		for (j = x1; j <= x2; j++)
-			mapgen_put_tile(j, i, TILE_WALL, -1);
+			mapgen_put_tile(ctx, j, i, TILE_WALL, -1);
 	}
-	mapgen_draw_room(room);
+	mapgen_draw_room(ctx, room);
 
 	return 1;
 }
 
-static int cmp_room_surface(const void *room1, const void *room2)
+// Sort rooms by decreasing surface. qsort() can not be given the context,
+// and its order of equal elements is not the same on every platform, so an
+// insertion sort is used to keep the result reproducible.
+static void sort_rooms_by_surface(struct mapgen_context *ctx, int *idx, int nb)
 {
-	int r1 = *(int *)room1;
-	int r2 = *(int *)room2;
+	int i, j;
 
-	int s1 = rooms[r1].w * rooms[r1].h;
-	int s2 = rooms[r2].w * rooms[r2].h;
+	for (i = 1; i < nb; i++) {
+		int room = idx[i];
+		int s = ctx->rooms[room].w * ctx->rooms[room].h;
 
-	if (s1 == s2) { 
-		return 0;
-	} else if (s1 < s2) {
-		return 1;
-	} else 
-		return -1;
+		for (j = i; j > 0; j--) {
+			int prev = idx[j - 1];
+			if (ctx->rooms[prev].w * ctx->rooms[prev].h >= s)
+				break;
+			idx[j] = prev;
+		}
+		idx[j] = room;
+	}
 }
 
 // Convert tile matrix to a set of obstacles and decorate rooms according to their themes,
 // using mid_room as the center of dungeon
-void mapgen_convert(struct dungeon_info *di, int w, int h, unsigned char *tiles)
+void mapgen_convert(struct mapgen_context *ctx, struct dungeon_info *di, int w, int h, unsigned char *tiles)
 {
 	int i;
 	int idx[di->num_rooms];
 	int tries = 30;
 	int n = 7;
 
-	reduce_room_space();
-	split_wall(w, h, tiles);
+	reduce_room_space(ctx);
+	split_wall(ctx, w, h, tiles);
 
 	// Sort rooms by their surface
 	for (i = 0; i < di->num_rooms; i++)
 		idx[i] = i;
-	qsort(idx, di->num_rooms, sizeof(int), cmp_room_surface);
+	sort_rooms_by_surface(ctx, idx, di->num_rooms);
 
 	i = 0;
 	while(tries && n && (i < di->num_rooms)) {
 		if (idx[i] != di->enter && idx[i] != di->exit) {
-			if (make_corridor(idx[i]))
+			if (make_corridor(ctx, idx[i]))
 				n--;
 			else
 				tries--;
@@ -476,14 +520,14 @@ void mapgen_convert(struct dungeon_info *di, int w, int h, unsigned char *tiles)
 		i++;
 	}
 
-	place_doors();
+	place_doors(ctx);
 
-	qsort(idx, di->num_rooms, sizeof(int), cmp_room_surface);
+	sort_rooms_by_surface(ctx, idx, di->num_rooms);
 
-	mapgen_place_obstacles(di, w, h, tiles, idx);
+	mapgen_place_obstacles(ctx, di, w, h, tiles, idx);
 }
 
-static void add_teleport(int telnum, int x, int y, int tpair)
+static void add_teleport(struct mapgen_context *ctx, int telnum, int x, int y, int tpair)
 {
 	const int helpers[2][4] = {
 		{ ISO_DROID_NEST_GREEN, ISO_DROID_NEST_GREEN, ISO_DROID_NEST_GREEN, ISO_DROID_NEST_GREEN },
@@ -493,43 +537,43 @@ static void add_teleport(int telnum, int x, int y, int tpair)
 	char *warp, *fromwarp;
 	char tmp[500];
 
-	sprintf(tmp, "%dtoX%d", target_level->levelnum, telnum);
+	sprintf(tmp, "%dtoX%d", ctx->target_level->levelnum, telnum);
 	warp = strdup(tmp);
 
-	sprintf(tmp, "%dfromX%d", target_level->levelnum, telnum);
+	sprintf(tmp, "%dfromX%d", ctx->target_level->levelnum, telnum);
 	fromwarp = strdup(tmp);
 
-	add_map_label(target_level, x, y, warp);
-	add_map_label(target_level, x + 1, y, fromwarp);
+	add_map_label(ctx->target_level, x, y, warp);
+	add_map_label(ctx->target_level, x + 1, y, fromwarp);
 
 	// A label placed at (x, y) is actually positioned at (x+0.5, y+0.5).
 	// That 0.5 translation is added to the other obstacles around the labels
 	// to have a coherent position.
 
 	int obs_type = telnum ? teleport_pairs[tpair].exit : teleport_pairs[tpair].enter;
-	mapgen_add_obstacle(x + 0.5, y + 0.5, obs_type);
+	mapgen_add_obstacle(ctx, x + 0.5, y + 0.5, obs_type);
 
 	// Decorate room with teleport if the obstacle is the cloud
 	if (obs_type == ISO_TELEPORTER_1) {
-		int helper = MyRandom(1);
-		mapgen_add_obstacle(x + 1 + 0.5, y - 1 + 0.5, helpers[helper][0]);
-		mapgen_add_obstacle(x - 1 + 0.5, y - 1 + 0.5, helpers[helper][1]);
-		mapgen_add_obstacle(x + 1 + 0.5, y + 1 + 0.5, helpers[helper][2]);
-		mapgen_add_obstacle(x - 1 + 0.5, y + 1 + 0.5, helpers[helper][3]);
+		int helper = mapgen_random(ctx, 1);
+		mapgen_add_obstacle(ctx, x + 1 + 0.5, y - 1 + 0.5, helpers[helper][0]);
+		mapgen_add_obstacle(ctx, x - 1 + 0.5, y - 1 + 0.5, helpers[helper][1]);
+		mapgen_add_obstacle(ctx, x + 1 + 0.5, y + 1 + 0.5, helpers[helper][2]);
+		mapgen_add_obstacle(ctx, x - 1 + 0.5, y + 1 + 0.5, helpers[helper][3]);
 	}
 }
 
-void mapgen_entry_at(struct roominfo *r, int tpair)
+void mapgen_entry_at(struct mapgen_context *ctx, struct roominfo *r, int tpair)
 {
-	add_teleport(0, r->x + r->w / 2, r->y + r->h / 2, tpair);
+	add_teleport(ctx, 0, r->x + r->w / 2, r->y + r->h / 2, tpair);
 }
 
-void mapgen_exit_at(struct roominfo *r, int tpair)
+void mapgen_exit_at(struct mapgen_context *ctx, struct roominfo *r, int tpair)
 {
-	add_teleport(1, r->x + r->w / 2, r->y + r->h / 2, tpair);
+	add_teleport(ctx, 1, r->x + r->w / 2, r->y + r->h / 2, tpair);
 }
 
-void mapgen_gift(struct roominfo *r)
+void mapgen_gift(struct mapgen_context *ctx, struct roominfo *r)
 {
 	const int gifts[] = {
 		ISO_E_CHEST2_CLOSED,
@@ -540,7 +584,7 @@ void mapgen_gift(struct roominfo *r)
 	const int dx[] = { -2, 1, 0, 0 };
 	const int dy[] = { 0, 0, -2, 1 };
 
-	int pos = MyRandom(3);
+	int pos = mapgen_random(ctx, 3);
 
 	struct {
 		float x;
@@ -553,119 +597,119 @@ void mapgen_gift(struct roominfo *r)
 		r->x + r->w / 2, r->y + r->h - 1}
 	};
 
-	if (mapgen_get_tile(positions[pos].x + dx[pos], positions[pos].y + dy[pos]) == TILE_WALL) {
+	if (mapgen_get_tile(ctx, positions[pos].x + dx[pos], positions[pos].y + dy[pos]) == TILE_WALL) {
 		obstacle_spec *spec = get_obstacle_spec(gifts[pos]);
 		positions[pos].x += spec->right_border;
 		positions[pos].y += spec->lower_border;
-		mapgen_add_obstacle(positions[pos].x, positions[pos].y, gifts[pos]);
+		mapgen_add_obstacle(ctx, positions[pos].x, positions[pos].y, gifts[pos]);
 	}
 }
 
-int mapgen_add_room(int x, int y, int w, int h)
+int mapgen_add_room(struct mapgen_context *ctx, int x, int y, int w, int h)
 {
-	int newid = total_rooms;
+	int newid = ctx->total_rooms;
 
-	if (total_rooms == max_rooms) {
+	if (ctx->total_rooms == ctx->max_rooms) {
 		// Add 10 more slots
-		max_rooms += 10;
-		struct roominfo *buffer = realloc(rooms, max_rooms * sizeof(struct roominfo));
+		ctx->max_rooms += 10;
+		struct roominfo *buffer = realloc(ctx->rooms, ctx->max_rooms * sizeof(struct roominfo));
 		if (!buffer) {
-			error_message(__FUNCTION__, "Not enough memory to reallocate the 'rooms' datastruct (requested size: " SIZE_T_F ").", IS_FATAL, max_rooms * sizeof(struct roominfo));
+			error_message(__FUNCTION__, "Not enough memory to reallocate the 'ctx->rooms' datastruct (requested size: " SIZE_T_F ").", IS_FATAL, ctx->max_rooms * sizeof(struct roominfo));
 			return -1;
 		}
-		rooms = buffer;
+		ctx->rooms = buffer;
 	}
 
-	total_rooms++;
+	ctx->total_rooms++;
 
 	// don't forget to reserve space for bounding walls
-	rooms[newid].x = x;
-	rooms[newid].y = y;
-	rooms[newid].w = w;
-	rooms[newid].h = h;
-	rooms[newid].num_neighbors = 0;
-	rooms[newid].max_neighbors = 8;
-	rooms[newid].neighbors = MyMalloc(rooms[newid].max_neighbors * sizeof(int));
-	rooms[newid].num_doors = 0;
+	ctx->rooms[newid].x = x;
+	ctx->rooms[newid].y = y;
+	ctx->rooms[newid].w = w;
+	ctx->rooms[newid].h = h;
+	ctx->rooms[newid].num_neighbors = 0;
+	ctx->rooms[newid].max_neighbors = 8;
+	ctx->rooms[newid].neighbors = MyMalloc(ctx->rooms[newid].max_neighbors * sizeof(int));
+	ctx->rooms[newid].num_doors = 0;
 
 	return newid;
 }
 
-void mapgen_put_tile(int x, int y, unsigned char tile, int room)
+void mapgen_put_tile(struct mapgen_context *ctx, int x, int y, unsigned char tile, int room)
 {
-	map.m[map.w * y + x] = tile;
-	map.r[map.w * y + x] = room;
+	ctx->map.m[ctx->map.w * y + x] = tile;
+	ctx->map.r[ctx->map.w * y + x] = room;
 }
 
-unsigned char mapgen_get_tile(int x, int y)
+unsigned char mapgen_get_tile(struct mapgen_context *ctx, int x, int y)
 {
 	if (x < 0)
 		return TILE_EMPTY;
 	if (y < 0)
 		return TILE_EMPTY;
-	if (x >= map.w)
+	if (x >= ctx->map.w)
 		return TILE_EMPTY;
-	if (y >= map.h)
+	if (y >= ctx->map.h)
 		return TILE_EMPTY;
 
-	return map.m[map.w * y + x];
+	return ctx->map.m[ctx->map.w * y + x];
 }
 
-int mapgen_get_room(int x, int y)
+int mapgen_get_room(struct mapgen_context *ctx, int x, int y)
 {
 	if (x < 0)
 		return -1;
 	if (y < 0)
 		return -1;
-	if (x >= map.w)
+	if (x >= ctx->map.w)
 		return -1;
-	if (y >= map.h)
+	if (y >= ctx->map.h)
 		return -1;
 
-	return map.r[map.w * y + x];
+	return ctx->map.r[ctx->map.w * y + x];
 }
 
-void mapgen_draw_room(int room_id)
+void mapgen_draw_room(struct mapgen_context *ctx, int room_id)
 {
-	int place_x = rooms[room_id].x - 1;
-  	int	place_y = rooms[room_id].y - 1;
-	int room_w = rooms[room_id].w + 1;
-	int room_h = rooms[room_id].h + 1;
+	int place_x = ctx->rooms[room_id].x - 1;
+  	int	place_y = ctx->rooms[room_id].y - 1;
+	int room_w = ctx->rooms[room_id].w + 1;
+	int room_h = ctx->rooms[room_id].h + 1;
 	int x, y, i;
 
 	// Corners
-	mapgen_put_tile(place_x, place_y, TILE_WALL, -1);
-	mapgen_put_tile(place_x + room_w, place_y, TILE_WALL, -1);
-	mapgen_put_tile(place_x, place_y + room_h, TILE_WALL, -1);
-	mapgen_put_tile(place_x + room_w, place_y + room_h, TILE_WALL, -1);
+	mapgen_put_tile(ctx, place_x, place_y, TILE_WALL, -1);
+	mapgen_put_tile(ctx, place_x + room_w, place_y, TILE_WALL, -1);
+	mapgen_put_tile(ctx, place_x, place_y + room_h, TILE_WALL, -1);
+	mapgen_put_tile(ctx, place_x + room_w, place_y + room_h, TILE_WALL, -1);
 
 	// Walls 
 	for (i = 1; i < room_w; i++) {
-		mapgen_put_tile(place_x + i, place_y + room_h, TILE_WALL, -1);
-		mapgen_put_tile(place_x + i, place_y, TILE_WALL, -1);
+		mapgen_put_tile(ctx, place_x + i, place_y + room_h, TILE_WALL, -1);
+		mapgen_put_tile(ctx, place_x + i, place_y, TILE_WALL, -1);
 	}
 	for (i = 1; i < room_h; i++) {
-		mapgen_put_tile(place_x + room_w, place_y + i, TILE_WALL, -1);
-		mapgen_put_tile(place_x, place_y + i, TILE_WALL, -1);
+		mapgen_put_tile(ctx, place_x + room_w, place_y + i, TILE_WALL, -1);
+		mapgen_put_tile(ctx, place_x, place_y + i, TILE_WALL, -1);
 	}
 
 	// Floor 
 	for (y = 1; y < room_h; y++)
 		for (x = 1; x < room_w; x++)
-			mapgen_put_tile(place_x + x, place_y + y, TILE_FLOOR, room_id);
+			mapgen_put_tile(ctx, place_x + x, place_y + y, TILE_FLOOR, room_id);
 }
 
 // Check if the given cell is suitable for connections. Condition of success is that 
 // the current cell as well as 'offset' adjacent cells are free.
-static int SuitableConnection(int x, int y, enum connection_type t, int offset)
+static int SuitableConnection(struct mapgen_context *ctx, int x, int y, enum connection_type t, int offset)
 {
 	int i;
 	const int dx[] = { -1, 1,  0, 0};
 	const int dy[] = {  0, 0, -1, 1};
-	if (mapgen_get_room(x, y) == -1)
+	if (mapgen_get_room(ctx, x, y) == -1)
 		return 0;
 	for (i = -offset; i <= offset; i++) {
-		if (mapgen_get_tile(x + i * dx[t], y + i * dy[t]) != TILE_FLOOR)
+		if (mapgen_get_tile(ctx, x + i * dx[t], y + i * dy[t]) != TILE_FLOOR)
 			return 0;
 	}
 	return 1;
@@ -676,44 +720,44 @@ static int SuitableConnection(int x, int y, enum connection_type t, int offset)
   Fill out the struct cplist_t array and return the number of possible
   connections.
   */
-int find_connection_points(int room_id, struct cplist_t cplist[100], int offset)
+int find_connection_points(struct mapgen_context *ctx, int room_id, struct cplist_t cplist[100], int offset)
 {
 	// Find connection points
 	int connect_points = 0;
 	int i;
 
-	struct roominfo *r = &rooms[room_id];
+	struct roominfo *r = &ctx->rooms[room_id];
 
 	for (i = offset; i < r->w - offset; i++) {
-		if (SuitableConnection(r->x + i, r->y - 2, UP, offset)) {
+		if (SuitableConnection(ctx, r->x + i, r->y - 2, UP, offset)) {
 			cplist[connect_points].x = r->x + i;
 			cplist[connect_points].y = r->y - 1;
-			cplist[connect_points].r = mapgen_get_room(r->x + i, r->y - 2);
+			cplist[connect_points].r = mapgen_get_room(ctx, r->x + i, r->y - 2);
 			cplist[connect_points].t = UP;
 			connect_points++;
 		}
 
-		if (SuitableConnection(r->x + i, r->y + r->h + 1, DOWN, offset)) {
+		if (SuitableConnection(ctx, r->x + i, r->y + r->h + 1, DOWN, offset)) {
 			cplist[connect_points].x = r->x + i;
 			cplist[connect_points].y = r->y + r->h;
-			cplist[connect_points].r = mapgen_get_room(r->x + i, r->y + r->h + 1);
+			cplist[connect_points].r = mapgen_get_room(ctx, r->x + i, r->y + r->h + 1);
 			cplist[connect_points].t = DOWN;
 			connect_points++;
 		}
 	}
 	for (i = offset; i < r->h - offset; i++) {
-		if (SuitableConnection(r->x - 2, r->y + i, LEFT, offset)) {
+		if (SuitableConnection(ctx, r->x - 2, r->y + i, LEFT, offset)) {
 			cplist[connect_points].x = r->x - 1;
 			cplist[connect_points].y = r->y + i;
-			cplist[connect_points].r = mapgen_get_room(r->x - 2, r->y + i);
+			cplist[connect_points].r = mapgen_get_room(ctx, r->x - 2, r->y + i);
 			cplist[connect_points].t = LEFT;
 			connect_points++;
 		}
 
-		if (SuitableConnection(r->x + r->w + 1, r->y + i, RIGHT, offset)) {
+		if (SuitableConnection(ctx, r->x + r->w + 1, r->y + i, RIGHT, offset)) {
 			cplist[connect_points].x = r->x + r->w;
 			cplist[connect_points].y = r->y + i;
-			cplist[connect_points].r = mapgen_get_room(r->x + r->w + 1, r->y + i);
+			cplist[connect_points].r = mapgen_get_room(ctx, r->x + r->w + 1, r->y + i);
 			cplist[connect_points].t = RIGHT;
 			connect_points++;
 		}
@@ -722,7 +766,7 @@ int find_connection_points(int room_id, struct cplist_t cplist[100], int offset)
 	return connect_points;
 }
 
-static void recursive_browse(int at, int parent, unsigned char *seen)
+static void recursive_browse(struct mapgen_context *ctx, int at, int parent, unsigned char *seen)
 {
 	int i;
 
@@ -732,23 +776,23 @@ static void recursive_browse(int at, int parent, unsigned char *seen)
 
 	seen[at] = 1;
 
-	for (i = 0; i < rooms[at].num_neighbors; i++) {
+	for (i = 0; i < ctx->rooms[at].num_neighbors; i++) {
 		// Don't recurse into our parent
-		if (rooms[at].neighbors[i] == parent)
+		if (ctx->rooms[at].neighbors[i] == parent)
 			continue;
 
-		recursive_browse(rooms[at].neighbors[i], at, seen);
+		recursive_browse(ctx, ctx->rooms[at].neighbors[i], at, seen);
 	}
 }
 
-int mapgen_is_connected(unsigned char *seen)
+int mapgen_is_connected(struct mapgen_context *ctx, unsigned char *seen)
 {
 	int i;
-	memset(seen, 0, total_rooms);
+	memset(seen, 0, ctx->total_rooms);
 
-	recursive_browse(0, 0, seen);
+	recursive_browse(ctx, 0, 0, seen);
 
-	for (i = 0; i < total_rooms; i++) {
+	for (i = 0; i < ctx->total_rooms; i++) {
 		if (seen[i] == 0) {
 			return 0;
 		}
@@ -757,10 +801,10 @@ int mapgen_is_connected(unsigned char *seen)
 	return 1;
 }
 
-int mapgen_are_connected(int room1, int room2)
+int mapgen_are_connected(struct mapgen_context *ctx, int room1, int room2)
 {
 	int i;
-	struct roominfo *r1 = &rooms[room1];
+	struct roominfo *r1 = &ctx->rooms[room1];
 
 	for (i = 0; i < r1->num_neighbors; i++) {
 		if (r1->neighbors[i] == room2)
@@ -770,18 +814,18 @@ int mapgen_are_connected(int room1, int room2)
 	return 0;
 }
 
-void mapgen_add_door(int x, int y, int from, int to)
+void mapgen_add_door(struct mapgen_context *ctx, int x, int y, int from, int to)
 {
-	int num = rooms[from].num_doors;
+	int num = ctx->rooms[from].num_doors;
 	if (num == MAX_DOORS) {
 			error_message(__FUNCTION__, "Maximal number of doors for a room exceeded", PLEASE_INFORM | IS_FATAL);
 			return;
 	}
-	rooms[from].doors[num].x = x;
-	rooms[from].doors[num].y = y;
-	rooms[from].doors[num].room = to;
-	rooms[from].doors[num].internal = 0;
-	rooms[from].num_doors++;
+	ctx->rooms[from].doors[num].x = x;
+	ctx->rooms[from].doors[num].y = y;
+	ctx->rooms[from].doors[num].room = to;
+	ctx->rooms[from].doors[num].internal = 0;
+	ctx->rooms[from].num_doors++;
 }
 
 static void add_neighbor(struct roominfo *r, int neigh)
@@ -798,7 +842,7 @@ static void add_neighbor(struct roominfo *r, int neigh)
 	r->neighbors[newid] = neigh;
 }
 
-void MakeConnect(int x, int y, enum connection_type type)
+void MakeConnect(struct mapgen_context *ctx, int x, int y, enum connection_type type)
 {
 	const int shift = 2;
 	int wp_x, wp_y, wp_nx, wp_ny;
@@ -830,11 +874,11 @@ void MakeConnect(int x, int y, enum connection_type type)
 
 	} 
 
-	room_1 = mapgen_get_room(wp_nx, wp_ny);
-	room_2 = mapgen_get_room(wp_x, wp_y);
-	mapgen_add_door(x, y, room_2, room_1);
-	add_neighbor(&rooms[room_1], room_2);
-	add_neighbor(&rooms[room_2], room_1);
+	room_1 = mapgen_get_room(ctx, wp_nx, wp_ny);
+	room_2 = mapgen_get_room(ctx, wp_x, wp_y);
+	mapgen_add_door(ctx, x, y, room_2, room_1);
+	add_neighbor(&ctx->rooms[room_1], room_2);
+	add_neighbor(&ctx->rooms[room_2], room_1);
 
 	// Make waypoint correction according to pending
 	if (type == UP || type == DOWN) {
@@ -844,20 +888,20 @@ void MakeConnect(int x, int y, enum connection_type type)
 		wp_y -= shift;
 		wp_ny -= shift;
 	}
-	int wp1 = add_waypoint(target_level, wp_x, wp_y, 0);
-	int wp2 = add_waypoint(target_level, wp_nx, wp_ny, 0);
+	int wp1 = add_waypoint(ctx->target_level, wp_x, wp_y, 0);
+	int wp2 = add_waypoint(ctx->target_level, wp_nx, wp_ny, 0);
 
-	action_toggle_waypoint_connection(target_level, wp1, wp2, 0, 0);
-	action_toggle_waypoint_connection(target_level, wp2, wp1, 0, 0);
+	action_toggle_waypoint_connection(ctx->target_level, wp1, wp2, 0, 0);
+	action_toggle_waypoint_connection(ctx->target_level, wp2, wp1, 0, 0);
 }
 
-static int find_waypoints(int x1, int y1, int x2, int y2, int *wps, int max)
+static int find_waypoints(struct mapgen_context *ctx, int x1, int y1, int x2, int y2, int *wps, int max)
 {
-	waypoint *wpts = target_level->waypoints.arr;
+	waypoint *wpts = ctx->target_level->waypoints.arr;
 	int total_wps = 0;
 	int i;
 
-	for (i = 0; i < target_level->waypoints.size; i++) {
+	for (i = 0; i < ctx->target_level->waypoints.size; i++) {
 		if (wpts[i].x >= x1 && wpts[i].x < x2 && wpts[i].y >= y1 && wpts[i].y < y2) {
 			wps[total_wps] = i;
 			total_wps++;
@@ -870,13 +914,13 @@ static int find_waypoints(int x1, int y1, int x2, int y2, int *wps, int max)
 	return total_wps;
 }
 
-static void connect_waypoints()
+static void connect_waypoints(struct mapgen_context *ctx)
 {
 	int rn;
 
-	for (rn = 0; rn < total_rooms; rn++) {
+	for (rn = 0; rn < ctx->total_rooms; rn++) {
 		int wps[25];
-		int max_wps = find_waypoints(rooms[rn].x - 1, rooms[rn].y - 1, rooms[rn].x + rooms[rn].w + 1, rooms[rn].y + rooms[rn].h + 1, wps, 25);
+		int max_wps = find_waypoints(ctx, ctx->rooms[rn].x - 1, ctx->rooms[rn].y - 1, ctx->rooms[rn].x + ctx->rooms[rn].w + 1, ctx->rooms[rn].y + ctx->rooms[rn].h + 1, wps, 25);
 		int nbconn = max_wps;
 
 		if (max_wps == 1 || max_wps == 0)
@@ -884,38 +928,66 @@ static void connect_waypoints()
 
 		while (nbconn--) {
 			int wp1 = nbconn;
-			int wp2 = rand() % max_wps;
+			int wp2 = mapgen_rand(ctx) % max_wps;
 
 			while (wp2 == wp1)
-				wp2 = rand() % max_wps;
+				wp2 = mapgen_rand(ctx) % max_wps;
 
 			if (wp1 != wp2) {
-				action_toggle_waypoint_connection(target_level, wps[wp1], wps[wp2], 0, 0);
-				action_toggle_waypoint_connection(target_level, wps[wp2], wps[wp1], 0, 0);
+				action_toggle_waypoint_connection(ctx->target_level, wps[wp1], wps[wp2], 0, 0);
+				action_toggle_waypoint_connection(ctx->target_level, wps[wp2], wps[wp1], 0, 0);
 			}
 		}
 	}
 }
 
-static void place_waypoints()
+// Check that the center of a tile is walkable, with a margin of 0.8 around the
+// obstacles. This is SinglePointColldet() with WalkablePassFilterCallback, but
+// restricted to the level being generated: the level is not yet part of the
+// ship, and the collision detection's timestamps can not be shared between
+// several generations.
+static int waypoint_position_is_free(struct mapgen_context *ctx, int x, int y)
+{
+	const float margin = 0.8;
+	level *lvl = ctx->target_level;
+	float px = x + 0.5;
+	float py = y + 0.5;
+	int i;
+
+	for (i = 0; i < lvl->map[y][x].glued_obstacles.size; i++) {
+		int obstacle_index = ((int *)lvl->map[y][x].glued_obstacles.arr)[i];
+		obstacle *obs = &ACCESS_OBSTACLE(lvl, obstacle_index);
+		obstacle_spec *spec = get_obstacle_spec(obs->type);
+
+		if (spec->block_area_type == COLLISION_TYPE_NONE || (spec->flags & IS_WALKABLE))
+			continue;
+
+		if (px >= obs->pos.x + spec->left_border - margin && px <= obs->pos.x + spec->right_border + margin &&
+		    py >= obs->pos.y + spec->upper_border - margin && py <= obs->pos.y + spec->lower_border + margin)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+static void place_waypoints(struct mapgen_context *ctx)
 {
 	int rn;
 
-	for (rn = 0; rn < total_rooms; rn++) {
-		int func = sqrt(rooms[rn].w * rooms[rn].h);
+	for (rn = 0; rn < ctx->total_rooms; rn++) {
+		int func = sqrt(ctx->rooms[rn].w * ctx->rooms[rn].h);
 
 		int nb = -1 + func / 3;
 
 		int retries = 15;
 
 		while ((nb--) > 0) {
-			int newx = rooms[rn].x;
-			int newy = rooms[rn].y;
-			newx += MyRandom(rooms[rn].w - 1);
-			newy += MyRandom(rooms[rn].h - 1);
+			int newx = ctx->rooms[rn].x;
+			int newy = ctx->rooms[rn].y;
+			newx += mapgen_random(ctx, ctx->rooms[rn].w - 1);
+			newy += mapgen_random(ctx, ctx->rooms[rn].h - 1);
 
-			colldet_filter my_filter = { WalkablePassFilterCallback, NULL, 0.8, NULL };
-			if (!SinglePointColldet(newx + 0.5, newy + 0.5, target_level->levelnum, &my_filter)) {
+			if (!waypoint_position_is_free(ctx, newx, newy)) {
 				// If the randomly chosen position is not passable, retry... a certain number of times before giving up.
 				if (retries-- > 0) {
 					nb++;
@@ -923,7 +995,7 @@ static void place_waypoints()
 				continue;
 			}
 
-			add_waypoint(target_level, newx, newy, 0);
+			add_waypoint(ctx->target_level, newx, newy, 0);
 		}
 	}
 }
@@ -931,12 +1003,13 @@ static void place_waypoints()
 // The function computes eccentricity for each room and picks the one
 // with the minimal eccentricity as the center. Also it fills 'distance'
 // array with the distances from the 'entrance' in terms of rooms.
-static int get_middle_room(int entrance, int *distance)
+static int get_middle_room(struct mapgen_context *ctx, int entrance, int *distance)
 {
+	int total_rooms = ctx->total_rooms;
 #ifdef __clang_analyzer__
 	// Avoid Clang Static Analyser to report a possible OOB access
 	// on dist[][] and eccentricity[]
-#define total_rooms 10
+	total_rooms = 10;
 #endif
 
 	int i, j, k;
@@ -954,8 +1027,8 @@ static int get_middle_room(int entrance, int *distance)
 	}
 	for (i = 0; i < total_rooms; i++) {
 		// Distance from a room to its neighbors is 1
-		for (j = 0; j < rooms[i].num_neighbors; j++)
-			dist[i][rooms[i].neighbors[j]] = 1;
+		for (j = 0; j < ctx->rooms[i].num_neighbors; j++)
+			dist[i][ctx->rooms[i].neighbors[j]] = 1;
 	}
 	// Calculate distance for each pair of rooms
 	for (k = 0; k < total_rooms; k++) {
@@ -984,56 +1057,200 @@ static int get_middle_room(int entrance, int *distance)
 	return m;
 }
 
-int generate_dungeon(int w, int h, int nbconnec, int tpair)
+/**
+ * Generate a random dungeon on a level.
+ *
+ * \param lvl   The level to fill in. Its size, number of connections and
+ *              teleport pair define the dungeon.
+ * \param seed  Seed of the generation. The same seed, level number and teleport
+ *              pair always produce the same dungeon.
+ */
+int generate_dungeon(level *lvl, unsigned int seed)
 {
 	int i, j;
 	struct dungeon_info di;
+	struct mapgen_context context = { .target_level = lvl };
+	struct mapgen_context *ctx = &context;
+	int w = lvl->xlen;
+	int h = lvl->ylen;
+	int nbconnec = lvl->random_dungeon;
+	int tpair = lvl->teleport_pair;
 
-	new_level(w, h);
+	mapgen_seed(ctx, seed, lvl->levelnum, tpair);
 
-	generate_dungeon_gram(w, h);
+	new_level(ctx, w, h);
+
+	generate_dungeon_gram(ctx, w, h);
 
 	// Select entrance at random.
-	int dist[total_rooms];
-	int vis[total_rooms];
-	int entrance = rand() % total_rooms;
-	int mid_room = get_middle_room(entrance, dist);
+	int dist[ctx->total_rooms];
+	int vis[ctx->total_rooms];
+	int entrance = mapgen_rand(ctx) % ctx->total_rooms;
+	int mid_room = get_middle_room(ctx, entrance, dist);
 
-	mapgen_entry_at(&rooms[entrance], tpair);
+	mapgen_entry_at(ctx, &ctx->rooms[entrance], tpair);
 
-	memset(vis, 0, sizeof(int) * total_rooms);
+	memset(vis, 0, sizeof(int) * ctx->total_rooms);
 	// Choose N farthest rooms and place exits there
 	int max_idx = 0;
 	for (i = 0; i < nbconnec - 1; i++) {
 		int max = dist[0];
 		max_idx = 0;
-		for (j = 1; j < total_rooms; j++) {
+		for (j = 1; j < ctx->total_rooms; j++) {
 			if (dist[j] > max && !vis[j]) {
 				max = dist[j];
 				max_idx = j;
 			}
 		}
-		mapgen_exit_at(&rooms[max_idx], tpair);
+		mapgen_exit_at(ctx, &ctx->rooms[max_idx], tpair);
 		vis[max_idx] = 1;
 	}
 
 	di.enter = entrance;
 	di.exit = max_idx;
 	di.middle_room = mid_room;
-	di.num_rooms = total_rooms;
+	di.num_rooms = ctx->total_rooms;
 	di.distance = dist;
-	mapgen_convert(&di, w, h, map.m);
+	mapgen_convert(ctx, &di, w, h, ctx->map.m);
 
 	// Place random waypoints
-	place_waypoints();
+	place_waypoints(ctx);
 
 	// Connect waypoints
-	connect_waypoints();
+	connect_waypoints(ctx);
 
-	free_level();
+	free_level(ctx);
 	return 0;
 }
 
+/*
+ * Work shared by the threads of generate_dungeons() and
+ * generate_dungeons_in_background()
+ */
+static struct {
+	level **levels;
+	int nb_levels;
+	int next;
+	unsigned int seed;
+	SDL_mutex *lock;
+	SDL_Thread *threads[MAPGEN_MAX_THREADS];
+	int nb_threads;
+} dungeon_jobs;
+
+static int dungeon_worker(void *data)
+{
+	while (1) {
+		SDL_LockMutex(dungeon_jobs.lock);
+		int job = dungeon_jobs.next++;
+		SDL_UnlockMutex(dungeon_jobs.lock);
+
+		if (job >= dungeon_jobs.nb_levels)
+			break;
+
+		generate_dungeon(dungeon_jobs.levels[job], dungeon_jobs.seed);
+	}
+
+	return 0;
+}
+
+static int dungeon_worker_count(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+	long nb_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nb_cpus > 0)
+		return min(nb_cpus, MAPGEN_MAX_THREADS);
+#endif
+	return 2;
+}
+
+static void start_dungeon_jobs(level **levels, int nb_levels, unsigned int seed, int nb_threads)
+{
+	int i;
+
+	dungeon_jobs.levels = MyMalloc(nb_levels * sizeof(level *));
+	memcpy(dungeon_jobs.levels, levels, nb_levels * sizeof(level *));
+	dungeon_jobs.nb_levels = nb_levels;
+	dungeon_jobs.next = 0;
+	dungeon_jobs.seed = seed;
+	dungeon_jobs.lock = SDL_CreateMutex();
+
+	dungeon_jobs.nb_threads = 0;
+	for (i = 0; i < nb_threads; i++) {
+		SDL_Thread *thread = SDL_CreateThread(dungeon_worker, NULL);
+		if (thread)
+			dungeon_jobs.threads[dungeon_jobs.nb_threads++] = thread;
+	}
+}
+
+/**
+ * Wait for the end of the generation started by
+ * generate_dungeons_in_background(). Does nothing if no generation is
+ * running.
+ */
+void wait_for_dungeons(void)
+{
+	int i;
+
+	if (!dungeon_jobs.levels)
+		return;
+
+	// If no thread could be started, the levels are generated here
+	if (!dungeon_jobs.nb_threads)
+		dungeon_worker(NULL);
+
+	for (i = 0; i < dungeon_jobs.nb_threads; i++)
+		SDL_WaitThread(dungeon_jobs.threads[i], NULL);
+	dungeon_jobs.nb_threads = 0;
+
+	SDL_DestroyMutex(dungeon_jobs.lock);
+	dungeon_jobs.lock = NULL;
+	free(dungeon_jobs.levels);
+	dungeon_jobs.levels = NULL;
+}
+
+/**
+ * Generate several random dungeons at the same time, on a pool of threads.
+ * The result does not depend on the number of threads: each level is
+ * generated as by generate_dungeon() with the given seed.
+ *
+ * \param levels     Levels to fill in. They must all be different.
+ * \param nb_levels  Number of levels.
+ * \param seed       Seed of the generation.
+ */
+void generate_dungeons(level **levels, int nb_levels, unsigned int seed)
+{
+	int nb_threads = min(dungeon_worker_count(), nb_levels);
+	int i;
+
+	wait_for_dungeons();
+
+	if (nb_threads <= 1) {
+		for (i = 0; i < nb_levels; i++)
+			generate_dungeon(levels[i], seed);
+		return;
+	}
+
+	// The calling thread is one of the workers
+	start_dungeon_jobs(levels, nb_levels, seed, nb_threads - 1);
+	dungeon_worker(NULL);
+	wait_for_dungeons();
+}
+
+/**
+ * Same as generate_dungeons(), but return at once and let the pool of
+ * threads work while the caller goes on. The levels must not be used
+ * before wait_for_dungeons() is called.
+ */
+void generate_dungeons_in_background(level **levels, int nb_levels, unsigned int seed)
+{
+	wait_for_dungeons();
+
+	if (nb_levels <= 0)
+		return;
+
+	start_dungeon_jobs(levels, nb_levels, seed, min(dungeon_worker_count(), nb_levels));
+}
+
 const char * mapgen_teleport_pair_str(int idx)
 {
 	const char *teleport_pair_str[] = {
@@ -3,6 +3,9 @@
 
 #define 	MAX_DOORS	4
 
+// Maximum number of threads used to generate several dungeons
+#define		MAPGEN_MAX_THREADS	8
+
 enum TILES {
 	TILE_WALL,
 	TILE_EMPTY,
@@ -60,33 +63,55 @@ struct dungeon_info {
 	int *distance;
 };
 
-extern struct roominfo *rooms;
-extern int total_rooms;
+/**
+ * State of the generation of one dungeon.
+ * Each generation has its own context and its own pseudo-random number
+ * generator, so that several dungeons can be generated at the same time and
+ * that a given seed always produces the same dungeon.
+ */
+struct mapgen_context {
+	struct mapgen_gamelevel map;
+	level *target_level;
+
+	struct roominfo *rooms;
+	int total_rooms;
+	int max_rooms;
+
+	// Dimensions of the dungeon, used when cutting rooms
+	int dim_x_init;
+	int dim_y_init;
+
+	uint32_t rand_state;
+};
+
+#define		MAPGEN_RAND_MAX		0x7fffffff
 
 // Interface to the game
 void (*dungeonmap_convert) (int, int, unsigned char *);
 void (*dungeonmap_place_enemies) (struct roominfo *);
 void (*dungeonmap_gift) (struct roominfo *);
 
-int generate_dungeon_gram(int, int);
-
-int mapgen_add_room(int, int, int, int);
-void mapgen_put_tile(int, int, unsigned char, int);
-unsigned char mapgen_get_tile(int x, int y);
-int mapgen_get_room(int x, int y);
-void mapgen_draw_room(int room_id);
-int mapgen_are_connected(int, int);
-int mapgen_is_connected(unsigned char *);
-void mapgen_add_obstacle(double x, double y, int type);
-void mapgen_set_floor(int x, int y, int type);
-void mapgen_gift(struct roominfo *r);
-void mapgen_add_door(int, int, int, int);
+int generate_dungeon_gram(struct mapgen_context *, int, int);
+
+int mapgen_add_room(struct mapgen_context *, int, int, int, int);
+void mapgen_put_tile(struct mapgen_context *, int, int, unsigned char, int);
+unsigned char mapgen_get_tile(struct mapgen_context *ctx, int x, int y);
+int mapgen_get_room(struct mapgen_context *ctx, int x, int y);
+void mapgen_draw_room(struct mapgen_context *ctx, int room_id);
+int mapgen_are_connected(struct mapgen_context *, int, int);
+int mapgen_is_connected(struct mapgen_context *, unsigned char *);
+void mapgen_add_obstacle(struct mapgen_context *ctx, double x, double y, int type);
+void mapgen_set_floor(struct mapgen_context *ctx, int x, int y, int type);
+void mapgen_gift(struct mapgen_context *ctx, struct roominfo *r);
+void mapgen_add_door(struct mapgen_context *, int, int, int, int);
+int mapgen_rand(struct mapgen_context *);
+int mapgen_random(struct mapgen_context *, int);
 unsigned int mapgen_cycle_teleport_pair(unsigned int);
 const char * mapgen_teleport_pair_str(int);
 
-int find_connection_points(int room_id, struct cplist_t cplist[100], int offset);
+int find_connection_points(struct mapgen_context *ctx, int room_id, struct cplist_t cplist[100], int offset);
 
-void MakeConnect(int x, int y, enum connection_type type);
+void MakeConnect(struct mapgen_context *ctx, int x, int y, enum connection_type type);
 
 
 #endif
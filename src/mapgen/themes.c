@@ -30,16 +30,16 @@
 #include "mapgen/mapgen.h"
 #include "mapgen/themes.h"
 
-#define RAND_THEME(t)	t[MyRandom(sizeof(t) / sizeof(t[0]) - 1)]
+#define RAND_THEME(t)	t[mapgen_random(ctx, sizeof(t) / sizeof(t[0]) - 1)]
 #define OBSTACLE_DIM_X(x)	ceil(get_obstacle_spec(x)->right_border - get_obstacle_spec(x)->left_border)
 #define OBSTACLE_DIM_Y(x)	ceil(get_obstacle_spec(x)->lower_border - get_obstacle_spec(x)->upper_border)
 
-static void apply_default_theme(int, int, int);
-static void apply_metal_theme(int, int, int);
-static void apply_glass_theme(int, int, int);
-static void apply_red_theme(int, int, int);
-static void apply_green_theme(int, int, int);
-static void apply_flower_theme(int, int, int);
+static void apply_default_theme(struct mapgen_context *, int, int, int);
+static void apply_metal_theme(struct mapgen_context *, int, int, int);
+static void apply_glass_theme(struct mapgen_context *, int, int, int);
+static void apply_red_theme(struct mapgen_context *, int, int, int);
+static void apply_green_theme(struct mapgen_context *, int, int, int);
+static void apply_flower_theme(struct mapgen_context *, int, int, int);
 
 const struct theme_info theme_data[] = {
 	{ ISO_V_WALL, ISO_H_WALL, ISO_V_WALL, ISO_H_WALL, ISO_GREY_WALL_END_N, ISO_GREY_WALL_END_W },
@@ -57,7 +57,7 @@ const struct theme_info theme_data[] = {
 	},
 };
 
-typedef void (*theme_proc)(int, int, int);
+typedef void (*theme_proc)(struct mapgen_context *, int, int, int);
 const theme_proc themes[] = {
 	apply_default_theme,
 	apply_metal_theme,
@@ -80,34 +80,34 @@ const enum theme basic_themes[] = {
 const enum theme living_themes[]		= { THEME_RED, THEME_GREEN, THEME_FLOWER };
 const enum theme industrial_themes[]	= { THEME_METAL, THEME_GRAY };
 
-static int set_generic_wall(int x, int y, int wall, int theme)
+static int set_generic_wall(struct mapgen_context *ctx, int x, int y, int wall, int theme)
 {
 	// A value '1' of 'processed' means that data was processed, otherwise
 	// the caller should process them itself.
 	int processed = 1;
-	int room = mapgen_get_room(x, y);
-	int period = room != -1 ? rooms[room].period : 0;
+	int room = mapgen_get_room(ctx, x, y);
+	int period = room != -1 ? ctx->rooms[room].period : 0;
 	if (wall & WALL_PART) {
 		if (wall & WALL_N) {
 			int obs_type = theme_data[theme].wall_n;
 			if (period && !(x % period))
 				obs_type = theme_data[theme].window_wall_h;
-			mapgen_add_obstacle(x + 0.5, y, obs_type);
+			mapgen_add_obstacle(ctx, x + 0.5, y, obs_type);
 		} else if (wall & WALL_S) {
 			int obs_type = theme_data[theme].wall_n;
 			if (period && !(x % period))
 				obs_type = theme_data[theme].window_wall_h;
-			mapgen_add_obstacle(x + 0.5, y + 1, obs_type);
+			mapgen_add_obstacle(ctx, x + 0.5, y + 1, obs_type);
 		} else if (wall & WALL_W) {
 			int obs_type = theme_data[theme].wall_w;
 			if (period && !(y % period))
 				obs_type = theme_data[theme].window_wall_v;
-			mapgen_add_obstacle(x, y + 0.5, obs_type);
+			mapgen_add_obstacle(ctx, x, y + 0.5, obs_type);
 		} else if (wall & WALL_E) {
 			int obs_type = theme_data[theme].wall_w;
 			if (period && !(y % period))
 				obs_type = theme_data[theme].window_wall_v;
-			mapgen_add_obstacle(x + 1, y + 0.5, obs_type);
+			mapgen_add_obstacle(ctx, x + 1, y + 0.5, obs_type);
 		} else {
 			processed = 0;
 		}
@@ -116,16 +116,16 @@ static int set_generic_wall(int x, int y, int wall, int theme)
 			case 0:
 				break;
 			case WALL_N:
-				mapgen_add_obstacle(x + 0.5, y, theme_data[theme].wall_n);
+				mapgen_add_obstacle(ctx, x + 0.5, y, theme_data[theme].wall_n);
 				break;
 			case WALL_S:
-				mapgen_add_obstacle(x + 0.5, y + 1, theme_data[theme].wall_s);
+				mapgen_add_obstacle(ctx, x + 0.5, y + 1, theme_data[theme].wall_s);
 				break;
 			case WALL_W:
-				mapgen_add_obstacle(x, y + 0.5, theme_data[theme].wall_w);
+				mapgen_add_obstacle(ctx, x, y + 0.5, theme_data[theme].wall_w);
 				break;
 			case WALL_E:
-				mapgen_add_obstacle(x + 1, y + 0.5, theme_data[theme].wall_e);
+				mapgen_add_obstacle(ctx, x + 1, y + 0.5, theme_data[theme].wall_e);
 				break;
 			default:
 				processed = 0;
@@ -135,70 +135,70 @@ static int set_generic_wall(int x, int y, int wall, int theme)
 	return processed;
 }
 
-static void set_simple_wall(int x, int y, int wall, int theme)
+static void set_simple_wall(struct mapgen_context *ctx, int x, int y, int wall, int theme)
 {
-	if (set_generic_wall(x, y, wall, theme)) return;
+	if (set_generic_wall(ctx, x, y, wall, theme)) return;
 	switch (wall) {
 		case WALL_NW:
-			mapgen_add_obstacle(x + 0.5, y, theme_data[theme].wall_n);
-			mapgen_add_obstacle(x, y + 0.5, theme_data[theme].wall_w);
+			mapgen_add_obstacle(ctx, x + 0.5, y, theme_data[theme].wall_n);
+			mapgen_add_obstacle(ctx, x, y + 0.5, theme_data[theme].wall_w);
 			break;
 		case WALL_NE:
-			mapgen_add_obstacle(x + 0.5, y, theme_data[theme].wall_n);
-			mapgen_add_obstacle(x + 1, y + 0.5, theme_data[theme].wall_e);
+			mapgen_add_obstacle(ctx, x + 0.5, y, theme_data[theme].wall_n);
+			mapgen_add_obstacle(ctx, x + 1, y + 0.5, theme_data[theme].wall_e);
 			break;
 		case WALL_SW:
-			mapgen_add_obstacle(x + 0.5, y + 1, theme_data[theme].wall_s);
-			mapgen_add_obstacle(x, y + 0.5, theme_data[theme].wall_w);
+			mapgen_add_obstacle(ctx, x + 0.5, y + 1, theme_data[theme].wall_s);
+			mapgen_add_obstacle(ctx, x, y + 0.5, theme_data[theme].wall_w);
 			break;
 		case WALL_SE:
-			mapgen_add_obstacle(x + 0.5, y + 1, theme_data[theme].wall_s);
-			mapgen_add_obstacle(x + 1, y + 0.5, theme_data[theme].wall_e);
+			mapgen_add_obstacle(ctx, x + 0.5, y + 1, theme_data[theme].wall_s);
+			mapgen_add_obstacle(ctx, x + 1, y + 0.5, theme_data[theme].wall_e);
 			break;
 	}
 }
 
-static void apply_default_theme(int x, int y, int object)
+static void apply_default_theme(struct mapgen_context *ctx, int x, int y, int object)
 {
-	set_simple_wall(x, y, object, THEME_METAL);
-	mapgen_set_floor(x, y, ISO_FLOOR_ERROR_TILE);
+	set_simple_wall(ctx, x, y, object, THEME_METAL);
+	mapgen_set_floor(ctx, x, y, ISO_FLOOR_ERROR_TILE);
 }
 
-static void apply_metal_theme(int x, int y, int object)
+static void apply_metal_theme(struct mapgen_context *ctx, int x, int y, int object)
 {
-	set_simple_wall(x, y, object, THEME_GRAY);
-	mapgen_set_floor(x, y, ISO_FLOOR_STONE_FLOOR);
+	set_simple_wall(ctx, x, y, object, THEME_GRAY);
+	mapgen_set_floor(ctx, x, y, ISO_FLOOR_STONE_FLOOR);
 }
 
-static void apply_glass_theme(int x, int y, int object)
+static void apply_glass_theme(struct mapgen_context *ctx, int x, int y, int object)
 {
-	int theme = object == WALL_W && MyRandom(100) < 15 ? THEME_BROKEN_GLASS : THEME_GLASS;
-	set_simple_wall(x, y, object, theme);
-	mapgen_set_floor(x, y, ISO_MINI_SQUARE_0003);
+	int theme = object == WALL_W && mapgen_random(ctx, 100) < 15 ? THEME_BROKEN_GLASS : THEME_GLASS;
+	set_simple_wall(ctx, x, y, object, theme);
+	mapgen_set_floor(ctx, x, y, ISO_MINI_SQUARE_0003);
 }
 
-static void apply_red_theme(int x, int y, int object)
+static void apply_red_theme(struct mapgen_context *ctx, int x, int y, int object)
 {
-	set_simple_wall(x, y, object, THEME_RED);
-	mapgen_set_floor(x, y, ISO_CARPET_TILE_0004);
+	set_simple_wall(ctx, x, y, object, THEME_RED);
+	mapgen_set_floor(ctx, x, y, ISO_CARPET_TILE_0004);
 } 
 
-static void apply_green_theme(int x, int y, int object)
+static void apply_green_theme(struct mapgen_context *ctx, int x, int y, int object)
 {
-	set_simple_wall(x, y, object, THEME_GREEN);
-	mapgen_set_floor(x, y, ISO_CARPET_TILE_0002);
+	set_simple_wall(ctx, x, y, object, THEME_GREEN);
+	mapgen_set_floor(ctx, x, y, ISO_CARPET_TILE_0002);
 } 
 
-static void apply_flower_theme(int x, int y, int object)
+static void apply_flower_theme(struct mapgen_context *ctx, int x, int y, int object)
 {
-	set_simple_wall(x, y, object, THEME_FLOWER);
-	mapgen_set_floor(x, y, ISO_CARPET_TILE_0002);
+	set_simple_wall(ctx, x, y, object, THEME_FLOWER);
+	mapgen_set_floor(ctx, x, y, ISO_CARPET_TILE_0002);
 }
 
-static void fill_armory(int r)
+static void fill_armory(struct mapgen_context *ctx, int r)
 {
 	int x, y;
-	struct roominfo	*room = &rooms[r];
+	struct roominfo	*room = &ctx->rooms[r];
 
 #define ARMORY_PROB		90
 
@@ -206,27 +206,27 @@ static void fill_armory(int r)
 	if (room->w > room->h) {
 		for (y = 1; y < 3; y++) {
 			for (x = 1; x < room->w; x++) {
-				if (mapgen_get_tile(room->x + x, room->y - 1) == TILE_WALL && MyRandom(100) < ARMORY_PROB)
-					mapgen_add_obstacle(room->x + x, room->y + y, ISO_BARREL_1 + MyRandom(3));
-				if (mapgen_get_tile(room->x + x, room->y + room->h) == TILE_WALL && MyRandom(100) < ARMORY_PROB)
-					mapgen_add_obstacle(room->x + x, room->y + room->h - y, ISO_BARREL_1 + MyRandom(3));
+				if (mapgen_get_tile(ctx, room->x + x, room->y - 1) == TILE_WALL && mapgen_random(ctx, 100) < ARMORY_PROB)
+					mapgen_add_obstacle(ctx, room->x + x, room->y + y, ISO_BARREL_1 + mapgen_random(ctx, 3));
+				if (mapgen_get_tile(ctx, room->x + x, room->y + room->h) == TILE_WALL && mapgen_random(ctx, 100) < ARMORY_PROB)
+					mapgen_add_obstacle(ctx, room->x + x, room->y + room->h - y, ISO_BARREL_1 + mapgen_random(ctx, 3));
 			}
 		}
 	} else {
 		for (y = 1; y < room->h; y++) {
 			for (x = 1; x < 3; x++) {
-				if (mapgen_get_tile(room->x - 1, room->y + y) == TILE_WALL && MyRandom(100) < ARMORY_PROB)
-					mapgen_add_obstacle(room->x + x, room->y + y, ISO_BARREL_1 + MyRandom(3));
-				if (mapgen_get_tile(room->x + room->w, room->y + y) == TILE_WALL && MyRandom(100) < ARMORY_PROB)
-					mapgen_add_obstacle(room->x + room->w - x, room->y + y, ISO_BARREL_1 + MyRandom(3));
+				if (mapgen_get_tile(ctx, room->x - 1, room->y + y) == TILE_WALL && mapgen_random(ctx, 100) < ARMORY_PROB)
+					mapgen_add_obstacle(ctx, room->x + x, room->y + y, ISO_BARREL_1 + mapgen_random(ctx, 3));
+				if (mapgen_get_tile(ctx, room->x + room->w, room->y + y) == TILE_WALL && mapgen_random(ctx, 100) < ARMORY_PROB)
+					mapgen_add_obstacle(ctx, room->x + room->w - x, room->y + y, ISO_BARREL_1 + mapgen_random(ctx, 3));
 			}
 		}
 	}
 }
 
-static void place_library(int room)
+static void place_library(struct mapgen_context *ctx, int room)
 {
-	struct roominfo *ri = &rooms[room];
+	struct roominfo *ri = &ctx->rooms[room];
 	int x1 = ri->x;
 	int y1 = ri->y;
 	int x2 = x1 + ri->w - 1;
@@ -250,11 +250,11 @@ static void place_library(int room)
 		// Put chair at the corner
 		x += OBSTACLE_DIM_X(ISO_DESKCHAIR_3);
 		y += 0.5;
-		mapgen_add_obstacle(x, y, ISO_DESKCHAIR_3);
+		mapgen_add_obstacle(ctx, x, y, ISO_DESKCHAIR_3);
 		// Put library table near the chair
 		x = x1 + OBSTACLE_DIM_X(ISO_LIBRARY_FURNITURE_1) / 2;
 		y = y1 + OBSTACLE_DIM_Y(ISO_LIBRARY_FURNITURE_1);
-		mapgen_add_obstacle(x, y, ISO_LIBRARY_FURNITURE_1);
+		mapgen_add_obstacle(ctx, x, y, ISO_LIBRARY_FURNITURE_1);
 	} else {
 		dx = OBSTACLE_DIM_X(ISO_SHELF_FULL_H);
 		dy = OBSTACLE_DIM_Y(ISO_SHELF_FULL_H);
@@ -265,23 +265,23 @@ static void place_library(int room)
 		// Put chair at the corner
 		x += 0.5;
 		y += OBSTACLE_DIM_Y(ISO_DESKCHAIR_1);
-		mapgen_add_obstacle(x, y, ISO_DESKCHAIR_1);
+		mapgen_add_obstacle(ctx, x, y, ISO_DESKCHAIR_1);
 		// Put library table near the chair
 		x = x1 + OBSTACLE_DIM_X(ISO_LIBRARY_FURNITURE_2);
 		y = y1 + OBSTACLE_DIM_Y(ISO_LIBRARY_FURNITURE_2) / 2;
-		mapgen_add_obstacle(x, y, ISO_LIBRARY_FURNITURE_2);
+		mapgen_add_obstacle(ctx, x, y, ISO_LIBRARY_FURNITURE_2);
 	}
 
 	for (i = 1; i <= rows; i++) {
 		for (j = 1; j <= cols; j++) {
 			x = x2 - j * dx;
 			y = y2 - i * dy;
-			mapgen_add_obstacle(x, y, obj);
+			mapgen_add_obstacle(ctx, x, y, obj);
 		}
 	}
 }
 
-static void build_garden_path(struct roominfo *ri, struct doorinfo *di)
+static void build_garden_path(struct mapgen_context *ctx, struct roominfo *ri, struct doorinfo *di)
 {
 	int x1, x2, y1, y2;
 	int i, j;
@@ -313,18 +313,18 @@ static void build_garden_path(struct roominfo *ri, struct doorinfo *di)
 
 	for (i = y1; i < y2; i++) {
 		for (j = x1; j < x2; j++) {
-			mapgen_set_floor(j, i, ISO_MISCELLANEOUS_FLOOR_21);
-			mapgen_set_floor(j, i, ISO_MISCELLANEOUS_FLOOR_21);
+			mapgen_set_floor(ctx, j, i, ISO_MISCELLANEOUS_FLOOR_21);
+			mapgen_set_floor(ctx, j, i, ISO_MISCELLANEOUS_FLOOR_21);
 			// Prevent path from placing other obstacles on it
-			mapgen_put_tile(j, i, TILE_WALL, -1);
-			mapgen_put_tile(j, i, TILE_WALL, -1);
+			mapgen_put_tile(ctx, j, i, TILE_WALL, -1);
+			mapgen_put_tile(ctx, j, i, TILE_WALL, -1);
 		}
 	}
 }
 
-static void place_garden(int room)
+static void place_garden(struct mapgen_context *ctx, int room)
 {
-	struct roominfo *ri = &rooms[room];
+	struct roominfo *ri = &ctx->rooms[room];
 	int x1 = ri->x;
 	int y1 = ri->y;
 	int x2 = x1 + ri->w - 1;
@@ -334,16 +334,16 @@ static void place_garden(int room)
 
 	for (i = y1; i <= y2; i++)
 		for (j = x1; j <= x2; j++)
-			mapgen_set_floor(j, i, ISO_OVERLAY_FLOOR_SAND_WITH_GRASS_1 + MyRandom(4));
+			mapgen_set_floor(ctx, j, i, ISO_OVERLAY_FLOOR_SAND_WITH_GRASS_1 + mapgen_random(ctx, 4));
 
 	// Cycle through doors of the given room
 	for (i = 0; i < ri->num_doors; i++)
-		build_garden_path(ri, &ri->doors[i]);
+		build_garden_path(ctx, ri, &ri->doors[i]);
 	// Find the doors of other rooms that lead to the given
-	for (i = 0; i < total_rooms; i++) {
-		for (j = 0; j < rooms[i].num_doors; j++) {
-			if (rooms[i].doors[j].room == room)
-				build_garden_path(ri, &rooms[i].doors[j]);
+	for (i = 0; i < ctx->total_rooms; i++) {
+		for (j = 0; j < ctx->rooms[i].num_doors; j++) {
+			if (ctx->rooms[i].doors[j].room == room)
+				build_garden_path(ctx, ri, &ctx->rooms[i].doors[j]);
 		}
 	}
 	// Fill garden with trees
@@ -351,40 +351,40 @@ static void place_garden(int room)
 	while (num--) {
 		x1 = ri->x + 1;
 		y1 = ri->y + 1;
-		x1 += MyRandom(ri->w - 2);
-		y1 += MyRandom(ri->h - 2);
-		if (mapgen_get_tile(x1, y1) == TILE_FLOOR) {
-			mapgen_add_obstacle(x1, y1, ISO_TREE_1 + MyRandom(2));
-			mapgen_put_tile(x1, y1, TILE_WALL, -1);
+		x1 += mapgen_random(ctx, ri->w - 2);
+		y1 += mapgen_random(ctx, ri->h - 2);
+		if (mapgen_get_tile(ctx, x1, y1) == TILE_FLOOR) {
+			mapgen_add_obstacle(ctx, x1, y1, ISO_TREE_1 + mapgen_random(ctx, 2));
+			mapgen_put_tile(ctx, x1, y1, TILE_WALL, -1);
 		}
 	}
 }
 
 // Place a grid of office desks in the given room
-static int place_work_office(int room)
+static int place_work_office(struct mapgen_context *ctx, int room)
 {
 	// Randomly choose to place single row of desks or double
-	int d = 3 + 2 * MyRandom(1);
+	int d = 3 + 2 * mapgen_random(ctx, 1);
 
-	int w = rooms[room].w - 3;
-	int h = rooms[room].h - 3;
+	int w = ctx->rooms[room].w - 3;
+	int h = ctx->rooms[room].h - 3;
 	int num_col = w / 2;
 	int num_row = h / d;
-	int x0 = rooms[room].x + (rooms[room].w - num_col * 2) / 2;
-	int y0 = rooms[room].y + (rooms[room].h - num_row * d) / 2;
+	int x0 = ctx->rooms[room].x + (ctx->rooms[room].w - num_col * 2) / 2;
+	int y0 = ctx->rooms[room].y + (ctx->rooms[room].h - num_row * d) / 2;
 	int i, j, k, n, l;
 	float x, y;
 	int theme = RAND_THEME(living_themes);
 	int floor_theme = RAND_THEME(living_themes);
 	int obj;
-	int plain_wall = MyRandom(5);
-	int chair = MyRandom(1) ? ISO_N_CHAIR : ISO_DESKCHAIR_1;
+	int plain_wall = mapgen_random(ctx, 5);
+	int chair = mapgen_random(ctx, 1) ? ISO_N_CHAIR : ISO_DESKCHAIR_1;
 
 	if (!w || !h)
 		return 0;
 
 	// Whether to start build upper cube or lower if the row is double
-	l = -2 * MyRandom(1);
+	l = -2 * mapgen_random(ctx, 1);
 	if (l == -2 || d == 5)
 		y0 += 2;
 	for (i = 0; i < num_row; i++) {
@@ -393,34 +393,34 @@ static int place_work_office(int room)
 			k = l;
 			while (n--) {
 				// Construct office cube
-				mapgen_add_obstacle(x0 + j * 2 + 0.5, y0 + i * d, theme_data[theme].wall_n);
+				mapgen_add_obstacle(ctx, x0 + j * 2 + 0.5, y0 + i * d, theme_data[theme].wall_n);
 				obj = plain_wall ? theme_data[theme].wall_n : theme_data[theme].window_wall_h;
-				mapgen_add_obstacle(x0 + j * 2 + 1.5, y0 + i * d, obj);
+				mapgen_add_obstacle(ctx, x0 + j * 2 + 1.5, y0 + i * d, obj);
 				// Sometimes don't create cube, instead place sofas and table
-				if (MyRandom(5) || !j) {
-					mapgen_add_obstacle(x0 + j * 2, y0 + i * d + 0.5 + k, theme_data[theme].wall_w);
-					mapgen_add_obstacle(x0 + j * 2, y0 + i * d + 1.5 + k, theme_data[theme].wall_w);
+				if (mapgen_random(ctx, 5) || !j) {
+					mapgen_add_obstacle(ctx, x0 + j * 2, y0 + i * d + 0.5 + k, theme_data[theme].wall_w);
+					mapgen_add_obstacle(ctx, x0 + j * 2, y0 + i * d + 1.5 + k, theme_data[theme].wall_w);
 					// Place table and chair
 					obj = ISO_N_DESK;
 					x = OBSTACLE_DIM_X(obj) / 2;
 					y = OBSTACLE_DIM_Y(obj) / 2 + k;
-					mapgen_add_obstacle(x0 + j * 2 + x, y0 + i * d + y, obj);
-					obj = chair + MyRandom(2);
-					mapgen_add_obstacle(x0 + j * 2 + x + OBSTACLE_DIM_X(obj) / 2, y0 + i * d + y, obj);
+					mapgen_add_obstacle(ctx, x0 + j * 2 + x, y0 + i * d + y, obj);
+					obj = chair + mapgen_random(ctx, 2);
+					mapgen_add_obstacle(ctx, x0 + j * 2 + x + OBSTACLE_DIM_X(obj) / 2, y0 + i * d + y, obj);
 					// Place a book shelf or a plant
-					if (!MyRandom(3))
-						obj = ISO_SOFFA_CORNER_PLANT_2 + 2 * MyRandom(1);
+					if (!mapgen_random(ctx, 3))
+						obj = ISO_SOFFA_CORNER_PLANT_2 + 2 * mapgen_random(ctx, 1);
 					else
 						obj = ISO_SHELF_SMALL_FULL_H;
-					mapgen_add_obstacle(x0 + j * 2 + x, y0 + i * d + y + 1, obj);
+					mapgen_add_obstacle(ctx, x0 + j * 2 + x, y0 + i * d + y + 1, obj);
 				} else {
 					obj = ISO_TABLE_GLASS_2;
 					x = OBSTACLE_DIM_X(obj) / 3;
 					y = 3 * OBSTACLE_DIM_Y(obj) / 4 + k;
-					mapgen_add_obstacle(x0 + j * 2 + x, y0 + i * d + y, obj);
-					mapgen_add_obstacle(x0 + j * 2 + x, y0 + i * d + y - OBSTACLE_DIM_Y(obj) / 3, ISO_RED_CHAIR_S);
-					if (MyRandom(1))
-						mapgen_add_obstacle(x0 + j * 2 + x + OBSTACLE_DIM_X(obj) / 2, y0 + i * d + y, ISO_SOFFA_3);
+					mapgen_add_obstacle(ctx, x0 + j * 2 + x, y0 + i * d + y, obj);
+					mapgen_add_obstacle(ctx, x0 + j * 2 + x, y0 + i * d + y - OBSTACLE_DIM_Y(obj) / 3, ISO_RED_CHAIR_S);
+					if (mapgen_random(ctx, 1))
+						mapgen_add_obstacle(ctx, x0 + j * 2 + x + OBSTACLE_DIM_X(obj) / 2, y0 + i * d + y, ISO_SOFFA_3);
 				}
 				k = -2 - k;
 			}
@@ -431,13 +431,13 @@ static int place_work_office(int room)
 		y0 -= 2;
 	for (i = 0; i < num_row * d - 1; i++) {
 		for (j = 0; j < num_col * 2; j++)
-			mapgen_set_floor(x0 + j, y0 + i, theme_data[floor_theme].floor[1]);
+			mapgen_set_floor(ctx, x0 + j, y0 + i, theme_data[floor_theme].floor[1]);
 	}
 
 	return 1;
 }
 
-static int place_main_room(int room)
+static int place_main_room(struct mapgen_context *ctx, int room)
 {
 	const int projectors[] = { ISO_PROJECTOR_S, ISO_PROJECTOR_W, ISO_PROJECTOR_N, ISO_PROJECTOR_E };
 	const int dx[] = { 1, -1, -1,  1 };
@@ -445,31 +445,31 @@ static int place_main_room(int room)
 	const int screen_dx[] = { 1, -3, -1, 3 };
 	const int screen_dy[] = { 3,  1, -3, -1 };
 
-	int x = rooms[room].x + rooms[room].w / 2;
-	int y = rooms[room].y + rooms[room].h / 2;
-	int i = MyRandom(3);
+	int x = ctx->rooms[room].x + ctx->rooms[room].w / 2;
+	int y = ctx->rooms[room].y + ctx->rooms[room].h / 2;
+	int i = mapgen_random(ctx, 3);
 	int obj;
 
-	if (rooms[room].w < 8 || rooms[room].h < 8)
+	if (ctx->rooms[room].w < 8 || ctx->rooms[room].h < 8)
 		return 0;
 
 	// If length of the one of the sides is equal to 8 the others
 	// should be greater than 8
-	if (rooms[room].w == 8 || rooms[room].h == 8) {
-		if (rooms[room].w < rooms[room].h && i % 2)
+	if (ctx->rooms[room].w == 8 || ctx->rooms[room].h == 8) {
+		if (ctx->rooms[room].w < ctx->rooms[room].h && i % 2)
 			i = (i + 1) % 4;
-		else if (rooms[room].w > rooms[room].h && !(i % 2))
+		else if (ctx->rooms[room].w > ctx->rooms[room].h && !(i % 2))
 			i = (i + 1) % 4;
 		else
 			return 0;
 	}
-	int n = MyRandom(1) + 3;
+	int n = mapgen_random(ctx, 1) + 3;
 	// If we place only 3 tables out of 4, there is a place for projector
 	if (n == 3) {
 		// Place projector instead of one of the tables
 		obj = projectors[i];
-		mapgen_add_obstacle(x + dx[i], y + dy[i], obj);
-		mapgen_add_obstacle(x + screen_dx[i], y + screen_dy[i], ISO_PROJECTOR_SCREEN_N + i);
+		mapgen_add_obstacle(ctx, x + dx[i], y + dy[i], obj);
+		mapgen_add_obstacle(ctx, x + screen_dx[i], y + screen_dy[i], ISO_PROJECTOR_SCREEN_N + i);
 	}
 	// Place round tables
 	while (n--) {
@@ -477,34 +477,34 @@ static int place_main_room(int room)
 		obj = ISO_CONFERENCE_TABLE_N + i;
 		int w = OBSTACLE_DIM_X(obj) / 2;
 		int h = OBSTACLE_DIM_Y(obj) / 2;
-		mapgen_add_obstacle(x + w * dx[i], y + h * dy[i], obj);
+		mapgen_add_obstacle(ctx, x + w * dx[i], y + h * dy[i], obj);
 	}
 
 	return 1;
 }
 
-static void fill_rooms(int *vis)
+static void fill_rooms(struct mapgen_context *ctx, int *vis)
 {
 	int i;
 	// Gifts are placed in rooms that have not yet been visited.
 
 	// Armories are for rooms with only one neighbor
-	for (i = 0; i < total_rooms; i++) {
-		if (!vis[i] && rooms[i].num_neighbors == 1) {
-			fill_armory(i);
+	for (i = 0; i < ctx->total_rooms; i++) {
+		if (!vis[i] && ctx->rooms[i].num_neighbors == 1) {
+			fill_armory(ctx, i);
 			vis[i] = 1;
 		}
 	}
 
 	// Other rooms get regular gifts
-	for (i = 0; i < total_rooms; i++) {
+	for (i = 0; i < ctx->total_rooms; i++) {
 		if (!vis[i])
-			mapgen_gift(&rooms[i]);
+			mapgen_gift(ctx, &ctx->rooms[i]);
 	}
 }
 
 // Sets living room theme for the middle room and some its neighbors
-static int set_living_theme_recursive(int room, int depth, int *vis)
+static int set_living_theme_recursive(struct mapgen_context *ctx, int room, int depth, int *vis)
 {
 	int i;
 	int count = 0;
@@ -512,18 +512,18 @@ static int set_living_theme_recursive(int room, int depth, int *vis)
 	if (!depth)
 		return 0;
 
-	if (rooms[room].w != 2 && rooms[room].h != 2) {
-		rooms[room].theme = RAND_THEME(living_themes);
+	if (ctx->rooms[room].w != 2 && ctx->rooms[room].h != 2) {
+		ctx->rooms[room].theme = RAND_THEME(living_themes);
 		vis[room] = 1;
 		count = 1;
 	}
-	for (i = 0; i < rooms[room].num_neighbors; i++)
-		count += set_living_theme_recursive(rooms[room].neighbors[i], depth - 1, vis);
+	for (i = 0; i < ctx->rooms[room].num_neighbors; i++)
+		count += set_living_theme_recursive(ctx, ctx->rooms[room].neighbors[i], depth - 1, vis);
 
 	return count;
 }
 
-void mapgen_place_obstacles(struct dungeon_info *di, int w, int h, unsigned char *tiles, int *sorted_square)
+void mapgen_place_obstacles(struct mapgen_context *ctx, struct dungeon_info *di, int w, int h, unsigned char *tiles, int *sorted_square)
 {
 #define MIN_LIVING_ROOMS	6
 
@@ -536,50 +536,50 @@ void mapgen_place_obstacles(struct dungeon_info *di, int w, int h, unsigned char
 	int i;
 	int x, y;
 	int wall, room, room2;
-	int vis[total_rooms];
+	int vis[ctx->total_rooms];
 	int num;
 
-	for (i = 0; i < total_rooms; i++) {
-		rooms[i].theme = RAND_THEME(industrial_themes);
-		rooms[i].period = MyRandom(4) + 1;
+	for (i = 0; i < ctx->total_rooms; i++) {
+		ctx->rooms[i].theme = RAND_THEME(industrial_themes);
+		ctx->rooms[i].period = mapgen_random(ctx, 4) + 1;
 		vis[i] = 0;
 	}
-	num = MyRandom(1) + 2;
-	while (set_living_theme_recursive(di->middle_room, num, vis) < MIN_LIVING_ROOMS)
-		set_living_theme_recursive(di->middle_room, ++num, vis);
+	num = mapgen_random(ctx, 1) + 2;
+	while (set_living_theme_recursive(ctx, di->middle_room, num, vis) < MIN_LIVING_ROOMS)
+		set_living_theme_recursive(ctx, di->middle_room, ++num, vis);
 	vis[di->enter] = SPECIAL_ROOM;
 	vis[di->exit] = SPECIAL_ROOM;
 	// Place main room to the biggest among visited
-	for (i = 0; i < total_rooms; i++)
+	for (i = 0; i < ctx->total_rooms; i++)
 		if (vis[sorted_square[i]] == 1) {
-			place_main_room(sorted_square[i]);
+			place_main_room(ctx, sorted_square[i]);
 			vis[sorted_square[i]] = MAIN_ROOM;
 			break;
 		}
 
 	for (y = 0; y < h; y++) {
 		for (x = 0; x < w; x++) {
-			room = mapgen_get_room(x, y);
+			room = mapgen_get_room(ctx, x, y);
 			switch(tiles[y * w + x]) {
 				case TILE_PARTITION:
 					wall = WALL_PART;
 					room2 = room;
 					// Tiles oriented to the north and west, must have a theme of a room,
 					// which is lower and right of the partition, respectively.
-					if (mapgen_get_room(x, y + 1) != room && mapgen_get_tile(x, y + 1) == TILE_FLOOR) {
+					if (mapgen_get_room(ctx, x, y + 1) != room && mapgen_get_tile(ctx, x, y + 1) == TILE_FLOOR) {
 						wall |= WALL_S;
-						room2 = mapgen_get_room(x, y + 1);
+						room2 = mapgen_get_room(ctx, x, y + 1);
 					}
-					if (mapgen_get_room(x + 1, y) != room && mapgen_get_tile(x + 1, y) == TILE_FLOOR) {
+					if (mapgen_get_room(ctx, x + 1, y) != room && mapgen_get_tile(ctx, x + 1, y) == TILE_FLOOR) {
 						wall |= WALL_E;
-						room2 = mapgen_get_room(x + 1, y);
+						room2 = mapgen_get_room(ctx, x + 1, y);
 					}
 
-					if (mapgen_get_room(x - 1, y) != room && mapgen_get_tile(x - 1, y) == TILE_FLOOR)
+					if (mapgen_get_room(ctx, x - 1, y) != room && mapgen_get_tile(ctx, x - 1, y) == TILE_FLOOR)
 						wall |= WALL_W;
-					if (mapgen_get_room(x, y - 1) != room && mapgen_get_tile(x, y - 1) == TILE_FLOOR)
+					if (mapgen_get_room(ctx, x, y - 1) != room && mapgen_get_tile(ctx, x, y - 1) == TILE_FLOOR)
 						wall |= WALL_N;
-					themes[rooms[room2].theme](x, y, wall);
+					themes[ctx->rooms[room2].theme](ctx, x, y, wall);
 					// no break (really ?)
 				case TILE_FLOOR:
 					wall = 0;
@@ -591,33 +591,33 @@ void mapgen_place_obstacles(struct dungeon_info *di, int w, int h, unsigned char
 						wall |= WALL_N;
 					if (tiles[(y + 1) * w + x] == TILE_WALL)
 						wall |= WALL_S;
-					themes[rooms[room].theme](x, y, wall);
+					themes[ctx->rooms[room].theme](ctx, x, y, wall);
 					break;	
 				case TILE_WALL:
-					mapgen_set_floor(x, y, ISO_FLOOR_EMPTY);
+					mapgen_set_floor(ctx, x, y, ISO_FLOOR_EMPTY);
 					break;
 				default:
-					mapgen_set_floor(x, y, tiles[y * w + x]);
+					mapgen_set_floor(ctx, x, y, tiles[y * w + x]);
 			}
 		}
 	} 
 
 	// Place offices
-	for (i = 0; i < total_rooms; i++) {
+	for (i = 0; i < ctx->total_rooms; i++) {
 		// vis[i] equal to 1 means that the room is free to decorate
-		if (rooms[i].w != 2 && rooms[i].h != 2 && vis[i] == 1) {
-			if (MyRandom(1)) {
-				place_work_office(i);
+		if (ctx->rooms[i].w != 2 && ctx->rooms[i].h != 2 && vis[i] == 1) {
+			if (mapgen_random(ctx, 1)) {
+				place_work_office(ctx, i);
 				vis[i] = OFFICE_ROOM;
-			} else if (MyRandom(1)) {
-				place_library(i);
+			} else if (mapgen_random(ctx, 1)) {
+				place_library(ctx, i);
 				vis[i] = LIBRARY_ROOM;
-			} else if (di->distance[i] < num + 5 && !MyRandom(2)) {
-				place_garden(i);
+			} else if (di->distance[i] < num + 5 && !mapgen_random(ctx, 2)) {
+				place_garden(ctx, i);
 				vis[i] = GARDEN_ROOM;
 			}
 		}
 	}
 
-	fill_rooms(vis);
+	fill_rooms(ctx, vis);
 }
@@ -747,13 +747,165 @@ int check_directory(const char *dirname, int subdir_handle, int check_if_writabl
 	return 0;
 }
 
+/*
+ * Cache of the content of the data directories.
+ *
+ * The first time a file is looked for in a directory, the whole directory
+ * is read, and the path of each of its entries is stored in a hash table,
+ * along with the path of the directory itself. The existence of any other
+ * file of that directory is then known without accessing the filesystem,
+ * whether the file exists or not.
+ *
+ * The directories written by the game (CONFIG_DIR) are not cached.
+ */
+
+// Number of buckets of the file cache's hash table (must be a power of 2)
+#define FILE_CACHE_BUCKETS 4096
+
+#if defined __WIN32__ || defined __APPLE__
+#  define FILE_CACHE_IGNORE_CASE 1
+#  define file_cache_cmp(a, b) strcasecmp(a, b)
+#  define file_cache_fold(c) tolower(c)
+#else
+#  define file_cache_cmp(a, b) strcmp(a, b)
+#  define file_cache_fold(c) (c)
+#endif
+
+enum file_cache_kind {
+	CACHED_FILE,         // Entry of a scanned directory
+	CACHED_DIR,          // Scanned directory
+	CACHED_MISSING_DIR   // Directory that could not be read
+};
+
+struct file_cache_entry {
+	char *path;
+	uint32_t hash;
+	enum file_cache_kind kind;
+	struct list_head bucket_node;
+};
+
+static struct list_head file_cache_buckets[FILE_CACHE_BUCKETS];
+static int file_cache_initialized = FALSE;
+
+/**
+ * FNV-1a hash of the concatenation of two strings.
+ */
+static uint32_t file_cache_hash(const char *str1, const char *str2)
+{
+	uint32_t hash = 2166136261u;
+	const unsigned char *ptr;
+
+	for (ptr = (const unsigned char *)str1; *ptr; ptr++)
+		hash = (hash ^ file_cache_fold(*ptr)) * 16777619u;
+	for (ptr = (const unsigned char *)str2; *ptr; ptr++)
+		hash = (hash ^ file_cache_fold(*ptr)) * 16777619u;
+
+	return hash;
+}
+
+static struct file_cache_entry *file_cache_lookup(const char *path, uint32_t hash)
+{
+	struct file_cache_entry *entry;
+	struct list_head *bucket = &file_cache_buckets[hash & (FILE_CACHE_BUCKETS - 1)];
+
+	list_for_each_entry(entry, bucket, bucket_node) {
+		if (entry->hash == hash && !file_cache_cmp(entry->path, path))
+			return entry;
+	}
+
+	return NULL;
+}
+
+static void file_cache_insert(const char *dir, const char *name, enum file_cache_kind kind)
+{
+	struct file_cache_entry *entry = MyMalloc(sizeof(struct file_cache_entry));
+
+	entry->path = MyMalloc(strlen(dir) + strlen(name) + 1);
+	strcpy(entry->path, dir);
+	strcat(entry->path, name);
+	entry->hash = file_cache_hash(dir, name);
+	entry->kind = kind;
+
+	list_add(&entry->bucket_node, &file_cache_buckets[entry->hash & (FILE_CACHE_BUCKETS - 1)]);
+}
+
+/**
+ * Read a directory, and store its entries in the cache.
+ * \param dir  Path of the directory, including the trailing '/'
+ */
+static void file_cache_scan_dir(const char *dir)
+{
+	DIR *dp = opendir(dir);
+	struct dirent *ent;
+
+	if (!dp) {
+		file_cache_insert(dir, "", CACHED_MISSING_DIR);
+		return;
+	}
+
+	while ((ent = readdir(dp)) != NULL) {
+		if (!strcmp(ent->d_name, ".") || !strcmp(ent->d_name, ".."))
+			continue;
+		file_cache_insert(dir, ent->d_name, CACHED_FILE);
+	}
+	closedir(dp);
+
+	file_cache_insert(dir, "", CACHED_DIR);
+}
+
+/**
+ * Check if a file exists, using the cache of the data directories.
+ *
+ * \param fpath  Path of the file
+ * \return TRUE if the file exists
+ */
+int data_file_exists(const char *fpath)
+{
+	int i;
+
+	if (!file_cache_initialized) {
+		for (i = 0; i < FILE_CACHE_BUCKETS; i++)
+			INIT_LIST_HEAD(&file_cache_buckets[i]);
+		file_cache_initialized = TRUE;
+	}
+
+	const char *slash = strrchr(fpath, '/');
+#ifdef __WIN32__
+	const char *backslash = strrchr(fpath, '\\');
+	if (backslash > slash)
+		slash = backslash;
+#endif
+	if (!slash || slash - fpath + 1 >= PATH_MAX) {
+#ifdef __WIN32__
+		return _access(fpath, 0x04) != -1;
+#else
+		return access(fpath, R_OK) != -1;
+#endif
+	}
+
+	char dir[PATH_MAX];
+	memcpy(dir, fpath, slash - fpath + 1);
+	dir[slash - fpath + 1] = '\0';
+
+	struct file_cache_entry *dir_entry = file_cache_lookup(dir, file_cache_hash(dir, ""));
+	if (!dir_entry) {
+		file_cache_scan_dir(dir);
+		dir_entry = file_cache_lookup(dir, file_cache_hash(dir, ""));
+	}
+
+	if (dir_entry->kind == CACHED_MISSING_DIR)
+		return FALSE;
+
+	return file_cache_lookup(fpath, file_cache_hash(fpath, "")) != NULL;
+}
+
 /* -----------------------------------------------------------------
  * check if a given filename exists in subdir.
  *
  * fills in the (ALLOC'd) string and returns 1 if okay, 0 on error.
  * file_path's length HAS to be PATH_MAX.
  * ----------------------------------------------------------------- */
-static int _file_exists(char *fpath, const char *subdir, const char *fname, const char *fext)
+static int _file_exists(char *fpath, const char *subdir, const char *fname, const char *fext, int use_cache)
 {
 	int nb;
 	if (fext)
@@ -770,6 +922,9 @@ static int _file_exists(char *fpath, const char *subdir, const char *fname, cons
 		return 0;
 	}
 
+	if (use_cache)
+		return data_file_exists(fpath);
+
 #ifdef __WIN32__
 	int access_rtn = _access(fpath, 0x04);
 #else
@@ -806,7 +961,7 @@ int find_file(char *fpath, int subdir_handle, const char *fname, const char *fex
 		return 0;
 	}
 
-	if (!_file_exists(fpath, data_dirs[subdir_handle].path, fname, fext)) {
+	if (!_file_exists(fpath, data_dirs[subdir_handle].path, fname, fext, subdir_handle != CONFIG_DIR)) {
 		if (fext)
 			error_once_message(ONCE_PER_RUN, __FUNCTION__, "File %s.%s not found in %s",
 			                   error_report, fname, fext, data_dirs[subdir_handle].name);
@@ -906,7 +1061,7 @@ int find_localized_file(char *fpath, int subdir_handle, const char *fname, int e
 			             error_report, PATH_MAX, data_dirs[subdir_handle].path, locale, fname);
 			break;
 		}
-		if (_file_exists(fpath, l10ndir, fname, NULL)) {
+		if (_file_exists(fpath, l10ndir, fname, NULL, TRUE)) {
 			free(locale);
 			return 1;
 		}
@@ -941,7 +1096,7 @@ int find_encoded_file(char *fpath, int subdir_handle, const char *fname, int err
 		             error_report, PATH_MAX, data_dirs[subdir_handle].path, used_encoding, fname);
 		return find_file(fpath, subdir_handle, fname, NULL, error_report);
 	}
-	if (_file_exists(fpath, encoded_dir, fname, NULL))
+	if (_file_exists(fpath, encoded_dir, fname, NULL, TRUE))
 		return TRUE;
 #endif
 
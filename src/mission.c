@@ -61,28 +61,112 @@ void mission_diary_add(const char *mis_name, const char *diarytext)
 	Me.quest_browser_changed = 1;
 }
 
+/*
+ * Progress of the assigned missions towards their completion criteria.
+ *
+ * The criteria of a mission are not polled: the events which can change
+ * them (a bot dies, is hacked, changes level or faction, a faction changes
+ * its attitude...) mark the missions they concern, and only those missions
+ * have their counters recomputed and are checked for completion.
+ */
+struct mission_progress {
+	int marked_bots;	// Living bots with the mission's KillMarker
+	int hostile_bots;	// Hostile bots on the mission's must_clear_level
+	int changed;		// TRUE if the counters have to be recomputed
+};
+
+static struct dynarray mission_progress;
+static int missions_changed;	// TRUE if the progress of some missions has to be recomputed
+static int all_missions_changed;	// TRUE if the progress of all missions has to be recomputed
+
+static struct mission_progress *get_mission_progress(int mis_num)
+{
+	while (mission_progress.size <= mis_num) {
+		struct mission_progress progress = { .marked_bots = 0, .hostile_bots = 0, .changed = TRUE };
+		dynarray_add(&mission_progress, &progress, sizeof(struct mission_progress));
+		missions_changed = TRUE;
+	}
+
+	return dynarray_member(&mission_progress, mis_num, sizeof(struct mission_progress));
+}
+
+/**
+ * Mark the missions concerned by a bot as changed, so that their progress is
+ * recomputed by the next check_if_mission_is_complete().
+ * To be called whenever a bot appears, disappears, dies, changes its faction
+ * or its marker, and before and after it changes level.
+ */
+void mission_bot_changed(struct enemy *e)
+{
+	for (int mis_num = 0; mis_num < Me.missions.size; mis_num++) {
+		struct mission *quest = (struct mission *)dynarray_member(&Me.missions, mis_num, sizeof(struct mission));
+
+		if ((quest->KillMarker != -1 && quest->KillMarker == e->marker) || quest->must_clear_level == e->pos.z) {
+			get_mission_progress(mis_num)->changed = TRUE;
+			missions_changed = TRUE;
+		}
+	}
+}
+
+/**
+ * Mark all the missions as changed. To be called when the bots are reloaded,
+ * or when the attitude of a faction changes.
+ */
+void mission_all_bots_changed(void)
+{
+	all_missions_changed = TRUE;
+	missions_changed = TRUE;
+}
+
+static void count_mission_progress(struct mission *quest, struct mission_progress *progress)
+{
+	struct enemy *erot;
+
+	progress->marked_bots = 0;
+	progress->hostile_bots = 0;
+
+	if (quest->KillMarker != -1) {
+		BROWSE_ALIVE_BOTS(erot) {
+			if (erot->marker == quest->KillMarker)
+				progress->marked_bots++;
+		}
+	}
+
+	if (quest->must_clear_level != -1) {
+		BROWSE_LEVEL_BOTS(erot, quest->must_clear_level) {
+			if (!is_friendly(erot->faction, FACTION_SELF))
+				progress->hostile_bots++;
+		}
+	}
+
+	progress->changed = FALSE;
+}
+
 /*----------------------------------------------------------------------
- * This function checks, if the influencer has succeeded in his given 
- * mission.  If not it returns, if yes the EndTitle/Debriefing is
- * started.
+ * This function checks, if the influencer has succeeded in one of the
+ * missions whose progress changed since the last call.
  ----------------------------------------------------------------------*/
 void check_if_mission_is_complete(void)
 {
-	static int check_mission_timestamp = 0;
-
-	// We do not need to check for mission completed EVERY frame
-	// It will be enough to do it now and then..., e.g. every 50th frame
-
-	check_mission_timestamp++;
-	if ((check_mission_timestamp % 50) != 0)
+	if (!missions_changed)
 		return;
 
+	// The completion code of a mission can change the progress of the
+	// other ones
+	int recount_all = all_missions_changed;
+	missions_changed = FALSE;
+	all_missions_changed = FALSE;
+
 	for (int mis_num = 0; mis_num < Me.missions.size; mis_num++) {
 		struct mission *quest = (struct mission *)dynarray_member(&Me.missions, mis_num, sizeof(struct mission));
+		struct mission_progress *progress = get_mission_progress(mis_num);
+
+		if (recount_all)
+			progress->changed = TRUE;
 
 		// We do not need to do anything if the mission has already failed or
-		// if the mission is already completed or if the mission does not exist
-		// at all or if the mission was not assigned yet
+		// if the mission is already completed or if the mission was not
+		// assigned yet. Its progress will be recomputed once it is assigned.
 
 		if (quest->MissionIsComplete == TRUE)
 			continue;
@@ -91,42 +175,17 @@ void check_if_mission_is_complete(void)
 		if (quest->MissionWasAssigned != TRUE)
 			continue;
 
-		int this_mission_seems_completed = TRUE;
-		int checked_one_criterion = FALSE;
-
-		// Continue if the Mission target KillMarker is given but not fulfilled
-
-		if (quest->KillMarker != -1) {
-			struct enemy *erot;
-			BROWSE_ALIVE_BOTS(erot) {
-				if (erot->marker == quest->KillMarker) {
-					this_mission_seems_completed = FALSE;
-					break;
-				}
-
-			}
-			checked_one_criterion = TRUE;
-		}
+		// Missions without criteria are completed by the dialogs
+		if (quest->KillMarker == -1 && quest->must_clear_level == -1)
+			continue;
 
-		// Continue if the Mission target must_clear_level is given but not fulfilled
-
-		if (quest->must_clear_level != -1) {
-			struct enemy *erot;
-			BROWSE_LEVEL_BOTS(erot, quest->must_clear_level) {
-				if (!is_friendly(erot->faction, FACTION_SELF)) {
-					this_mission_seems_completed = FALSE;
-					break;
-				}
-			}
-			checked_one_criterion = TRUE;
-		}
+		if (!progress->changed)
+			continue;
 
-		// If the mission actually had criteria we checked for, and those criteria
-		// are OK, the mission is finished.
+		count_mission_progress(quest, progress);
 
-		if (checked_one_criterion && this_mission_seems_completed)
+		if (!progress->marked_bots && !progress->hostile_bots)
 			complete_mission(quest->mission_name);
-
 	}
 }
 
@@ -141,6 +200,8 @@ void assign_mission(const char *name)
 
 	struct mission *quest = (struct mission *)dynarray_member(&Me.missions, mis_num, sizeof(struct mission));
 	quest->MissionWasAssigned = TRUE;
+	get_mission_progress(mis_num)->changed = TRUE;
+	missions_changed = TRUE;
 
 	if (quest->assignment_lua_code)
 		run_lua(LUA_DIALOG, quest->assignment_lua_code);
@@ -191,6 +252,8 @@ void clear_tux_mission_info()
 	}
 
 	dynarray_free(&Me.missions);
+	dynarray_free(&mission_progress);
+	mission_all_bots_changed();
 }
 
 /**
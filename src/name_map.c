@@ -0,0 +1,261 @@
+/*
+ *
+ *   Copyright (c) 2026 FreedroidRPG development team
+ *
+ *
+ *  This file is part of Freedroid
+ *
+ *  Freedroid is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Freedroid is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Freedroid; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ *  MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file name_map.c
+ * \brief Hash maps used to find game data (obstacles, items, droids...) by name.
+ *
+ * The specs of the game data are stored in plain tables, and are referenced
+ * by name in the data files, the savegames and the Lua scripts. Finding them
+ * used to be done by comparing the name with each entry of the table.
+ *
+ * A name map is an open-addressing hash map (with linear probing) from names
+ * to indices or pointers. The names are copied into the map, so that the map
+ * never refers to memory owned by the indexed table.
+ *
+ * Maps of indexed tables (see name_map_index_of()) are filled lazily from the
+ * table itself, and every hit is checked against the table, so that they
+ * keep working when the table grows during the data loading, or is reloaded.
+ * The entries added to a table are indexed by the next lookup, but a name
+ * missing from the map is not looked for in the table: the names of the
+ * entries already indexed must not change without the map being cleared.
+ */
+
+#define _name_map_c 1
+
+#include "system.h"
+
+#include "defs.h"
+#include "struct.h"
+#include "global.h"
+#include "proto.h"
+
+// Initial number of slots of a map
+#define NAME_MAP_MIN_CAPACITY 64
+
+/**
+ * FNV-1a hash of a name.
+ */
+uint32_t name_map_hash(const char *name)
+{
+	uint32_t hash = 2166136261u;
+	const unsigned char *ptr;
+
+	for (ptr = (const unsigned char *)name; *ptr; ptr++)
+		hash = (hash ^ *ptr) * 16777619u;
+
+	return hash;
+}
+
+/**
+ * Find the slot of a name, or the free slot where it has to be inserted.
+ * The map must have been allocated.
+ */
+static struct name_map_entry *find_slot(struct name_map *map, const char *name)
+{
+	uint32_t mask = map->capacity - 1;
+	uint32_t i = name_map_hash(name) & mask;
+
+	while (map->slots[i].name) {
+		if (!strcmp(map->slots[i].name, name))
+			break;
+		i = (i + 1) & mask;
+	}
+
+	return &map->slots[i];
+}
+
+/**
+ * Re-allocate the slots of a map, keeping its content.
+ */
+static void resize_map(struct name_map *map, int capacity)
+{
+	struct name_map_entry *old_slots = map->slots;
+	int old_capacity = map->capacity;
+	int i;
+
+	map->slots = MyMalloc(capacity * sizeof(struct name_map_entry));
+	map->capacity = capacity;
+
+	for (i = 0; i < old_capacity; i++) {
+		if (old_slots[i].name)
+			*find_slot(map, old_slots[i].name) = old_slots[i];
+	}
+
+	free(old_slots);
+}
+
+/**
+ * Return the slot of a name, creating it if needed.
+ * The map is kept at most half full.
+ */
+static struct name_map_entry *get_slot(struct name_map *map, const char *name, int *created)
+{
+	struct name_map_entry *entry;
+
+	if (2 * (map->count + 1) > map->capacity)
+		resize_map(map, map->capacity ? 2 * map->capacity : NAME_MAP_MIN_CAPACITY);
+
+	entry = find_slot(map, name);
+	*created = (entry->name == NULL);
+	if (*created) {
+		entry->name = strdup(name);
+		map->count++;
+	}
+
+	return entry;
+}
+
+/**
+ * Remove all the names of a map, and release its memory.
+ * The map can be used again afterwards.
+ */
+void name_map_clear(struct name_map *map)
+{
+	int i;
+
+	for (i = 0; i < map->capacity; i++)
+		free(map->slots[i].name);
+	free(map->slots);
+
+	map->slots = NULL;
+	map->capacity = 0;
+	map->count = 0;
+	map->nb_indexed = 0;
+}
+
+/**
+ * Associate a pointer to a name, replacing any previous association.
+ */
+void name_map_add(struct name_map *map, const char *name, void *data)
+{
+	int created;
+
+	get_slot(map, name, &created)->data = data;
+}
+
+/**
+ * Return the pointer associated to a name, or NULL if the name is unknown.
+ */
+void *name_map_get(struct name_map *map, const char *name)
+{
+	struct name_map_entry *entry;
+
+	if (!map->count || !name)
+		return NULL;
+
+	entry = find_slot(map, name);
+	return entry->name ? entry->data : NULL;
+}
+
+/**
+ * Index the names of a table not indexed yet.
+ * When a name is used several times, the first entry is kept.
+ */
+static void index_names(struct name_map *map, const char *(*get_name)(int), int nb_names)
+{
+	int created;
+	int i;
+
+	for (i = map->nb_indexed; i < nb_names; i++) {
+		const char *name = get_name(i);
+		struct name_map_entry *entry;
+
+		if (!name)
+			continue;
+
+		entry = get_slot(map, name, &created);
+		if (created)
+			entry->index = i;
+	}
+
+	map->nb_indexed = nb_names;
+}
+
+/**
+ * Look for a name in a map, and check the found index against the table.
+ */
+static int checked_index(struct name_map *map, const char *name, const char *(*get_name)(int), int nb_names)
+{
+	struct name_map_entry *entry = find_slot(map, name);
+	const char *indexed_name;
+
+	if (!entry->name || entry->index >= nb_names)
+		return -1;
+
+	indexed_name = get_name(entry->index);
+	if (!indexed_name || strcmp(indexed_name, name))
+		return -1;
+
+	return entry->index;
+}
+
+/**
+ * \brief Find the index of a name in a table.
+ *
+ * The map is filled with the names of the table the first time it is used,
+ * and the entries added to the table since the previous call are indexed.
+ * A found entry is checked against the table. If the check fails, the table
+ * was reloaded, and the map is rebuilt. An unknown name is not found in
+ * constant time, without any rebuild.
+ *
+ * \param map       Map of the table.
+ * \param name      Name to look for.
+ * \param get_name  Function returning the name of an entry of the table (or NULL).
+ * \param nb_names  Number of entries in the table.
+ *
+ * \return The index of the first entry of the table with the given name, or -1.
+ */
+int name_map_index_of(struct name_map *map, const char *name, const char *(*get_name)(int), int nb_names)
+{
+	if (!name)
+		return -1;
+
+	if (map->nb_indexed > nb_names)
+		name_map_clear(map);
+	index_names(map, get_name, nb_names);
+
+	if (!map->count)
+		return -1;
+
+	struct name_map_entry *entry = find_slot(map, name);
+	if (!entry->name)
+		return -1;
+
+	if (entry->index < nb_names) {
+		const char *indexed_name = get_name(entry->index);
+		if (indexed_name && !strcmp(indexed_name, name))
+			return entry->index;
+	}
+
+	// The found entry does not match the table, which was reloaded
+	name_map_clear(map);
+	index_names(map, get_name, nb_names);
+	if (!map->count)
+		return -1;
+
+	return checked_index(map, name, get_name, nb_names);
+}
+
+#undef _name_map_c
@@ -43,13 +43,15 @@ static void npc_clear_inventory(struct npc *);
 // List of NPCs in the game
 LIST_HEAD(npc_head);
 
+// NPCs by dialog name
+static struct name_map npc_names;
+
 struct npc *npc_get(const char *dialog_basename)
 {
-	struct npc *n;
-	list_for_each_entry(n, &npc_head, node) {
-		if (!strcmp(n->dialog_basename, dialog_basename))
-			return n;
-	}
+	struct npc *n = name_map_get(&npc_names, dialog_basename);
+
+	if (n)
+		return n;
 
 	error_message(__FUNCTION__, "Could not find NPC with name \"%s\".", PLEASE_INFORM, dialog_basename);
 	return NULL;
@@ -58,6 +60,7 @@ struct npc *npc_get(const char *dialog_basename)
 void npc_insert(struct npc *n)
 {
 	list_add(&n->node, &npc_head);
+	name_map_add(&npc_names, n->dialog_basename, n);
 }
 
 void npc_add(const char *dialog_basename)
@@ -111,6 +114,7 @@ void clear_npcs()
 	}
 
 	INIT_LIST_HEAD(&npc_head);
+	name_map_clear(&npc_names);
 }
 
 int npc_add_shoplist(const char *dialog_basename, const char *item_name, int weight)
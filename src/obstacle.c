@@ -114,28 +114,19 @@ void unglue_obstacle(level *lvl, obstacle *o)
  */
 struct obstacle *add_obstacle_nocheck(struct level *lvl, float x, float y, int type)
 {
-	int i;
-
-	for (i = 0; i < MAX_OBSTACLES_ON_MAP; i++) {
-		if (lvl->obstacle_list[i].type != -1)
-			continue;
-
-		lvl->obstacle_list[i].pos.x = x;
-		lvl->obstacle_list[i].pos.y = y;
-		lvl->obstacle_list[i].pos.z = lvl->levelnum;
-		lvl->obstacle_list[i].type = type;
-		lvl->obstacle_list[i].timestamp = 0;
-
-		glue_obstacle(lvl, &lvl->obstacle_list[i]);
+	int i = pool_add(&lvl->obstacle_list);
+	obstacle *o = &ACCESS_OBSTACLE(lvl, i);
 
-		return &lvl->obstacle_list[i];
-	}
+	o->pos.x = x;
+	o->pos.y = y;
+	o->pos.z = lvl->levelnum;
+	o->type = type;
+	o->timestamp = 0;
+	o->frame_index = 0;
 
-	error_message(__FUNCTION__,
-			"Ran out of obstacle positions (%d) in level %d !",
-			PLEASE_INFORM | IS_FATAL, MAX_OBSTACLES_ON_MAP, lvl->levelnum);
+	glue_obstacle(lvl, o);
 
-	return NULL;
+	return o;
 }
 
 /**
@@ -183,6 +174,10 @@ void del_obstacle(obstacle *o)
 	o->type = -1;
 
 	del_obstacle_extensions(lvl, o);
+
+	int index = get_obstacle_index(lvl, o);
+	if (index != -1)
+		pool_del(&lvl->obstacle_list, index);
 }
 
 /**
@@ -206,6 +201,24 @@ void move_obstacle(obstacle *o, float newx, float newy)
 		return;
 	}
 
+	// When the obstacle stays on the same tiles (as when it is dragged in
+	// the level editor), the tiles it is glued to do not change
+	if (o->type != -1) {
+		int x_min, x_max, y_min, y_max;
+		int new_x_min, new_x_max, new_y_min, new_y_max;
+		struct obstacle moved = *o;
+
+		moved.pos.x = newx;
+		moved.pos.y = newy;
+		obstacle_boundaries(o, &x_min, &x_max, &y_min, &y_max);
+		obstacle_boundaries(&moved, &new_x_min, &new_x_max, &new_y_min, &new_y_max);
+		if (new_x_min == x_min && new_x_max == x_max && new_y_min == y_min && new_y_max == y_max) {
+			o->pos.x = newx;
+			o->pos.y = newy;
+			return;
+		}
+	}
+
 	unglue_obstacle(lvl, o);
 
 	o->pos.x = newx;
@@ -289,6 +302,11 @@ int change_obstacle_type(const char *obslabel, int type)
 	return 0;
 }
 
+static const char *obstacle_spec_name(int id)
+{
+	return get_obstacle_spec(id)->name;
+}
+
 /**
  * \brief Get the type of the obstacle spec with the specified name.
  * \param The name of the obstacle spec to get.
@@ -296,17 +314,11 @@ int change_obstacle_type(const char *obslabel, int type)
  */
 int get_obstacle_type_by_name(char *name)
 {
-	int id = 0;
-
-	for (id = 0; id < obstacle_map.size; id++) {
-		char *obstacle_spec_name = get_obstacle_spec(id)->name;
-		
-		if (obstacle_spec_name == NULL)
-			continue;
-		
-		if (!strcmp(obstacle_spec_name, name))
-			return id;
-	}
+	static struct name_map obstacle_names;
+	int id = name_map_index_of(&obstacle_names, name, obstacle_spec_name, obstacle_map.size);
+
+	if (id != -1)
+		return id;
 
 	error_message(__FUNCTION__, "Unable to find the obstacle specs with name \"%s\"", PLEASE_INFORM, name);
 	return -1;
@@ -31,9 +31,7 @@
 
 int get_obstacle_index(level *lvl, obstacle *o)
 {
-	int obstacle_index = (o - &(lvl->obstacle_list[0]));
-
-	return obstacle_index;
+	return pool_index(&lvl->obstacle_list, o);
 }
 
 static void change_extensions(struct level *lvl, struct obstacle *from, struct obstacle *to)
@@ -55,12 +53,12 @@ static void change_extensions(struct level *lvl, struct obstacle *from, struct o
  */
 void defrag_obstacle_array(level *lvl) 
 {
-	int i = MAX_OBSTACLES_ON_MAP - 1;
+	int i = lvl->obstacle_list.size - 1;
 	int array_end;
 
 	// Locate the last (existing) element of the array
 	while (i >= 0) {
-		if (lvl->obstacle_list[i].type != -1)
+		if (ACCESS_OBSTACLE(lvl, i).type != -1)
 			break;
 		i--;
 	}
@@ -68,29 +66,31 @@ void defrag_obstacle_array(level *lvl)
 
 	// Browse the array and fill in the voids
 	for (i = 0; i < array_end; i++) {
-		if (lvl->obstacle_list[i].type == -1) {
+		if (ACCESS_OBSTACLE(lvl, i).type == -1) {
 			// Unglue the last obstacle.
-			unglue_obstacle(lvl, &lvl->obstacle_list[array_end]);
+			unglue_obstacle(lvl, &ACCESS_OBSTACLE(lvl, array_end));
 
 			// Fill in this spot with the last obstacle
-			memcpy(&lvl->obstacle_list[i], &lvl->obstacle_list[array_end], sizeof(obstacle));
+			memcpy(&ACCESS_OBSTACLE(lvl, i), &ACCESS_OBSTACLE(lvl, array_end), sizeof(obstacle));
 
 			// Re-address obstacle extension pointing to the obstacle we've moved
-			change_extensions(lvl, &lvl->obstacle_list[array_end], &lvl->obstacle_list[i]);
+			change_extensions(lvl, &ACCESS_OBSTACLE(lvl, array_end), &ACCESS_OBSTACLE(lvl, i));
 
 			// Glue the moved obstacle.
-			glue_obstacle(lvl, &lvl->obstacle_list[i]);
+			glue_obstacle(lvl, &ACCESS_OBSTACLE(lvl, i));
 
 			// Mark the old entry as unused
-			lvl->obstacle_list[array_end].type = -1;
+			ACCESS_OBSTACLE(lvl, array_end).type = -1;
 
 			// Reverse scan the array to find the new array's end
 			do {
 				array_end--;
-			} while (lvl->obstacle_list[array_end].type == -1 && array_end > i);
+			} while (ACCESS_OBSTACLE(lvl, array_end).type == -1 && array_end > i);
 		}
 	}
 
+	pool_reset_free_slots(&lvl->obstacle_list);
+
 	dirty_animated_obstacle_list(lvl->levelnum);
 }
 
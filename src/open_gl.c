@@ -267,6 +267,64 @@ void make_texture_out_of_surface(struct image *img)
 	img->surface = NULL;
 	open_gl_check_error_status(__FUNCTION__);
 }
+
+/**
+ * Create a texture with undefined content, to be filled in with
+ * update_texture_rect(). The dimensions have to be powers of two if the GPU
+ * does not support NPOT textures.
+ */
+GLuint create_empty_texture(int w, int h)
+{
+	GLuint texture;
+
+	end_image_batch(__FUNCTION__);
+
+	glGenTextures(1, &texture);
+	glBindTexture(GL_TEXTURE_2D, texture);
+
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+	if (pbo) {
+		// Unbind the PBO, so that the NULL argument means "create undefined storage"
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	}
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, w, h, 0, GL_BGRA, GL_UNSIGNED_BYTE, NULL);
+
+	if (pbo) {
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pbo);
+	}
+
+	open_gl_check_error_status(__FUNCTION__);
+	return texture;
+}
+
+/**
+ * Copy a part of an SDL surface to the same part of a texture.
+ * The surface has to be a 32 bits surface in the display format.
+ */
+void update_texture_rect(GLuint texture, SDL_Surface *surf, SDL_Rect *rect)
+{
+	Uint8 *data_ptr = (Uint8 *)surf->pixels + rect->y * surf->pitch + rect->x * 4;
+
+	// Stop any image batch being constructed, the texture may be in use
+	end_image_batch(__FUNCTION__);
+
+	glBindTexture(GL_TEXTURE_2D, texture);
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, surf->pitch / 4);
+
+	if (pbo) {
+		glBufferData(GL_PIXEL_UNPACK_BUFFER, (rect->h - 1) * surf->pitch + rect->w * 4, data_ptr, GL_STREAM_DRAW);
+	}
+
+	glTexSubImage2D(GL_TEXTURE_2D, 0, rect->x, rect->y, rect->w, rect->h, GL_BGRA, GL_UNSIGNED_BYTE, (pbo) ? NULL : data_ptr);
+
+	glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+	open_gl_check_error_status(__FUNCTION__);
+}
 #endif
 
 static void safely_set_open_gl_viewport_and_matrix_mode(void)
@@ -691,6 +749,10 @@ void blit_background(const char *background)
 	display_image_on_screen(&bg->img, x, y, set_image_transformation(scalex, scaley, 1.0, 1.0, 1.0, 1.0, 0));
 }
 
+// Current scissor rectangle, if the scissor test is enabled
+static SDL_Rect gl_clip_rect;
+static int gl_clip_rect_set = FALSE;
+
 void set_gl_clip_rect(const SDL_Rect *clip)
 {
 #ifdef HAVE_LIBGL
@@ -700,6 +762,8 @@ void set_gl_clip_rect(const SDL_Rect *clip)
 	if (use_open_gl) {
 		glScissor(clip->x, GameConfig.screen_height - (clip->y + clip->h), clip->w, clip->h);
 		glEnable(GL_SCISSOR_TEST);
+		gl_clip_rect = *clip;
+		gl_clip_rect_set = TRUE;
 	}
 #endif
 }
@@ -709,10 +773,23 @@ void unset_gl_clip_rect(void)
 #ifdef HAVE_LIBGL
 	if (use_open_gl) {
 		glDisable(GL_SCISSOR_TEST);
+		gl_clip_rect_set = FALSE;
 	}
 #endif
 }
 
+/**
+ * Get the current clip rectangle set with set_gl_clip_rect().
+ *
+ * \return FALSE if no clip rectangle is set
+ */
+int get_gl_clip_rect(SDL_Rect *clip)
+{
+	if (gl_clip_rect_set)
+		*clip = gl_clip_rect;
+	return gl_clip_rect_set;
+}
+
 /**
  * Retrieve a bit mask of the OpenGL "quirks" that FreedroidRPG will apply. These are driver- and hardware-dependent workarounds we apply in the driver.
  */
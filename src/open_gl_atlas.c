@@ -51,9 +51,132 @@ static char *get_texture_atlas(const char *fname)
 	return NULL;
 }
 
+/**
+ * Fill in the image of an atlas element, as a part of the atlas page image.
+ * The page image is loaded when the first of its elements used by the game
+ * is found, so that nothing is decoded for the pages the game does not use.
+ */
+static void load_atlas_element(struct image *page_img, int *page_loaded, const char *page_name,
+                               const char *key, SDL_Rect *rect, int xoff, int yoff,
+                               struct image *(*get_storage_for_key)(const char *key))
+{
+	struct image *img = get_storage_for_key(key);
+	if (!img)
+		return;
+
+	if (!*page_loaded) {
+		load_image(page_img, GRAPHICS_DIR, page_name, NO_MOD);
+		*page_loaded = TRUE;
+	}
+
+	// Fill in element struct image
+	delete_image(img);
+	create_subimage(page_img, img, rect);
+
+	// Set image offset
+	img->offset_x = xoff;
+	img->offset_y = yoff;
+}
+
+/**
+ * Free the SDL surface of an atlas page, once its elements are created.
+ * In OpenGL mode, the texture of the page is kept, since the elements
+ * use it.
+ */
+static void release_atlas_page(struct image *page_img, int page_loaded)
+{
+	if (page_loaded)
+		free_image_surface(page_img);
+}
+
+/**
+ * Load a texture atlas from the asset pack, without reading its
+ * description file.
+ *
+ * @return TRUE if the atlas is in the asset pack
+ */
+static int load_packed_texture_atlas(const char *atlas_name, struct image *(*get_storage_for_key)(const char *key))
+{
+	int first_page, nb_pages;
+	int page, element;
+
+	if (!get_packed_atlas(atlas_name, &first_page, &nb_pages))
+		return FALSE;
+
+	for (page = first_page; page < first_page + nb_pages; page++) {
+		int first_element, nb_elements;
+		const char *page_name = get_packed_atlas_page(page, &first_element, &nb_elements);
+
+		struct image atlas_img = EMPTY_IMAGE;
+		int page_loaded = FALSE;
+
+		for (element = first_element; element < first_element + nb_elements; element++) {
+			SDL_Rect dest_rect;
+			int xoff, yoff;
+			const char *key = get_packed_atlas_element(element, &dest_rect, &xoff, &yoff);
+
+			load_atlas_element(&atlas_img, &page_loaded, page_name, key, &dest_rect, xoff, yoff, get_storage_for_key);
+		}
+
+		release_atlas_page(&atlas_img, page_loaded);
+	}
+
+	return TRUE;
+}
+
+/**
+ * Start decoding the images of a texture atlas on the image decoder
+ * threads, so that the next load_texture_atlas() on this atlas only has to
+ * wait for them.
+ *
+ * @param atlas_name Path of the atlas (will be searched for in graphics dir)
+ * @param directory Directory of the atlas images
+ */
+void prefetch_texture_atlas(const char *atlas_name, const char *directory)
+{
+	// Page images of the atlases already read, as a list of
+	// '\0' terminated paths ending with an empty path
+	static struct name_map page_lists;
+	char fpath[PATH_MAX];
+	int first_page, nb_pages;
+	const char *page;
+
+	if (get_packed_atlas(atlas_name, &first_page, &nb_pages))
+		return;
+
+	char *pages = name_map_get(&page_lists, atlas_name);
+	if (!pages) {
+		// Errors are reported by load_texture_atlas()
+		if (strlen(directory) > 1023 || !find_file(fpath, GRAPHICS_DIR, atlas_name, NULL, SILENT))
+			return;
+
+		char *atlas_data = read_and_malloc_and_terminate_file(fpath, NULL);
+		char *dat = atlas_data;
+		struct auto_string *list = alloc_autostr(256);
+
+		while ((dat = strchr(dat, '*'))) {
+			char filename[1024];
+			int at_line_start = (dat == atlas_data || dat[-1] == '\n');
+			if (at_line_start && sscanf(dat, "* %1023s size", filename) == 1)
+				autostr_append(list, "%s%s%c", directory, filename, '\0');
+			dat++;
+		}
+		free(atlas_data);
+
+		pages = MyMalloc(list->length + 1);
+		memcpy(pages, list->value, list->length);
+		free_autostr(list);
+		name_map_add(&page_lists, atlas_name, pages);
+	}
+
+	for (page = pages; *page; page += strlen(page) + 1)
+		prefetch_image(GRAPHICS_DIR, page, NO_MOD);
+}
+
 int load_texture_atlas(const char *atlas_name, const char *directory, struct image *(*get_storage_for_key)(const char *key))
 {
-	int loaded_any_subimage = FALSE;
+	if (load_packed_texture_atlas(atlas_name, get_storage_for_key))
+		return 0;
 
 	// Ensure that 'directory' length is not too large, to have enough room to
 	// read the image names
@@ -83,9 +206,9 @@ int load_texture_atlas(const char *atlas_name, const char *directory, struct ima
 			dat++;
 		dat++;
 
-		// Load the atlas in memory
+		// The atlas image is loaded with its first used element
 		struct image atlas_img = EMPTY_IMAGE;
-		load_image(&atlas_img, GRAPHICS_DIR, atlas_path, NO_MOD);
+		int page_loaded = FALSE;
 
 		while (*dat && *dat != '*') {
 			// Read each element in the atlas
@@ -102,18 +225,7 @@ int load_texture_atlas(const char *atlas_name, const char *directory, struct ima
 			dest_rect.w = w;
 			dest_rect.h = h;
 
-			struct image *img = get_storage_for_key(element_key);
-			if (img) {
-				// Fill in element struct image
-				delete_image(img);
-				create_subimage(&atlas_img, img, &dest_rect);
-
-				// Set image offset
-				img->offset_x = xoff;
-				img->offset_y = yoff;
-
-				loaded_any_subimage = TRUE;
-			}
+			load_atlas_element(&atlas_img, &page_loaded, atlas_path, element_key, &dest_rect, xoff, yoff, get_storage_for_key);
 
 			// Move on to the next element
 			while (*dat && *dat != '\n')
@@ -121,13 +233,7 @@ int load_texture_atlas(const char *atlas_name, const char *directory, struct ima
 			dat++;
 		}
 
-		// Free atlas SDL surface.
-		// If no subimage was loaded the OpenGL texture is also deleted
-		// in order to prevent a potential resource leak.
-		if (!loaded_any_subimage)
-			delete_image(&atlas_img);
-		else
-			free_image_surface(&atlas_img);
+		release_atlas_page(&atlas_img, page_loaded);
 	}
 
 	free(atlas_data);
@@ -150,6 +150,15 @@ int init_opengl_debug(void)
 	return 0;
 }
 
+/**
+ * Check if the debug markers are sent somewhere, to avoid building them
+ * for nothing.
+ */
+int gl_debug_markers_enabled(void)
+{
+	return GLEW_GREMEDY_string_marker;
+}
+
 void gl_debug_marker(const char *str)
 {
 	if (GLEW_GREMEDY_string_marker) {
@@ -164,6 +173,11 @@ int init_opengl_debug(void)
 	return 1;
 }
 
+int gl_debug_markers_enabled(void)
+{
+	return FALSE;
+}
+
 void gl_debug_marker(const char *str)
 {
 }
@@ -53,6 +53,7 @@ void display_automap(void);
 void toggle_automap(void);
 void CollectAutomapData(void);
 void update_obstacle_automap(int z, obstacle *our_obstacle);
+int automap_count_seen_squares(int z);
 
 // init.c
 void prepare_execution(int, char **);
@@ -174,6 +175,7 @@ void set_up_ordered_blitting_list(int mask);
 void blit_preput_objects_according_to_blitting_list(int mask);
 void blit_nonpreput_objects_according_to_blitting_list(int mask);
 void draw_grid_on_the_floor(int mask);
+void blit_one_floor_tile(level *lvl, int col, int line, int layer_start, int layer_end, float zf);
 void blit_leveleditor_point(int x, int y);
 void update_item_text_slot_positions(void);
 void AssembleCombatPicture(int);
@@ -285,17 +287,23 @@ void gl_draw_quad(const struct point[4], int, int, int, int);
 SDL_Surface *our_IMG_load_wrapper(const char *file);
 void flip_image_vertically(SDL_Surface * tmp1);
 void make_texture_out_of_surface(struct image *our_image);
+#ifdef HAVE_LIBGL
+GLuint create_empty_texture(int, int);
+void update_texture_rect(GLuint, SDL_Surface *, SDL_Rect *);
+#endif
 void blit_open_gl_stretched_texture_light_radius(int decay_x, int decay_y);
 int init_open_gl(void);
 void blit_background(const char *background);
 struct background *get_background(const char *);
 void set_gl_clip_rect(const SDL_Rect *clip);
 void unset_gl_clip_rect(void);
+int get_gl_clip_rect(SDL_Rect *clip);
 int get_opengl_quirks(void);
 
 // open_gl_debug.c
 int init_opengl_debug();
 void open_gl_check_error_status(const char *name_of_calling_function);
+int gl_debug_markers_enabled(void);
 void gl_debug_marker(const char *str);
 
 // open_gl_shaders.c
@@ -314,6 +322,7 @@ struct image *get_obstacle_image(int, int);
 struct image *get_obstacle_shadow_image(int, int);
 struct image *get_map_label_image(void);
 struct image *get_droid_portrait_image(int);
+void prefetch_floor_tiles_and_obstacles(void);
 void load_all_obstacles(int with_startup_bar);
 void free_obstacle_graphics(void);
 struct image *get_item_shop_image(int type);
@@ -324,6 +333,8 @@ void free_item_graphics(void);
 void load_tux_graphics(int motion_class, int tux_part_group, const char *part_string);
 void reload_tux_graphics(void);
 void get_offset_for_iso_image_from_file_and_path(const char *fpath, struct image * our_iso_image);
+void update_graphics_prefetch(void);
+void reset_graphics_prefetch(void);
 
 // graphics.c 
 void blit_mouse_cursor(void);
@@ -362,6 +373,8 @@ void complete_mission(const char *);
 void assign_mission(const char *);
 void get_quest_list(char *);
 void clear_tux_mission_info(void);
+void mission_bot_changed(struct enemy *);
+void mission_all_bots_changed(void);
 void check_if_mission_is_complete(void);
 void mission_diary_add(const char *, const char *);
 int get_mission_index_by_name(const char *);
@@ -378,6 +391,7 @@ int smash_obstacle(float, float, int);
 uint16_t *get_map_brick(level *, float, float);
 void CountNumberOfDroidsOnShip(void);
 void free_current_ship();
+void init_level_pools(level *);
 void free_ship_level(level*);
 int LoadShip(char *filename, int);
 int SaveShip(const char *filename, int reset_random_levels, int);
@@ -399,6 +413,7 @@ float translate_pixel_to_zoomed_map_location(float axis_x, float axis_y, int giv
 int next_pathfinder_timestamp(void);
 int next_glue_timestamp(void);
 void free_glued_obstacles(level *lvl);
+struct floor_tile_spec *get_floor_tile_spec(int floor_value);
 struct image *get_floor_tile_image(int floor_value);
 
 //colldet.c
@@ -416,6 +431,7 @@ int normalize_vect(float, float, float *, float *);
 // sound.c
 void init_audio(void);
 void close_audio(void);
+void update_audio(void);
 void set_music_volume(float);
 void set_SFX_volume(float);
 void switch_background_music(char *);
@@ -519,6 +535,7 @@ int item_upgrade_ui_visible(void);
 
 // character.c
 unsigned int get_experience_required(int);
+void invalidate_character_stats(void);
 void UpdateAllCharacterStats(void);
 void ShowCharacterScreen(void);
 void HandleCharacterScreen(void);
@@ -606,6 +623,7 @@ int MouseCursorIsOnButton(int ButtonIndex, int x, int y);
 void *my_memmem(char *, size_t, char *, size_t);
 void init_data_dirs_path();
 int check_directory(const char *, int, int, int);
+int data_file_exists(const char *);
 int find_file(char *, int, const char *, const char *, int);
 int find_suffixed_file(char *, int, const char *, const char *, int);
 int find_localized_file(char *, int, const char *, int);
@@ -653,6 +671,7 @@ int teleport_to_closest_waypoint(enemy *ThisRobot);
 int teleport_to_random_waypoint(enemy *, level *, char *);
 void teleport_enemy(enemy *, int, float, float);
 int get_droid_type(const char *);
+void init_droid_specs(void);
 enemy *get_enemy_with_dialog(const char *dialog);
 int get_sensor_id_by_name(const char *);
 const char *get_sensor_name_by_id(int);
@@ -680,11 +699,16 @@ int chat_with_droid(Enemy ChatDroid);
 
 int display_text(const char *, int, int, const SDL_Rect*, float);
 
-int ImprovedCheckLineBreak(char *, const SDL_Rect*, float);
 char *get_string(int, const char *, const char *);
 void printf_SDL(SDL_Surface * screen, int x, int y, const char *fmt, ...) PRINTF_FMT_ATTRIBUTE(4,5);
 int longest_line_width(char *text);
 
+// text_layout.c
+void text_layout_cache_clear(void);
+struct text_layout *get_text_run_layout(struct font *, const char *, int);
+struct text_layout *get_text_layout(struct font *, const char *, int, const SDL_Rect *, float);
+int text_layout_find_step(struct text_layout *, int);
+
 // text_public.c 
 char *ReadAndMallocStringFromData(char *SearchString, const char *StartIndicationString, const char *EndIndicationString);
 char *ReadAndMallocStringFromDataOptional(char *SearchString, const char *StartIndicationString, const char *EndIndicationString);
@@ -753,16 +777,6 @@ int GreatShopInterface(int, item * ShowPointerList[MAX_ITEMS_IN_INVENTORY], int,
 int droid_takeover(struct enemy *, float *);
 int do_takeover(int, int, int, enemy *);
 
-void InventPlayground(void);
-
-void ProcessPlayground(void);
-void ProcessDisplayColumn(void);
-void ProcessCapsules(void);
-void AnimateCurrents(void);
-
-void ClearPlayground(void);
-int IsActive(int color, int row);
-
 void list_add(list_head_t * new, list_head_t * head);
 void list_add_tail(list_head_t * new, list_head_t * head);
 void list_del(list_head_t * entry);
@@ -774,6 +788,16 @@ void list_splice(list_head_t * list, list_head_t * head);
 void list_splice_init(list_head_t * list, list_head_t * head);
 
 int load_texture_atlas(const char *, const char *, struct image *(*get_storage_for_key)(const char *key));
+void prefetch_texture_atlas(const char *, const char *);
+
+// asset_pack.c
+int open_asset_pack(void);
+void close_asset_pack(void);
+int asset_pack_has_image(const char *);
+int load_image_from_asset_pack(struct image *, const char *, int);
+int get_packed_atlas(const char *, int *, int *);
+const char *get_packed_atlas_page(int, int *, int *);
+const char *get_packed_atlas_element(int, SDL_Rect *, int *, int *);
 
 // chat.c
 struct widget_group *create_chat_dialog(void);
@@ -799,10 +823,10 @@ void title_screen_run(struct title_screen *);
 void leveleditor_process_input(void);
 
 // mapgen/mapgen.c
-int generate_dungeon(int, int, int, int);
-
-// mapgen/fd_hooks.c
-void set_dungeon_output(level *);
+int generate_dungeon(level *, unsigned int);
+void generate_dungeons(level **, int, unsigned int);
+void generate_dungeons_in_background(level **, int, unsigned int);
+void wait_for_dungeons(void);
 
 // string.c
 struct auto_string *alloc_autostr(int);
@@ -827,6 +851,24 @@ void sparse_dynarray_add(struct sparse_dynarray *, void *, size_t);
 void sparse_dynarray_del(struct sparse_dynarray *, int, size_t);
 void *sparse_dynarray_member(struct sparse_dynarray *, int, size_t);
 int sparse_dynarray_member_used(struct sparse_dynarray *, int);
+int sparse_dynarray_live_member(struct sparse_dynarray *, int);
+void pool_init(struct pool *, size_t, int (*)(void *));
+void pool_free(struct pool *);
+int pool_add(struct pool *);
+void pool_del(struct pool *, int);
+void pool_reset_free_slots(struct pool *);
+int pool_index(struct pool *, void *);
+
+// name_map.c
+uint32_t name_map_hash(const char *);
+void name_map_clear(struct name_map *);
+void name_map_add(struct name_map *, const char *, void *);
+void *name_map_get(struct name_map *, const char *);
+int name_map_index_of(struct name_map *, const char *, const char *(*)(int), int);
+
+// spec_cache.c
+int load_spec_cache(void);
+void save_spec_cache(void);
 
 // animate.c
 void dirty_animated_obstacle_list(int lvl_num);
@@ -878,6 +920,11 @@ struct map_label *map_label_exists(const char *);
 // lvledit_display.c
 float lvledit_zoomfact_inv(void);
 
+// lvledit_overview.c
+int lvledit_overview_show_floor(int line_start, int line_end, int col_start, int col_end, int layer_start, int layer_end);
+void lvledit_overview_forget_level(int levelnum);
+void lvledit_overview_free(void);
+
 // lvledit_widgets.c
 struct widget_group *get_lvledit_ui(void);
 void free_lvledit_ui();
@@ -891,18 +938,55 @@ void move_waypoint(level *, waypoint *, int, int);
 // image.c
 void start_image_batch(void);
 void end_image_batch(const char *reason);
+void start_display_capture(struct display_capture *);
+void end_display_capture(void);
+int display_capture_active(void);
+void capture_rectangle(SDL_Rect *, int, int, int, int);
+int display_captured(struct display_capture *);
 void display_image_on_screen(struct image *img, int x, int y, struct image_transformation t);
 void display_image_on_map(struct image *img, float X, float Y, struct image_transformation t);
 void create_subimage(struct image *source, struct image *new_img, SDL_Rect *rect);
 void load_image(struct image *, int, const char *, int);
 void load_image_surface(struct image *img, const char *filepath, int use_offset_file);
+SDL_Surface *decode_surface_bitmap(const char *, char *, size_t);
 SDL_Surface *load_surface_bitmap(const char *);
+void prefetch_image(int, const char *, int);
 void free_image_surface(struct image *img);
 void delete_image(struct image *img);
 int image_loaded(struct image *);
 struct image_transformation set_image_transformation(float scale_x, float scale_y, float r, float g, float b, float a, int highlight);
 void init_image_shaders(void);
 
+// image_atlas.c
+void atlas_skyline_init(struct atlas_skyline *, int, int);
+void atlas_skyline_free(struct atlas_skyline *);
+int atlas_skyline_insert(struct atlas_skyline *, int, int, int *, int *);
+int atlas_skyline_used_area(struct atlas_skyline *);
+void update_atlas_image(struct image *);
+SDL_Surface *get_atlas_image_surface(struct image *, SDL_Rect *);
+int pack_image_in_atlas(struct image *);
+void release_atlas_image(struct image *);
+int get_image_atlas_usage(int *, int *);
+
+// image_batch.c
+void image_batch_add_quad(unsigned int, const float[4], int, float, float, float, float, float, float, float, float);
+void image_batch_flush(struct image_batch_backend *);
+void image_batch_forget_textures(void);
+
+// image_decoder.c
+int queue_image_decoding(const char *);
+int image_decoder_busy(void);
+int take_decoded_image(const char *, SDL_Surface **, char *, size_t);
+void release_unrenewed_images(void);
+void stop_image_decoder(void);
+
+// sdl_compositor.c
+void stop_sdl_compositor(void);
+int sdl_compositor_thread_count(void);
+int sdl_compositor_can_blend(SDL_Surface *);
+void sdl_compositor_blit(SDL_Surface *, SDL_Rect *, int, int, const float[4], int);
+void sdl_compositor_flush(void);
+
 // obstacle.c
 struct obstacle *add_obstacle(struct level *, float , float, int);
 struct obstacle *add_obstacle_nocheck(struct level *, float , float, int);
@@ -95,19 +95,10 @@ static void quest_browser_append_mission_info(const char *mis_name, int full_des
 */
 static void calculate_level_explored(int levelnum, int *num_squares_seen, int *num_squares_exist)
 {
-	int x = 0;
-	int y = 0;
 	level *automap_level = curShip.AllLevels[levelnum];
 
-	for (y = 0; y < automap_level->ylen; y++) {
-		for (x = 0; x < automap_level->xlen; x++) {
-			if (Me.Automap[levelnum][y][x] & SQUARE_SEEN_AT_ALL_BIT) {
-				*num_squares_seen = *num_squares_seen + 1;
-			}
-		}
-	}
-
-	*num_squares_exist = *num_squares_exist + (x * y);
+	*num_squares_seen = *num_squares_seen + automap_count_seen_squares(levelnum);
+	*num_squares_exist = *num_squares_exist + (automap_level->xlen * automap_level->ylen);
 	return; 
 }
 
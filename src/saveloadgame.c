@@ -340,7 +340,11 @@ static int load_saved_game(int use_backup)
 	char ship_filepath[PATH_MAX];
 	char sav_filepath[PATH_MAX];
 
+	// LoadShip() generates the random dungeons in the background. Every
+	// return path waits for them (see wait_for_dungeons()), so that they are
+	// not still being generated while the game state is cleared or reloaded.
 	if (!strlen(data_dirs[CONFIG_DIR].path)) {
+		wait_for_dungeons();
 		return OK;
 	}
 
@@ -356,6 +360,7 @@ static int load_saved_game(int use_backup)
 	if (!find_file(ship_filepath, CONFIG_DIR, Me.character_name, (use_backup) ? ".bkp.shp" : ".shp", SILENT) ||
 		!find_file(sav_filepath, CONFIG_DIR, Me.character_name, (use_backup) ? ".bkp"SAVEDGAME_EXT : SAVEDGAME_EXT, SILENT)) {
 		alert_window(_("No saved game found."));
+		wait_for_dungeons();
 		return ERR;
 	}
 
@@ -379,6 +384,7 @@ static int load_saved_game(int use_backup)
 	if (inflate_stream(data_file, (unsigned char **)&game_data, &loaded_size)) {
 		fclose(data_file);
 		alert_window(_("Unable to decompress saved game - this is probably a very old, incompatible game. Sorry."));
+		wait_for_dungeons();
 		return ERR;
 	}
 	fclose(data_file);
@@ -412,13 +418,17 @@ static int load_saved_game(int use_backup)
 		if (game_data != NULL)
 			free((char *)game_data);
 		game_data = NULL;
+		wait_for_dungeons();
 		return (ERR);
 	}
 
+	wait_for_dungeons();
 	load_game_data(game_data);
 	free(game_data);
 	game_data = NULL;
 
+	invalidate_character_stats();
+
 	/*
 	 * Post-loading: Some transient states have to be adapted
 	**/
@@ -326,58 +326,169 @@ void write_SDL_Rect(struct auto_string *strout, SDL_Rect *data)
  * Read an automap.
  * \ingroup userrw
  *
- * An automap is a 100x100 array of bytes (actually, these are 'chars' used to
- * contain byte values). To speed-up the reading of an automap, it is saved as
- * 100 strings of chars.
+ * An automap is saved as its level size and one run-length encoded string
+ * per bitplane (see write_automap_data_t). An empty table means that the
+ * level was never explored.
+ * Old savegames stored a 100x100 array of bytes, saved as 100 strings of
+ * chars. They are still read, the automap is then cropped to the actual size
+ * of the level on its first use.
  * \param L     Current Lua State
  * \param index Lua stack index of the data
  * \param data  Pointer to the resulting data storage
  */
 void read_automap_data_t(lua_State *L, int index, automap_data_t *data)
 {
-	// See write_automap_data_t for more information about the conversion
-	// from ascii char value to byte value.
+	int i, j, plane, words;
+
 	lua_is_of_type_or_abort(L, index, LUA_TTABLE);
-	int i, j;
-	for (i = 0; i < 100; i++) {
-		lua_rawgeti(L, index, i+1);
+
+	free(data->planes);
+	data->planes = NULL;
+	data->xlen = 0;
+	data->ylen = 0;
+
+	if (lua_rawlen(L, index) != 0) {
+		// Old 100x100 byte array. Each byte value was converted to an ascii
+		// char by adding a '0'.
+		uint32_t *planes = MyMalloc(AUTOMAP_NB_PLANES * AUTOMAP_PLANE_WORDS(100, 100) * sizeof(uint32_t));
+		int empty = TRUE;
+
+		for (i = 0; i < 100; i++) {
+			lua_rawgeti(L, index, i+1);
+			lua_is_of_type_or_abort(L, -1, LUA_TSTRING);
+			char *line = (char *)lua_tostring(L, -1);
+			for (j = 0; j < 100; j++) {
+				int idx = j + i * 100;
+				int value = line[j] - '0';
+				for (plane = 0; plane < AUTOMAP_NB_PLANES; plane++) {
+					if (value & (1 << plane)) {
+						planes[plane * AUTOMAP_PLANE_WORDS(100, 100) + (idx >> 5)] |= 1u << (idx & 31);
+						empty = FALSE;
+					}
+				}
+			}
+			lua_pop(L, 1);
+		}
+
+		if (empty) {
+			free(planes);
+			return;
+		}
+
+		data->planes = planes;
+		data->xlen = 100;
+		data->ylen = 100;
+		return;
+	}
+
+	lua_getfield(L, index, "xlen");
+	if (lua_isnil(L, -1)) {
+		lua_pop(L, 1);
+		return;
+	}
+	read_int32_t(L, -1, &data->xlen);
+	lua_pop(L, 1);
+	if (lua_getfield_or_warn(L, index, "ylen")) {
+		read_int32_t(L, -1, &data->ylen);
+		lua_pop(L, 1);
+	}
+
+	int nb_bits = data->xlen * data->ylen;
+	words = AUTOMAP_PLANE_WORDS(data->xlen, data->ylen);
+	data->planes = MyMalloc(AUTOMAP_NB_PLANES * words * sizeof(uint32_t));
+
+	if (!lua_getfield_or_warn(L, index, "planes"))
+		return;
+	lua_is_of_type_or_abort(L, -1, LUA_TTABLE);
+
+	for (plane = 0; plane < AUTOMAP_NB_PLANES; plane++) {
+		lua_rawgeti(L, -1, plane + 1);
+		if (lua_isnil(L, -1)) {
+			lua_pop(L, 1);
+			break;
+		}
 		lua_is_of_type_or_abort(L, -1, LUA_TSTRING);
-		char *line = (char *)lua_tostring(L, -1);
-		for (j = 0; j < 100; j++) {
-			(*data)[i][j] = (char)(line[j] - '0');
+
+		// Runs of alternating clear and set bits, starting with clear bits.
+		uint32_t *bits = data->planes + plane * words;
+		const char *ptr = lua_tostring(L, -1);
+		char *end;
+		int pos = 0;
+		int set = FALSE;
+		long run;
+
+		while (TRUE) {
+			run = strtol(ptr, &end, 10);
+			if (end == ptr)
+				break;
+			ptr = end;
+			if (run > nb_bits - pos)
+				run = nb_bits - pos;
+			if (set) {
+				for (i = pos; i < pos + run; i++)
+					bits[i >> 5] |= 1u << (i & 31);
+			}
+			pos += run;
+			set = !set;
 		}
+
 		lua_pop(L, 1);
 	}
+
+	lua_pop(L, 1);
 }
 
 /**
  * Write an automap.
  * \ingroup userrw
  *
- * An automap is a 100x100 array of bytes (actually, these are 'chars' used to
- * contain byte values). To speed-up the reading of an automap, it is saved as
- * 100 strings of chars.
+ * Only the automap of explored levels is saved. Each bitplane is written
+ * as a string of run lengths, alternately of clear and set bits, starting
+ * with clear bits. Trailing clear bits are not written.
  * \param strout The auto_string to be filled
  * \param data   Pointer to the data to write
  */
 void write_automap_data_t(struct auto_string *strout, automap_data_t *data)
 {
-	// Each byte value is converted to a printable ascii char by adding a '0'
-	// ascii value (48). This only works as long as the resulting value is a
-	// printable one (< 127). The byte value must then be less than 79.
-	// TODO : do we abort or do we clamp, in such a case ??? Or do we use
-	// a base64-like representation ?
-
-	int i, j;
-	autostr_append(savestruct_autostr, "{\n");
-	for (i = 0; i < 100; i++) {
-		char line[101];
-		for (j = 0; j < 100; j++)
-			line[j] = (char)((*data)[i][j] + '0');
-		line[100] = '\0';
-		autostr_append(strout, "\"%s\",\n", line);
+	int plane, i;
+
+	if (!data->planes) {
+		autostr_append(strout, "{}");
+		return;
 	}
-	autostr_append(strout, "}");
+
+	int nb_bits = data->xlen * data->ylen;
+	int words = AUTOMAP_PLANE_WORDS(data->xlen, data->ylen);
+
+	autostr_append(strout, "{\nxlen = %d,\nylen = %d,\nplanes = {\n", data->xlen, data->ylen);
+	for (plane = 0; plane < AUTOMAP_NB_PLANES; plane++) {
+		uint32_t *bits = data->planes + plane * words;
+		int set = FALSE;
+		int run = 0;
+
+		autostr_append(strout, "\"");
+		for (i = 0; i < nb_bits; i++) {
+			if (!(bits[i >> 5] & ~((1u << (i & 31)) - 1)) && !set) {
+				// Skip the clear bits of the rest of the word at once
+				int next = (i | 31) + 1;
+				if (next > nb_bits)
+					next = nb_bits;
+				run += next - i;
+				i = next - 1;
+				continue;
+			}
+			if (((bits[i >> 5] >> (i & 31)) & 1) != set) {
+				autostr_append(strout, "%d ", run);
+				set = !set;
+				run = 0;
+			}
+			run++;
+		}
+		if (set)
+			autostr_append(strout, "%d", run);
+		autostr_append(strout, "\",\n");
+	}
+	autostr_append(strout, "}\n}");
 }
 
 /**
@@ -0,0 +1,573 @@
+/*
+ *
+ *   Copyright (c) 2026 FreedroidRPG development team
+ *
+ *
+ *  This file is part of Freedroid
+ *
+ *  Freedroid is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Freedroid is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Freedroid; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ *  MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file sdl_compositor.c
+ * \brief Compositing of the image batches on a pool of threads, in SDL mode.
+ *
+ * In SDL mode, the images drawn during an image batch are recorded, and are
+ * only blended on the screen when the batch ends.
+ *
+ * The screen is then split into horizontal bands, the recorded blits are
+ * binned into the bands they cover, and the bands are composited by the
+ * threads of the pool (the main thread included), each band drawing its
+ * blits in the order they were recorded. The color filter and the highlight
+ * of the images are applied while blending, so that no colored copy of the
+ * images has to be created.
+ *
+ * Only 32 bits surfaces with an alpha channel, and the same color channels
+ * as the screen, can be blended that way. The other ones are blitted by SDL,
+ * once all the blits recorded before them are done.
+ */
+
+#define _sdl_compositor_c 1
+
+#include "system.h"
+
+#include "defs.h"
+#include "struct.h"
+#include "global.h"
+#include "proto.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#define SDL_COMPOSITOR_MAX_THREADS 8
+
+// The screen is split into more bands than there are threads, so that the
+// threads having the least to draw can take the remaining bands
+#define BANDS_PER_THREAD 4
+#define MIN_BAND_HEIGHT 16
+#define MAX_BANDS (SDL_COMPOSITOR_MAX_THREADS * BANDS_PER_THREAD)
+
+// Below this number of pixels, the blits are composited by the main thread
+// alone, waking up the other threads would cost more than it saves
+#define PARALLEL_MIN_PIXELS (64 * 1024)
+
+struct sdl_blit {
+	SDL_Surface *surface;       // Source surface (a reference is held until the blit is done)
+	SDL_Rect src;               // Part of the surface to draw, clipped if blended by us
+	SDL_Rect dst;               // Position on the screen, clipped if blended by us
+	SDL_Rect clip;              // Clip rectangle of the screen, for the blits done by SDL
+	Uint16 tint[4];             // Factor of each byte of the pixels, 256 being 1.0
+	Uint16 add[4];              // Value added to each byte of the pixels, after the tint
+	int alpha_lane;             // Byte of the pixels holding the alpha value
+	int opaque;                 // TRUE if the alpha channel is to be ignored
+	int tinted;
+	int composite;              // FALSE if the blit is done by SDL
+};
+
+struct blend_row_params {
+	const Uint16 *tint;
+	const Uint16 *add;
+	int alpha_lane;
+	int opaque;
+	int tinted;
+	Uint32 rgb_mask;            // Bytes of the screen pixels to write
+};
+
+static struct {
+	struct dynarray blits;
+	struct dynarray bins[MAX_BANDS];     // Indices of the blits covering each band
+	int band_height;
+	int initialized;
+} comp;
+
+static struct {
+	SDL_mutex *lock;
+	SDL_cond *wakeup;                    // Signaled when bands are to be composited
+	SDL_cond *done;                      // Signaled when the last band is composited
+	SDL_Thread *threads[SDL_COMPOSITOR_MAX_THREADS];
+	int nb_threads;
+	int next_band;
+	int nb_bands;
+	int bands_done;
+	int started;
+	int quit;
+} pool;
+
+/*
+ * Blend a row of pixels: d = s * a + d * (1 - a), rounded, on the color
+ * bytes of the screen. The other byte of the screen pixels is kept.
+ */
+static void blend_row_c(Uint32 *dst, const Uint32 *src, int n, const struct blend_row_params *p)
+{
+	int i, k;
+
+	for (i = 0; i < n; i++) {
+		Uint32 s = src[i], d = dst[i], r = 0;
+		unsigned int lanes[4];
+		unsigned int a;
+
+		for (k = 0; k < 4; k++) {
+			lanes[k] = (s >> (8 * k)) & 0xff;
+			if (p->tinted)
+				lanes[k] = min(((lanes[k] * p->tint[k]) >> 8) + p->add[k], 255);
+		}
+
+		a = p->opaque ? 255 : lanes[p->alpha_lane];
+		if (!a)
+			continue;
+
+		for (k = 0; k < 4; k++) {
+			unsigned int v = lanes[k] * a + ((d >> (8 * k)) & 0xff) * (255 - a);
+			r |= ((v + 1 + (v >> 8)) >> 8) << (8 * k);
+		}
+
+		dst[i] = (r & p->rgb_mask) | (d & ~p->rgb_mask);
+	}
+}
+
+#ifdef __SSE2__
+/*
+ * Same as blend_row_c(), 4 pixels at a time.
+ */
+static void blend_row_sse2(Uint32 *dst, const Uint32 *src, int n, const struct blend_row_params *p)
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(1);
+	const __m128i c255 = _mm_set1_epi16(255);
+	const __m128i byte_mask = _mm_set1_epi32(0xff);
+	const __m128i rgb = _mm_set1_epi32(p->rgb_mask);
+	const __m128i tint = _mm_set_epi16(p->tint[3], p->tint[2], p->tint[1], p->tint[0], p->tint[3], p->tint[2], p->tint[1], p->tint[0]);
+	const __m128i add = _mm_set_epi16(p->add[3], p->add[2], p->add[1], p->add[0], p->add[3], p->add[2], p->add[1], p->add[0]);
+	const __m128i alpha_shift = _mm_cvtsi32_si128(8 * p->alpha_lane);
+	int i;
+
+	for (i = 0; i + 4 <= n; i += 4) {
+		__m128i s = _mm_loadu_si128((const __m128i *)(src + i));
+		__m128i slo = _mm_unpacklo_epi8(s, zero);
+		__m128i shi = _mm_unpackhi_epi8(s, zero);
+		__m128i alo, ahi;
+
+		if (p->tinted) {
+			slo = _mm_min_epi16(_mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(slo, tint), 8), add), c255);
+			shi = _mm_min_epi16(_mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(shi, tint), 8), add), c255);
+			s = _mm_packus_epi16(slo, shi);
+		}
+
+		if (p->opaque) {
+			alo = ahi = c255;
+		} else {
+			__m128i a = _mm_and_si128(_mm_srl_epi32(s, alpha_shift), byte_mask);
+			if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, zero)) == 0xffff)
+				continue;
+			a = _mm_or_si128(a, _mm_slli_epi32(a, 8));
+			a = _mm_or_si128(a, _mm_slli_epi32(a, 16));
+			alo = _mm_unpacklo_epi8(a, zero);
+			ahi = _mm_unpackhi_epi8(a, zero);
+		}
+
+		__m128i d = _mm_loadu_si128((const __m128i *)(dst + i));
+		__m128i dlo = _mm_unpacklo_epi8(d, zero);
+		__m128i dhi = _mm_unpackhi_epi8(d, zero);
+
+		// At most 255 * 255, which fits in the unsigned 16 bits lanes
+		__m128i rlo = _mm_add_epi16(_mm_mullo_epi16(slo, alo), _mm_mullo_epi16(dlo, _mm_sub_epi16(c255, alo)));
+		__m128i rhi = _mm_add_epi16(_mm_mullo_epi16(shi, ahi), _mm_mullo_epi16(dhi, _mm_sub_epi16(c255, ahi)));
+		rlo = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rlo, one), _mm_srli_epi16(rlo, 8)), 8);
+		rhi = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(rhi, one), _mm_srli_epi16(rhi, 8)), 8);
+
+		__m128i r = _mm_packus_epi16(rlo, rhi);
+		r = _mm_or_si128(_mm_and_si128(r, rgb), _mm_andnot_si128(rgb, d));
+		_mm_storeu_si128((__m128i *)(dst + i), r);
+	}
+
+	blend_row_c(dst + i, src + i, n - i, p);
+}
+#endif
+
+/*
+ * Blend the rows of a blit which are in [y0, y1[.
+ */
+static void composite_blit(struct sdl_blit *b, int y0, int y1)
+{
+	struct blend_row_params params = { .tint = b->tint, .add = b->add, .alpha_lane = b->alpha_lane,
+	                                   .opaque = b->opaque, .tinted = b->tinted,
+	                                   .rgb_mask = Screen->format->Rmask | Screen->format->Gmask | Screen->format->Bmask };
+	int top = max(b->dst.y, y0);
+	int bottom = min(b->dst.y + b->dst.h, y1);
+	int y;
+
+	for (y = top; y < bottom; y++) {
+		const Uint32 *s = (const Uint32 *)((Uint8 *)b->surface->pixels + (b->src.y + y - b->dst.y) * b->surface->pitch) + b->src.x;
+		Uint32 *d = (Uint32 *)((Uint8 *)Screen->pixels + y * Screen->pitch) + b->dst.x;
+#ifdef __SSE2__
+		blend_row_sse2(d, s, b->dst.w, &params);
+#else
+		blend_row_c(d, s, b->dst.w, &params);
+#endif
+	}
+}
+
+static void composite_band(int band)
+{
+	struct sdl_blit *blits = comp.blits.arr;
+	int *indices = comp.bins[band].arr;
+	int y0 = band * comp.band_height;
+	int y1 = min(y0 + comp.band_height, Screen->h);
+	int i;
+
+	for (i = 0; i < comp.bins[band].size; i++)
+		composite_blit(&blits[indices[i]], y0, y1);
+}
+
+/*
+ * Compositor threads' main loop.
+ * Take the next band to composite, until all the bands are done.
+ */
+static int sdl_compositor_thread(void *data)
+{
+	SDL_LockMutex(pool.lock);
+	while (TRUE) {
+		while (pool.next_band >= pool.nb_bands && !pool.quit)
+			SDL_CondWait(pool.wakeup, pool.lock);
+		if (pool.quit)
+			break;
+
+		int band = pool.next_band++;
+		SDL_UnlockMutex(pool.lock);
+
+		composite_band(band);
+
+		SDL_LockMutex(pool.lock);
+		if (++pool.bands_done == pool.nb_bands)
+			SDL_CondSignal(pool.done);
+	}
+	SDL_UnlockMutex(pool.lock);
+
+	return 0;
+}
+
+static int sdl_compositor_cpu_count(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+	long nb_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	if (nb_cpus > 0)
+		return min(nb_cpus, SDL_COMPOSITOR_MAX_THREADS);
+#endif
+	return 1;
+}
+
+/*
+ * Start the compositor threads.
+ * The main thread composites bands too, so one thread less than the number
+ * of CPUs is started. If no thread can be created, the main thread does
+ * everything.
+ */
+static void sdl_compositor_start(void)
+{
+	int nb_threads = sdl_compositor_cpu_count() - 1;
+	int i;
+
+	pool.started = TRUE;
+
+	if (nb_threads <= 0)
+		return;
+
+	pool.next_band = pool.nb_bands = pool.bands_done = 0;
+	pool.quit = FALSE;
+	pool.lock = SDL_CreateMutex();
+	pool.wakeup = SDL_CreateCond();
+	pool.done = SDL_CreateCond();
+	if (!pool.lock || !pool.wakeup || !pool.done)
+		return;
+
+	for (i = 0; i < nb_threads; i++) {
+		SDL_Thread *thread = SDL_CreateThread(sdl_compositor_thread, NULL);
+		if (thread)
+			pool.threads[pool.nb_threads++] = thread;
+	}
+
+	if (!pool.nb_threads) {
+		error_message(__FUNCTION__, "Could not create the compositor threads: %s\n"
+		              "Images will be drawn by the main thread only.",
+		              NO_REPORT, SDL_GetError());
+	}
+}
+
+/**
+ * Stop the compositor threads. They are started again by the next
+ * compositing needing them.
+ */
+void stop_sdl_compositor(void)
+{
+	int i;
+
+	if (pool.nb_threads) {
+		SDL_LockMutex(pool.lock);
+		pool.quit = TRUE;
+		SDL_CondBroadcast(pool.wakeup);
+		SDL_UnlockMutex(pool.lock);
+		for (i = 0; i < pool.nb_threads; i++)
+			SDL_WaitThread(pool.threads[i], NULL);
+		pool.nb_threads = 0;
+	}
+
+	if (pool.done)
+		SDL_DestroyCond(pool.done);
+	if (pool.wakeup)
+		SDL_DestroyCond(pool.wakeup);
+	if (pool.lock)
+		SDL_DestroyMutex(pool.lock);
+	pool.done = NULL;
+	pool.wakeup = NULL;
+	pool.lock = NULL;
+	pool.started = FALSE;
+}
+
+/**
+ * Get the number of threads compositing the images, the main thread
+ * included.
+ */
+int sdl_compositor_thread_count(void)
+{
+	if (!pool.started)
+		sdl_compositor_start();
+
+	return pool.nb_threads + 1;
+}
+
+/*
+ * Composite the blits in [first, last[, which are all blended by us.
+ */
+static void composite_blits(int first, int last)
+{
+	struct sdl_blit *blits = comp.blits.arr;
+	int nb_pixels = 0;
+	int nb_bands;
+	int i, band;
+
+	for (i = first; i < last; i++)
+		nb_pixels += blits[i].dst.w * blits[i].dst.h;
+
+	if (!pool.started && nb_pixels >= PARALLEL_MIN_PIXELS)
+		sdl_compositor_start();
+
+	if (!pool.nb_threads || nb_pixels < PARALLEL_MIN_PIXELS) {
+		for (i = first; i < last; i++)
+			composite_blit(&blits[i], 0, Screen->h);
+		return;
+	}
+
+	// Bin the blits into the bands they cover, keeping their order
+	nb_bands = min((pool.nb_threads + 1) * BANDS_PER_THREAD, MAX_BANDS);
+	comp.band_height = max(MIN_BAND_HEIGHT, (Screen->h + nb_bands - 1) / nb_bands);
+	nb_bands = (Screen->h + comp.band_height - 1) / comp.band_height;
+
+	for (band = 0; band < nb_bands; band++)
+		comp.bins[band].size = 0;
+
+	for (i = first; i < last; i++) {
+		int first_band = blits[i].dst.y / comp.band_height;
+		int last_band = (blits[i].dst.y + blits[i].dst.h - 1) / comp.band_height;
+		for (band = first_band; band <= last_band; band++)
+			dynarray_add(&comp.bins[band], &i, sizeof(int));
+	}
+
+	// Composite the bands, the main thread taking its share
+	SDL_LockMutex(pool.lock);
+	pool.nb_bands = nb_bands;
+	pool.next_band = 0;
+	pool.bands_done = 0;
+	SDL_CondBroadcast(pool.wakeup);
+
+	while (pool.next_band < pool.nb_bands) {
+		band = pool.next_band++;
+		SDL_UnlockMutex(pool.lock);
+
+		composite_band(band);
+
+		SDL_LockMutex(pool.lock);
+		pool.bands_done++;
+	}
+
+	while (pool.bands_done < pool.nb_bands)
+		SDL_CondWait(pool.done, pool.lock);
+	SDL_UnlockMutex(pool.lock);
+}
+
+/*
+ * Blit a surface with SDL, using the clip rectangle the screen had when the
+ * blit was recorded.
+ */
+static void sdl_blit(struct sdl_blit *b)
+{
+	SDL_Rect old_clip;
+	SDL_Rect dst = b->dst;
+
+	SDL_GetClipRect(Screen, &old_clip);
+	SDL_SetClipRect(Screen, &b->clip);
+	SDL_BlitSurface(b->surface, &b->src, Screen, &dst);
+	SDL_SetClipRect(Screen, &old_clip);
+}
+
+/**
+ * Check if a surface can be blended by the compositor. The color filter
+ * and the highlight can only be applied to those surfaces.
+ */
+int sdl_compositor_can_blend(SDL_Surface *surface)
+{
+	SDL_PixelFormat *fmt = surface->format;
+	SDL_PixelFormat *screen_fmt = Screen->format;
+
+	if (fmt->BytesPerPixel != 4 || screen_fmt->BytesPerPixel != 4 || !fmt->Amask)
+		return FALSE;
+
+	if (fmt->Rmask != screen_fmt->Rmask || fmt->Gmask != screen_fmt->Gmask || fmt->Bmask != screen_fmt->Bmask)
+		return FALSE;
+
+	// RLE encoded surfaces are decoded by sdl_compositor_blit(), the other
+	// surfaces needing to be locked are left to SDL
+	return !surface->offset && !(surface->flags & (SDL_HWSURFACE | SDL_ASYNCBLIT | SDL_SRCCOLORKEY));
+}
+
+static Uint16 tint_factor(float c)
+{
+	if (c <= 0.0)
+		return 0;
+	if (c >= 1.0)
+		return 256;
+	return (Uint16)(c * 256);
+}
+
+/**
+ * Record the blit of a surface on the screen. It is done by the next call
+ * to sdl_compositor_flush().
+ *
+ * \param surface   Surface to blit
+ * \param src_rect  Part of the surface to blit, NULL for the whole surface
+ * \param color     Color to multiply the pixels with, must be white if the
+ *                  surface can not be blended by the compositor
+ * \param highlight TRUE to lighten the pixels
+ */
+void sdl_compositor_blit(SDL_Surface *surface, SDL_Rect *src_rect, int x, int y, const float color[4], int highlight)
+{
+	struct sdl_blit b = { .surface = surface };
+	SDL_Rect src = { 0, 0, surface->w, surface->h };
+	SDL_Rect clip;
+
+	if (!comp.initialized) {
+		int band;
+		dynarray_init(&comp.blits, 1024, sizeof(struct sdl_blit));
+		for (band = 0; band < MAX_BANDS; band++)
+			dynarray_init(&comp.bins[band], 256, sizeof(int));
+		comp.initialized = TRUE;
+	}
+
+	if (src_rect)
+		src = *src_rect;
+
+	SDL_GetClipRect(Screen, &clip);
+
+	b.composite = sdl_compositor_can_blend(surface);
+	if (!b.composite) {
+		b.src = src;
+		b.dst.x = x;
+		b.dst.y = y;
+		b.clip = clip;
+	} else {
+		int left = max(x, clip.x);
+		int top = max(y, clip.y);
+		int right = min(x + src.w, clip.x + clip.w);
+		int bottom = min(y + src.h, clip.y + clip.h);
+		if (right <= left || bottom <= top)
+			return;
+
+		b.src.x = src.x + left - x;
+		b.src.y = src.y + top - y;
+		b.src.w = b.dst.w = right - left;
+		b.src.h = b.dst.h = bottom - top;
+		b.dst.x = left;
+		b.dst.y = top;
+
+		SDL_PixelFormat *fmt = surface->format;
+		b.alpha_lane = fmt->Ashift / 8;
+		b.opaque = !(surface->flags & SDL_SRCALPHA);
+		b.tint[fmt->Rshift / 8] = tint_factor(color[0]);
+		b.tint[fmt->Gshift / 8] = tint_factor(color[1]);
+		b.tint[fmt->Bshift / 8] = tint_factor(color[2]);
+		b.tint[fmt->Ashift / 8] = tint_factor(color[3]);
+		b.add[fmt->Rshift / 8] = b.add[fmt->Gshift / 8] = b.add[fmt->Bshift / 8] = highlight ? 64 : 0;
+		b.add[fmt->Ashift / 8] = 0;
+		b.tinted = highlight || color[0] != 1.0 || color[1] != 1.0 || color[2] != 1.0 || color[3] != 1.0;
+
+		// The pixels of an RLE encoded surface are only available while it
+		// is locked, decode it once for all
+		if (surface->flags & SDL_RLEACCEL)
+			SDL_SetAlpha(surface, surface->flags & SDL_SRCALPHA, surface->format->alpha);
+	}
+
+	surface->refcount++;
+	dynarray_add(&comp.blits, &b, sizeof(struct sdl_blit));
+}
+
+/**
+ * Do all the recorded blits.
+ */
+void sdl_compositor_flush(void)
+{
+	struct sdl_blit *blits = comp.blits.arr;
+	int locked = FALSE;
+	int first = 0;
+	int i;
+
+	if (!comp.initialized || !comp.blits.size)
+		return;
+
+	for (i = 0; i <= comp.blits.size; i++) {
+		if (i < comp.blits.size && blits[i].composite)
+			continue;
+
+		// Blend the blits recorded since the last blit done by SDL
+		if (i > first) {
+			if (SDL_MUSTLOCK(Screen) && !locked) {
+				if (SDL_LockSurface(Screen) < 0)
+					break;
+				locked = TRUE;
+			}
+			composite_blits(first, i);
+		}
+
+		if (i < comp.blits.size) {
+			if (locked) {
+				SDL_UnlockSurface(Screen);
+				locked = FALSE;
+			}
+			sdl_blit(&blits[i]);
+		}
+
+		first = i + 1;
+	}
+
+	if (locked)
+		SDL_UnlockSurface(Screen);
+
+	for (i = 0; i < comp.blits.size; i++)
+		SDL_FreeSurface(blits[i].surface);
+	comp.blits.size = 0;
+}
+
+#undef _sdl_compositor_c
@@ -84,6 +84,7 @@ void ImproveSkill(int *skill)
 	if (*skill >= NUMBER_OF_SKILL_LEVELS - 1)
 		return;
 	(*skill)++;
+	invalidate_character_stats();
 };				// void ImproveSkill ( int * skill )
 
 /**
@@ -389,6 +390,7 @@ int do_skill(int skill_index, int spell_cost)
 		Me.invisible_duration += strcmp(SpellSkillMap[skill_index].effect, "invisibility") ? 0 : effdur;
 		Me.nmap_duration += strcmp(SpellSkillMap[skill_index].effect, "nmap") ? 0 : effdur;
 		Me.light_bonus_end_date = Me.current_game_date + (strcmp(SpellSkillMap[skill_index].effect, "light") ? 0 : effdur);
+		invalidate_character_stats();
 		return 1;
 
 	case PROGRAM_FORM_BULLET:
@@ -35,6 +35,7 @@
 #include "struct.h"
 #include "global.h"
 #include "proto.h"
+#include "rtprof.h"
 
 // Number of slots in the SFX cache
 #define MAX_SOUNDS_IN_SFX_CACHE 100
@@ -46,6 +47,11 @@
 #define MUSIC_FADE_INOUT 1000
 // Max number of times a same sound is played
 #define MAX_SOUND_OVERLAPPING 6
+// Max delay (in ms) between the request to play a sound and the end of its
+// decoding, after which the sound is no more worth being played
+#define MAX_SFX_DEFER_DELAY 150
+// Max number of sounds waiting to be decoded (or waiting to be collected)
+#define SOUND_DECODER_QUEUE_SIZE 32
 
 #ifndef WITH_SOUND
 
@@ -55,6 +61,7 @@
 
 void init_audio(void) {}
 void close_audio(void) {}
+void update_audio(void) {}
 void set_music_volume(float volume) {}
 void set_SFX_volume(float volume) {}
 void switch_background_music(char *filename) {}
@@ -77,6 +84,9 @@ static char *music_filename = NULL;      // The background music to play (once t
 static Mix_Music *loaded_music = NULL;   // Keep reference to previously loaded background music
 
 static int voice_channel[] = { -1, -1 }; // [0] is currently playing voice, [1] is a possible fading out voice
+static int voice_id = 0;                 // Identifier of the current voice, as returned by play_voice()
+static int voice_loading = FALSE;        // TRUE while the current voice is being decoded
+static int voice_paused = FALSE;         // TRUE if the current voice is to be started paused, once decoded
 
 ////////////////////////////////////////////////////////////////////
 // SFX cache
@@ -88,6 +98,15 @@ struct sound_cache {
 		int play_counter;              // Number of simultaneous play of the chunk
 		uint32_t last_used;            // Last time the chunk was played
 		char *sound_name;              // Filename of the sound chunk (allocated)
+		int loading;                   // TRUE while the sound chunk is being decoded
+		struct deferred_play {
+			int pending;               // TRUE if the sound is to be played once decoded
+			uint32_t requested;        // Time of the play request
+			float volume;              // Volume ratio to apply
+			int positional;            // TRUE if a positional effect is to be applied
+			Sint16 angle;              // Positional effect's angle
+			Uint8 distance;            // Positional effect's distance
+		} deferred;
 	} slots[MAX_SOUNDS_IN_SFX_CACHE];
 	int next_free_slot;                // Index of the first free slot (when all slots are not filled)
 };
@@ -106,6 +125,8 @@ static void _SFX_cache_init(void)
 		slot->last_used = 0;
 		slot->play_counter = 0;
 		slot->sound_name = NULL;
+		slot->loading = FALSE;
+		slot->deferred.pending = FALSE;
 	}
 	SFX_cache.next_free_slot = 0;
 }
@@ -122,8 +143,11 @@ static void _SFX_cache_free_slot(int index)
 	slot->play_counter = 0;
 	free(slot->sound_name);
 	slot->sound_name = NULL;
-	Mix_FreeChunk(slot->chunk);
+	if (slot->chunk)
+		Mix_FreeChunk(slot->chunk);
 	slot->chunk = NULL;
+	slot->loading = FALSE;
+	slot->deferred.pending = FALSE;
 }
 
 /*
@@ -142,7 +166,8 @@ static void _SFX_cache_clear(void)
 /*
  * Find an unused SFX cache slot, and return its index.
  * When the cache is full, find the least recently used inactive slot and
- * free it ("inactive" means that the stored chunk is not currently played).
+ * free it ("inactive" means that the stored chunk is not currently played,
+ * nor being decoded).
  * If no slot is found, warn and return -1.
  */
 static int _SFX_cache_allocate_slot(void)
@@ -157,14 +182,15 @@ static int _SFX_cache_allocate_slot(void)
 	int least_recently_used_index = -1;
 
 	for (i = 0; i < SFX_cache.next_free_slot; i++) {
-		if (SFX_cache.slots[i].play_counter == 0 && SFX_cache.slots[i].last_used < least_recently_used) {
+		if (SFX_cache.slots[i].play_counter == 0 && !SFX_cache.slots[i].loading &&
+		    SFX_cache.slots[i].last_used < least_recently_used) {
 			least_recently_used = SFX_cache.slots[i].last_used;
 			least_recently_used_index = i;
 		}
 	}
 
 	// No inactive slot found
-	if (least_recently_used == -1) {
+	if (least_recently_used_index == -1) {
 		error_once_message(ONCE_PER_GAME, __FUNCTION__,
 			"Could not find an inactive slot to remove from SFX cache.\n",
 			PLEASE_INFORM);
@@ -178,16 +204,19 @@ static int _SFX_cache_allocate_slot(void)
 }
 
 /*
- * Fill a cache slot with the sound filename and sound chunk to cache.
+ * Fill a cache slot with the sound filename, and mark it as being decoded.
+ * The sound chunk is set by _sound_decoder_collect(), once decoded.
  */
-static void _SFX_cache_fill_slot(int index, const char *filename, Mix_Chunk *wav_chunk)
+static void _SFX_cache_fill_slot(int index, const char *filename)
 {
 	struct sound_cache_slot *slot = &SFX_cache.slots[index];
 
-	slot->last_used = 0;
+	slot->last_used = SDL_GetTicks();
 	slot->play_counter = 0;
 	slot->sound_name = my_strdup((char *)filename);
-	slot->chunk = wav_chunk;
+	slot->chunk = NULL;
+	slot->loading = TRUE;
+	slot->deferred.pending = FALSE;
 }
 
 /*
@@ -234,13 +263,14 @@ static int _SFX_cache_find_filename(const char *filename)
 
 /*
  * Find a cache slot given a pointer to a sound chunk, and return its index.
+ * Slots with no chunk (being decoded, or which failed to be decoded) never match.
  * Return -1 if the slot is not found.
  */
 static int _SFX_cache_find_chunk(Mix_Chunk *chunk)
 {
 	int i;
 	for (i = 0; i < SFX_cache.next_free_slot; i++) {
-		if (SFX_cache.slots[i].chunk == chunk) {
+		if (SFX_cache.slots[i].chunk && SFX_cache.slots[i].chunk == chunk) {
 			return i;
 		}
 	}
@@ -263,6 +293,344 @@ static int _SFX_cache_get_counter(int index)
 	return SFX_cache.slots[index].play_counter;
 }
 
+////////////////////////////////////////////////////////////////////
+// Sound decoder
+////////////////////////////////////////////////////////////////////
+
+/*
+ * Decoding a sound file can take several tens of milliseconds (and far more
+ * for a voice sound), which leads to visible hitches when done in the game
+ * loop. The decoding is thus delegated to a worker thread.
+ * Decoded chunks are collected, and their cache slot filled, by the main
+ * thread only (see _sound_decoder_collect()), so that the SFX cache does not
+ * need to be protected against concurrent accesses.
+ */
+
+enum sound_decoder_kind {
+	DECODE_SFX,
+	DECODE_VOICE
+};
+
+struct sound_decoder_request {
+	enum sound_decoder_kind kind;  // Type of the sound to decode
+	int id;                        // SFX cache slot index or voice id
+	char *fpath;                   // Full path of the sound file (allocated)
+	Mix_Chunk *chunk;              // Decoded sound chunk
+	uint32_t decode_time;          // Time spent to decode the sound (in ms)
+	char error[256];               // Error message, if the decoding failed
+};
+
+static struct sound_decoder {
+	SDL_Thread *thread;
+	SDL_mutex *lock;
+	SDL_cond *wakeup;
+	struct sound_decoder_request pending[SOUND_DECODER_QUEUE_SIZE];  // Ring buffer of requests to decode
+	int pending_first;
+	int pending_count;
+	struct sound_decoder_request done[SOUND_DECODER_QUEUE_SIZE];     // Decoded chunks, waiting to be collected
+	int done_count;
+	int in_flight;                 // Number of requests either pending, being decoded or done
+	int quit;
+} decoder;
+
+/*
+ * Decoder thread's main loop.
+ * Wait for requests, decode them, and push the result to the 'done' list.
+ */
+static int _sound_decoder_thread(void *data)
+{
+	struct sound_decoder_request req;
+
+	SDL_LockMutex(decoder.lock);
+	while (TRUE) {
+		while (!decoder.pending_count && !decoder.quit)
+			SDL_CondWait(decoder.wakeup, decoder.lock);
+		if (decoder.quit)
+			break;
+
+		req = decoder.pending[decoder.pending_first];
+		decoder.pending_first = (decoder.pending_first + 1) % SOUND_DECODER_QUEUE_SIZE;
+		decoder.pending_count--;
+		SDL_UnlockMutex(decoder.lock);
+
+		uint32_t start = SDL_GetTicks();
+		req.chunk = Mix_LoadWAV(req.fpath);
+		req.decode_time = SDL_GetTicks() - start;
+
+		// SDL errors are per thread, so the error is read here
+		req.error[0] = '\0';
+		if (!req.chunk)
+			snprintf(req.error, sizeof(req.error), "%s", Mix_GetError());
+
+		SDL_LockMutex(decoder.lock);
+		decoder.done[decoder.done_count++] = req;
+	}
+	SDL_UnlockMutex(decoder.lock);
+
+	return 0;
+}
+
+/*
+ * Start the decoder thread.
+ * If the thread can not be created, sounds will be decoded synchronously.
+ */
+static void _sound_decoder_start(void)
+{
+	memset(&decoder, 0, sizeof(decoder));
+
+	decoder.lock = SDL_CreateMutex();
+	decoder.wakeup = SDL_CreateCond();
+	if (decoder.lock && decoder.wakeup)
+		decoder.thread = SDL_CreateThread(_sound_decoder_thread, NULL);
+
+	if (!decoder.thread) {
+		error_message(__FUNCTION__, "Could not create the sound decoder thread: %s\n"
+		              "Sounds will be decoded synchronously.",
+		              NO_REPORT, SDL_GetError());
+	}
+}
+
+/*
+ * Stop the decoder thread, and free all the requests it still owns.
+ */
+static void _sound_decoder_stop(void)
+{
+	int i;
+
+	if (decoder.thread) {
+		SDL_LockMutex(decoder.lock);
+		decoder.quit = TRUE;
+		SDL_CondSignal(decoder.wakeup);
+		SDL_UnlockMutex(decoder.lock);
+		SDL_WaitThread(decoder.thread, NULL);
+		decoder.thread = NULL;
+	}
+
+	for (i = 0; i < decoder.pending_count; i++)
+		free(decoder.pending[(decoder.pending_first + i) % SOUND_DECODER_QUEUE_SIZE].fpath);
+	for (i = 0; i < decoder.done_count; i++) {
+		free(decoder.done[i].fpath);
+		if (decoder.done[i].chunk)
+			Mix_FreeChunk(decoder.done[i].chunk);
+	}
+	decoder.pending_count = 0;
+	decoder.done_count = 0;
+	decoder.in_flight = 0;
+
+	if (decoder.wakeup)
+		SDL_DestroyCond(decoder.wakeup);
+	if (decoder.lock)
+		SDL_DestroyMutex(decoder.lock);
+	decoder.wakeup = NULL;
+	decoder.lock = NULL;
+}
+
+/*
+ * Ask the decoder thread to decode a sound file.
+ * Return FALSE if the request could not be queued (no decoder thread, or
+ * queue full). The caller is then to decode the sound by itself.
+ */
+static int _sound_decoder_push(enum sound_decoder_kind kind, int id, const char *fpath)
+{
+	if (!decoder.thread || decoder.in_flight >= SOUND_DECODER_QUEUE_SIZE)
+		return FALSE;
+
+	SDL_LockMutex(decoder.lock);
+	struct sound_decoder_request *req = &decoder.pending[(decoder.pending_first + decoder.pending_count) % SOUND_DECODER_QUEUE_SIZE];
+	req->kind = kind;
+	req->id = id;
+	req->fpath = my_strdup((char *)fpath);
+	req->chunk = NULL;
+	req->decode_time = 0;
+	decoder.pending_count++;
+	decoder.in_flight++;
+	SDL_CondSignal(decoder.wakeup);
+	SDL_UnlockMutex(decoder.lock);
+
+	return TRUE;
+}
+
+static void _SFX_play_deferred(int index);
+static void _voice_start(Mix_Chunk *wav_chunk);
+
+/*
+ * Set the sound chunk of a cache slot, once it is decoded.
+ * If the sound was asked to be played while being decoded, and if it is not
+ * too late, play it now.
+ */
+static void _SFX_cache_set_chunk(int index, Mix_Chunk *wav_chunk, const char *fpath, const char *error)
+{
+	struct sound_cache_slot *slot = &SFX_cache.slots[index];
+
+	slot->loading = FALSE;
+	slot->chunk = wav_chunk;
+
+	if (!wav_chunk) {
+		// The slot is kept empty, so that we do not try again to load the file
+		error_message(__FUNCTION__, "Could not load sound file \"%s\": %s", PLEASE_INFORM, fpath, error);
+		slot->deferred.pending = FALSE;
+		return;
+	}
+
+	if (slot->deferred.pending) {
+		slot->deferred.pending = FALSE;
+		if (SDL_GetTicks() - slot->deferred.requested <= MAX_SFX_DEFER_DELAY)
+			_SFX_play_deferred(index);
+	}
+}
+
+/*
+ * Collect the sounds decoded by the decoder thread.
+ * Fill the related SFX cache slots, or start the related voice.
+ */
+static void _sound_decoder_collect(void)
+{
+	struct sound_decoder_request done[SOUND_DECODER_QUEUE_SIZE];
+	int done_count;
+	int i;
+
+	if (!decoder.thread)
+		return;
+
+	SDL_LockMutex(decoder.lock);
+	done_count = decoder.done_count;
+	memcpy(done, decoder.done, done_count * sizeof(struct sound_decoder_request));
+	decoder.done_count = 0;
+	decoder.in_flight -= done_count;
+	SDL_UnlockMutex(decoder.lock);
+
+	for (i = 0; i < done_count; i++) {
+		struct sound_decoder_request *req = &done[i];
+
+#ifdef WITH_RTPROF
+		probe_graph1D_set(decode_time, "Sound decoding time (ms)", 500, 1, req->decode_time);
+#endif
+
+		if (req->kind == DECODE_SFX) {
+			_SFX_cache_set_chunk(req->id, req->chunk, req->fpath, req->error);
+		} else if (req->id == voice_id && voice_loading) {
+			voice_loading = FALSE;
+			if (req->chunk)
+				_voice_start(req->chunk);
+			else
+				error_message(__FUNCTION__, "Could not load sound file \"%s\": %s", PLEASE_INFORM, req->fpath, req->error);
+		} else if (req->chunk) {
+			// Voice stopped or replaced while being decoded
+			Mix_FreeChunk(req->chunk);
+		}
+
+		free(req->fpath);
+	}
+}
+
+/*
+ * Read a little-endian unsigned integer of 'bytes' bytes.
+ */
+static uint64_t _read_le(const unsigned char *buf, int bytes)
+{
+	uint64_t val = 0;
+	while (bytes--)
+		val = (val << 8) | buf[bytes];
+	return val;
+}
+
+/*
+ * Compute the duration (in ms) of an Ogg/Vorbis file, without decoding it.
+ * The sample rate is read from the Vorbis identification header, and the
+ * number of samples is the granule position of the last Ogg page.
+ * Return -1 on failure.
+ */
+static float _ogg_duration(FILE *f)
+{
+	unsigned char buf[8192];
+	size_t len;
+	long rate;
+	int i;
+
+	// The identification header is the first packet of the first page
+	len = fread(buf, 1, 27 + 255 + 16, f);
+	if (len < 28 || memcmp(buf, "OggS", 4))
+		return -1;
+	int header_start = 27 + buf[26];
+	if (len < header_start + 16 || memcmp(buf + header_start, "\001vorbis", 7))
+		return -1;
+	rate = _read_le(buf + header_start + 12, 4);
+	if (rate <= 0)
+		return -1;
+
+	// Look backward for the last page header
+	if (fseek(f, 0, SEEK_END))
+		return -1;
+	long file_size = ftell(f);
+	long offset = max(0, file_size - (long)sizeof(buf));
+	if (fseek(f, offset, SEEK_SET))
+		return -1;
+	len = fread(buf, 1, sizeof(buf), f);
+	for (i = (int)len - 14; i >= 0; i--) {
+		if (!memcmp(buf + i, "OggS", 4)) {
+			uint64_t granule = _read_le(buf + i + 6, 8);
+			return 1000.0 * (float)granule / (float)rate;
+		}
+	}
+
+	return -1;
+}
+
+/*
+ * Compute the duration (in ms) of a RIFF/WAVE file, without loading it.
+ * Return -1 on failure.
+ */
+static float _wav_duration(FILE *f)
+{
+	unsigned char buf[12];
+	long byte_rate = 0;
+
+	if (fread(buf, 1, 12, f) != 12 || memcmp(buf, "RIFF", 4) || memcmp(buf + 8, "WAVE", 4))
+		return -1;
+
+	// Walk through the chunks, to find the format and the size of the data
+	while (fread(buf, 1, 8, f) == 8) {
+		long chunk_size = _read_le(buf + 4, 4);
+		if (!memcmp(buf, "fmt ", 4)) {
+			unsigned char fmt[12];
+			if (chunk_size < 12 || fread(fmt, 1, 12, f) != 12)
+				return -1;
+			byte_rate = _read_le(fmt + 8, 4);
+			chunk_size -= 12;
+		} else if (!memcmp(buf, "data", 4)) {
+			if (byte_rate <= 0)
+				return -1;
+			return 1000.0 * (float)chunk_size / (float)byte_rate;
+		}
+		if (fseek(f, chunk_size + (chunk_size & 1), SEEK_CUR))
+			return -1;
+	}
+
+	return -1;
+}
+
+/*
+ * Get the duration (in ms) of a sound file, by reading its headers.
+ * Return -1 if the duration can not be computed this way.
+ */
+static float _sound_file_duration(const char *fpath)
+{
+	float duration;
+
+	FILE *f = fopen(fpath, "rb");
+	if (!f)
+		return -1;
+
+	duration = _ogg_duration(f);
+	if (duration < 0) {
+		rewind(f);
+		duration = _wav_duration(f);
+	}
+
+	fclose(f);
+	return duration;
+}
+
 ////////////////////////////////////////////////////////////////////
 // SDL mixer callbacks
 ////////////////////////////////////////////////////////////////////
@@ -440,8 +808,9 @@ void init_audio(void)
 	// Allocate a bunch of mixing channels.
 	Mix_AllocateChannels(ALLOCATED_AUDIO_CHANNELS);
 
-	// Initialize the SFX cache
+	// Initialize the SFX cache, and start the sound decoder
 	_SFX_cache_init();
+	_sound_decoder_start();
 
 	// Add callback functions, called when a sound or a music is finished
 	Mix_ChannelFinished(_channel_done);
@@ -460,7 +829,9 @@ void close_audio(void)
 
 	Mix_ChannelFinished(NULL); // Avoid Mix_HaltChannel to call the ChannelFinished callback
 	Mix_HaltChannel(-1); // Ensure that all channels are halted before to free the sound chunks
+	_sound_decoder_stop();
 	_SFX_cache_clear();
+	voice_loading = FALSE;
 
 	Mix_HookMusicFinished(NULL); // Prevent to call the MusicFinished callback
 	if (loaded_music) {
@@ -477,6 +848,20 @@ void close_audio(void)
 	Mix_CloseAudio();
 }
 
+/**
+ * \brief Collect the sounds decoded in background.
+ *
+ * \details Must be called once per frame, so that the sounds requested while
+ * their decoding was not finished are started as soon as possible.
+ */
+void update_audio(void)
+{
+	if (!sound_on)
+		return;
+
+	_sound_decoder_collect();
+}
+
 /**
  * \brief Set the volume of the currently played background music.
  *
@@ -554,17 +939,42 @@ char *get_background_music()
 	return music_filename;
 }
 
+/*
+ * Start to play a decoded voice sound.
+ */
+static void _voice_start(Mix_Chunk *wav_chunk)
+{
+	int mix_channel = Mix_PlayChannel(-1, wav_chunk, 0);
+	if (mix_channel <= -1) {
+		error_once_message(ONCE_PER_GAME, __FUNCTION__,
+		                   "The SDL mixer was unable to play a certain sound sample file,"
+		                   "probably due to no audio channel being available.\n"
+		                   "Mix_GetError(): %s",
+						   NO_REPORT, Mix_GetError());
+		Mix_FreeChunk(wav_chunk);
+		return;
+	}
+
+	if (voice_paused)
+		Mix_Pause(mix_channel);
+
+	Mix_Volume(mix_channel, GameConfig.Current_Sound_FX_Volume * MIX_MAX_VOLUME);
+	voice_channel[0] = mix_channel;
+}
+
 /**
  * \brief Play a voice sound (used with title screens)
  *
- * \details A sound cannot be played (and the funtion returns -1) when
- * no audio channel is available.
+ * \details The voice sound is decoded in background, and starts to play once
+ * decoded. Its duration is read from the file's headers, so that the caller
+ * does not have to wait for the decoding.
+ * If the duration can not be read that way, the voice is decoded synchronously.
  *
  * \param fpath         Filename of the voice sound (full path)
  * \param pause         Immediately pause the voice sound (call resume_voice() to resume it)
  * \param voice_length  Return the duration, in milliseconds, of the playing voice
  *
- * \return Either the audio channel used to play the sound or -1 if error or the sound can not be played.
+ * \return Either the identifier of the voice (to be used with resume_voice() and stop_voice()) or -1 if error.
  */
 int play_voice(const char *fpath, int pause, float *voice_length)
 {
@@ -574,6 +984,8 @@ int play_voice(const char *fpath, int pause, float *voice_length)
 	if (!sound_on || fpath == NULL || fpath[0] == '\0')
 		return -1;
 
+	_sound_decoder_collect();
+
 	// First stop currently played voice, if any
 
 	if (voice_channel[0] != -1) {
@@ -581,8 +993,20 @@ int play_voice(const char *fpath, int pause, float *voice_length)
 		voice_channel[1] = voice_channel[0];
 	}
 	voice_channel[0] = -1;
+	voice_loading = FALSE;
+	voice_paused = pause;
+	voice_id++;
 
-	// Try to load the voice file
+	// Ask the decoder to load the voice file, if we can know its duration
+	// without decoding it
+
+	*voice_length = _sound_file_duration(fpath);
+	if (*voice_length >= 0 && _sound_decoder_push(DECODE_VOICE, voice_id, fpath)) {
+		voice_loading = TRUE;
+		return voice_id;
+	}
+
+	// Otherwise, load the voice file now
 
 	Mix_Chunk *wav_chunk = Mix_LoadWAV(fpath);
 	if (!wav_chunk) {
@@ -591,49 +1015,101 @@ int play_voice(const char *fpath, int pause, float *voice_length)
 	}
 	*voice_length = 1000.0 * ((float)wav_chunk->alen / (float)(audio_rate * audio_format_bytes * audio_channels));
 
-	// Try to play the sound file
+	_voice_start(wav_chunk);
+	if (voice_channel[0] == -1)
+		return -1;
 
-	int mix_channel = Mix_PlayChannel(-1, wav_chunk, 0);
+	return voice_id;
+}
+
+void resume_voice(int id)
+{
+	if (id != voice_id)
+		return;
+
+	voice_paused = FALSE;
+	if (voice_channel[0] != -1)
+		Mix_Resume(voice_channel[0]);
+}
+
+void stop_voice(int id)
+{
+	if (id != voice_id)
+		return;
+
+	// A voice still being decoded will be dropped once collected
+	voice_loading = FALSE;
+	if (voice_channel[0] != -1)
+		Mix_FadeOutChannel(voice_channel[0], 1000);
+}
+
+/*
+ * Play a cached SFX sound, at a given volume ratio, and optionally with
+ * a positional effect.
+ * Return the audio channel used to play the sound or -1 if the sound can not be played.
+ */
+static int _SFX_play(int cache_index, float ratio, int positional, Sint16 angle, Uint8 distance)
+{
+	// Mixing a same sound too many times can possibly lead to sound clipping.
+	// Since the independent samples will not really be distinguishable, we
+	// 'artificially' limit the overlap.
+	// This mainly happens when several bots fire a burst with a delay between
+	// 2 bullets that is shorter than the duration of the bullet sound.
+
+	if (_SFX_cache_get_counter(cache_index) >= MAX_SOUND_OVERLAPPING)
+		return -1;
+
+	// Now we try to play the sound file
+
+	int mix_channel = Mix_PlayChannel(-1, _SFX_cache_get_chunk(cache_index), 0);
 	if (mix_channel <= -1) {
 		error_once_message(ONCE_PER_GAME, __FUNCTION__,
-		                   "The SDL mixer was unable to play a certain sound sample file,"
-		                   "probably due to no audio channel being available.\n"
-		                   "Mix_GetError(): %s",
-						   NO_REPORT, Mix_GetError());
+				"The SDL mixer was unable to play a certain sound sample file,"
+				"probably due to no audio channel being available.\n"
+				"Mix_GetError(): %s",
+				NO_REPORT, Mix_GetError());
 		return -1;
 	}
 
-	if (pause)
-		Mix_Pause(mix_channel);
+	Mix_Volume(mix_channel, (int)rintf(ratio * GameConfig.Current_Sound_FX_Volume * MIX_MAX_VOLUME));
+	_SFX_cache_touch_slot(cache_index);
 
-	Mix_Volume(mix_channel, GameConfig.Current_Sound_FX_Volume * MIX_MAX_VOLUME);
-	voice_channel[0] = mix_channel;
+	// If requested, add positional effect.
+	if (positional) {
+		// TODO: MIX_SetPosition() does not preserve the audio power (referring
+		// to linear pan rule or constant power pan rule).
+		// We should compute ourself the volume to apply to each speaker (at least
+		// in stereo) and use Mix_SetPanning().
+		if (!Mix_SetPosition(mix_channel, angle, distance)){
+			error_message(__FUNCTION__,
+					"The SDL mixer was unable to register an effect on given channel.\n"
+					"FileName: '%s' channel: '%d' Mix_GetError(): %s",
+					NO_REPORT, SFX_cache.slots[cache_index].sound_name, mix_channel, Mix_GetError());
+		}
+	}
 
 	return mix_channel;
 }
 
-void resume_voice(int channel)
+/*
+ * Play a sound whose decoding ended after it was requested to be played.
+ */
+static void _SFX_play_deferred(int index)
 {
-	Mix_Resume(channel);
-}
+	struct deferred_play *deferred = &SFX_cache.slots[index].deferred;
 
-void stop_voice(int channel)
-{
-	Mix_FadeOutChannel(channel, 1000);
+	_SFX_play(index, deferred->volume, deferred->positional, deferred->angle, deferred->distance);
 }
 
-/**
- * \brief Play an SFX sound
- *
- * \details A sound cannot be played (and the funtion returns -1) when:
- * no unused slot is found in the SFX cache, or no audio channel is available,
- * or the sound is already played too many times.
- *
- * \param filename Filename of the SFX sound (relative to SOUND_DIR)
+/*
+ * Play an SFX sound, loading it in the SFX cache if needed.
  *
- * \return Either the audio channel used to play the sound or -1 if error or the sound can not be played.
+ * On a cache miss, the sound is decoded in background, and will be played
+ * once decoded, unless it takes more than MAX_SFX_DEFER_DELAY.
+ * Return the audio channel used to play the sound or -1 if the sound can not
+ * (or not yet) be played.
  */
-int play_sound(const char *filename)
+static int _play_sound(const char *filename, float ratio, int positional, Sint16 angle, Uint8 distance)
 {
 	// In case sound has been disabled, or not sound file name is given,
 	// do nothing
@@ -641,77 +1117,104 @@ int play_sound(const char *filename)
 	if (!sound_on || filename == NULL || filename[0] == '\0')
 		return -1;
 
+#ifdef WITH_RTPROF
+	probe_timer_set_in(play_sound, "Sound play time (us)", 20000);
+#endif
+
+	_sound_decoder_collect();
+
 	// First we go take a look if maybe the sound sample is already in the
 	// SFX cache. If not, the sample is loaded and put in cache.
 
 	int cache_index = _SFX_cache_find_filename(filename);
 
+#ifdef WITH_RTPROF
+	probe_counter_set(sfx_cache_misses, "SFX cache misses/frame", 20, (cache_index == -1));
+#endif
+
 	if (cache_index == -1) {
 		char fpath[PATH_MAX];
 
-		// Try to load the requested sound file into memory
+		// Try to find the requested sound file
 		if (!find_file(fpath, SOUND_DIR, filename, NULL, PLEASE_INFORM)) {
-			return -1;
-		}
-		Mix_Chunk *wav_chunk = Mix_LoadWAV(fpath);
-		if (!wav_chunk) {
-			error_message(__FUNCTION__, "Could not load sound file \"%s\": %s", PLEASE_INFORM, fpath, Mix_GetError());
+#ifdef WITH_RTPROF
+			probe_timer_set_out(play_sound);
+#endif
 			return -1;
 		}
 
-		// Allocate a cache entry for the loaded WAV sample
+		// Allocate a cache entry for the sound
 		cache_index = _SFX_cache_allocate_slot();
 		if (cache_index == -1) {
-			Mix_FreeChunk(wav_chunk);
+#ifdef WITH_RTPROF
+			probe_timer_set_out(play_sound);
+#endif
 			return -1;
 		}
-		_SFX_cache_fill_slot(cache_index, filename, wav_chunk);
+		_SFX_cache_fill_slot(cache_index, filename);
+
+		// Ask the decoder thread to load the sound, and defer its playing.
+		// If the decoder can not handle the request, load it right now.
+		if (_sound_decoder_push(DECODE_SFX, cache_index, fpath)) {
+			struct deferred_play *deferred = &SFX_cache.slots[cache_index].deferred;
+			deferred->pending = TRUE;
+			deferred->requested = SDL_GetTicks();
+			deferred->volume = ratio;
+			deferred->positional = positional;
+			deferred->angle = angle;
+			deferred->distance = distance;
+#ifdef WITH_RTPROF
+			probe_timer_set_out(play_sound);
+#endif
+			return -1;
+		}
+		Mix_Chunk *wav_chunk = Mix_LoadWAV(fpath);
+		_SFX_cache_set_chunk(cache_index, wav_chunk, fpath, wav_chunk ? "" : Mix_GetError());
 	}
 
-	// Mixing a same sound too many times can possibly lead to sound clipping.
-	// Since the independent samples will not really be distinguishable, we
-	// 'artificially' limit the overlap.
-	// This mainly happens when several bots fire a burst with a delay between
-	// 2 bullets that is shorter than the duration of the bullet sound.
-
-	if (_SFX_cache_get_counter(cache_index) >= MAX_SOUND_OVERLAPPING)
-		return -1;
-
-	// Now we try to play the sound file
-
-	int mix_channel = Mix_PlayChannel(-1, _SFX_cache_get_chunk(cache_index), 0);
-	if (mix_channel <= -1) {
-		error_once_message(ONCE_PER_GAME, __FUNCTION__,
-				"The SDL mixer was unable to play a certain sound sample file,"
-				"probably due to no audio channel being available.\n"
-				"Mix_GetError(): %s",
-				NO_REPORT, Mix_GetError());
+	// The sound is still being decoded, or could not be loaded: skip it
+	if (!_SFX_cache_get_chunk(cache_index)) {
+#ifdef WITH_RTPROF
+		probe_timer_set_out(play_sound);
+#endif
 		return -1;
 	}
 
-	Mix_Volume(mix_channel, GameConfig.Current_Sound_FX_Volume * MIX_MAX_VOLUME);
-	_SFX_cache_touch_slot(cache_index);
+	int mix_channel = _SFX_play(cache_index, ratio, positional, angle, distance);
 
+#ifdef WITH_RTPROF
+	probe_timer_set_out(play_sound);
+#endif
 	return mix_channel;
 }
 
 /**
- * \brief Play an SFX sound at a given ratio of the global sound volume
+ * \brief Play an SFX sound
  *
- * \brief The function first calls play_sound() and then sets the volume.
+ * \details A sound cannot be played (and the funtion returns -1) when:
+ * no unused slot is found in the SFX cache, or no audio channel is available,
+ * or the sound is already played too many times.
+ * The first time a sound is requested, it is decoded in background, and the
+ * function returns -1. The sound will be played as soon as it is decoded.
+ *
+ * \param filename Filename of the SFX sound (relative to SOUND_DIR)
+ *
+ * \return Either the audio channel used to play the sound or -1 if error or the sound can not be played.
+ */
+int play_sound(const char *filename)
+{
+	return _play_sound(filename, 1.0, FALSE, 0, 0);
+}
+
+/**
+ * \brief Play an SFX sound at a given ratio of the global sound volume
  *
  * \param filename Filename of the SFX sound (relative to SOUND_DIR)
  * \param ratio    Multiplied by the global sound volume (game configuration) (between 0.0 and 1.0)
  */
 void play_sound_v(const char *filename, float ratio)
 {
-	if (!sound_on)
-		return;
-
-	int sound_channel = play_sound(filename);
-	if (sound_channel != -1) {
-		Mix_Volume(sound_channel, (int)rintf(ratio * GameConfig.Current_Sound_FX_Volume * MIX_MAX_VOLUME));
-	}
+	_play_sound(filename, ratio, FALSE, 0, 0);
 }
 
 /**
@@ -719,7 +1222,6 @@ void play_sound_v(const char *filename, float ratio)
  *
  * \details Simulate a 3D sound, based on the position of the sound source
  * and the position of the listener (Tux).
- * The function first calls play_sound() and then adds a positional effect.
  *
  * \param filename      Filename of the SFX sound (relative to SOUND_DIR)
  * \param listener_gps  GPS position of the listener
@@ -736,7 +1238,6 @@ void play_sound_at_position(const char *filename, struct gps *listener_gps, stru
 	float angle;
 	Uint8 sound_distance;
 	Sint16 sound_angle;
-	int sound_channel;
 
 	if (!sound_on)
 		return;
@@ -798,22 +1299,8 @@ void play_sound_at_position(const char *filename, struct gps *listener_gps, stru
 	sound_angle = (Sint16)(90.0 - angle * (180.0/M_PI)) % 360;
 	if (sound_angle < 0) sound_angle = 360 + sound_angle;
 
-	// Try to play the sound
-	sound_channel = play_sound(filename);
-
-	// If sound is played, add positional effect.
-	if (sound_channel != -1) {
-		// TODO: MIX_SetPosition() does not preserve the audio power (referring
-		// to linear pan rule or constant power pan rule).
-		// We should compute ourself the volume to apply to each speaker (at least
-		// in stereo) and use Mix_SetPanning().
-		if (!Mix_SetPosition(sound_channel, sound_angle, sound_distance)){
-			error_message(__FUNCTION__,
-					"The SDL mixer was unable to register an effect on given channel.\n"
-					"FileName: '%s' channel: '%d' Mix_GetError(): %s",
-					NO_REPORT, filename, sound_channel, Mix_GetError());
-		}
-	}
+	// Play the sound, with a positional effect
+	_play_sound(filename, 1.0, TRUE, sound_angle, sound_distance);
 }
 
 #endif // HAVE_LIBSDL_MIXER
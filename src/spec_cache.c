@@ -0,0 +1,504 @@
+/*
+ *
+ *   Copyright (c) 2026 FreedroidRPG development team
+ *
+ *
+ *  This file is part of Freedroid
+ *
+ *  Freedroid is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Freedroid is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Freedroid; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ *  MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file spec_cache.c
+ * \brief Snapshot of the item and droid specs read from the data files.
+ *
+ * The item and droid specs are the largest Lua data files, and executing
+ * them, then converting each field of their tables, is a significant part
+ * of the startup time. Once they are read, the resulting specs are written
+ * in a cache file of the config dir. On the next starts, the specs are read
+ * back from that file, as long as the data files they come from (and the
+ * ones they depend on) were not modified, and the code producing the specs
+ * is the same (see SPEC_CACHE_VERSION).
+ *
+ * The file starts with a header, followed by the list of the source data
+ * files (path, modification time and size), the item count per drop class,
+ * and the item and droid specs. Each spec is stored field by field (see
+ * item_fields[] and droid_fields[]), a string being stored as its length
+ * (SPEC_CACHE_NULL_STRING for a NULL string) followed by its characters.
+ * All the integers are in the byte order of the computer which wrote the file.
+ *
+ * The droid specs are stored before their adaptation to the difficulty
+ * level (see init_droid_specs()).
+ */
+
+#define _spec_cache_c 1
+
+#include "system.h"
+
+#include "defs.h"
+#include "struct.h"
+#include "global.h"
+#include "proto.h"
+
+#define SPEC_CACHE_FILE "spec_cache.dat"
+#define SPEC_CACHE_MAGIC "FDSPECS\n"
+#define SPEC_CACHE_BYTE_ORDER 0x01020304
+#define SPEC_CACHE_NULL_STRING 0xFFFFFFFF
+
+// Version of the content of the cache. It has to be increased whenever the
+// file layout changes, or whenever the code converting the data files into
+// specs changes: get_one_item() and get_one_droid() in luaconfig.c, and the
+// name tables they use (enemy_sensors[] in enemy.c, get_slot_type_by_name()
+// and get_busy_type_by_name() in items.c).
+// The cache is also only valid for the game version which wrote it.
+#define SPEC_CACHE_VERSION 2
+#define SPEC_CACHE_GAME_VERSION VERSION
+
+struct spec_cache_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t byte_order;
+	char game_version[64];
+
+	uint32_t itemspec_size;
+	uint32_t droidspec_size;
+
+	uint32_t nb_sources;
+	uint32_t nb_items;
+	uint32_t nb_droids;
+};
+
+// Data files the cached specs are read from, or depend on
+static const struct {
+	int subdir_handle;
+	const char *fname;
+} spec_sources[] = {
+	{ LUA_MOD_DIR, "script_helpers.lua" },
+	{ BASE_DIR, "bullet_specs.lua" },    // Bullet types of the items
+	{ BASE_DIR, "tuxrender_specs.lua" }, // Motion classes of the items
+	{ BASE_DIR, "item_specs.lua" },
+	{ BASE_DIR, "droid_specs.lua" }
+};
+
+#define NB_SPEC_SOURCES (sizeof(spec_sources) / sizeof(spec_sources[0]))
+
+/**
+ * Field of a spec structure. Its size is 0 for a string.
+ */
+struct spec_field {
+	size_t offset;
+	size_t size;
+};
+
+#define SPEC_FIELD(type, field) { offsetof(type, field), sizeof(((type *)0)->field) }
+#define SPEC_STRING(type, field) { offsetof(type, field), 0 }
+
+// Fields of the item specs, as set by get_one_item() (see luaconfig.c).
+// The images are not stored.
+static const struct spec_field item_fields[] = {
+	SPEC_STRING(itemspec, id),
+	SPEC_STRING(itemspec, name),
+	SPEC_STRING(itemspec, item_rotation_series_prefix),
+	SPEC_STRING(itemspec, item_description),
+	SPEC_STRING(itemspec, item_drop_sound_file_name),
+	SPEC_STRING(itemspec, item_inv_file_name),
+	SPEC_FIELD(itemspec, slot),
+	SPEC_STRING(itemspec, tux_part_instance),
+	SPEC_FIELD(itemspec, item_group_together_in_inventory),
+	SPEC_FIELD(itemspec, weapon_is_melee),
+	SPEC_FIELD(itemspec, weapon_needs_two_hands),
+	SPEC_FIELD(itemspec, weapon_motion_class),
+	SPEC_FIELD(itemspec, weapon_attack_time),
+	SPEC_FIELD(itemspec, weapon_reloading_time),
+	SPEC_STRING(itemspec, weapon_reloading_sound),
+	SPEC_FIELD(itemspec, weapon_base_damage),
+	SPEC_FIELD(itemspec, weapon_damage_modifier),
+	SPEC_STRING(itemspec, weapon_ammo_type),
+	SPEC_FIELD(itemspec, weapon_ammo_clip_size),
+	SPEC_FIELD(itemspec, weapon_bullet_type),
+	SPEC_FIELD(itemspec, weapon_bullet_speed),
+	SPEC_FIELD(itemspec, weapon_bullet_lifetime),
+	SPEC_FIELD(itemspec, weapon_bullet_pass_through_hit_bodies),
+	SPEC_FIELD(itemspec, base_armor_class),
+	SPEC_FIELD(itemspec, armor_class_modifier),
+	SPEC_FIELD(itemspec, item_require_strength),
+	SPEC_FIELD(itemspec, item_require_dexterity),
+	SPEC_FIELD(itemspec, item_require_cooling),
+	SPEC_FIELD(itemspec, base_item_durability),
+	SPEC_FIELD(itemspec, item_durability_modifier),
+	SPEC_STRING(itemspec, right_use.tooltip),
+	SPEC_STRING(itemspec, right_use.skill),
+	SPEC_STRING(itemspec, right_use.add_skill),
+	SPEC_FIELD(itemspec, right_use.busy_type),
+	SPEC_FIELD(itemspec, right_use.busy_time),
+	SPEC_FIELD(itemspec, inv_size),
+	SPEC_FIELD(itemspec, base_list_price),
+	SPEC_FIELD(itemspec, min_drop_class),
+	SPEC_FIELD(itemspec, max_drop_class),
+	SPEC_FIELD(itemspec, drop_amount),
+	SPEC_FIELD(itemspec, drop_amount_max)
+};
+
+// Fields of the droid specs, as set by get_one_droid() (see luaconfig.c).
+// The graphics related fields are set by init_droid_specs().
+static const struct spec_field droid_fields[] = {
+	SPEC_STRING(droidspec, droidname),
+	SPEC_STRING(droidspec, default_short_description),
+	SPEC_STRING(droidspec, notes),
+	SPEC_FIELD(droidspec, is_human),
+	SPEC_FIELD(droidspec, class),
+	SPEC_FIELD(droidspec, can_move),
+	SPEC_FIELD(droidspec, maxspeed),
+	SPEC_FIELD(droidspec, maxenergy),
+	SPEC_FIELD(droidspec, healing_friendly),
+	SPEC_FIELD(droidspec, healing_hostile),
+	SPEC_FIELD(droidspec, to_hit),
+	SPEC_FIELD(droidspec, aggression_distance),
+	SPEC_FIELD(droidspec, time_spent_eyeing_tux),
+	SPEC_FIELD(droidspec, recover_time_after_getting_hit),
+	SPEC_FIELD(droidspec, experience_reward),
+	SPEC_FIELD(droidspec, weapon_id),
+	SPEC_FIELD(droidspec, sensor_id),
+	SPEC_FIELD(droidspec, drop_class),
+	SPEC_FIELD(droidspec, amount_of_plasma_transistors),
+	SPEC_FIELD(droidspec, amount_of_superconductors),
+	SPEC_FIELD(droidspec, amount_of_antimatter_converters),
+	SPEC_FIELD(droidspec, amount_of_entropy_inverters),
+	SPEC_FIELD(droidspec, amount_of_tachyon_condensators),
+	SPEC_STRING(droidspec, gfx_prefix),
+	SPEC_FIELD(droidspec, gun_muzzle_height),
+	SPEC_FIELD(droidspec, walk_animation_speed_factor),
+	SPEC_FIELD(droidspec, attack_animation_speed_factor),
+	SPEC_FIELD(droidspec, gethit_animation_speed_factor),
+	SPEC_FIELD(droidspec, death_animation_speed_factor),
+	SPEC_FIELD(droidspec, stand_animation_speed_factor),
+	SPEC_FIELD(droidspec, portrait_rotations),
+	SPEC_STRING(droidspec, greeting_sound),
+	SPEC_STRING(droidspec, attack_sound),
+	SPEC_STRING(droidspec, death_sound),
+	SPEC_STRING(droidspec, voice_samples_path),
+	SPEC_FIELD(droidspec, voice_samples_first),
+	SPEC_FIELD(droidspec, voice_samples_last),
+	SPEC_FIELD(droidspec, voice_samples_probability)
+};
+
+#define NB_ITEM_FIELDS (sizeof(item_fields) / sizeof(item_fields[0]))
+#define NB_DROID_FIELDS (sizeof(droid_fields) / sizeof(droid_fields[0]))
+
+/**
+ * Cursor reading the content of the cache file.
+ * Reading past the end of the file sets the error flag, and reads zeros.
+ */
+struct spec_reader {
+	const unsigned char *ptr;
+	const unsigned char *end;
+	int error;
+};
+
+static void read_bytes(struct spec_reader *r, void *dst, size_t size)
+{
+	if (r->error || (size_t)(r->end - r->ptr) < size) {
+		r->error = TRUE;
+		memset(dst, 0, size);
+		return;
+	}
+
+	memcpy(dst, r->ptr, size);
+	r->ptr += size;
+}
+
+static uint32_t read_uint32(struct spec_reader *r)
+{
+	uint32_t value;
+
+	read_bytes(r, &value, sizeof(value));
+	return value;
+}
+
+static char *read_string(struct spec_reader *r)
+{
+	uint32_t len = read_uint32(r);
+	char *str;
+
+	if (r->error || len == SPEC_CACHE_NULL_STRING)
+		return NULL;
+
+	if ((size_t)(r->end - r->ptr) < len) {
+		r->error = TRUE;
+		return NULL;
+	}
+
+	str = MyMalloc(len + 1);
+	memcpy(str, r->ptr, len);
+	r->ptr += len;
+
+	return str;
+}
+
+static void write_string(FILE *f, const char *str)
+{
+	uint32_t len = str ? strlen(str) : SPEC_CACHE_NULL_STRING;
+
+	fwrite(&len, sizeof(len), 1, f);
+	if (str)
+		fwrite(str, 1, len, f);
+}
+
+/**
+ * Get the state of a source data file.
+ *
+ * \return FALSE if the file was not found
+ */
+static int get_source_state(int source, char *fpath, int64_t *mtime, int64_t *size)
+{
+	struct stat file_info;
+
+	if (!find_file(fpath, spec_sources[source].subdir_handle, spec_sources[source].fname, NULL, SILENT))
+		return FALSE;
+
+	if (stat(fpath, &file_info))
+		return FALSE;
+
+	*mtime = file_info.st_mtime;
+	*size = file_info.st_size;
+	return TRUE;
+}
+
+static void read_spec(struct spec_reader *r, void *spec, const struct spec_field *fields, int nb_fields)
+{
+	int i;
+
+	for (i = 0; i < nb_fields; i++) {
+		void *field = (char *)spec + fields[i].offset;
+
+		if (fields[i].size)
+			read_bytes(r, field, fields[i].size);
+		else
+			*(char **)field = read_string(r);
+	}
+}
+
+static void write_spec(FILE *f, const void *spec, const struct spec_field *fields, int nb_fields)
+{
+	int i;
+
+	for (i = 0; i < nb_fields; i++) {
+		const void *field = (const char *)spec + fields[i].offset;
+
+		if (fields[i].size)
+			fwrite(field, fields[i].size, 1, f);
+		else
+			write_string(f, *(char * const *)field);
+	}
+}
+
+static void free_specs(void *specs, size_t spec_size, int nb, const struct spec_field *fields, int nb_fields)
+{
+	int i, j;
+
+	for (i = 0; i < nb; i++) {
+		for (j = 0; j < nb_fields; j++) {
+			if (!fields[j].size)
+				free(*(char **)((char *)specs + i * spec_size + fields[j].offset));
+		}
+	}
+
+	free(specs);
+}
+
+/**
+ * Check the header and the source data files of the cache.
+ */
+static int cache_is_valid(struct spec_reader *r, struct spec_cache_header *h)
+{
+	char fpath[PATH_MAX];
+	int64_t mtime, size;
+	int i;
+
+	read_bytes(r, h, sizeof(*h));
+	if (r->error ||
+	    memcmp(h->magic, SPEC_CACHE_MAGIC, sizeof(h->magic)) ||
+	    h->version != SPEC_CACHE_VERSION ||
+	    h->byte_order != SPEC_CACHE_BYTE_ORDER ||
+	    strncmp(h->game_version, SPEC_CACHE_GAME_VERSION, sizeof(h->game_version)) ||
+	    h->itemspec_size != sizeof(itemspec) ||
+	    h->droidspec_size != sizeof(droidspec) ||
+	    h->nb_sources != NB_SPEC_SOURCES)
+		return FALSE;
+
+	for (i = 0; i < NB_SPEC_SOURCES; i++) {
+		char *cached_path = read_string(r);
+		int64_t cached_mtime, cached_size;
+		int valid;
+
+		read_bytes(r, &cached_mtime, sizeof(cached_mtime));
+		read_bytes(r, &cached_size, sizeof(cached_size));
+
+		valid = !r->error && cached_path && get_source_state(i, fpath, &mtime, &size) &&
+		        !strcmp(cached_path, fpath) && cached_mtime == mtime && cached_size == size;
+		free(cached_path);
+
+		if (!valid)
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+/**
+ * Read the item and droid specs from the spec cache, if it is up to date.
+ *
+ * \return TRUE if the specs were read, FALSE if they have to be read from
+ * the data files
+ */
+int load_spec_cache(void)
+{
+	char fpath[PATH_MAX];
+	struct spec_cache_header h;
+	struct spec_reader r;
+	short int count_per_class[MAX_DROP_CLASS + 1];
+	itemspec *items = NULL;
+	droidspec *droids = NULL;
+	unsigned char *data;
+	long data_size;
+	int i;
+
+	if (!find_file(fpath, CONFIG_DIR, SPEC_CACHE_FILE, NULL, SILENT))
+		return FALSE;
+
+	FILE *f = fopen(fpath, "rb");
+	if (!f)
+		return FALSE;
+
+	data_size = FS_filelength(f);
+	data = malloc(data_size);
+	if (!data || fread(data, data_size, 1, f) != 1) {
+		fclose(f);
+		free(data);
+		return FALSE;
+	}
+	fclose(f);
+
+	r.ptr = data;
+	r.end = data + data_size;
+	r.error = FALSE;
+
+	// Each spec takes at least one byte, which bounds the allocations
+	if (!cache_is_valid(&r, &h) || !h.nb_items || !h.nb_droids ||
+	    h.nb_items > r.end - r.ptr || h.nb_droids > r.end - r.ptr) {
+		free(data);
+		return FALSE;
+	}
+
+	read_bytes(&r, count_per_class, sizeof(count_per_class));
+
+	items = (itemspec *) MyMalloc(sizeof(itemspec) * h.nb_items + 1);
+	for (i = 0; i < h.nb_items; i++)
+		read_spec(&r, &items[i], item_fields, NB_ITEM_FIELDS);
+
+	droids = (droidspec *) MyMalloc(sizeof(droidspec) * h.nb_droids + 1);
+	for (i = 0; i < h.nb_droids; i++)
+		read_spec(&r, &droids[i], droid_fields, NB_DROID_FIELDS);
+
+	if (r.error || r.ptr != r.end) {
+		error_message(__FUNCTION__, "The spec cache %s is corrupted, the specs are read from the data files.",
+		              NO_REPORT, fpath);
+		free_specs(items, sizeof(itemspec), h.nb_items, item_fields, NB_ITEM_FIELDS);
+		free_specs(droids, sizeof(droidspec), h.nb_droids, droid_fields, NB_DROID_FIELDS);
+		free(data);
+		return FALSE;
+	}
+
+	free(data);
+
+	memcpy(item_count_per_class, count_per_class, sizeof(count_per_class));
+	ItemMap = items;
+	Number_Of_Item_Types = h.nb_items;
+	Droidmap = droids;
+	Number_Of_Droid_Types = h.nb_droids;
+
+	return TRUE;
+}
+
+/**
+ * Write the item and droid specs, just read from the data files, to the
+ * spec cache. The droid specs must not be adapted to the difficulty level yet.
+ */
+void save_spec_cache(void)
+{
+	char fpath[PATH_MAX];
+	char source_path[PATH_MAX];
+	struct spec_cache_header h;
+	int64_t mtime, size;
+	int i, failed;
+
+	if (!strlen(data_dirs[CONFIG_DIR].path) || !Number_Of_Item_Types || !Number_Of_Droid_Types)
+		return;
+
+	memset(&h, 0, sizeof(h));
+	memcpy(h.magic, SPEC_CACHE_MAGIC, sizeof(h.magic));
+	h.version = SPEC_CACHE_VERSION;
+	h.byte_order = SPEC_CACHE_BYTE_ORDER;
+	strncpy(h.game_version, SPEC_CACHE_GAME_VERSION, sizeof(h.game_version) - 1);
+	h.itemspec_size = sizeof(itemspec);
+	h.droidspec_size = sizeof(droidspec);
+	h.nb_sources = NB_SPEC_SOURCES;
+	h.nb_items = Number_Of_Item_Types;
+	h.nb_droids = Number_Of_Droid_Types;
+
+	find_file(fpath, CONFIG_DIR, SPEC_CACHE_FILE, NULL, SILENT);
+	FILE *f = fopen(fpath, "wb");
+	if (!f) {
+		DebugPrintf(-4, "Unable to open spec cache file %s for writing\n", fpath);
+		return;
+	}
+
+	fwrite(&h, sizeof(h), 1, f);
+
+	failed = FALSE;
+	for (i = 0; i < NB_SPEC_SOURCES; i++) {
+		if (!get_source_state(i, source_path, &mtime, &size)) {
+			failed = TRUE;
+			break;
+		}
+		write_string(f, source_path);
+		fwrite(&mtime, sizeof(mtime), 1, f);
+		fwrite(&size, sizeof(size), 1, f);
+	}
+
+	fwrite(item_count_per_class, sizeof(item_count_per_class), 1, f);
+
+	for (i = 0; i < Number_Of_Item_Types; i++)
+		write_spec(f, &ItemMap[i], item_fields, NB_ITEM_FIELDS);
+
+	for (i = 0; i < Number_Of_Droid_Types; i++)
+		write_spec(f, &Droidmap[i], droid_fields, NB_DROID_FIELDS);
+
+	if (ferror(f))
+		failed = TRUE;
+	if (fclose(f))
+		failed = TRUE;
+
+	// A partially written cache would be rejected, but would still be read
+	// on each start
+	if (failed) {
+		DebugPrintf(-4, "Unable to write spec cache file %s\n", fpath);
+		remove(fpath);
+	}
+}
+
+#undef _spec_cache_c
@@ -63,7 +63,38 @@ struct sparse_dynarray {
 	int size;
 	int capacity;
 	// sparse_dynarray specific attributes
-	int *used_members;
+	int *used_members;	// Position of the member in live_members + 1, 0 if the slot is free
+	int *live_members;	// Dense list of the used slots, in no particular order
+	int nb_live;
+	struct dynarray free_slots;	// Stack of released slots
+};
+
+/**
+ * Pools, with stable member addresses (see dynarray.c)
+ */
+struct pool {
+	void **pages;
+	int nb_pages;
+	int size;	// Index of the last used slot + 1
+	size_t membersize;
+	struct dynarray free_slots;	// Stack of released slots
+	int (*slot_is_free)(void *);
+};
+
+/**
+ * Open-addressing hash maps of names (see name_map.c)
+ */
+struct name_map_entry {
+	char *name;	// Own copy of the name, NULL if the slot is free
+	int index;	// Index of the named object, for maps of indexed tables
+	void *data;	// Named object, for maps of pointers
+};
+
+struct name_map {
+	struct name_map_entry *slots;
+	int capacity;	// Number of slots, always a power of two
+	int count;	// Number of used slots
+	int nb_indexed;	// Number of entries of the source table already indexed
 };
 
 typedef struct dynarray item_dynarray;
@@ -95,6 +126,43 @@ struct image_transformation {
 	enum image_transformation_mode mode;
 };
 
+/**
+ * Operations used to draw the quads recorded in an image batch (see
+ * image_batch.c).
+ */
+struct image_batch_backend {
+	int (*max_textures)(void);                                  // Number of textures usable in a draw
+	void (*upload)(const float *vertices, int nb_quads);        // 4 vertices per quad, x y s t for each
+	void (*bind_texture)(int unit, unsigned int texture);
+	void (*draw)(int first_quad, int nb_quads, const float color[4], int additive);
+	void (*done)(void);                                         // Called after the last draw
+};
+
+/**
+ * Free space of a texture atlas page built at runtime, as the list of the
+ * top edges of the free space, from left to right (see image_atlas.c).
+ */
+struct atlas_skyline_node {
+	int x;
+	int y;
+	int w;
+};
+
+struct atlas_skyline {
+	int w;
+	int h;
+	struct dynarray nodes;
+};
+
+/**
+ * Place of an image in an atlas page built at runtime.
+ */
+struct atlas_slot {
+	struct atlas_page *page;
+	SDL_Rect rect;
+	struct list_head node;
+};
+
 /**
  * This structure defines an image in FreedroidRPG. It contains information
  * that enables rendering using SDL or OpenGL.
@@ -119,8 +187,50 @@ struct image {
 	short tex_h;
 
 	struct image_transformation cached_transformation;
+	struct atlas_slot *atlas_slot; /**< place in an atlas page, for images loaded with PACK_IN_ATLAS */
+};
+#define EMPTY_IMAGE { .surface = NULL , .offset_x = 0 , .offset_y = 0 , .texture_type = NO_TEXTURE , .cached_transformation = { NULL, 0.0, 0.0, { 0.0, 0.0, 0.0, 0.0}, 0 } , .atlas_slot = NULL }
+
+/**
+ * Images and rectangles drawn while a display capture is active, recorded
+ * so that they can be drawn again without the code that computed them
+ * (see image.c).
+ */
+struct display_capture {
+	struct dynarray items;
+	int generation;   /**< Images generation at capture time. The capture is stale once an image is deleted. */
+	SDL_Rect end_clip;  /**< Clip rectangle left by the captured drawing code */
+	int end_clip_set;
+};
+
+/**
+ * Pre-computed layout of a text, as rendered with a given font (see text_layout.c).
+ * The state of the text cursor is recorded before each processed character
+ * (or font switch code), so that the rendering can be stopped anywhere.
+ */
+struct text_layout_step {
+	int x;                  // Cursor position before the step
+	int y;                  // (y is relative to the first line)
+	int nblines;            // Number of lines written before the step
+	int offset;             // Offset of the step in the text
+	int is_font_switch;     // TRUE if the step is a font switch code
+	struct font *font;      // Font in use before the step (NULL if not yet set)
+};
+
+struct text_layout_glyph {
+	struct image *img;      // Image of the character
+	int x;                  // Position of the character
+	int y;                  // (y is relative to the first line)
+	int line_height;        // Height of the line, in the character's font
+	int step;               // Index of the step displaying the character
+};
+
+struct text_layout {
+	int nb_steps;                      // The steps array contains nb_steps + 1 entries,
+	struct text_layout_step *steps;    // the last one being the state at the end of the text
+	int nb_glyphs;
+	struct text_layout_glyph *glyphs;
 };
-#define EMPTY_IMAGE { .surface = NULL , .offset_x = 0 , .offset_y = 0 , .texture_type = NO_TEXTURE , .cached_transformation = { NULL, 0.0, 0.0, { 0.0, 0.0, 0.0, 0.0}, 0 } }
 
 typedef struct mouse_press_button {
 	struct image button_image;
@@ -187,6 +297,7 @@ typedef struct configuration_for_freedroid {
 	int cheat_running_stamina;
 	int cheat_double_speed;
 	int lazyload;
+	int graphics_memory_budget;	// Memory for the enemy and item graphics (in MB, 0 for no limit)
 	int show_item_labels;
 	int last_edited_level;
 	int show_all_floor_layers;
@@ -545,7 +656,17 @@ typedef struct npc {
 	list_head_t node;
 } npc;
 
-typedef char automap_data_t[100][100];
+/**
+ * Automap knowledge of one level.
+ * Each automap flag (see EW_WALL_BIT and friends) is stored in its own
+ * bitplane of xlen*ylen bits. Planes are only allocated once something
+ * is recorded on the level.
+ */
+typedef struct automap_data {
+	int xlen;
+	int ylen;
+	uint32_t *planes;	// AUTOMAP_NB_PLANES planes of AUTOMAP_PLANE_WORDS(xlen, ylen) words
+} automap_data_t;
 
 typedef struct tux {
 	float current_game_date;	// seconds since game start, will be printed as a different 'date'
@@ -832,8 +953,8 @@ typedef struct level {
 	int jump_target_east;
 	int jump_target_west;
 
-	obstacle obstacle_list[MAX_OBSTACLES_ON_MAP];
-	item ItemList[MAX_ITEMS_PER_LEVEL];
+	struct pool obstacle_list;	// Use ACCESS_OBSTACLE() to get an obstacle
+	struct pool ItemList;	// Use ACCESS_FLOOR_ITEM() to get a floor item
 
 	struct dynarray obstacle_extensions;
 	struct dynarray map_labels;
@@ -87,6 +87,10 @@
 #include <fcntl.h>
 #endif
 
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+
 #ifdef HAVE_ICONV
 #include <iconv.h>
 #endif
@@ -50,36 +50,6 @@ static struct image ToGroundBlocks[NUM_GROUND_BLOCKS];
 static struct image ToColumnBlock;
 static struct image ToLeaderBlock;
 
-//--------------------
-// Class separation of the blocks 
-//
-int BlockClass[TO_BLOCKS] = {
-	CONNECTOR,		// cable
-	NON_CONNECTOR,		// end of cable
-	CONNECTOR,		// re-enforcer
-	CONNECTOR,		// color-change
-	CONNECTOR,		// bridge above
-	NON_CONNECTOR,		// bridge middle
-	CONNECTOR,		// bridge below
-	NON_CONNECTOR,		// uniter above
-	CONNECTOR,		// uniter middle
-	NON_CONNECTOR,		// uniter below
-	NON_CONNECTOR		// empty
-};
-
-//--------------------
-// Probability of the various elements 
-//
-#define MAX_PROB		100
-int ElementProb[TO_ELEMENTS] = {
-	100,			// EL_CABLE 
-	2,			// EL_CABLE_END 
-	5,			// EL_AMPLIFIER 
-	5,			// EL_COLOR_EXCHANGER: only on last layer 
-	5,			// EL_SEPARATOR 
-	5			// EL_GATE 
-};
-
 int max_opponent_capsules;
 int NumCapsules[TO_COLORS] = {
 	0, 0
@@ -114,17 +84,16 @@ int OpponentColor = PURPLE;
 int OpponentType;		/* The droid-type of your opponent */
 enemy *cdroid;
 
-/* the display  column */
-int DisplayColumn[NUM_LINES] = {
-	YELLOW, PURPLE, YELLOW, PURPLE, YELLOW, PURPLE, YELLOW, PURPLE, YELLOW, PURPLE,
-	YELLOW, PURPLE
-};
-
 SDL_Color to_bg_color = { 199, 199, 199 };
 
-playground_t ToPlayground;
-playground_t ActivationMap;
-playground_t CapsuleCountdown;
+static struct takeover_board to_board;
+
+// Row the opponent aims at, and motion ticks before it looks for a new one
+static int opponent_target = -1;
+static int opponent_target_age;
+
+// Animation phases of the currents going through the playground
+static playground_t CurrentPhases;
 
 void EvaluatePlayground(void);
 float EvaluatePosition(const int color, const int row, const int layer, const int endgame);
@@ -132,6 +101,8 @@ float EvaluateCenterPosition(const int color, const int row, const int layer, co
 void advanced_enemy_takeover_movements(const int countdown);
 
 static void ShowPlayground(enemy *target);
+static void update_current_phases(void);
+static void AnimateCurrents(void);
 
 static void display_takeover_help()
 {
@@ -349,8 +320,8 @@ static void PlayGame(int countdown, enemy *target)
 	SDL_Event event;
 
 	sprintf(count_text, " ");	/* Make sure a value gets assigned to count_text */
-	count_tick_len = 100;	/* countdown in 1/10 second steps */
-	move_tick_len = 60;	/* allow motion at this tick-speed in ms */
+	count_tick_len = TO_COUNT_TICK_LEN;	/* countdown in 1/10 second steps */
+	move_tick_len = TO_MOVE_TICK_LEN;	/* allow motion at this tick-speed in ms */
 
 	up = down = set = FALSE;
 	up_counter = down_counter = 0;
@@ -451,13 +422,9 @@ static void PlayGame(int countdown, enemy *target)
 			if (set && (NumCapsules[YOU] > 0)) {
 				set = FALSE;
 				row = CapsuleCurRow[YourColor] - 1;
-				if ((row >= 0) &&
-				    (ToPlayground[YourColor][0][row] != CABLE_END) && (ActivationMap[YourColor][0][row] == INACTIVE)) {
+				if (takeover_board_set_capsule(&to_board, YourColor, row, CAPSULE_COUNTDOWN * 2)) {
 					NumCapsules[YOU]--;
 					CapsuleCurRow[YourColor] = 0;
-					ToPlayground[YourColor][0][row] = AMPLIFIER;
-					ActivationMap[YourColor][0][row] = ACTIVE1;
-					CapsuleCountdown[YourColor][0][row] = CAPSULE_COUNTDOWN * 2;
 
 					Takeover_Set_Capsule_Sound();
 
@@ -468,14 +435,9 @@ static void PlayGame(int countdown, enemy *target)
 				}	/* if (row > 0 && ... ) */
 			}
 			/* if ( set ) */
-			ProcessCapsules();	/* count down the lifetime of the capsules */
-
-			ProcessPlayground();
-			ProcessPlayground();
-			ProcessPlayground();
-			ProcessPlayground();	/* this has to be done several times to be sure */
-
-			ProcessDisplayColumn();
+			takeover_board_step(&to_board);
+			LeaderColor = takeover_board_leader(&to_board, &LeaderCapsuleCount);
+			update_current_phases();
 
 		}
 		/* if (motion_tick has occurred) */
@@ -486,20 +448,15 @@ static void PlayGame(int countdown, enemy *target)
 	}			/* while !FinishTakeover */
 
 	/* Final countdown */
-	countdown = CAPSULE_COUNTDOWN + 10;
+	countdown = TO_FINAL_STEPS;
 
 	while (countdown--) {
 		// speed this up a little, some people get bored here...
 		//      while ( SDL_GetTicks() < prev_count_tick + count_tick_len ) ;
 		//      prev_count_tick += count_tick_len;
-		ProcessCapsules();	/* count down the lifetime of the capsules */
-		ProcessCapsules();	/* do it twice this time to be faster */
-		//      AnimateCurrents ();
-		ProcessPlayground();
-		ProcessPlayground();
-		ProcessPlayground();
-		ProcessPlayground();	/* this has to be done several times to be sure */
-		ProcessDisplayColumn();
+		takeover_board_final_step(&to_board);
+		LeaderColor = takeover_board_leader(&to_board, &LeaderCapsuleCount);
+		update_current_phases();
 		ShowPlayground(target);
 		our_SDL_flip_wrapper();
 	}			/* while (countdown) */
@@ -651,6 +608,31 @@ int droid_takeover(struct enemy *target, float *needed_capsules_ratio)
 	}
 };				// int Takeover( int enemynum ) 
 
+/*-----------------------------------------------------------------
+ * This function looks for the row where the opponent should set its
+ * next capsule, with a search in the state of the running game.
+ * It returns -1 if the opponent had better wait.
+ *-----------------------------------------------------------------*/
+static int search_opponent_row(int countdown, int cursor)
+{
+	struct takeover_game game;
+	int playouts;
+
+	game.board = to_board;
+	game.capsules[YourColor] = NumCapsules[YOU];
+	game.capsules[OpponentColor] = NumCapsules[ENEMY];
+	game.lifetime[YourColor] = CAPSULE_COUNTDOWN * 2;
+	game.lifetime[OpponentColor] = CAPSULE_COUNTDOWN;
+	game.ticks_left = countdown * TO_COUNT_TICK_LEN / TO_MOVE_TICK_LEN;
+
+	if (GameConfig.difficulty_level == DIFFICULTY_HARD)
+		playouts = TO_SEARCH_PLAYOUTS_HARD;
+	else
+		playouts = TO_SEARCH_PLAYOUTS_NORMAL;
+
+	return takeover_search_row(&game, OpponentColor, cursor, playouts, TO_SEARCH_BUDGET, MyRandom(1000000) + 1);
+}
+
 /*-----------------------------------------------------------------
  * This function performs the enemy movements in the takeover game,
  * but it does this in an advanced way, that has not been there in
@@ -680,27 +662,38 @@ void advanced_enemy_takeover_movements(const int countdown)
 	if (NumCapsules[ENEMY] == 0)
 		return;
 
-	// Disable AI waiting on easy
-	if (GameConfig.difficulty_level !=  DIFFICULTY_EASY) {
-		// Wait for the player to move
-		if ((LeaderColor != YourColor) && ((NumCapsules[YOU]-NumCapsules[ENEMY]) >= 0) && (!endgame) && (NumCapsules[ENEMY] < max_opponent_capsules))
+	if (GameConfig.difficulty_level != DIFFICULTY_EASY) {
+		// Play the game out from each possible move, and go for the one
+		// winning most often. The search is only done again every few
+		// ticks, to stay within the time of a motion tick.
+		if (opponent_target_age <= 0) {
+			opponent_target = search_opponent_row(countdown, row);
+			opponent_target_age = TO_SEARCH_INTERVAL;
+		}
+		opponent_target_age--;
+
+		BestTarget = opponent_target;
+		DebugPrintf(TAKEOVER_MOVEMENT_DEBUG, "\nBest target row searched : %d.", BestTarget);
+
+		// Waiting is better
+		if (BestTarget == -1)
 			return;
-	}
-        
-	// First we're going to find out which target place is
-	// best choice for the next capsule setting.
-
-	for (test_row = 0; test_row < NUM_LINES; test_row++) {
-		int test_value = EvaluatePosition(OpponentColor, test_row, 1, endgame) + 0.01*test_row;
-		if (test_value > BestValue) {
-			BestTarget = test_row;
-			BestValue = test_value;
+	} else {
+		// First we're going to find out which target place is
+		// best choice for the next capsule setting.
+
+		for (test_row = 0; test_row < NUM_LINES; test_row++) {
+			int test_value = EvaluatePosition(OpponentColor, test_row, 1, endgame) + 0.01*test_row;
+			if (test_value > BestValue) {
+				BestTarget = test_row;
+				BestValue = test_value;
+			}
 		}
-	}
-	DebugPrintf(TAKEOVER_MOVEMENT_DEBUG, "\nBest target row found : %d.", BestTarget);
+		DebugPrintf(TAKEOVER_MOVEMENT_DEBUG, "\nBest target row found : %d.", BestTarget);
 
-	if ((BestValue < 0.5) && (!endgame) && (LeaderColor == OpponentColor)) //it isn't worth it
-		return;
+		if ((BestValue < 0.5) && (!endgame) && (LeaderColor == OpponentColor)) //it isn't worth it
+			return;
+	}
         
 	// Now we can start to move into the right direction.
 
@@ -733,14 +726,11 @@ void advanced_enemy_takeover_movements(const int countdown)
 
 	case 2:		/* Try to set capsule */
 		if (MyRandom(100) <= SetProbability) {
-			if ((row >= 0) && 
-			    (ToPlayground[OpponentColor][0][row] != CABLE_END) && (ActivationMap[OpponentColor][0][row] == INACTIVE)) {
+			if (takeover_board_set_capsule(&to_board, OpponentColor, row, CAPSULE_COUNTDOWN)) {
 				NumCapsules[ENEMY]--;
 				Takeover_Set_Capsule_Sound();
-				ToPlayground[OpponentColor][0][row] = AMPLIFIER;
-				ActivationMap[OpponentColor][0][row] = ACTIVE1;
-				CapsuleCountdown[OpponentColor][0][row] = CAPSULE_COUNTDOWN;
 				row = -1;	/* For the next capsule: startpos */
+				opponent_target_age = 0;
 			} else {
 				row += direction;
 			}
@@ -834,7 +824,6 @@ int do_takeover(int player_capsules, int opponent_capsules, int game_length, ene
 	char *message;
 	int player_won = 0;
 	int FinishTakeover = FALSE;
-	int row;
 	int old_status;
 
 	game_length += 5*Me.skill_level[get_program_index_with_name("Animal Magnetism")];
@@ -852,12 +841,6 @@ int do_takeover(int player_capsules, int opponent_capsules, int game_length, ene
 	while (!FinishTakeover) {
 		// Init Color-column and Capsule-Number for each opponent and your color 
 		//
-		for (row = 0; row < NUM_LINES; row++) {
-			DisplayColumn[row] = (row % 2);
-			CapsuleCountdown[YELLOW][0][row] = -1;
-			CapsuleCountdown[PURPLE][0][row] = -1;
-		}		// for row 
-
 		YourColor = YELLOW;
 		OpponentColor = PURPLE;
 
@@ -866,7 +849,11 @@ int do_takeover(int player_capsules, int opponent_capsules, int game_length, ene
 
 		NumCapsules[YOU] = player_capsules;
 		NumCapsules[ENEMY] = opponent_capsules;
-		InventPlayground();
+		opponent_target = -1;
+		opponent_target_age = 0;
+		takeover_board_invent(&to_board);
+		LeaderColor = takeover_board_leader(&to_board, &LeaderCapsuleCount);
+		update_current_phases();
 
 		EvaluatePlayground();
 
@@ -998,7 +985,7 @@ static void ShowPlayground(enemy * target)
 	// Fill the display column with its colors 
 	for (i = 0; i < NUM_LINES; i++) {
 		Set_Rect(Target_Rect, xoffs + LEDCOLUMN_X, yoffs + LEDCOLUMN_Y + i * (FILL_BLOCK_HEIGHT + 2), 0, 0);
-		display_image_on_screen (&FillBlocks[DisplayColumn[i]], Target_Rect.x, Target_Rect.y, IMAGE_NO_TRANSFO);
+		display_image_on_screen (&FillBlocks[takeover_board_row_color(&to_board, i)], Target_Rect.x, Target_Rect.y, IMAGE_NO_TRANSFO);
 	}
 
 	// Show the yellow playground 
@@ -1006,7 +993,7 @@ static void ShowPlayground(enemy * target)
 		for (j = 0; j < NUM_LINES; j++) {
 			Set_Rect(Target_Rect, xoffs + PlaygroundStart[YELLOW].x + i * TO_BLOCKLEN,
 				 yoffs + PlaygroundStart[YELLOW].y + j * TO_BLOCKHEIGHT, 0, 0);
-			block = ToPlayground[YELLOW][i][j] + ActivationMap[YELLOW][i][j] * TO_BLOCKS;
+			block = to_board.blocks[YELLOW][i][j] + CurrentPhases[YELLOW][i][j] * TO_BLOCKS;
 			display_image_on_screen (&ToGameBlocks[block], Target_Rect.x, Target_Rect.y, IMAGE_NO_TRANSFO);
 		}
 
@@ -1016,7 +1003,7 @@ static void ShowPlayground(enemy * target)
 			Set_Rect(Target_Rect,
 				 xoffs + PlaygroundStart[PURPLE].x + (NUM_LAYERS - i - 2) * TO_BLOCKLEN,
 				 yoffs + PlaygroundStart[PURPLE].y + j * TO_BLOCKHEIGHT, 0, 0);
-			block = ToPlayground[PURPLE][i][j] + (NUM_PHASES + ActivationMap[PURPLE][i][j]) * TO_BLOCKS;
+			block = to_board.blocks[PURPLE][i][j] + (NUM_PHASES + CurrentPhases[PURPLE][i][j]) * TO_BLOCKS;
 			display_image_on_screen (&ToGameBlocks[block], Target_Rect.x, Target_Rect.y, IMAGE_NO_TRANSFO);
 		}
 
@@ -1045,182 +1032,6 @@ static void ShowPlayground(enemy * target)
 
 };				// ShowPlayground 
 
-/*-----------------------------------------------------------------
- * @Desc: Clears Playground (and ActivationMap) to default start-values
- * @Ret:  void
- *
- *-----------------------------------------------------------------*/
-void ClearPlayground(void)
-{
-	int color, layer, row;
-
-	for (color = YELLOW; color < TO_COLORS; color++)
-		for (layer = 0; layer < NUM_LAYERS; layer++)
-			for (row = 0; row < NUM_LINES; row++) {
-				ActivationMap[color][layer][row] = INACTIVE;
-				if (layer < TO_COLORS - 1)
-					ToPlayground[color][layer][row] = CABLE;
-				else
-					ToPlayground[color][layer][row] = INACTIVE;
-			}
-
-	for (row = 0; row < NUM_LINES; row++)
-		DisplayColumn[row] = row % 2;
-
-};				// void ClearPlayground ( void )
-
-/* -----------------------------------------------------------------
- * This function generates a random playground for the takeover game
- * ----------------------------------------------------------------- */
-void InventPlayground(void)
-{
-	int anElement;
-	int newElement;
-	int row, layer;
-	int color = YELLOW;
-
-	// first clear the playground: we depend on this !! 
-	//
-	ClearPlayground();
-
-	for (color = YELLOW; color < TO_COLORS; color++) {
-		for (layer = 1; layer < NUM_LAYERS - 1; layer++) {
-			for (row = 0; row < NUM_LINES; row++) {
-				if (ToPlayground[color][layer][row] != CABLE)
-					continue;
-
-				newElement = MyRandom(TO_ELEMENTS - 1);
-				if (MyRandom(MAX_PROB) > ElementProb[newElement]) {
-					row--;
-					continue;
-				}
-
-				switch (newElement) {
-				case EL_CABLE:	/* has not to be set any more */
-					anElement = ToPlayground[color][layer - 1][row];
-					if (BlockClass[anElement] == NON_CONNECTOR)
-						ToPlayground[color][layer][row] = EMPTY;
-					break;
-
-				case EL_CABLE_END:
-					anElement = ToPlayground[color][layer - 1][row];
-					if (BlockClass[anElement] == NON_CONNECTOR)
-						ToPlayground[color][layer][row] = EMPTY;
-					else
-						ToPlayground[color][layer][row] = CABLE_END;
-					break;
-
-				case EL_AMPLIFIER:
-					anElement = ToPlayground[color][layer - 1][row];
-					if (BlockClass[anElement] == NON_CONNECTOR)
-						ToPlayground[color][layer][row] = EMPTY;
-					else
-						ToPlayground[color][layer][row] = AMPLIFIER;
-					break;
-
-				case EL_COLOR_EXCHANGER:
-					if (layer != 2) {	/* only existing on layer 2 */
-						row--;
-						continue;
-					}
-
-					anElement = ToPlayground[color][layer - 1][row];
-					if (BlockClass[anElement] == NON_CONNECTOR)
-						ToPlayground[color][layer][row] = EMPTY;
-					else
-						ToPlayground[color][layer][row] = COLOR_EXCHANGER;
-					break;
-
-				case EL_SEPARATOR:
-					if (row > NUM_LINES - 3) {
-						/* try again */
-						row--;
-						break;
-					}
-
-					anElement = ToPlayground[color][layer - 1][row + 1];
-					if (BlockClass[anElement] == NON_CONNECTOR) {
-						/* try again */
-						row--;
-						break;
-					}
-
-					/* don't destroy branch in prev. layer */
-					anElement = ToPlayground[color][layer - 1][row];
-					if (anElement == SEPARATOR_H || anElement == SEPARATOR_L) {
-						row--;
-						break;
-					}
-					anElement = ToPlayground[color][layer - 1][row + 2];
-					if (anElement == SEPARATOR_H || anElement == SEPARATOR_L) {
-						row--;
-						break;
-					}
-
-					/* cut off cables in last layer, if any */
-					anElement = ToPlayground[color][layer - 1][row];
-					if (BlockClass[anElement] == CONNECTOR)
-						ToPlayground[color][layer - 1][row] = CABLE_END;
-
-					anElement = ToPlayground[color][layer - 1][row + 2];
-					if (BlockClass[anElement] == CONNECTOR)
-						ToPlayground[color][layer - 1][row + 2] = CABLE_END;
-
-					/* set the branch itself */
-					ToPlayground[color][layer][row] = SEPARATOR_H;
-					ToPlayground[color][layer][row + 1] = SEPARATOR_M;
-					ToPlayground[color][layer][row + 2] = SEPARATOR_L;
-
-					row += 2;
-					break;
-
-				case EL_GATE:
-					if (row > NUM_LINES - 3) {
-						/* try again */
-						row--;
-						break;
-					}
-
-					anElement = ToPlayground[color][layer - 1][row];
-					if (BlockClass[anElement] == NON_CONNECTOR) {
-						/* try again */
-						row--;
-						break;
-					}
-					anElement = ToPlayground[color][layer - 1][row + 2];
-					if (BlockClass[anElement] == NON_CONNECTOR) {
-						/* try again */
-						row--;
-						break;
-					}
-
-					/* cut off cables in last layer, if any */
-					anElement = ToPlayground[color][layer - 1][row + 1];
-					if (BlockClass[anElement] == CONNECTOR)
-						ToPlayground[color][layer - 1][row + 1] = CABLE_END;
-
-					/* set the GATE itself */
-					ToPlayground[color][layer][row] = GATE_H;
-					ToPlayground[color][layer][row + 1] = GATE_M;
-					ToPlayground[color][layer][row + 2] = GATE_L;
-
-					row += 2;
-					break;
-
-				default:
-					row--;
-					break;
-
-				}	/* switch NewElement */
-
-			}	/* for row */
-
-		}		/* for layer */
-
-	}			/* for color */
-
-}				/* InventPlayground */
-
 /* -----------------------------------------------------------------
  * This function generates a random playground for the takeover game
  * ----------------------------------------------------------------- */
@@ -1243,7 +1054,7 @@ Starting to evaluate side nr. %d.  Results displayed below:\n", color);
 			for (row = 0; row < NUM_LINES; row++) {
 
 				// we examine this particular spot
-				newElement = ToPlayground[color][layer][row];
+				newElement = to_board.blocks[color][layer][row];
 
 				switch (newElement) {
 				case CABLE:	/* has not to be set any more */
@@ -1319,13 +1130,13 @@ float EvaluatePosition(const int color, const int row, const int layer, const in
 
 	if (layer == NUM_LAYERS - 1) {
 		DebugPrintf(EVAL_DEBUG, "End layer reached...");
-                if (IsActive(color, row)) {
+                if (takeover_board_is_active(&to_board, color, NUM_LAYERS - 1, row)) {
                         DebugPrintf(EVAL_DEBUG, "same color already active... returning 0.01 ");
                         return (0.01*EvaluateCenterPosition(opp_color, row, layer, endgame));
-		} else if (DisplayColumn[row] == color) {
+		} else if (takeover_board_row_color(&to_board, row) == color) {
 			DebugPrintf(EVAL_DEBUG, "same color... returning 0.05 ");
 			return (0.05*EvaluateCenterPosition(opp_color, row, layer, endgame));
-		} else if (IsActive(opp_color, row)) {
+		} else if (takeover_board_is_active(&to_board, opp_color, NUM_LAYERS - 1, row)) {
 			DebugPrintf(EVAL_DEBUG, "different color, but active... returning 9 ");
                         if (endgame)
                                 return (90*EvaluateCenterPosition(opp_color, row, layer, endgame));
@@ -1340,9 +1151,9 @@ float EvaluatePosition(const int color, const int row, const int layer, const in
 		}
 	}
 
-	if (ActivationMap[color][layer][row] == ACTIVE1) { return (0); }
+	if (takeover_board_is_active(&to_board, color, layer, row)) { return (0); }
 
-	newElement = ToPlayground[color][layer][row];
+	newElement = to_board.blocks[color][layer][row];
 
 	switch (newElement) {
 	case CABLE:		/* has not to be set any more */
@@ -1366,7 +1177,7 @@ float EvaluatePosition(const int color, const int row, const int layer, const in
 
 	case GATE_H:
 		DebugPrintf(EVAL_DEBUG, "GATE reached... stopping...\n");
-                if (ActivationMap[color][layer][row + 2] >= ACTIVE1) {
+                if (takeover_board_is_active(&to_board, color, layer, row + 2)) {
                         return (5 * EvaluatePosition(color, row + 1, layer + 1, endgame));
                 } else if (endgame) {
                         return (0.5 * EvaluatePosition(color, row + 1, layer + 1, endgame));
@@ -1377,7 +1188,7 @@ float EvaluatePosition(const int color, const int row, const int layer, const in
 
 	case GATE_L:
 		DebugPrintf(EVAL_DEBUG, "GATE reached... stopping...\n");
-                if (ActivationMap[color][layer][row - 2] >= ACTIVE1) {
+                if (takeover_board_is_active(&to_board, color, layer, row - 2)) {
                         return (5 * EvaluatePosition(color, row - 1, layer + 1, endgame));
                 } else if (endgame) {
                         return (0.5 * EvaluatePosition(color, row - 1, layer + 1, endgame));
@@ -1417,13 +1228,13 @@ float EvaluateCenterPosition(const int color, const int row, const int layer, co
                 return (1); //hit the player's end
         }
 
-	newElement = ToPlayground[color][layer][row];
+	newElement = to_board.blocks[color][layer][row];
 
 	switch (newElement) {
 	case CABLE:		// has not to be set any more 
 		return (EvaluateCenterPosition(color, row, layer - 1, endgame));
 	case AMPLIFIER:
-                if (ActivationMap[color][layer+1][row] >= ACTIVE1) { //very low hope to take this over
+                if (takeover_board_is_active(&to_board, color, layer + 1, row)) { //very low hope to take this over
                         return (0.06);
                 } else if (endgame) {
                         return (1);
@@ -1472,219 +1283,41 @@ float EvaluateCenterPosition(const int color, const int row, const int layer, co
 
 };
 
-/*-----------------------------------------------------------------
- * @Desc: process the playground following its intrinsic logic
- *
- * @Ret: void
- *
- *-----------------------------------------------------------------*/
-void ProcessPlayground(void)
+/* -----------------------------------------------------------------
+ * This function follows the currents of the playground: the blocks the
+ * current just reached start with the first active phase, and the other
+ * active blocks keep their phase
+ * ----------------------------------------------------------------- */
+static void update_current_phases(void)
 {
 	int color, layer, row;
-	int TurnActive = FALSE;
-
-	for (color = YELLOW; color < TO_COLORS; color++) {
-		for (layer = 1; layer < NUM_LAYERS; layer++) {
-			for (row = 0; row < NUM_LINES; row++) {
-				if (layer == NUM_LAYERS - 1) {
-					if (IsActive(color, row))
-						ActivationMap[color][layer][row] = ACTIVE1;
-					else
-						ActivationMap[color][layer][row] = INACTIVE;
-
-					continue;
-				}
-				/* if last layer */
-				TurnActive = FALSE;
-
-				switch (ToPlayground[color][layer][row]) {
-				case COLOR_EXCHANGER:
-				case SEPARATOR_M:
-				case GATE_H:
-				case GATE_L:
-				case CABLE:
-					if (ActivationMap[color][layer - 1][row] >= ACTIVE1)
-						TurnActive = TRUE;
-					break;
-
-				case AMPLIFIER:
-					if (ActivationMap[color][layer - 1][row] >= ACTIVE1)
-						TurnActive = TRUE;
-
-					// additional enforcers stay active by themselves...
-					if (ActivationMap[color][layer][row] >= ACTIVE1)
-						TurnActive = TRUE;
-
-					break;
-
-				case CABLE_END:
-					break;
-
-				case SEPARATOR_H:
-					if (ActivationMap[color][layer][row + 1] >= ACTIVE1)
-						TurnActive = TRUE;
-					break;
-
-				case SEPARATOR_L:
-					if (ActivationMap[color][layer][row - 1] >= ACTIVE1)
-						TurnActive = TRUE;
-					break;
-
-				case GATE_M:
-					if ((ActivationMap[color][layer][row - 1] >= ACTIVE1)
-					    && (ActivationMap[color][layer][row + 1] >= ACTIVE1))
-						TurnActive = TRUE;
-
-					break;
-
-				default:
-					break;
-				}	/* switch */
-
-				if (TurnActive) {
-					if (ActivationMap[color][layer][row] == INACTIVE)
-						ActivationMap[color][layer][row] = ACTIVE1;
-				} else
-					ActivationMap[color][layer][row] = INACTIVE;
-
-			}	/* for row */
-
-		}		/* for layer */
-
-	}			/* for color */
-
-	return;
-};				// void ProcessPlayground ( void )
-
-/** 
- * This function sets the correct values for the status column in the
- * middle of the takeover game field.
- * Blinking LEDs are realized here as well.
- */
-void ProcessDisplayColumn(void)
-{
-	static int CLayer = 3;	/* the connection-layer to the Column */
-	static int flicker_color = 0;
-	int row;
-	int YellowCounter, PurpleCounter;
-
-	flicker_color = !flicker_color;
-
-	for (row = 0; row < NUM_LINES; row++) {
-		// unquestioned yellow
-		if ((ActivationMap[YELLOW][CLayer][row] >= ACTIVE1) && (ActivationMap[PURPLE][CLayer][row] == INACTIVE)) {
-			// change color?
-			if (ToPlayground[YELLOW][CLayer - 1][row] == COLOR_EXCHANGER)
-				DisplayColumn[row] = PURPLE;
-			else
-				DisplayColumn[row] = YELLOW;
-			continue;
-		}
-		// clearly purple
-		if ((ActivationMap[YELLOW][CLayer][row] == INACTIVE) && (ActivationMap[PURPLE][CLayer][row] >= ACTIVE1)) {
-			// change color?
-			if (ToPlayground[PURPLE][CLayer - 1][row] == COLOR_EXCHANGER)
-				DisplayColumn[row] = YELLOW;
-			else
-				DisplayColumn[row] = PURPLE;
-
-			continue;
-		}
-		// undecided: flimmering
-		if ((ActivationMap[YELLOW][CLayer][row] >= ACTIVE1) && (ActivationMap[PURPLE][CLayer][row] >= ACTIVE1)) {
-			// change color?
-			if ((ToPlayground[YELLOW][CLayer - 1][row] == COLOR_EXCHANGER) &&
-			    (ToPlayground[PURPLE][CLayer - 1][row] != COLOR_EXCHANGER))
-				DisplayColumn[row] = PURPLE;
-			else if ((ToPlayground[YELLOW][CLayer - 1][row] != COLOR_EXCHANGER) &&
-				 (ToPlayground[PURPLE][CLayer - 1][row] == COLOR_EXCHANGER))
-				DisplayColumn[row] = YELLOW;
-			else {
-				if (flicker_color == 0)
-					DisplayColumn[row] = YELLOW;
-				else
-					DisplayColumn[row] = PURPLE;
-			}	/* if - else if - else */
-
-		}
-		/* if undecided */
-	}			/* for */
-
-	// evaluate the winning color
-	YellowCounter = 0;
-	PurpleCounter = 0;
-	for (row = 0; row < NUM_LINES; row++)
-		if (DisplayColumn[row] == YELLOW)
-			YellowCounter++;
-		else
-			PurpleCounter++;
-
-	LeaderCapsuleCount = (PurpleCounter > YellowCounter) ? PurpleCounter : YellowCounter;
-	if (PurpleCounter < YellowCounter)
-		LeaderColor = YELLOW;
-	else if (PurpleCounter > YellowCounter)
-		LeaderColor = PURPLE;
-	else
-		LeaderColor = DRAW;
-
-	return;
-};				// void ProcessDisplayColumn 
-
-/** 
- * This function does the countdown of the capsules and kills them if 
- * they are too old.
- */
-void ProcessCapsules(void)
-{
-	int row;
-	int color;
 
 	for (color = YELLOW; color <= PURPLE; color++)
-		for (row = 0; row < NUM_LINES; row++) {
-			if (CapsuleCountdown[color][0][row] > 0)
-				CapsuleCountdown[color][0][row]--;
-
-			if (CapsuleCountdown[color][0][row] == 0) {
-				CapsuleCountdown[color][0][row] = -1;
-				ActivationMap[color][0][row] = INACTIVE;
-				ToPlayground[color][0][row] = CABLE;
+		for (layer = 0; layer < NUM_LAYERS; layer++)
+			for (row = 0; row < NUM_LINES; row++) {
+				if (!takeover_board_is_active(&to_board, color, layer, row))
+					CurrentPhases[color][layer][row] = INACTIVE;
+				else if (CurrentPhases[color][layer][row] == INACTIVE)
+					CurrentPhases[color][layer][row] = ACTIVE1;
 			}
-
-		}		/* for row */
-
-};				// void ProcessCapsules ( void )
-
-/**
- * This function tells, whether a Column-connection is active or not.
- * It returns TRUE or FALSE accordingly.
- */
-int IsActive(int color, int row)
-{
-	int CLayer = 3;		/* the connective Layer */
-	int TestElement = ToPlayground[color][CLayer - 1][row];
-
-	if ((ActivationMap[color][CLayer - 1][row] >= ACTIVE1) && (BlockClass[TestElement] == CONNECTOR))
-		return TRUE;
-	else
-		return FALSE;
-}				/* IsActive */
+}
 
 /* -----------------------------------------------------------------
  * This function animates the active cables: this is done by cycling 
  * over the active phases ACTIVE1-ACTIVE3, which are represented by 
  * different pictures in the playground
  * ----------------------------------------------------------------- */
-void AnimateCurrents(void)
+static void AnimateCurrents(void)
 {
 	int color, layer, row;
 
 	for (color = YELLOW; color <= PURPLE; color++)
 		for (layer = 0; layer < NUM_LAYERS; layer++)
 			for (row = 0; row < NUM_LINES; row++)
-				if (ActivationMap[color][layer][row] >= ACTIVE1) {
-					ActivationMap[color][layer][row]++;
-					if (ActivationMap[color][layer][row] == NUM_PHASES)
-						ActivationMap[color][layer][row] = ACTIVE1;
+				if (CurrentPhases[color][layer][row] >= ACTIVE1) {
+					CurrentPhases[color][layer][row]++;
+					if (CurrentPhases[color][layer][row] == NUM_PHASES)
+						CurrentPhases[color][layer][row] = ACTIVE1;
 				}
 
 	return;
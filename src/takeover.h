@@ -80,6 +80,18 @@ void to_show_banner(const char *left, const char *right);
 #define WAIT_AFTER_GAME		2*18	/* Wait after a deadlock */
 
 #define TO_TICK_LENGTH		40	/* Time in ms between ticks */
+#define TO_COUNT_TICK_LEN	100	/* Time in ms between countdown ticks */
+#define TO_MOVE_TICK_LEN	60	/* Time in ms between motion ticks */
+
+#define TO_PROCESS_PASSES	4	/* propagation passes per motion tick */
+#define TO_FINAL_STEPS		(CAPSULE_COUNTDOWN + 10)	/* steps after the end of the countdown */
+
+/* --------------- Opponent search --------------- */
+#define TO_SEARCH_BUDGET	15	/* max. time in ms to search for a move */
+#define TO_SEARCH_INTERVAL	4	/* motion ticks between two searches */
+#define TO_SEARCH_WAIT		8	/* motion ticks a waiting opponent is assumed to wait */
+#define TO_SEARCH_PLAYOUTS_NORMAL	240	/* games played out per search, normal difficulty */
+#define TO_SEARCH_PLAYOUTS_HARD		960	/* games played out per search, hard difficulty */
 
 /* --------------- Playground layout --------------- */
 
@@ -193,4 +205,53 @@ enum to_block_tyes {
 /* the playground type */
 typedef int playground_t[TO_COLORS][NUM_LAYERS][NUM_LINES];
 
+/* Rules followed by the current through the blocks of a layer */
+enum takeover_rule {
+	TO_RULE_PASS,		/* active if the block of the previous layer is active */
+	TO_RULE_HOLD,		/* stays active by itself once activated */
+	TO_RULE_FROM_BELOW,	/* active if the block below it was active */
+	TO_RULE_FROM_ABOVE,	/* active if the block above it is active */
+	TO_RULE_FROM_BOTH,	/* active if the blocks above and below it are active */
+	TO_RULE_CONNECT,	/* connects to the next layer */
+	TO_RULE_EXCHANGE,	/* exchanges the color of the current */
+	TO_NUM_RULES
+};
+
+/*
+ * The playground of a takeover game. The activations are packed into one
+ * bitmask per color and layer, bit N standing for row N, and so are the
+ * rows of each layer following each rule.
+ */
+struct takeover_board {
+	unsigned char blocks[TO_COLORS][NUM_LAYERS][NUM_LINES];
+	uint16_t rules[TO_COLORS][NUM_LAYERS][TO_NUM_RULES];
+	uint16_t active[TO_COLORS][NUM_LAYERS];
+	short capsule_countdown[TO_COLORS][NUM_LINES];	/* -1 if there is no capsule */
+	uint16_t purple_rows;	/* rows of the display column showing purple */
+	int flicker;		/* color shown by the undecided rows of the display column */
+};
+
+/* A takeover game, as played out by the opponent search */
+struct takeover_game {
+	struct takeover_board board;
+	int capsules[TO_COLORS];	/* capsules left to each color */
+	int lifetime[TO_COLORS];	/* lifetime of the capsules of each color, in motion ticks */
+	int ticks_left;			/* motion ticks before the end of the countdown */
+};
+
+// takeover_engine.c
+void takeover_board_clear(struct takeover_board *);
+void takeover_board_invent(struct takeover_board *);
+int takeover_board_is_active(const struct takeover_board *, int, int, int);
+int takeover_board_row_color(const struct takeover_board *, int);
+int takeover_board_set_capsule(struct takeover_board *, int, int, int);
+void takeover_board_process_capsules(struct takeover_board *);
+void takeover_board_process(struct takeover_board *);
+void takeover_board_process_display(struct takeover_board *);
+int takeover_board_leader(const struct takeover_board *, int *);
+void takeover_board_step(struct takeover_board *);
+void takeover_board_final_step(struct takeover_board *);
+int takeover_playout(struct takeover_game *, uint32_t *);
+int takeover_search_row(const struct takeover_game *, int, int, int, int, uint32_t);
+
 #endif
@@ -0,0 +1,643 @@
+/*
+ *
+ *   Copyright (c) 2026 FreedroidRPG development team
+ *
+ *
+ *  This file is part of Freedroid
+ *
+ *  Freedroid is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Freedroid is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Freedroid; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ *  MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file takeover_engine.c
+ * \brief Rules of the takeover game, and search of the opponent's moves.
+ *
+ * The activations of a takeover playground are packed into one bitmask per
+ * color and layer. When a playground is created, the block_rules table turns
+ * its blocks into masks of the rows following each propagation rule, so that
+ * the current goes through a whole layer with a few bitwise operations.
+ *
+ * Nothing here draws anything or waits: takeover.c renders the board between
+ * the steps of the game, and the opponent plays thousands of games out,
+ * without any rendering, to choose its moves.
+ */
+
+#define _takeover_engine_c 1
+
+#include "system.h"
+
+#include "defs.h"
+#include "struct.h"
+#include "global.h"
+#include "proto.h"
+#include "takeover.h"
+
+#define ROWS_MASK ((1 << NUM_LINES) - 1)
+#define RULE(r) (1 << (r))
+
+// Rules followed by the current through each block
+static const int block_rules[TO_BLOCKS] = {
+	[CABLE]           = RULE(TO_RULE_PASS) | RULE(TO_RULE_CONNECT),
+	[CABLE_END]       = 0,
+	[AMPLIFIER]       = RULE(TO_RULE_PASS) | RULE(TO_RULE_HOLD) | RULE(TO_RULE_CONNECT),
+	[COLOR_EXCHANGER] = RULE(TO_RULE_PASS) | RULE(TO_RULE_EXCHANGE) | RULE(TO_RULE_CONNECT),
+	[SEPARATOR_H]     = RULE(TO_RULE_FROM_BELOW) | RULE(TO_RULE_CONNECT),
+	[SEPARATOR_M]     = RULE(TO_RULE_PASS),
+	[SEPARATOR_L]     = RULE(TO_RULE_FROM_ABOVE) | RULE(TO_RULE_CONNECT),
+	[GATE_H]          = RULE(TO_RULE_PASS),
+	[GATE_M]          = RULE(TO_RULE_FROM_BOTH) | RULE(TO_RULE_CONNECT),
+	[GATE_L]          = RULE(TO_RULE_PASS),
+	[EMPTY]           = 0
+};
+
+//--------------------
+// Probability of the various elements
+//
+#define MAX_PROB		100
+static const int ElementProb[TO_ELEMENTS] = {
+	100,			// EL_CABLE
+	2,			// EL_CABLE_END
+	5,			// EL_AMPLIFIER
+	5,			// EL_COLOR_EXCHANGER: only on last layer
+	5,			// EL_SEPARATOR
+	5			// EL_GATE
+};
+
+static int connects(int block)
+{
+	return block_rules[block] & RULE(TO_RULE_CONNECT);
+}
+
+static int count_rows(uint16_t rows)
+{
+	int nb = 0;
+
+	while (rows) {
+		rows &= rows - 1;
+		nb++;
+	}
+
+	return nb;
+}
+
+/**
+ * Build the rule masks of a layer from its blocks.
+ */
+static void update_layer_rules(struct takeover_board *b, int color, int layer)
+{
+	int row, rule;
+
+	memset(b->rules[color][layer], 0, sizeof(b->rules[color][layer]));
+
+	for (row = 0; row < NUM_LINES; row++) {
+		for (rule = 0; rule < TO_NUM_RULES; rule++) {
+			if (block_rules[b->blocks[color][layer][row]] & RULE(rule))
+				b->rules[color][layer][rule] |= 1 << row;
+		}
+	}
+}
+
+/**
+ * Clear a playground: cables everywhere, no current, no capsule.
+ */
+void takeover_board_clear(struct takeover_board *b)
+{
+	int color, layer, row;
+
+	memset(b, 0, sizeof(*b));
+
+	for (color = YELLOW; color < TO_COLORS; color++) {
+		for (layer = 0; layer < NUM_LAYERS; layer++) {
+			for (row = 0; row < NUM_LINES; row++)
+				b->blocks[color][layer][row] = CABLE;
+			update_layer_rules(b, color, layer);
+		}
+
+		for (row = 0; row < NUM_LINES; row++)
+			b->capsule_countdown[color][row] = -1;
+	}
+
+	// The display column starts alternating the colors
+	for (row = 0; row < NUM_LINES; row++) {
+		if (row % 2)
+			b->purple_rows |= 1 << row;
+	}
+}
+
+/**
+ * Generate a random playground.
+ */
+void takeover_board_invent(struct takeover_board *b)
+{
+	int anElement;
+	int newElement;
+	int row, layer;
+	int color;
+
+	// first clear the playground: we depend on this !!
+	//
+	takeover_board_clear(b);
+
+	for (color = YELLOW; color < TO_COLORS; color++) {
+		unsigned char (*blocks)[NUM_LINES] = b->blocks[color];
+
+		for (layer = 1; layer < NUM_LAYERS - 1; layer++) {
+			for (row = 0; row < NUM_LINES; row++) {
+				if (blocks[layer][row] != CABLE)
+					continue;
+
+				newElement = MyRandom(TO_ELEMENTS - 1);
+				if (MyRandom(MAX_PROB) > ElementProb[newElement]) {
+					row--;
+					continue;
+				}
+
+				switch (newElement) {
+				case EL_CABLE:	/* has not to be set any more */
+					anElement = blocks[layer - 1][row];
+					if (!connects(anElement))
+						blocks[layer][row] = EMPTY;
+					break;
+
+				case EL_CABLE_END:
+					anElement = blocks[layer - 1][row];
+					if (!connects(anElement))
+						blocks[layer][row] = EMPTY;
+					else
+						blocks[layer][row] = CABLE_END;
+					break;
+
+				case EL_AMPLIFIER:
+					anElement = blocks[layer - 1][row];
+					if (!connects(anElement))
+						blocks[layer][row] = EMPTY;
+					else
+						blocks[layer][row] = AMPLIFIER;
+					break;
+
+				case EL_COLOR_EXCHANGER:
+					if (layer != 2) {	/* only existing on layer 2 */
+						row--;
+						continue;
+					}
+
+					anElement = blocks[layer - 1][row];
+					if (!connects(anElement))
+						blocks[layer][row] = EMPTY;
+					else
+						blocks[layer][row] = COLOR_EXCHANGER;
+					break;
+
+				case EL_SEPARATOR:
+					if (row > NUM_LINES - 3) {
+						/* try again */
+						row--;
+						break;
+					}
+
+					anElement = blocks[layer - 1][row + 1];
+					if (!connects(anElement)) {
+						/* try again */
+						row--;
+						break;
+					}
+
+					/* don't destroy branch in prev. layer */
+					anElement = blocks[layer - 1][row];
+					if (anElement == SEPARATOR_H || anElement == SEPARATOR_L) {
+						row--;
+						break;
+					}
+					anElement = blocks[layer - 1][row + 2];
+					if (anElement == SEPARATOR_H || anElement == SEPARATOR_L) {
+						row--;
+						break;
+					}
+
+					/* cut off cables in last layer, if any */
+					anElement = blocks[layer - 1][row];
+					if (connects(anElement))
+						blocks[layer - 1][row] = CABLE_END;
+
+					anElement = blocks[layer - 1][row + 2];
+					if (connects(anElement))
+						blocks[layer - 1][row + 2] = CABLE_END;
+
+					/* set the branch itself */
+					blocks[layer][row] = SEPARATOR_H;
+					blocks[layer][row + 1] = SEPARATOR_M;
+					blocks[layer][row + 2] = SEPARATOR_L;
+
+					row += 2;
+					break;
+
+				case EL_GATE:
+					if (row > NUM_LINES - 3) {
+						/* try again */
+						row--;
+						break;
+					}
+
+					anElement = blocks[layer - 1][row];
+					if (!connects(anElement)) {
+						/* try again */
+						row--;
+						break;
+					}
+					anElement = blocks[layer - 1][row + 2];
+					if (!connects(anElement)) {
+						/* try again */
+						row--;
+						break;
+					}
+
+					/* cut off cables in last layer, if any */
+					anElement = blocks[layer - 1][row + 1];
+					if (connects(anElement))
+						blocks[layer - 1][row + 1] = CABLE_END;
+
+					/* set the GATE itself */
+					blocks[layer][row] = GATE_H;
+					blocks[layer][row + 1] = GATE_M;
+					blocks[layer][row + 2] = GATE_L;
+
+					row += 2;
+					break;
+
+				default:
+					row--;
+					break;
+
+				}	/* switch NewElement */
+
+			}	/* for row */
+
+		}		/* for layer */
+
+		for (layer = 0; layer < NUM_LAYERS; layer++)
+			update_layer_rules(b, color, layer);
+
+	}			/* for color */
+}
+
+/**
+ * Tell if the current goes through a block of the playground.
+ */
+int takeover_board_is_active(const struct takeover_board *b, int color, int layer, int row)
+{
+	if (row < 0 || row >= NUM_LINES)
+		return FALSE;
+
+	return (b->active[color][layer] >> row) & 1;
+}
+
+/**
+ * Color shown by a row of the display column.
+ */
+int takeover_board_row_color(const struct takeover_board *b, int row)
+{
+	return ((b->purple_rows >> row) & 1) ? PURPLE : YELLOW;
+}
+
+/*
+ * Rows where a color can set a capsule: the rows without a capsule, which do
+ * not start with a cable end.
+ */
+static uint16_t capsule_rows(const struct takeover_board *b, int color)
+{
+	uint16_t rows = 0;
+	int row;
+
+	for (row = 0; row < NUM_LINES; row++) {
+		if (b->blocks[color][0][row] != CABLE_END)
+			rows |= 1 << row;
+	}
+
+	return rows & ~b->active[color][0];
+}
+
+/**
+ * Set a capsule at the start of a row.
+ *
+ * \param lifetime Number of steps before the capsule vanishes
+ * \return FALSE if there is already a capsule at the start of the row, or if
+ * the row starts with a cable end
+ */
+int takeover_board_set_capsule(struct takeover_board *b, int color, int row, int lifetime)
+{
+	if (row < 0 || row >= NUM_LINES || takeover_board_is_active(b, color, 0, row) ||
+	    b->blocks[color][0][row] == CABLE_END)
+		return FALSE;
+
+	b->blocks[color][0][row] = AMPLIFIER;
+	b->active[color][0] |= 1 << row;
+	b->capsule_countdown[color][row] = lifetime;
+	return TRUE;
+}
+
+/**
+ * Count down the lifetime of the capsules, and remove the ones which are too
+ * old.
+ */
+void takeover_board_process_capsules(struct takeover_board *b)
+{
+	int color;
+
+	for (color = YELLOW; color < TO_COLORS; color++) {
+		uint16_t capsules = b->active[color][0];
+
+		while (capsules) {
+			int row = count_rows((capsules & -capsules) - 1);
+			capsules &= capsules - 1;
+
+			if (b->capsule_countdown[color][row] > 0)
+				b->capsule_countdown[color][row]--;
+
+			if (b->capsule_countdown[color][row] == 0) {
+				b->capsule_countdown[color][row] = -1;
+				b->active[color][0] &= ~(1 << row);
+				b->blocks[color][0][row] = CABLE;
+			}
+		}
+	}
+}
+
+/**
+ * Let the current go one step further through the playground.
+ *
+ * The layers are processed in order, and the rows of a layer from the top
+ * to the bottom, a block seeing the new state of the blocks processed before
+ * it and the previous state of the other ones. The masks are shifted to get
+ * the state of the blocks above (<< 1) and below (>> 1) each block.
+ */
+void takeover_board_process(struct takeover_board *b)
+{
+	int color, layer;
+
+	for (color = YELLOW; color < TO_COLORS; color++) {
+		uint16_t prev = b->active[color][0];
+
+		for (layer = 1; layer < NUM_LAYERS - 1; layer++) {
+			uint16_t *rules = b->rules[color][layer];
+			uint16_t old = b->active[color][layer];
+			uint16_t cur;
+
+			cur = (rules[TO_RULE_PASS] & prev) | (rules[TO_RULE_HOLD] & old);
+			cur |= rules[TO_RULE_FROM_BELOW] & (old >> 1);
+			cur |= rules[TO_RULE_FROM_ABOVE] & (cur << 1);
+			cur |= rules[TO_RULE_FROM_BOTH] & (cur << 1) & (old >> 1);
+
+			b->active[color][layer] = cur & ROWS_MASK;
+			prev = b->active[color][layer];
+		}
+
+		// The last layer is the connection to the display column
+		b->active[color][NUM_LAYERS - 1] = prev & b->rules[color][NUM_LAYERS - 2][TO_RULE_CONNECT];
+	}
+}
+
+/**
+ * Set the colors of the display column, from the currents reaching it.
+ * Undecided rows flicker between both colors.
+ */
+void takeover_board_process_display(struct takeover_board *b)
+{
+	uint16_t yellow = b->active[YELLOW][NUM_LAYERS - 1];
+	uint16_t purple = b->active[PURPLE][NUM_LAYERS - 1];
+	uint16_t yellow_exchange = b->rules[YELLOW][NUM_LAYERS - 2][TO_RULE_EXCHANGE];
+	uint16_t purple_exchange = b->rules[PURPLE][NUM_LAYERS - 2][TO_RULE_EXCHANGE];
+	uint16_t contested = yellow & purple;
+	uint16_t column;
+
+	b->flicker = !b->flicker;
+
+	// Rows reached by no current keep their color
+	column = b->purple_rows & ~(yellow | purple);
+
+	column |= yellow & ~purple & yellow_exchange;
+	column |= purple & ~yellow & ~purple_exchange;
+	column |= contested & yellow_exchange & ~purple_exchange;
+	if (b->flicker)
+		column |= contested & ~(yellow_exchange ^ purple_exchange);
+
+	b->purple_rows = column & ROWS_MASK;
+}
+
+/**
+ * Get the color leading the display column.
+ *
+ * \param count Filled with the number of rows of the leading color, if not NULL
+ * \return YELLOW, PURPLE or DRAW
+ */
+int takeover_board_leader(const struct takeover_board *b, int *count)
+{
+	int purple = count_rows(b->purple_rows);
+	int yellow = NUM_LINES - purple;
+
+	if (count)
+		*count = max(purple, yellow);
+
+	if (purple < yellow)
+		return YELLOW;
+	if (purple > yellow)
+		return PURPLE;
+	return DRAW;
+}
+
+/**
+ * Play one motion tick of the game.
+ */
+void takeover_board_step(struct takeover_board *b)
+{
+	int i;
+
+	takeover_board_process_capsules(b);
+
+	for (i = 0; i < TO_PROCESS_PASSES; i++)
+		takeover_board_process(b);
+
+	takeover_board_process_display(b);
+}
+
+/**
+ * Play one step of the end of the game, once the countdown is over. The
+ * capsules vanish twice as fast.
+ */
+void takeover_board_final_step(struct takeover_board *b)
+{
+	takeover_board_process_capsules(b);
+	takeover_board_step(b);
+}
+
+/* -----------------------------------------------------------------
+ * Opponent search
+ * ----------------------------------------------------------------- */
+
+static uint32_t next_random(uint32_t *seed)
+{
+	uint32_t x = *seed;
+
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	*seed = x;
+
+	return x;
+}
+
+/*
+ * Maybe set a capsule on a random free row, spreading the capsules left
+ * over the rest of the game.
+ */
+static void play_randomly(struct takeover_game *g, int color, uint32_t *seed)
+{
+	uint16_t free_rows = capsule_rows(&g->board, color);
+	int nb;
+
+	if (!g->capsules[color] || !free_rows)
+		return;
+
+	if (g->ticks_left > 0 && next_random(seed) % g->ticks_left >= g->capsules[color])
+		return;
+
+	// Take the nth free row
+	nb = next_random(seed) % count_rows(free_rows);
+	while (nb--)
+		free_rows &= free_rows - 1;
+
+	takeover_board_set_capsule(&g->board, color, count_rows((free_rows & -free_rows) - 1), g->lifetime[color]);
+	g->capsules[color]--;
+}
+
+static void play_tick(struct takeover_game *g, int yellow_plays, int purple_plays, uint32_t *seed)
+{
+	if (yellow_plays)
+		play_randomly(g, YELLOW, seed);
+	if (purple_plays)
+		play_randomly(g, PURPLE, seed);
+
+	takeover_board_step(&g->board);
+	g->ticks_left--;
+}
+
+/**
+ * Play a game out to its end, both colors setting their capsules at random.
+ *
+ * \return The winning color, or DRAW
+ */
+int takeover_playout(struct takeover_game *g, uint32_t *seed)
+{
+	int i;
+
+	while (g->ticks_left > 0)
+		play_tick(g, TRUE, TRUE, seed);
+
+	for (i = 0; i < TO_FINAL_STEPS; i++)
+		takeover_board_final_step(&g->board);
+
+	return takeover_board_leader(&g->board, NULL);
+}
+
+/*
+ * Play a game out after a move of a color: the color waits 'delay' ticks, sets
+ * a capsule on 'row' (-1 for none), and then both colors play at random.
+ * Return 2 for a win of the color, 1 for a draw, 0 for a loss.
+ */
+static int score_move(const struct takeover_game *game, int color, int row, int delay, uint32_t *seed)
+{
+	struct takeover_game g = *game;
+	int winner;
+
+	while (delay-- > 0 && g.ticks_left > 0)
+		play_tick(&g, color != YELLOW, color != PURPLE, seed);
+
+	if (row >= 0 && takeover_board_set_capsule(&g.board, color, row, g.lifetime[color]))
+		g.capsules[color]--;
+
+	winner = takeover_playout(&g, seed);
+	if (winner == color)
+		return 2;
+	if (winner == DRAW)
+		return 1;
+	return 0;
+}
+
+/**
+ * Look for the row where a color should set its next capsule, playing the
+ * game out many times after each possible move.
+ *
+ * \param game     Current state of the game
+ * \param color    Color to play
+ * \param cursor   Row the capsule of the color is on, -1 above the first row
+ * \param playouts Number of games to play out
+ * \param budget   Time in ms after which the search is stopped
+ * \param seed     Seed of the random moves, not 0
+ * \return The row to set the capsule on, or -1 if it is better to wait
+ */
+int takeover_search_row(const struct takeover_game *game, int color, int cursor, int playouts, int budget, uint32_t seed)
+{
+	int rows[NUM_LINES + 1];
+	int delays[NUM_LINES + 1];
+	int scores[NUM_LINES + 1] = { 0 };
+	int nb_moves = 0;
+	int done = 0, i;
+	Uint32 deadline = SDL_GetTicks() + budget;
+	uint16_t free_rows = capsule_rows(&game->board, color);
+
+	if (!game->capsules[color])
+		return -1;
+
+	// Setting a capsule takes one tick to move to each row on the way, and
+	// one more tick to set it
+	for (i = 0; i < NUM_LINES; i++) {
+		int delay = abs(i - cursor) + 1;
+
+		if (!((free_rows >> i) & 1) || delay >= game->ticks_left)
+			continue;
+
+		rows[nb_moves] = i;
+		delays[nb_moves] = delay;
+		nb_moves++;
+	}
+
+	// Waiting is the last move, so that it is only chosen if it is better
+	rows[nb_moves] = -1;
+	delays[nb_moves] = TO_SEARCH_WAIT;
+	nb_moves++;
+
+	if (!seed)
+		seed = 1;
+
+	while (done < playouts) {
+		for (i = 0; i < nb_moves; i++)
+			scores[i] += score_move(game, color, rows[i], delays[i], &seed);
+		done += nb_moves;
+
+		if (budget && SDL_GetTicks() >= deadline)
+			break;
+	}
+
+	int best = 0;
+	for (i = 1; i < nb_moves; i++) {
+		if (scores[i] > scores[best])
+			best = i;
+	}
+
+	return rows[best];
+}
+
+#undef _takeover_engine_c
@@ -46,8 +46,6 @@
 static int MyCursorX;
 static int MyCursorY;
 
-static int display_char_disabled;
-
 static struct {
 	struct auto_string *text;
 	struct font *font;
@@ -64,11 +62,19 @@ static struct {
  */
 int get_lines_needed(const char *text, SDL_Rect t_rect, float line_height_factor)
 {
-	t_rect.h = 32767; // arbitrary large number
-	display_char_disabled = TRUE;
-	int lines = display_text(text, t_rect.x, t_rect.y, &t_rect, line_height_factor);
-	display_char_disabled = FALSE;
-	return lines;
+	if (text == NULL)
+		return 0;
+
+	// Use the pre-computed layout of the text, as if it was displayed
+	// in an arbitrary large rectangle
+	struct text_layout *layout = get_text_layout(get_current_font(), text, t_rect.x, &t_rect, line_height_factor);
+	struct text_layout_step *end = &layout->steps[text_layout_find_step(layout, 32767)];
+
+	MyCursorX = end->x;
+	MyCursorY = t_rect.y + end->y;
+	set_current_font(end->font);
+
+	return end->nblines;
 }
 
 /**
@@ -384,31 +390,14 @@ void display_effect_countdowns(void)
 
 static int display_text_with_cursor(const char *text, int startx, int starty, const SDL_Rect *clip, float line_height_factor, int curpos)
 {
-	char *tmp;		// mobile pointer to the current position in the string to be printed
 	SDL_Rect Temp_Clipping_Rect;	// adding this to prevent segfault in case of NULL as parameter
 	SDL_Rect store_clip;
-	short int nblines = 1;
-	int empty_lines_started = 0;
-	int current_curpos = 0;
+	SDL_Rect screen_clip;
+	int i;
 
 	if (text == NULL)
 		return 0;
 
-	int letter_spacing = get_letter_spacing(get_current_font());
-	int tab_width = TABWIDTH * (font_char_width(get_current_font(), TABCHAR) + letter_spacing);
-
-	if (text[0]=='\0')
-		nblines = 0;
-
-	// We position the internal text cursor on the right spot for
-	// the first character to be printed.
-	//
-	MyCursorX = startx;
-	MyCursorY = starty;
-
-	int cursor_x = MyCursorX;
-	int cursor_y = MyCursorY;
-
 	// We make a backup of the current clipping rect, so we can restore
 	// it later.
 	//
@@ -427,85 +416,51 @@ static int display_text_with_cursor(const char *text, int startx, int starty, co
 		Temp_Clipping_Rect.w = GameConfig.screen_width;
 		Temp_Clipping_Rect.h = GameConfig.screen_height;
 	}
+	SDL_GetClipRect(Screen, &screen_clip);
 
 	set_gl_clip_rect(clip);
 
-	start_image_batch();
-
-	// Now we can start to print the actual text to the screen.
+	// Get the pre-computed layout of the text (position of each character,
+	// line breaks), and find where its rendering is to be stopped, i.e. when
+	// reaching the bottom of the clipping rect.
 	//
-	// The running text pointer must be initialized.
+	struct text_layout *layout = get_text_layout(get_current_font(), text, startx, clip, line_height_factor);
+	int last_step = text_layout_find_step(layout, clip->y + clip->h - starty);
+	struct text_layout_step *end = &layout->steps[last_step];
+
+	// Now we can emit the visible characters as a single batch.
 	//
-	tmp = (char *)text;	// this is no longer a 'const' char*, but only a char*
-	while (*tmp && (MyCursorY < clip->y + clip->h)) {
-		if (current_curpos == curpos) {
-			cursor_x = MyCursorX;
-			cursor_y = MyCursorY;
-		}
+	start_image_batch();
 
-		if (handle_switch_font_char(&tmp)) {
-			current_curpos++;
-			continue;
-		}
+	for (i = 0; i < layout->nb_glyphs; i++) {
+		struct text_layout_glyph *glyph = &layout->glyphs[i];
+		if (glyph->step >= last_step)
+			break;
 
-		if (((*tmp == ' ') || (*tmp == '\t'))
-		    && (ImprovedCheckLineBreak(tmp, clip, line_height_factor) == 1))	// don't write over right border 
-		{		/*THE CALL ABOVE HAS DONE THE CARRIAGE RETURN FOR US !!! */
-			empty_lines_started++;
-			tmp++;
-			current_curpos++;
+		int y = starty + glyph->y;
+		if (y <= clip->y - glyph->line_height)
 			continue;
-		}
-
-		// carriage return in the middle of a word if it is too big to fit on one line
-		if (isgraph(*tmp) && (MyCursorX + font_char_width(get_current_font(), *tmp) + letter_spacing) > (clip->x + clip->w)) {
-			MyCursorX = clip->x;
-			MyCursorY += (int)(get_font_height(get_current_font()) * line_height_factor);
-			empty_lines_started++;
-		}
-
-		switch (*tmp) {
-		case '\n':
-			MyCursorX = clip->x;
-			MyCursorY += (int)(get_font_height(get_current_font()) * line_height_factor);
-			empty_lines_started++;
-			break;
-		case '\t':
-			MyCursorX = (int)ceilf((float)MyCursorX / (float)(tab_width)) * (tab_width);
-			break;
-		default:
-			if (MyCursorY > clip->y - (int)(get_font_height(get_current_font()) * line_height_factor)
-				&& !display_char_disabled)
-				put_char(get_current_font(), MyCursorX, MyCursorY, *tmp);
-
-			MyCursorX += font_char_width(get_current_font(), *tmp)
-				+ get_letter_spacing(get_current_font());
-
-			// At least one visible character must follow a line break or else
-			// the line is a trailing empty line not visible to the user. Such
-			// empty lines don't contribute to the visual height of the string.
-			if (isgraph(*tmp)) {
-				nblines += empty_lines_started;
-				empty_lines_started = 0;
-			}
-		}
-		tmp++;
-		current_curpos++;
+		if ((glyph->x >= screen_clip.x) && (glyph->x < screen_clip.x + screen_clip.w))
+			display_image_on_screen(glyph->img, glyph->x, y, IMAGE_NO_TRANSFO);
 	}
 
 	end_image_batch(__FUNCTION__);
 
 	SDL_SetClipRect(Screen, &store_clip);	// restore previous clip-rect 
 
-	if (curpos != -1) {
-		if (curpos != 0 && current_curpos == curpos) {
-			cursor_x = MyCursorX;
-			cursor_y = MyCursorY;
-		}
+	MyCursorX = end->x;
+	MyCursorY = starty + end->y;
+	set_current_font(end->font);
 
+	if (curpos != -1) {
 		SDL_Rect cursor_rect;
-		cursor_rect.x = cursor_x;
-		cursor_rect.y = cursor_y;
+		if (curpos >= 0 && curpos <= last_step) {
+			cursor_rect.x = layout->steps[curpos].x;
+			cursor_rect.y = starty + layout->steps[curpos].y;
+		} else {
+			cursor_rect.x = startx;
+			cursor_rect.y = starty;
+		}
 		cursor_rect.h = get_font_height(get_current_font());
 		cursor_rect.w = 8;
 		draw_highlight_rectangle(cursor_rect);
@@ -514,7 +469,7 @@ static int display_text_with_cursor(const char *text, int startx, int starty, co
 	if (use_open_gl)
 		unset_gl_clip_rect();
 
-	return nblines;
+	return end->nblines;
 }
 
 /**
@@ -529,43 +484,6 @@ int display_text(const char *text, int startx, int starty, const SDL_Rect *clip,
 	return display_text_with_cursor(text, startx, starty, clip, line_height_factor, -1);
 }
 
-/**
- * This function checks if the next word still fits in this line
- * of text and initiates a carriage return/line feed if not.
- * Very handy and convenient, for that means it is no longer necessary
- * to enter \n in the text every time its time for a newline. cool.
- *  
- * rp: added argument clip, which contains the text-window we're writing in
- *     (formerly known as "TextBorder")
- *
- * ah: added return value : 1 if carriage return was done, FALSE otherwise
- */
-int ImprovedCheckLineBreak(char *Resttext, const SDL_Rect * clip, float line_height_factor)
-{
-	int NeededSpace = 0;
-
-	int letter_spacing = get_letter_spacing(get_current_font());
-
-	if (*Resttext == ' ')
-		NeededSpace = font_char_width(get_current_font(), ' ') + letter_spacing;
-	else if (*Resttext == '\t')
-		NeededSpace = TABWIDTH * (font_char_width(get_current_font(), TABCHAR) + letter_spacing);
-
-	Resttext++;
-	while ((*Resttext != ' ') && (*Resttext != '\t') && (*Resttext != '\n') && (*Resttext != 0)) {
-		NeededSpace += font_char_width(get_current_font(), *Resttext) + letter_spacing;
-		Resttext++;
-	}
-
-	if ((MyCursorX + NeededSpace) > (clip->x + clip->w)) {
-		MyCursorX = clip->x;
-		MyCursorY += (int)(get_font_height(get_current_font()) * line_height_factor);
-		return 1;
-	}
-
-	return 0;
-};				// int ImprovedCheckLineBreak()
-
 /**
  * Prompt the user for a string no longer than MaxLen (excluding terminating \0).
  */
@@ -0,0 +1,435 @@
+/*
+ *
+ *   Copyright (c) 2026 FreedroidRPG development team
+ *
+ *
+ *  This file is part of Freedroid
+ *
+ *  Freedroid is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Freedroid is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Freedroid; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ *  MA  02111-1307  USA
+ *
+ */
+
+/**
+ * \file text_layout.c
+ * \brief Cache of pre-measured text layouts.
+ *
+ * Most of the texts displayed by the game (HUD, tooltips, quest browser...)
+ * are identical from one frame to the next, but their layout (font switches,
+ * character widths, word wrapping) used to be re-computed each time they were
+ * displayed or measured.
+ * A layout records the position of each glyph and the state of the text cursor
+ * before each character, so that displaying, measuring or counting the lines
+ * of a text only has to walk through pre-computed arrays.
+ * Layouts are cached, keyed by the text and all the parameters the layout
+ * depends on (font, position of the text and width of the clipping rectangle).
+ */
+
+#define _text_layout_c 1
+
+#include "system.h"
+
+#include "defs.h"
+#include "struct.h"
+#include "global.h"
+#include "proto.h"
+#include "BFont.h"
+
+// Max number of layouts kept in the cache
+#define MAX_CACHED_LAYOUTS 512
+// Number of buckets of the cache's hash table (must be a power of 2)
+#define LAYOUT_CACHE_BUCKETS 1024
+
+enum layout_kind {
+	LAYOUT_RUN,        // Single line of text, as rendered by put_string()
+	LAYOUT_MEASURE,    // Single line of text, as measured by text_width()
+	LAYOUT_WRAPPED     // Word-wrapped text, as rendered by display_text()
+};
+
+struct layout_key {
+	enum layout_kind kind;
+	struct font *font;
+	int startx;
+	int clip_x;
+	int clip_w;
+	float line_height_factor;
+};
+
+struct layout_cache_entry {
+	struct layout_key key;
+	char *text;
+	uint32_t hash;
+	struct text_layout layout;
+	struct list_head bucket_node;   // Entries sharing the same hash bucket
+	struct list_head lru_node;      // Entries in least recently used order (most recent first)
+};
+
+static struct list_head layout_buckets[LAYOUT_CACHE_BUCKETS];
+static LIST_HEAD(layout_lru);
+static int nb_cached_layouts = 0;
+static int layout_cache_initialized = FALSE;
+
+/**
+ * FNV-1a hash of a text and of the parameters its layout depends on.
+ */
+static uint32_t layout_hash(const struct layout_key *key, const char *text)
+{
+	uint32_t hash = 2166136261u;
+	const unsigned char *ptr;
+
+	for (ptr = (const unsigned char *)key; ptr < (const unsigned char *)(key + 1); ptr++)
+		hash = (hash ^ *ptr) * 16777619u;
+	for (ptr = (const unsigned char *)text; *ptr; ptr++)
+		hash = (hash ^ *ptr) * 16777619u;
+
+	return hash;
+}
+
+static void init_layout_cache(void)
+{
+	int i;
+
+	for (i = 0; i < LAYOUT_CACHE_BUCKETS; i++)
+		INIT_LIST_HEAD(&layout_buckets[i]);
+	layout_cache_initialized = TRUE;
+}
+
+static void free_layout_cache_entry(struct layout_cache_entry *entry)
+{
+	list_del(&entry->bucket_node);
+	list_del(&entry->lru_node);
+	free(entry->text);
+	free(entry->layout.steps);
+	free(entry->layout.glyphs);
+	free(entry);
+	nb_cached_layouts--;
+}
+
+/**
+ * Clear the layout cache.
+ * Must be called whenever the fonts are freed, since the layouts keep
+ * references to the fonts' glyphs.
+ */
+void text_layout_cache_clear(void)
+{
+	struct layout_cache_entry *entry, *next;
+
+	list_for_each_entry_safe(entry, next, &layout_lru, lru_node) {
+		free_layout_cache_entry(entry);
+	}
+}
+
+/**
+ * Initialize a layout able to contain the steps and glyphs of a text.
+ */
+static void layout_alloc(struct text_layout *layout, const char *text)
+{
+	int len = strlen(text);
+
+	layout->nb_steps = 0;
+	layout->steps = MyMalloc((len + 1) * sizeof(struct text_layout_step));
+	layout->nb_glyphs = 0;
+	layout->glyphs = MyMalloc((len + 1) * sizeof(struct text_layout_glyph));
+}
+
+static void layout_add_step(struct text_layout *layout, int x, int y, int nblines, int offset, struct font *font)
+{
+	struct text_layout_step *step = &layout->steps[layout->nb_steps];
+
+	step->x = x;
+	step->y = y;
+	step->nblines = nblines;
+	step->offset = offset;
+	step->is_font_switch = FALSE;
+	step->font = font;
+}
+
+static void layout_add_glyph(struct text_layout *layout, struct font *font, unsigned char c, int x, int y, int line_height)
+{
+	struct text_layout_glyph *glyph = &layout->glyphs[layout->nb_glyphs++];
+
+	glyph->img = &font->bfont->char_image[c];
+	glyph->x = x;
+	glyph->y = y;
+	glyph->line_height = line_height;
+	glyph->step = layout->nb_steps;
+}
+
+/**
+ * Compute the layout of a single line of text.
+ * In LAYOUT_RUN mode, font switch codes change the font used to measure and
+ * display the following characters. In LAYOUT_MEASURE mode, as done by the
+ * historical text_width() implementation, all characters are measured with
+ * the given font.
+ */
+static void layout_text_run(struct text_layout *layout, struct font *font, const char *text, enum layout_kind kind)
+{
+	char *ptr = (char *)text;
+	struct font *switched_font = (kind == LAYOUT_RUN) ? font : NULL;
+	int x = 0;
+
+	set_current_font(font);
+	int letter_spacing = get_letter_spacing(font);
+
+	while (*ptr != '\0') {
+		layout_add_step(layout, x, 0, 1, ptr - text, switched_font);
+
+		if (handle_switch_font_char(&ptr)) {
+			switched_font = get_current_font();
+			if (kind == LAYOUT_RUN)
+				letter_spacing = get_letter_spacing(switched_font);
+			layout->steps[layout->nb_steps++].is_font_switch = TRUE;
+			continue;
+		}
+
+		struct font *char_font = (kind == LAYOUT_RUN) ? switched_font : font;
+		unsigned char c = *ptr;
+		if (c < ' ' || c > char_font->bfont->number_of_chars - 1)
+			c = '.';
+
+		if (kind == LAYOUT_RUN && c != ' ')
+			layout_add_glyph(layout, char_font, c, x, 0, char_font->bfont->h);
+
+		x += char_font->bfont->char_image[c].w + letter_spacing;
+		layout->nb_steps++;
+		ptr++;
+	}
+
+	layout_add_step(layout, x, 0, 1, ptr - text, switched_font);
+}
+
+/**
+ * This function checks if the next word still fits in this line
+ * of text and initiates a carriage return/line feed if not.
+ * Return TRUE if a carriage return was done.
+ */
+static int check_line_break(char *resttext, int *cursor_x, int *cursor_y, int clip_x, int clip_w, float line_height_factor)
+{
+	int needed_space = 0;
+
+	int letter_spacing = get_letter_spacing(get_current_font());
+
+	if (*resttext == ' ')
+		needed_space = font_char_width(get_current_font(), ' ') + letter_spacing;
+	else if (*resttext == '\t')
+		needed_space = TABWIDTH * (font_char_width(get_current_font(), TABCHAR) + letter_spacing);
+
+	resttext++;
+	while ((*resttext != ' ') && (*resttext != '\t') && (*resttext != '\n') && (*resttext != 0)) {
+		needed_space += font_char_width(get_current_font(), *resttext) + letter_spacing;
+		resttext++;
+	}
+
+	if ((*cursor_x + needed_space) > (clip_x + clip_w)) {
+		*cursor_x = clip_x;
+		*cursor_y += (int)(get_font_height(get_current_font()) * line_height_factor);
+		return TRUE;
+	}
+
+	return FALSE;
+}
+
+/**
+ * Compute the layout of a text, word-wrapped at the edges of the clipping
+ * area. The text is supposed to start at (startx, 0).
+ */
+static void layout_text_wrapped(struct text_layout *layout, struct font *font, const char *text, int startx,
+		int clip_x, int clip_w, float line_height_factor)
+{
+	char *tmp = (char *)text;
+	int nblines = (text[0] == '\0') ? 0 : 1;
+	int empty_lines_started = 0;
+	int cursor_x = startx;
+	int cursor_y = 0;
+
+	set_current_font(font);
+	int letter_spacing = get_letter_spacing(font);
+	int tab_width = TABWIDTH * (font_char_width(font, TABCHAR) + letter_spacing);
+
+	while (*tmp) {
+		layout_add_step(layout, cursor_x, cursor_y, nblines, tmp - text, get_current_font());
+
+		if (handle_switch_font_char(&tmp)) {
+			layout->steps[layout->nb_steps++].is_font_switch = TRUE;
+			continue;
+		}
+
+		struct font *current_font = get_current_font();
+		int line_height = (int)(get_font_height(current_font) * line_height_factor);
+
+		if (((*tmp == ' ') || (*tmp == '\t'))
+		    && check_line_break(tmp, &cursor_x, &cursor_y, clip_x, clip_w, line_height_factor)) {
+			empty_lines_started++;
+			layout->nb_steps++;
+			tmp++;
+			continue;
+		}
+
+		// carriage return in the middle of a word if it is too big to fit on one line
+		if (isgraph(*tmp) && (cursor_x + font_char_width(current_font, *tmp) + letter_spacing) > (clip_x + clip_w)) {
+			cursor_x = clip_x;
+			cursor_y += line_height;
+			empty_lines_started++;
+		}
+
+		switch (*tmp) {
+		case '\n':
+			cursor_x = clip_x;
+			cursor_y += line_height;
+			empty_lines_started++;
+			break;
+		case '\t':
+			cursor_x = (int)ceilf((float)cursor_x / (float)(tab_width)) * (tab_width);
+			break;
+		default:
+			{
+				unsigned char c = *tmp;
+				if (c < ' ' || c > current_font->bfont->number_of_chars - 1)
+					c = '.';
+				if (c != ' ')
+					layout_add_glyph(layout, current_font, c, cursor_x, cursor_y, line_height);
+			}
+
+			cursor_x += font_char_width(current_font, *tmp) + get_letter_spacing(current_font);
+
+			// At least one visible character must follow a line break or else
+			// the line is a trailing empty line not visible to the user. Such
+			// empty lines don't contribute to the visual height of the string.
+			if (isgraph(*tmp)) {
+				nblines += empty_lines_started;
+				empty_lines_started = 0;
+			}
+		}
+		layout->nb_steps++;
+		tmp++;
+	}
+
+	layout_add_step(layout, cursor_x, cursor_y, nblines, tmp - text, get_current_font());
+}
+
+/**
+ * Get a layout from the cache, computing it if needed.
+ */
+static struct text_layout *get_layout(struct layout_key *key, const char *text)
+{
+	struct layout_cache_entry *entry;
+
+	if (!layout_cache_initialized)
+		init_layout_cache();
+
+	uint32_t hash = layout_hash(key, text);
+	struct list_head *bucket = &layout_buckets[hash & (LAYOUT_CACHE_BUCKETS - 1)];
+
+	list_for_each_entry(entry, bucket, bucket_node) {
+		if (entry->hash == hash && !memcmp(&entry->key, key, sizeof(*key)) && !strcmp(entry->text, text)) {
+			list_move(&entry->lru_node, &layout_lru);
+			return &entry->layout;
+		}
+	}
+
+	// Not found: evict the least recently used layout if the cache is full
+	if (nb_cached_layouts >= MAX_CACHED_LAYOUTS) {
+		free_layout_cache_entry(list_entry(layout_lru.prev, struct layout_cache_entry, lru_node));
+	}
+
+	entry = MyMalloc(sizeof(struct layout_cache_entry));
+	entry->key = *key;
+	entry->text = my_strdup(text);
+	entry->hash = hash;
+	layout_alloc(&entry->layout, text);
+
+	// Computing the layout changes the current font, through the font
+	// switch codes
+	struct font *current_font = get_current_font();
+	if (key->kind == LAYOUT_WRAPPED)
+		layout_text_wrapped(&entry->layout, key->font, text, key->startx, key->clip_x, key->clip_w, key->line_height_factor);
+	else
+		layout_text_run(&entry->layout, key->font, text, key->kind);
+	set_current_font(current_font);
+
+	list_add(&entry->bucket_node, bucket);
+	list_add(&entry->lru_node, &layout_lru);
+	nb_cached_layouts++;
+
+	return &entry->layout;
+}
+
+/**
+ * Get the layout of a single line of text.
+ *
+ * \param font     Font used at the beginning of the text
+ * \param text     The text
+ * \param measure  If TRUE, get the layout as measured by text_width()
+ *                 (all characters measured with 'font'), else as rendered
+ *                 by put_string()
+ */
+struct text_layout *get_text_run_layout(struct font *font, const char *text, int measure)
+{
+	struct layout_key key;
+
+	memset(&key, 0, sizeof(key));
+	key.kind = measure ? LAYOUT_MEASURE : LAYOUT_RUN;
+	key.font = font;
+
+	return get_layout(&key, text);
+}
+
+/**
+ * Get the layout of a text, word-wrapped inside a clipping rectangle.
+ * The y coordinates of the layout are relative to the first line of text.
+ *
+ * \param font                Font used at the beginning of the text
+ * \param text                The text
+ * \param startx              Position of the first character
+ * \param clip                Clipping rectangle (only x and w are used)
+ * \param line_height_factor  Line height, relatively to the font height
+ */
+struct text_layout *get_text_layout(struct font *font, const char *text, int startx, const SDL_Rect *clip, float line_height_factor)
+{
+	struct layout_key key;
+
+	memset(&key, 0, sizeof(key));
+	key.kind = LAYOUT_WRAPPED;
+	key.font = font;
+	key.startx = startx;
+	key.clip_x = clip->x;
+	key.clip_w = clip->w;
+	key.line_height_factor = line_height_factor;
+
+	return get_layout(&key, text);
+}
+
+/**
+ * Find the first step of a layout starting at or below a given y coordinate.
+ * Return nb_steps (the final state of the layout) if no step is found.
+ */
+int text_layout_find_step(struct text_layout *layout, int y)
+{
+	int low = 0;
+	int high = layout->nb_steps;
+
+	// Steps are sorted by increasing y
+	while (low < high) {
+		int mid = (low + high) / 2;
+		if (layout->steps[mid].y >= y)
+			high = mid;
+		else
+			low = mid + 1;
+	}
+
+	return low;
+}
+
+#undef _text_layout_c
@@ -295,6 +295,7 @@ void title_screen_run(struct title_screen *data)
 		title_screen_ui->display(title_screen_ui);
 		blit_mouse_cursor();
 		our_SDL_flip_wrapper();
+		update_audio();
 
 		// User's interaction
 		while (SDL_PollEvent(&event)) {
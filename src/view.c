@@ -131,15 +131,12 @@ static void DisplayItemImageAtMouseCursor(int ItemImageCode)
  */
 void put_miscellaneous_spell_effects(void)
 {
-	int i;
+	int n;
 
 	// Now we put all the spells in the list of spells
 	//
-	for (i = 0; i < all_spells.size; ++i) {
-		// skip unused spell slot
-		if (!sparse_dynarray_member_used(&all_spells, i))
-			continue;
-
+	for (n = 0; n < all_spells.nb_live; n++) {
+		int i = sparse_dynarray_live_member(&all_spells, n);
 		struct spell *current_spell = (struct spell *)sparse_dynarray_member(&all_spells, i, sizeof(struct spell));
 
 		put_radial_blue_sparks(current_spell->spell_center.x, current_spell->spell_center.y,
@@ -181,15 +178,44 @@ void object_vtx_color(void *data, float *r, float *g, float *b)
 	}
 }
 
+/**
+ * Display the floor layers of a tile, at a virtual position on a level.
+ */
+void blit_one_floor_tile(level *lvl, int col, int line, int layer_start, int layer_end, float zf)
+{
+	uint16_t *map_brick;
+	int layer;
+	float r, g, b;
+
+	// Retrieve floor tiles
+	map_brick = get_map_brick(lvl, col, line);
+	if (!map_brick) {
+		return;
+	}
+
+	for (layer = layer_start; layer < layer_end; layer++) {
+		if (map_brick[layer] == ISO_FLOOR_EMPTY)
+			continue;
+
+		// Compute colorization (in case the floor tile is currently selected in the leveleditor)
+		if (pos_inside_level(col, line, lvl)) {
+			object_vtx_color(&lvl->map[line][col], &r, &g, &b);
+		} else {
+			r = g = b = 1.0;
+		}
+
+		struct image *img = get_floor_tile_image(map_brick[layer]);
+		display_image_on_map(img, (float)col + 0.5, (float)line + 0.5, IMAGE_SCALE_RGB_TRANSFO(zf, r, g, b));
+	}
+}
+
 /**
  * This function displays floor on the screen.
  */
 static void show_floor(int mask)
 {
-       int LineStart, LineEnd, ColStart, ColEnd, line, col;
-       uint16_t *map_brick;
-	int layer_start, layer_end, layer;
-	float r, g, b;
+	int LineStart, LineEnd, ColStart, ColEnd, line, col;
+	int layer_start, layer_end;
 	float zf = ((mask & ZOOM_OUT) ? lvledit_zoomfact_inv() : 1.0);
 	level *lvl = curShip.AllLevels[Me.pos.z];
 
@@ -205,30 +231,15 @@ static void show_floor(int mask)
 		}
 	}
 
+	// The zoomed out level editor displays cached pictures of the floor
+	if ((mask & ZOOM_OUT) && lvledit_overview_show_floor(LineStart, LineEnd, ColStart, ColEnd, layer_start, layer_end))
+		return;
+
 	start_image_batch();
 
 	for (line = LineStart; line < LineEnd; line++) {
 		for (col = ColStart; col < ColEnd; col++) {
-			// Retrieve floor tiles
-			map_brick = get_map_brick(lvl, col, line);
-			if (!map_brick) {
-				continue;
-			}
-
-			for (layer = layer_start; layer < layer_end; layer++) {
-				if (map_brick[layer] == ISO_FLOOR_EMPTY)
-					continue;
-
-				// Compute colorization (in case the floor tile is currently selected in the leveleditor)
-				if (pos_inside_level(col, line, lvl)) {
-					object_vtx_color(&lvl->map[line][col], &r, &g, &b);
-				} else {
-					r = g = b = 1.0;
-				}
-
-				struct image *img = get_floor_tile_image(map_brick[layer]);
-				display_image_on_map(img, (float)col + 0.5, (float)line + 0.5, IMAGE_SCALE_RGB_TRANSFO(zf, r, g, b));
-			}
+			blit_one_floor_tile(lvl, col, line, layer_start, layer_end, zf);
 		}
 	}
 
@@ -427,7 +438,7 @@ void insert_obstacles_into_blitting_list(int mask)
 					// Now we have to insert this obstacle.  We do this of course respecting
 					// the blitting order, as always...
 					int idx = ((int *)obstacle_level->map[py][px].glued_obstacles.arr)[i];
-					OurObstacle = &obstacle_level->obstacle_list[idx];
+					OurObstacle = &ACCESS_OBSTACLE(obstacle_level, idx);
 
 					insert_one_obstacle_into_blitting_list(col, line, tile_rpos.z, OurObstacle, BLITTING_TYPE_OBSTACLE, idx, tstamp);
 			}
@@ -1108,14 +1119,12 @@ static void insert_enemies_into_blitting_list(int mask)
  */
 static void insert_bullets_into_blitting_list(int mask)
 {
-	int i;
+	int n;
 	int xmin, xmax, ymin, ymax;
 	get_floor_boundaries(mask, &ymin, &ymax, &xmin, &xmax);
 
-	for (i = 0; i < all_bullets.size; i++) {
-		if (!sparse_dynarray_member_used(&all_bullets, i))
-			continue;
-
+	for (n = 0; n < all_bullets.nb_live; n++) {
+		int i = sparse_dynarray_live_member(&all_bullets, n);
 		struct bullet *b = (struct bullet *)sparse_dynarray_member(&all_bullets, i, sizeof(struct bullet));
 
 		gps vpos;
@@ -1137,15 +1146,12 @@ static void insert_bullets_into_blitting_list(int mask)
  */
 static void insert_blasts_into_blitting_list(int mask)
 {
-	int i;
+	int n;
 	int xmin, xmax, ymin, ymax;
 	get_floor_boundaries(mask, &ymin, &ymax, &xmin, &xmax);
 
-	for (i = 0; i < all_blasts.size; i++) {
-		// Unused blast slot
-		if (!sparse_dynarray_member_used(&all_blasts, i))
-			continue;
-
+	for (n = 0; n < all_blasts.nb_live; n++) {
+		int i = sparse_dynarray_live_member(&all_blasts, n);
 		struct blast *current_blast = (struct blast *)sparse_dynarray_member(&all_blasts, i, sizeof(struct blast));
 		
 		gps vpos;
@@ -1176,8 +1182,8 @@ static void insert_thrown_items_into_blitting_list(int mask)
 	
 	BROWSE_VISIBLE_LEVELS(vis_lvl, n) {
 		level *lvl = vis_lvl->lvl_pointer;
-		for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
-			it = &lvl->ItemList[i];
+		for (i = 0; i < lvl->ItemList.size; i++) {
+			it = &ACCESS_FLOOR_ITEM(lvl, i);
 			
 			if (it->type == -1)
 				continue;
@@ -1516,33 +1522,33 @@ static void blit_all_item_slots(int mask)
 		
 		level *item_level = vis_lvl->lvl_pointer;
 
-		for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
+		for (i = 0; i < item_level->ItemList.size; i++) {
 			// We don't work with unused item slots...
 			//
-			if (item_level->ItemList[i].type == (-1))
+			if (ACCESS_FLOOR_ITEM(item_level, i).type == (-1))
 				continue;
 	
 			// Now we check if the cursor is on that slot, because then the
 			// background of the slot will be highlighted...
 			//
-			if (MouseCursorIsInRect(&(item_level->ItemList[i].text_slot_rectangle), GetMousePos_x(), GetMousePos_y()))
-				draw_rectangle(&item_level->ItemList[i].text_slot_rectangle, 0, 0, 153, 100);
+			if (MouseCursorIsInRect(&(ACCESS_FLOOR_ITEM(item_level, i).text_slot_rectangle), GetMousePos_x(), GetMousePos_y()))
+				draw_rectangle(&ACCESS_FLOOR_ITEM(item_level, i).text_slot_rectangle, 0, 0, 153, 100);
 			else {
-				if ((item_level->ItemList[i].text_slot_rectangle.x + item_level->ItemList[i].text_slot_rectangle.w <= 0) ||
-					(item_level->ItemList[i].text_slot_rectangle.y + item_level->ItemList[i].text_slot_rectangle.h <= 0) ||
-					(item_level->ItemList[i].text_slot_rectangle.x >= GameConfig.screen_width) ||
-					(item_level->ItemList[i].text_slot_rectangle.y >= GameConfig.screen_height))
+				if ((ACCESS_FLOOR_ITEM(item_level, i).text_slot_rectangle.x + ACCESS_FLOOR_ITEM(item_level, i).text_slot_rectangle.w <= 0) ||
+					(ACCESS_FLOOR_ITEM(item_level, i).text_slot_rectangle.y + ACCESS_FLOOR_ITEM(item_level, i).text_slot_rectangle.h <= 0) ||
+					(ACCESS_FLOOR_ITEM(item_level, i).text_slot_rectangle.x >= GameConfig.screen_width) ||
+					(ACCESS_FLOOR_ITEM(item_level, i).text_slot_rectangle.y >= GameConfig.screen_height))
 					continue;
 
-				draw_rectangle(&item_level->ItemList[i].text_slot_rectangle, 0, 0, 0, BACKGROUND_TEXT_RECT_ALPHA);
+				draw_rectangle(&ACCESS_FLOOR_ITEM(item_level, i).text_slot_rectangle, 0, 0, 0, BACKGROUND_TEXT_RECT_ALPHA);
 			}
 	
 			// Finally it's time to insert the font into the item slot.  We
 			// use the item name, but currently font color is not adapted for
 			// special item properties...
 			//
-			put_string(FPS_Display_Font, item_level->ItemList[i].text_slot_rectangle.x,
-					  item_level->ItemList[i].text_slot_rectangle.y, D_(item_specs_get_name(item_level->ItemList[i].type)));
+			put_string(FPS_Display_Font, ACCESS_FLOOR_ITEM(item_level, i).text_slot_rectangle.x,
+					  ACCESS_FLOOR_ITEM(item_level, i).text_slot_rectangle.y, D_(item_specs_get_name(ACCESS_FLOOR_ITEM(item_level, i).type)));
 	
 		}
 	}
@@ -1572,11 +1578,11 @@ int item_slot_position_blocked(item * given_item, int item_slot)
 			item_level_reached = TRUE;
 			last_slot_to_check = item_slot;
 		} else {
-			last_slot_to_check = MAX_ITEMS_PER_LEVEL;
+			last_slot_to_check = item_level->ItemList.size - 1;
 		}
 		
 		for (i = 0; i < last_slot_to_check + 1; i++) {
-			cur_item = &(item_level->ItemList[i]);
+			cur_item = &(ACCESS_FLOOR_ITEM(item_level, i));
 	
 			if (cur_item->type == (-1))
 				continue;
@@ -1643,8 +1649,8 @@ void update_item_text_slot_positions(void)
 		
 		level *item_level = vis_lvl->lvl_pointer;
 	
-		for (i = 0; i < MAX_ITEMS_PER_LEVEL; i++) {
-			cur_item = &(item_level->ItemList[i]);
+		for (i = 0; i < item_level->ItemList.size; i++) {
+			cur_item = &(ACCESS_FLOOR_ITEM(item_level, i));
 	
 			if (cur_item->type == (-1))
 				continue;
@@ -2141,6 +2147,11 @@ void tux_rendering_load_specs(const char *config_filename)
 	tux_images = MyMalloc(tux_rendering.motion_class_names.size * sizeof(struct tux_motion_class_images));
 }
 
+static const char *motion_class_name(int id)
+{
+	return ((char **)tux_rendering.motion_class_names.arr)[id];
+}
+
 /**
  * Returns the id (index number) of a motion_class, given its name
  *
@@ -2149,19 +2160,10 @@ void tux_rendering_load_specs(const char *config_filename)
  */
 int get_motion_class_id_by_name(char *name)
 {
-	// Check pre-condition
-	if (name == NULL)
-		return -1;
-
-	// Search 'name' in the motion_class_names list
-	int i;
-	for (i = 0; i < tux_rendering.motion_class_names.size; i++) {
-		if (!strcmp(name, ((char **)tux_rendering.motion_class_names.arr)[i]))
-			return i;
-	}
+	static struct name_map motion_class_names;
 
-	// Fall-back if 'name' is not found
-	return -1;
+	// Search 'name' in the motion_class_names list, -1 if 'name' is not found
+	return name_map_index_of(&motion_class_names, name, motion_class_name, tux_rendering.motion_class_names.size);
 }
 
 /**
@@ -59,6 +59,14 @@ struct line_reached_callback {
  *
  * \param w Pointer to the widget_autoscroll_text object
  */
+static void autoscroll_text_render(struct widget *w)
+{
+	struct widget_autoscroll_text *wat = WIDGET_AUTOSCROLL_TEXT(w);
+
+	set_current_font(wat->font);
+	display_text(wat->text, w->rect.x, wat->displayed_y, &w->rect, 1.0f);
+}
+
 static void autoscroll_text_display(struct widget *w)
 {
 	struct widget_autoscroll_text *wat = WIDGET_AUTOSCROLL_TEXT(w);
@@ -66,8 +74,14 @@ static void autoscroll_text_display(struct widget *w)
 	if (!wat->text)
 		return;
 
-	set_current_font(wat->font);
-	display_text(wat->text, w->rect.x, floorf((float)w->rect.y + wat->offset_current), &w->rect, 1.0f);
+	// The text is rendered again only when it has scrolled by a pixel
+	int y = floorf((float)w->rect.y + wat->offset_current);
+	if (y != wat->displayed_y) {
+		wat->displayed_y = y;
+		widget_invalidate(w);
+	}
+
+	widget_display_cached(w, autoscroll_text_render);
 }
 
 /**
@@ -239,6 +253,8 @@ void widget_autoscroll_set_text(struct widget_autoscroll_text *w, const char *te
 	w->scroll_interaction_disabled = FALSE;
 
 	set_current_font(tmp_font);
+
+	widget_invalidate(wb);
 }
 
 /**
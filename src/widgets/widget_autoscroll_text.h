@@ -122,6 +122,7 @@ struct widget_autoscroll_text {
 	int offset_stop;                         /**< Stop offset: text is 'over' the top of the widget */
 	int scroll_interaction_disabled;         /**< Boolean flag to enable/disable the modification of the scrolling speed */
 	struct dynarray line_reached_callbacks;  /**< Functions called when a given line is reached during the scrolling */
+	int displayed_y;                         /**< Position of the text when it was last displayed */
 	/// @}
 };
 
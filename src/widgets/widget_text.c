@@ -90,6 +90,46 @@ static int text_handle_mouse_down(struct widget_text *wt, SDL_Event *event)
  * TODO: This function has to be made static, when all panels will be converted
  * to the new GUI subsystem.
  */
+static const char *text_value(struct widget_text *wt)
+{
+	if (wt->l10n_at_display)
+		return _(wt->text->value);
+	return wt->text->value;
+}
+
+/**
+ * \brief Check if the text, or the way it is laid out, changed since the
+ * text widget was last displayed.
+ *
+ * \param wt   Pointer to the widget_text object
+ * \param text Text to display
+ *
+ * \return TRUE if the text has to be laid out again.
+ */
+static int text_changed(struct widget_text *wt, const char *text)
+{
+	struct widget *w = WIDGET(wt);
+
+	if (wt->displayed_text && !strcmp(wt->displayed_text, text) && wt->displayed_font == wt->font &&
+	    wt->displayed_line_height_factor == wt->line_height_factor && !memcmp(&wt->displayed_rect, &w->rect, sizeof(SDL_Rect)))
+		return FALSE;
+
+	free(wt->displayed_text);
+	wt->displayed_text = strdup(text);
+	wt->displayed_font = wt->font;
+	wt->displayed_line_height_factor = wt->line_height_factor;
+	wt->displayed_rect = w->rect;
+	return TRUE;
+}
+
+static void text_render(struct widget *w)
+{
+	struct widget_text *wt = WIDGET_TEXT(w);
+
+	SDL_SetClipRect(Screen, NULL);
+	display_text(wt->displayed_text, w->rect.x, w->rect.y - wt->offset, &w->rect, wt->line_height_factor);
+}
+
 void widget_text_display(struct widget *w)
 {
 	int lines_needed;
@@ -104,11 +144,12 @@ void widget_text_display(struct widget *w)
 	// Set font before computing number of lines required.
 	set_current_font(wt->font);
 
-	// Compute the number of lines required.
-	if (wt->l10n_at_display)
-		lines_needed = get_lines_needed(_(wt->text->value), w->rect, wt->line_height_factor);
-	else
-		lines_needed = get_lines_needed(wt->text->value, w->rect, wt->line_height_factor);
+	// Compute the number of lines required, when the text changed.
+	if (text_changed(wt, text_value(wt))) {
+		wt->lines_needed = get_lines_needed(wt->displayed_text, w->rect, wt->line_height_factor);
+		widget_invalidate(w);
+	}
+	lines_needed = wt->lines_needed;
 
 	// Get number of visible lines.
 	font_size = get_font_height(wt->font) * wt->line_height_factor;
@@ -131,11 +172,12 @@ void widget_text_display(struct widget *w)
 	if (offset < 0)
 		offset = 0;
 
-	SDL_SetClipRect(Screen, NULL);
-	if (wt->l10n_at_display)
-		display_text(_(wt->text->value), w->rect.x, w->rect.y - offset, &w->rect, wt->line_height_factor);
-	else
-		display_text(wt->text->value, w->rect.x, w->rect.y - offset, &w->rect, wt->line_height_factor);
+	/* The text is rendered again only when it changed or was scrolled. */
+	if (offset != wt->offset) {
+		wt->offset = offset;
+		widget_invalidate(w);
+	}
+	widget_display_cached(w, text_render);
 
 	/* If we have more content above or below the currently visible text, we call the
 	 * functions that may have been specified for this event.
@@ -318,6 +360,8 @@ void widget_text_init(struct widget_text *w, const char *start_text)
 	w->line_height_factor = 1.0;
 	w->content_above_func = NULL;
 	w->content_below_func = NULL;
+
+	widget_invalidate(WIDGET(w));
 }
 
 /**
@@ -344,6 +388,8 @@ static void widget_text_free(struct widget *w)
 		free_autostr(wt->text);
 	}
 
+	free(wt->displayed_text);
+
 	widget_free(w);
 }
 
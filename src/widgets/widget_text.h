@@ -121,6 +121,12 @@ struct widget_text {
 	/// @{
 	enum mouse_text_hover mouse_hover;  /**< Area hovered by the mouse. */
 	int mouse_already_handled;          /**< Flag used for handling input. Deprecated. */
+	char *displayed_text;               /**< Copy of the text, as it was last displayed. */
+	struct font *displayed_font;        /**< Font used when the text was last displayed. */
+	float displayed_line_height_factor; /**< Line spacing used when the text was last displayed. */
+	SDL_Rect displayed_rect;            /**< Widget's rectangle when the text was last displayed. */
+	int lines_needed;                   /**< Number of lines of the displayed text. */
+	int offset;                         /**< Vertical offset of the displayed text, taking scrolling into account. */
 	/// @}
 };
 
@@ -103,6 +103,8 @@ static void compute_visible_lines(struct widget_text_list *wl)
 		list_entries[i].rect = rect;
 		list_entries[i].text_rect = text_rect;
 	}
+
+	widget_invalidate(WIDGET(wl));
 }
 
 /**
@@ -135,7 +137,7 @@ static int compute_selected_entry(struct widget_text_list *wl, SDL_Event *event)
 //////////////////////////////////////////////////////////////////////
 
 /**
- * \brief Display a text-list widget.
+ * \brief Render a text-list widget.
  * \relates widget_text_list
  *
  * \details !the text is word-wrapped at the right border of the widget's
@@ -145,12 +147,11 @@ static int compute_selected_entry(struct widget_text_list *wl, SDL_Event *event)
  *
  * \param w Pointer to the widget_text object
  */
-static void text_list_display(struct widget *w)
+static void text_list_render(struct widget *w)
 {
 	struct widget_text_list *wl = WIDGET_TEXT_LIST(w);
 	struct text_list_entry *list_entries = wl->entries.arr;
 
-	compute_visible_lines(wl);
 	set_current_font(wl->font);
 
 	int i;
@@ -165,6 +166,34 @@ static void text_list_display(struct widget *w)
 	}
 }
 
+/**
+ * \brief Display a text-list widget.
+ * \relates widget_text_list
+ *
+ * \details The entries are laid out and rendered again only when the list
+ * content, its font, its rectangle, the scrolling or the highlighted entry
+ * changed.
+ *
+ * \param w Pointer to the widget_text_list object
+ */
+static void text_list_display(struct widget *w)
+{
+	struct widget_text_list *wl = WIDGET_TEXT_LIST(w);
+
+	if (wl->displayed_font != wl->font || memcmp(&wl->displayed_rect, &w->rect, sizeof(SDL_Rect))) {
+		wl->displayed_font = wl->font;
+		wl->displayed_rect = w->rect;
+		compute_visible_lines(wl);
+	}
+
+	if (wl->displayed_selected_entry != wl->selected_entry) {
+		wl->displayed_selected_entry = wl->selected_entry;
+		widget_invalidate(w);
+	}
+
+	widget_display_cached(w, text_list_render);
+}
+
 /**
  * \brief Event handler for the text-list widget.
  * \relates widget_text_list
@@ -343,6 +372,9 @@ void widget_text_list_init(struct widget_text_list *wl, string text_arr[], int *
 	wl->first_visible_entry = 0;
 	wl->last_visible_entry = -1;
 	wl->all_entries_visible = TRUE;
+
+	// Force the layout of the new content
+	wl->displayed_font = NULL;
 }
 
 static void widget_text_list_free(struct widget *w)
@@ -369,6 +401,7 @@ void widget_text_list_add(struct widget_text_list *wl, string text, int data)
 {
 	struct text_list_entry one_entry = {text, data, FALSE, {0, 0, 0, 0}, {0, 0, 0, 0}};
 	dynarray_add(&wl->entries, &one_entry, sizeof(struct text_list_entry));
+	wl->displayed_font = NULL;
 }
 
 /**
@@ -387,6 +420,7 @@ void widget_text_list_dupadd(struct widget_text_list *wl, const char *text, int
 	char *dup_text = strdup(text);
 	struct text_list_entry one_entry = {dup_text, data, TRUE, {0, 0, 0, 0}, {0, 0, 0, 0}};
 	dynarray_add(&wl->entries, &one_entry, sizeof(struct text_list_entry));
+	wl->displayed_font = NULL;
 }
 
 /**
@@ -165,6 +165,9 @@ struct widget_text_list {
 	int first_visible_entry;  /**< The index of the first visible entry. */
 	int last_visible_entry;   /**< The index of the last visible entry. */
 	int all_entries_visible;  /**< All entries are visible in the widget rect */
+	struct font *displayed_font;   /**< Font used when the list was last displayed. */
+	SDL_Rect displayed_rect;       /**< Widget's rectangle when the list was last displayed. */
+	int displayed_selected_entry;  /**< Entry highlighted when the list was last displayed. */
 	/// @}
 };
 
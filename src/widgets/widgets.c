@@ -116,6 +116,10 @@ void widget_free_image_resources()
 static struct _tooltip_info {
 	struct tooltip *value;	/**< Pointer to the current widget's tooltip. */
 	SDL_Rect widget_rect;	/**< Tooltip owner rectangle. */
+	char *text;		/**< Text of the tooltip when it was last displayed. */
+	int centered;		/**< Alignment of the text when it was last displayed. */
+	int dirty;		/**< Flag set when the cached rendering of the tooltip is outdated. */
+	struct display_capture cache;	/**< Rendering of the tooltip. */
 } tooltip_info;
 
 /**
@@ -135,6 +139,8 @@ void widget_set_tooltip(struct tooltip *new_tooltip, SDL_Rect *widget_rect)
 	}
 
 	if ((new_tooltip->get_text && new_tooltip->get_text()) || new_tooltip->text) {
+		if (tooltip_info.value != new_tooltip || memcmp(&tooltip_info.widget_rect, widget_rect, sizeof(SDL_Rect)))
+			tooltip_info.dirty = TRUE;
 		tooltip_info.value = new_tooltip;
 		tooltip_info.widget_rect = *widget_rect;
 	} else {
@@ -187,11 +193,58 @@ static struct widget *get_active_ui()
 	return new_active_ui;
 }
 
+/**
+ * \brief Lay out the current active tooltip, and display it.
+ */
+static void render_tooltip(const char *tooltip_text, int centered)
+{
+	SDL_Rect tooltip_rect = { .x = 0, .y = 0, .h = 500 };
+
+	// Set the correct font before computing text width.
+	set_current_font(FPS_Display_Font);
+
+	// Temporary copy required due to longest_line_width() altering the string.
+	char buffer[strlen(tooltip_text) + 1];
+	strcpy(buffer, tooltip_text);
+
+	// Tooltip width is given by the longest line in the tooltip, with a maximum of 400 pixels
+	// after which linebreaks are automatically added.
+	tooltip_rect.w = longest_line_width(buffer) + 2 * TEXT_BANNER_HORIZONTAL_MARGIN;
+	if (tooltip_rect.w > 400)
+		tooltip_rect.w = 400;	
+
+	// Compute height
+	int lines_in_text = get_lines_needed(tooltip_text, tooltip_rect, 1.0);
+	tooltip_rect.h = lines_in_text * get_font_height(FPS_Display_Font);
+
+	int center_x = tooltip_info.widget_rect.x + tooltip_info.widget_rect.w / 2;	
+	int center_y = tooltip_info.widget_rect.y + tooltip_info.widget_rect.h / 2;	
+
+	// The tooltip is positioned to the left or to the right (whichever is closer 
+	// to the screen's center) of the widget's center.
+	if (center_x < GameConfig.screen_width / 2)
+		tooltip_rect.x = center_x;
+	else
+		tooltip_rect.x = center_x - tooltip_rect.w;
+
+	// The tooltip is positioned above or under the widget (whichever is closer 
+	// to the screen's center). A small offset is added for aesthetic reasons.
+	if (center_y < GameConfig.screen_height / 2)
+		tooltip_rect.y = tooltip_info.widget_rect.y + tooltip_info.widget_rect.h + 4;
+	else
+		tooltip_rect.y = tooltip_info.widget_rect.y - tooltip_rect.h - 4;
+		
+
+	display_tooltip(tooltip_text, centered, tooltip_rect);
+}
+
 /**
  * \brief Display the current active tooltip.
  *
  * \details A widget can set the current active tooltip by calling widget_set_tooltip().
  * This is typically done when a widget receive a mouse hover event.\n
+ * The tooltip is laid out and rendered again only when its text or its
+ * owner changed, like a cached widget (see widget_display_cached()).\n
  * \n
  * TODO: reset the timer when a new tooltip is registered.
  */
@@ -200,7 +253,6 @@ static void display_tooltips()
 	static float time_spent_on_button = 0;
 	static float previous_function_call_time = 0;
 	int centered = 1;
-	SDL_Rect tooltip_rect = { .x = 0, .y = 0, .h = 500 };
 
 	// Update the timer.
 	time_spent_on_button += SDL_GetTicks() - previous_function_call_time;
@@ -230,43 +282,22 @@ static void display_tooltips()
 		
 		centered = 0;	// Editor tooltips are not centered.
 	}
-	
-	// Set the correct font before computing text width.
-	set_current_font(FPS_Display_Font);
-
-	// Temporary copy required due to longest_line_width() altering the string.
-	char buffer[strlen(tooltip_text) + 1];
-	strcpy(buffer, tooltip_text);
 
-	// Tooltip width is given by the longest line in the tooltip, with a maximum of 400 pixels
-	// after which linebreaks are automatically added.
-	tooltip_rect.w = longest_line_width(buffer) + 2 * TEXT_BANNER_HORIZONTAL_MARGIN;
-	if (tooltip_rect.w > 400)
-		tooltip_rect.w = 400;	
-
-	// Compute height
-	int lines_in_text = get_lines_needed(tooltip_text, tooltip_rect, 1.0);
-	tooltip_rect.h = lines_in_text * get_font_height(FPS_Display_Font);
-
-	int center_x = tooltip_info.widget_rect.x + tooltip_info.widget_rect.w / 2;	
-	int center_y = tooltip_info.widget_rect.y + tooltip_info.widget_rect.h / 2;	
-
-	// The tooltip is positioned to the left or to the right (whichever is closer 
-	// to the screen's center) of the widget's center.
-	if (center_x < GameConfig.screen_width / 2)
-		tooltip_rect.x = center_x;
-	else
-		tooltip_rect.x = center_x - tooltip_rect.w;
+	// Dynamic tooltips can change their text at any time.
+	if (!tooltip_info.text || strcmp(tooltip_info.text, tooltip_text) || tooltip_info.centered != centered) {
+		free(tooltip_info.text);
+		tooltip_info.text = strdup(tooltip_text);
+		tooltip_info.centered = centered;
+		tooltip_info.dirty = TRUE;
+	}
 
-	// The tooltip is positioned above or under the widget (whichever is closer 
-	// to the screen's center). A small offset is added for aesthetic reasons.
-	if (center_y < GameConfig.screen_height / 2)
-		tooltip_rect.y = tooltip_info.widget_rect.y + tooltip_info.widget_rect.h + 4;
-	else
-		tooltip_rect.y = tooltip_info.widget_rect.y - tooltip_rect.h - 4;
-		
+	if (!tooltip_info.dirty && display_captured(&tooltip_info.cache))
+		return;
 
-	display_tooltip(tooltip_text, centered, tooltip_rect);
+	start_display_capture(&tooltip_info.cache);
+	render_tooltip(tooltip_info.text, centered);
+	end_display_capture();
+	tooltip_info.dirty = FALSE;
 }
 
 /**
@@ -339,6 +370,8 @@ void widget_free(struct widget *w)
 	if (w->ext) {
 		free(w->ext);
 	}
+
+	dynarray_free(&w->cache.items);
 }
 
 /**
@@ -370,6 +403,8 @@ void widget_init(struct widget *w)
 	w->handle_event = handle_event;
 	w->enabled = 1;
 	w->update_tree = leaf_update;
+	w->dirty = TRUE;
+	memset(&w->cache, 0, sizeof(w->cache));
 }
 
 /**
@@ -401,6 +436,46 @@ void widget_set_rect(struct widget *w, int x, int y, int width, int height)
 	w->rect.y = y;
 	w->rect.w = width;
 	w->rect.h = height;
+	w->dirty = TRUE;
+}
+
+/**
+ * \brief Mark the cached rendering of a widget as outdated.
+ * \ingroup gui2d_widget
+ *
+ * \param w Pointer to the base widget struct
+ */
+void widget_invalidate(struct widget *w)
+{
+	w->dirty = TRUE;
+}
+
+/**
+ * \brief Display a widget from its cached rendering.
+ * \ingroup gui2d_widget
+ *
+ * \details The rendering function is called, and what it draws is recorded,
+ * only if the widget was invalidated since the last call. Otherwise the
+ * recorded images and rectangles are drawn again.
+ *
+ * \param w      Pointer to the base widget struct
+ * \param render Function displaying the widget
+ */
+void widget_display_cached(struct widget *w, void (*render)(struct widget *))
+{
+	if (!w->dirty && display_captured(&w->cache))
+		return;
+
+	// Captures can not be nested
+	if (display_capture_active()) {
+		render(w);
+		return;
+	}
+
+	start_display_capture(&w->cache);
+	render(w);
+	end_display_capture();
+	w->dirty = FALSE;
 }
 
 #undef _widgets_c
@@ -183,6 +183,29 @@
 /// WIDGET(my_button)->update = my_button_update;
 ///   \endcode
 ///
+/// \par Cached rendering
+///   \n
+///   Most widgets display the same thing frame after frame. A widget can render
+///   itself through widget_display_cached(): the images and rectangles drawn by
+///   its rendering function are recorded, and drawn again on the next frames
+///   without calling that function, until the widget is \e invalidated.\n
+///   A widget is invalidated by widget_invalidate(), by widget_set_rect(), and
+///   when any image is deleted. The widget code invalidates it when the
+///   attributes its rendering depends on change.\n
+///   \code
+/// void my_widget_render(struct widget *w)
+/// {
+///   ... display the widget
+/// }
+///
+/// void my_widget_display(struct widget *w)
+/// {
+///   if (some_attribute_changed)
+///     widget_invalidate(w);
+///   widget_display_cached(w, my_widget_render);
+/// }
+///   \endcode
+///
 /// \par Creating a GUI
 ///   \n
 ///   A GUI is a tree composed of containers (widget_group) and \e terminal widgets.
@@ -375,6 +398,8 @@ struct widget {
 	/// @{
 	void (*update_tree) (struct widget *);              /**< Update call propagation */
 	struct list_head node;                              /**< Linked list node used for storing sibling widgets in a widget_group. */
+	uint8_t dirty;                                      /**< Flag set when the cached rendering of the widget is outdated. */
+	struct display_capture cache;                       /**< Rendering of the widget, see widget_display_cached(). */
 	/// @}
 };
 
@@ -390,6 +415,8 @@ struct widget *widget_create(void);
 void widget_init(struct widget *);
 void widget_set_rect(struct widget *, int, int, int, int);
 void widget_free(struct widget *w);
+void widget_invalidate(struct widget *);
+void widget_display_cached(struct widget *, void (*)(struct widget *));
 
 // end gui2d_widget submodule
 ///@}
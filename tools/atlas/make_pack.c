@@ -0,0 +1,581 @@
+/*
+ *
+ *   Copyright (c) 2026 FreedroidRPG development team
+ *
+ *  This file is part of Freedroid
+ *
+ *  Freedroid is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  Freedroid is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with Freedroid; see the file COPYING. If not, write to the
+ *  Free Software Foundation, Inc., 59 Temple Place, Suite 330, Boston,
+ *  MA  02111-1307  USA
+ *
+ */
+
+/**
+ * Generate the asset pack of the game from a list of PNG files and texture
+ * atlas descriptions. See src/asset_pack.h for the file layout.
+ */
+#include <string.h>
+#include "../../src/pngfuncs.h"
+#include "../../src/system.h"
+#include "../../src/asset_pack.h"
+
+#define OFFSET_FILE_OFFSETX_STRING "OffsetX="
+#define OFFSET_FILE_OFFSETY_STRING "OffsetY="
+
+// Pixel format of the images, as created by the game
+#if SDL_BYTEORDER == SDL_LIL_ENDIAN
+#define RMASK 0x00FF0000
+#define GMASK 0x0000FF00
+#define BMASK 0x000000FF
+#define AMASK 0xFF000000
+#else
+#define RMASK 0x0000FF00
+#define GMASK 0x00FF0000
+#define BMASK 0xFF000000
+#define AMASK 0x000000FF
+#endif
+
+const char *img_dir;
+const char *output_path;
+FILE *pack_file;
+uint64_t pack_pos;
+
+char **input_files;
+int input_count;
+
+struct asset_pack_image *images;
+char **image_names;
+int image_count;
+
+struct asset_pack_atlas *atlases;
+int atlas_count;
+struct asset_pack_atlas_page *pages;
+int page_count;
+struct asset_pack_atlas_element *elements;
+int element_count;
+
+struct asset_pack_source *sources;
+int source_count;
+
+char *strings;
+uint64_t strings_size;
+uint64_t strings_capacity;
+
+static void *grow(void *array, int count, size_t size)
+{
+	// Grow by powers of two
+	if (count & (count - 1))
+		return array;
+
+	array = realloc(array, (count ? 2 * count : 1) * size);
+	if (!array) {
+		fprintf(stderr, "Out of memory.\n");
+		exit(1);
+	}
+	return array;
+}
+
+/**
+ * Remove the './' and duplicated '/' of a path, the same way as the game
+ * does before looking for a name in the pack.
+ */
+static void normalize_name(char *dst, const char *src)
+{
+	char *out = dst;
+
+	while (*src) {
+		if (src[0] == '/' && out > dst && out[-1] == '/') {
+			src++;
+			continue;
+		}
+		if (src[0] == '.' && src[1] == '/' && (out == dst || out[-1] == '/')) {
+			src += 2;
+			continue;
+		}
+		*out++ = *src++;
+	}
+	*out = '\0';
+}
+
+static uint32_t add_string(const char *str)
+{
+	uint64_t len = strlen(str) + 1;
+	uint64_t offset = strings_size;
+
+	while (strings_size + len > strings_capacity) {
+		strings_capacity = strings_capacity ? 2 * strings_capacity : 65536;
+		strings = realloc(strings, strings_capacity);
+		if (!strings) {
+			fprintf(stderr, "Out of memory.\n");
+			exit(1);
+		}
+	}
+
+	memcpy(strings + strings_size, str, len);
+	strings_size += len;
+
+	return offset;
+}
+
+/**
+ * FNV-1a hash of the content of a file, as computed by the game to check
+ * the sources of the pack.
+ */
+static uint64_t hash_file(FILE *f)
+{
+	uint64_t hash = 14695981039346656037ULL;
+	unsigned char buf[65536];
+	size_t len, i;
+
+	while ((len = fread(buf, 1, sizeof(buf), f)) > 0) {
+		for (i = 0; i < len; i++)
+			hash = (hash ^ buf[i]) * 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+/**
+ * Record the state of a file an entry of the pack is built from, so that
+ * the game can detect that it was modified after the pack was built.
+ *
+ * \return The index of the source
+ */
+static uint32_t add_source(const char *name)
+{
+	char fn[4096];
+	struct stat st;
+
+	snprintf(fn, sizeof(fn), "%s/%s", img_dir, name);
+
+	sources = grow(sources, source_count, sizeof(struct asset_pack_source));
+	struct asset_pack_source *src = &sources[source_count];
+	memset(src, 0, sizeof(*src));
+	src->name = add_string(name);
+
+	FILE *f = fopen(fn, "rb");
+	if (!f || fstat(fileno(f), &st)) {
+		if (f)
+			fclose(f);
+		src->flags = ASSET_PACK_SOURCE_MISSING;
+		return source_count++;
+	}
+
+	src->mtime = st.st_mtime;
+	src->size = st.st_size;
+	src->hash = hash_file(f);
+	if (ferror(f)) {
+		fprintf(stderr, "Unable to read %s: %s\n", fn, strerror(errno));
+		exit(1);
+	}
+	fclose(f);
+
+	return source_count++;
+}
+
+/**
+ * Record the current modification time of the sources of an existing pack,
+ * for the sources whose content is unchanged. This is done once the data is
+ * installed, as the installed files do not keep their modification time,
+ * so that the game does not have to hash them on each start.
+ */
+static int update_sources(const char *pack_path)
+{
+	struct asset_pack_header header;
+	uint32_t i;
+	int updated = 0, modified = 0;
+
+	FILE *pack = fopen(pack_path, "r+b");
+	if (!pack) {
+		fprintf(stderr, "Unable to open %s: %s\n", pack_path, strerror(errno));
+		return 1;
+	}
+
+	if (fread(&header, sizeof(header), 1, pack) != 1 ||
+	    memcmp(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic)) ||
+	    header.version != ASSET_PACK_VERSION || header.byte_order != ASSET_PACK_BYTE_ORDER) {
+		fprintf(stderr, "%s is not an asset pack of this version.\n", pack_path);
+		fclose(pack);
+		return 1;
+	}
+
+	sources = malloc(header.nb_sources * sizeof(struct asset_pack_source) + 1);
+	strings = malloc(header.strings_size + 1);
+	if (!sources || !strings) {
+		fprintf(stderr, "Out of memory.\n");
+		exit(1);
+	}
+
+	if (fseek(pack, header.sources_offset, SEEK_SET) ||
+	    fread(sources, sizeof(struct asset_pack_source), header.nb_sources, pack) != header.nb_sources ||
+	    fseek(pack, header.strings_offset, SEEK_SET) ||
+	    fread(strings, header.strings_size, 1, pack) != 1) {
+		fprintf(stderr, "Unable to read %s.\n", pack_path);
+		fclose(pack);
+		return 1;
+	}
+	strings[header.strings_size] = '\0';
+
+	for (i = 0; i < header.nb_sources; i++) {
+		struct asset_pack_source *src = &sources[i];
+		char fn[4096];
+		struct stat st;
+
+		if ((src->flags & ASSET_PACK_SOURCE_MISSING) || src->name >= header.strings_size)
+			continue;
+
+		snprintf(fn, sizeof(fn), "%s/%s", img_dir, strings + src->name);
+		FILE *f = fopen(fn, "rb");
+		if (!f || fstat(fileno(f), &st) || (uint64_t)st.st_size != src->size || hash_file(f) != src->hash) {
+			modified++;
+		} else if (src->mtime != st.st_mtime) {
+			src->mtime = st.st_mtime;
+			updated++;
+		}
+		if (f)
+			fclose(f);
+	}
+
+	if (fseek(pack, header.sources_offset, SEEK_SET) ||
+	    fwrite(sources, sizeof(struct asset_pack_source), header.nb_sources, pack) != header.nb_sources ||
+	    fclose(pack)) {
+		fprintf(stderr, "Unable to write %s: %s\n", pack_path, strerror(errno));
+		return 1;
+	}
+
+	printf("Asset pack %s: %d sources updated, %d sources modified since the pack was built.\n",
+	       pack_path, updated, modified);
+	return 0;
+}
+
+static void write_data(const void *data, size_t size)
+{
+	if (size && fwrite(data, size, 1, pack_file) != 1) {
+		fprintf(stderr, "Unable to write %s: %s\n", output_path, strerror(errno));
+		exit(1);
+	}
+	pack_pos += size;
+}
+
+static void align_output(void)
+{
+	static const char zeros[ASSET_PACK_ALIGN];
+
+	if (pack_pos % ASSET_PACK_ALIGN)
+		write_data(zeros, ASSET_PACK_ALIGN - pack_pos % ASSET_PACK_ALIGN);
+}
+
+static void get_offset_for_image(const char *fn, struct asset_pack_image *img)
+{
+	char offset_file_name[10000];
+	FILE *OffsetFile;
+	char *dat;
+	char *p;
+
+	strcpy(offset_file_name, fn);
+	offset_file_name[strlen(offset_file_name) - 4] = 0;
+	strcat(offset_file_name, ".offset");
+
+	if ((OffsetFile = fopen(offset_file_name, "rb")) == NULL)
+		return;
+
+	dat = calloc(1, 4000);
+
+	if (fread(dat, 3999, 1, OffsetFile) != 1 && ferror(OffsetFile)) {
+		fprintf(stderr, "Unable to read offset for image %s: %s\n", fn, strerror(errno));
+		fclose(OffsetFile);
+		free(dat);
+		return;
+	}
+	fclose(OffsetFile);
+
+	p = strstr(dat, OFFSET_FILE_OFFSETX_STRING);
+	if (p) {
+		img->offset_x = atoi(p + strlen(OFFSET_FILE_OFFSETX_STRING));
+		img->flags |= ASSET_PACK_HAS_OFFSET;
+	}
+
+	p = strstr(dat, OFFSET_FILE_OFFSETY_STRING);
+	if (p)
+		img->offset_y = atoi(p + strlen(OFFSET_FILE_OFFSETY_STRING));
+
+	free(dat);
+}
+
+/**
+ * Load an image, convert it to the pixel format of the game, and write its
+ * pixels in the pack.
+ */
+static int add_image(const char *name)
+{
+	char fn[4096];
+	char offset_name[4096];
+	int i;
+
+	for (i = 0; i < image_count; i++) {
+		if (!strcmp(image_names[i], name))
+			return i;
+	}
+
+	snprintf(fn, sizeof(fn), "%s/%s", img_dir, name);
+
+	SDL_Surface *src = IMG_Load(fn);
+	if (!src) {
+		fprintf(stderr, "Unable to load image %s: %s\n", fn, IMG_GetError());
+		exit(1);
+	}
+
+	// Same conversion as the one done by the game when loading an image,
+	// colorkeys are converted to transparent pixels
+	SDL_Surface *fmt = SDL_CreateRGBSurface(SDL_SWSURFACE, 1, 1, 32, RMASK, GMASK, BMASK, AMASK);
+	SDL_SetAlpha(src, 0, SDL_ALPHA_OPAQUE);
+	SDL_Surface *surf = SDL_ConvertSurface(src, fmt->format, SDL_SWSURFACE);
+	SDL_FreeSurface(fmt);
+	SDL_FreeSurface(src);
+	if (!surf) {
+		fprintf(stderr, "Unable to convert image %s: %s\n", fn, SDL_GetError());
+		exit(1);
+	}
+
+	images = grow(images, image_count, sizeof(struct asset_pack_image));
+	image_names = grow(image_names, image_count, sizeof(char *));
+
+	struct asset_pack_image *img = &images[image_count];
+	memset(img, 0, sizeof(*img));
+	img->name = add_string(name);
+	img->w = surf->w;
+	img->h = surf->h;
+	get_offset_for_image(fn, img);
+
+	// The .offset file is recorded even when missing, as adding one
+	// changes the image
+	snprintf(offset_name, sizeof(offset_name), "%.*s.offset", (int)strlen(name) - 4, name);
+	img->source = add_source(name);
+	img->offset_source = add_source(offset_name);
+
+	align_output();
+	img->pixels = pack_pos;
+
+	SDL_LockSurface(surf);
+	int y;
+	for (y = 0; y < surf->h; y++)
+		write_data((char *)surf->pixels + y * surf->pitch, surf->w * 4);
+	SDL_UnlockSurface(surf);
+	SDL_FreeSurface(surf);
+
+	image_names[image_count] = strdup(name);
+	return image_count++;
+}
+
+/**
+ * Read a texture atlas description, and add its pages and elements to
+ * the pack.
+ */
+static void add_atlas(const char *name)
+{
+	char fn[4096];
+	char dir[4096];
+	char line[4096];
+
+	snprintf(fn, sizeof(fn), "%s/%s", img_dir, name);
+	FILE *f = fopen(fn, "r");
+	if (!f) {
+		fprintf(stderr, "Unable to open atlas %s: %s\n", fn, strerror(errno));
+		exit(1);
+	}
+
+	// Page images are relative to the directory of the atlas
+	strcpy(dir, name);
+	char *slash = strrchr(dir, '/');
+	if (slash)
+		slash[1] = '\0';
+	else
+		dir[0] = '\0';
+
+	atlases = grow(atlases, atlas_count, sizeof(struct asset_pack_atlas));
+	struct asset_pack_atlas *atlas = &atlases[atlas_count++];
+	atlas->name = add_string(name);
+	atlas->first_page = page_count;
+	atlas->nb_pages = 0;
+	atlas->source = add_source(name);
+
+	while (fgets(line, sizeof(line), f)) {
+		char key[1024];
+		int width, height;
+		int x, y, w, h, xoff, yoff;
+
+		if (sscanf(line, "* %1023s size %d %d", key, &width, &height) == 3) {
+			char page_name[4096];
+			char path[8192];
+			snprintf(path, sizeof(path), "%s%s", dir, key);
+			normalize_name(page_name, path);
+
+			int image = add_image(page_name);
+
+			pages = grow(pages, page_count, sizeof(struct asset_pack_atlas_page));
+			pages[page_count].image = image;
+			pages[page_count].first_element = element_count;
+			pages[page_count].nb_elements = 0;
+			page_count++;
+			atlases[atlas_count - 1].nb_pages++;
+		} else if (sscanf(line, "%1023s %d %d %d %d off %d %d", key, &x, &y, &w, &h, &xoff, &yoff) == 7) {
+			if (!page_count || atlases[atlas_count - 1].nb_pages == 0) {
+				fprintf(stderr, "Atlas %s: element %s is not in a page\n", fn, key);
+				exit(1);
+			}
+
+			elements = grow(elements, element_count, sizeof(struct asset_pack_atlas_element));
+			struct asset_pack_atlas_element *elt = &elements[element_count++];
+			elt->key = add_string(key);
+			elt->x = x;
+			elt->y = y;
+			elt->w = w;
+			elt->h = h;
+			elt->offset_x = xoff;
+			elt->offset_y = yoff;
+			pages[page_count - 1].nb_elements++;
+		}
+	}
+
+	fclose(f);
+}
+
+static void read_input_files(void)
+{
+	char line[4096];
+
+	while (fgets(line, sizeof(line), stdin)) {
+		line[strcspn(line, "\r\n")] = '\0';
+		if (!*line)
+			continue;
+
+		char *name = malloc(strlen(line) + 1);
+		normalize_name(name, line);
+
+		input_files = grow(input_files, input_count, sizeof(char *));
+		input_files[input_count++] = name;
+	}
+}
+
+static int has_extension(const char *name, const char *ext)
+{
+	int len = strlen(name);
+	int ext_len = strlen(ext);
+
+	return len > ext_len && !strcmp(name + len - ext_len, ext);
+}
+
+int main(int argc, char **argv)
+{
+	int i;
+
+	if (argc == 4 && !strcmp(argv[1], "--update-sources")) {
+		img_dir = argv[2];
+		return update_sources(argv[3]);
+	}
+
+	if (argc != 3) {
+		fprintf(stderr, "Usage:\n"
+		                "  %s <image_src_dir> <output_file> < <file_list>\n"
+		                "    <file_list> contains one file per line, relative to <image_src_dir>.\n"
+		                "    The .png files are added as images (with their .offset file, if any),\n"
+		                "    and the .txt files are read as texture atlas descriptions.\n"
+		                "  %s --update-sources <image_dir> <pack_file>\n"
+		                "    Record the modification time of the files of <image_dir> in the pack,\n"
+		                "    for the ones unchanged since the pack was built (after an install).\n",
+		                argv[0], argv[0]);
+		exit(1);
+	}
+
+	img_dir = argv[1];
+	output_path = argv[2];
+
+	if (SDL_Init(0) == -1) {
+		fprintf(stderr, "Couldn't initialize SDL: %s\n", SDL_GetError());
+		exit(1);
+	}
+	atexit(SDL_Quit);
+
+	read_input_files();
+
+	pack_file = fopen(output_path, "wb");
+	if (!pack_file) {
+		fprintf(stderr, "Unable to create %s: %s\n", output_path, strerror(errno));
+		exit(1);
+	}
+
+	// The header is written again at the end, once complete
+	struct asset_pack_header header;
+	memset(&header, 0, sizeof(header));
+	write_data(&header, sizeof(header));
+
+	// Empty string, used for missing names
+	add_string("");
+
+	for (i = 0; i < input_count; i++) {
+		if (has_extension(input_files[i], ".png"))
+			add_image(input_files[i]);
+	}
+
+	for (i = 0; i < input_count; i++) {
+		if (has_extension(input_files[i], ".txt"))
+			add_atlas(input_files[i]);
+	}
+
+	memcpy(header.magic, ASSET_PACK_MAGIC, sizeof(header.magic));
+	header.version = ASSET_PACK_VERSION;
+	header.byte_order = ASSET_PACK_BYTE_ORDER;
+	header.rmask = RMASK;
+	header.gmask = GMASK;
+	header.bmask = BMASK;
+	header.amask = AMASK;
+
+	align_output();
+	header.nb_images = image_count;
+	header.images_offset = pack_pos;
+	write_data(images, image_count * sizeof(struct asset_pack_image));
+
+	align_output();
+	header.nb_atlases = atlas_count;
+	header.atlases_offset = pack_pos;
+	write_data(atlases, atlas_count * sizeof(struct asset_pack_atlas));
+
+	align_output();
+	header.nb_atlas_pages = page_count;
+	header.atlas_pages_offset = pack_pos;
+	write_data(pages, page_count * sizeof(struct asset_pack_atlas_page));
+
+	align_output();
+	header.nb_atlas_elements = element_count;
+	header.atlas_elements_offset = pack_pos;
+	write_data(elements, element_count * sizeof(struct asset_pack_atlas_element));
+
+	align_output();
+	header.nb_sources = source_count;
+	header.sources_offset = pack_pos;
+	write_data(sources, source_count * sizeof(struct asset_pack_source));
+
+	header.strings_offset = pack_pos;
+	header.strings_size = strings_size;
+	write_data(strings, strings_size);
+
+	if (fseek(pack_file, 0, SEEK_SET) || fwrite(&header, sizeof(header), 1, pack_file) != 1 || fclose(pack_file)) {
+		fprintf(stderr, "Unable to write %s: %s\n", output_path, strerror(errno));
+		exit(1);
+	}
+
+	printf("Asset pack %s created: %d images, %d atlases, %d atlas elements, %lluMB.\n",
+	       output_path, image_count, atlas_count, element_count, (unsigned long long)(pack_pos >> 20));
+	return 0;
+}